@@ -0,0 +1,65 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Private interface between vtkSMPTools and its backends. Every backend
+// compiled into VTK::CommonCore (see VTK_SMP_ENABLE_<backend>) provides its
+// entry points in SMP/<backend>/vtkSMPToolsImpl.cxx; vtkSMPTools.cxx selects
+// one of them at runtime.
+
+#ifndef vtkSMPToolsImpl_h
+#define vtkSMPToolsImpl_h
+
+#include "vtkSMPToolsInternal.h"
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+struct vtkSMPToolsBackend
+{
+  // Name used by vtkSMPTools::SetBackend() / GetBackend().
+  const char* Name;
+  BackendType Type;
+
+  // Set the number of threads, numThreads is always positive.
+  void (*Initialize)(int numThreads);
+  int (*GetEstimatedNumberOfThreads)();
+
+  // Execute functorExecuter(functor, from, grain, last) over [first, last)
+  // in chunks of at most grain items. grain <= 0 lets the backend choose.
+  void (*For)(vtkIdType first, vtkIdType last, vtkIdType grain,
+              ExecuteFunctorPtrType functorExecuter, void* functor);
+};
+
+const vtkSMPToolsBackend& GetSequentialBackend();
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+const vtkSMPToolsBackend& GetSTDThreadBackend();
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+const vtkSMPToolsBackend& GetOpenMPBackend();
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+const vtkSMPToolsBackend& GetTBBBackend();
+#endif
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsImpl.h
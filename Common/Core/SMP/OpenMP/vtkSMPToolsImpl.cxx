@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,18 +13,21 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "SMP/Common/vtkSMPToolsImpl.h"
 
 #include <omp.h>
 
 #include <algorithm>
 
+// Nested regions follow the OpenMP settings: unless OMP_MAX_ACTIVE_LEVELS
+// (or OMP_NESTED) allows more than one active level, a region started from
+// within another one is executed by a team of one thread.
+
 namespace
 {
 int vtkSMPNumberOfSpecifiedThreads = 0;
-}
 
-void vtkSMPTools::Initialize(int numThreads)
+void Initialize(int numThreads)
 {
 # pragma omp single
   if (numThreads)
@@ -34,20 +37,14 @@ void vtkSMPTools::Initialize(int numThreads)
   }
 }
 
-int vtkSMPTools::GetEstimatedNumberOfThreads()
-{
-  return vtk::detail::smp::GetNumberOfThreads();
-}
-
-int vtk::detail::smp::GetNumberOfThreads()
+int GetEstimatedNumberOfThreads()
 {
   return vtkSMPNumberOfSpecifiedThreads ? vtkSMPNumberOfSpecifiedThreads :
          omp_get_max_threads();
 }
 
-void vtk::detail::smp::vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
-  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
-  void *functor)
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor)
 {
   if (grain <= 0)
   {
@@ -61,3 +58,14 @@ void vtk::detail::smp::vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
     functorExecuter(functor, from, grain, last);
   }
 }
+
+}
+
+//--------------------------------------------------------------------------------
+const vtk::detail::smp::vtkSMPToolsBackend&
+vtk::detail::smp::GetOpenMPBackend()
+{
+  static const vtkSMPToolsBackend backend = { "OpenMP",
+    BackendType::OpenMP, &Initialize, &GetEstimatedNumberOfThreads, &For };
+  return backend;
+}
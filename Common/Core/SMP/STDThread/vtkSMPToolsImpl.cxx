@@ -0,0 +1,358 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Implementation based on a persistent pool of std::thread workers. Each
+// parallel For() splits its range into chunks of the requested grain. The
+// chunks are distributed in contiguous blocks to per-worker queues; a worker
+// consumes its own queue from the front and, once it is empty, steals the back
+// half of the queue of another worker. The calling thread participates in the
+// work as worker 0. A For() issued from inside one of the pool's parallel
+// regions (only possible when vtkSMPTools nested parallelism is enabled) or
+// while another thread owns the pool is executed serially by the calling
+// thread, so that the pool can neither deadlock nor oversubscribe the cores.
+
+namespace
+{
+
+// Set while the current thread is executing a chunk of a parallel For().
+thread_local bool vtkSMPInParallelRegion = false;
+
+class vtkSMPThreadPool
+{
+public:
+  vtkSMPThreadPool()
+    : NumberOfThreads(0), Generation(0), ActiveWorkers(0), JobWorkers(0),
+      Stop(false), First(0), Last(0), Grain(1), Executer(nullptr),
+      Functor(nullptr)
+  {
+    this->NumberOfThreads = vtkSMPThreadPool::GetDefaultNumberOfThreads();
+  }
+
+  ~vtkSMPThreadPool()
+  {
+    this->StopWorkers();
+  }
+
+  static int GetDefaultNumberOfThreads()
+  {
+    int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    return numThreads > 0 ? numThreads : 1;
+  }
+
+  int GetNumberOfThreads() const
+  {
+    return this->NumberOfThreads;
+  }
+
+  void SetNumberOfThreads(int numThreads)
+  {
+    std::lock_guard<std::mutex> runLock(this->RunLock);
+    if (numThreads <= 0)
+    {
+      numThreads = vtkSMPThreadPool::GetDefaultNumberOfThreads();
+    }
+    if (numThreads != this->NumberOfThreads)
+    {
+      this->StopWorkers();
+      this->NumberOfThreads = numThreads;
+    }
+  }
+
+  void Run(vtkIdType first, vtkIdType last, vtkIdType grain,
+           vtk::detail::smp::ExecuteFunctorPtrType executer, void* functor);
+
+private:
+  // A range of chunk indices owned by one worker. Padded so that the locks of
+  // neighboring queues do not share a cache line.
+  struct WorkerQueue
+  {
+    std::mutex Lock;
+    vtkIdType Begin;
+    vtkIdType End;
+    char Padding[64];
+  };
+
+  void StartWorkers();
+  void StopWorkers();
+  void WorkerLoop(int index, unsigned long long generation);
+  void Work(int index);
+  bool PopFront(int index, vtkIdType& chunk);
+  bool Steal(int victim, int thief);
+
+  void ExecuteChunk(vtkIdType chunk)
+  {
+    this->Executer(this->Functor, this->First + chunk * this->Grain,
+                   this->Grain, this->Last);
+  }
+
+  int NumberOfThreads;
+  std::vector<std::thread> Workers;
+  std::unique_ptr<WorkerQueue[]> Queues;
+
+  // Serializes parallel For() calls (and resizing) on the pool.
+  std::mutex RunLock;
+
+  // Protects the job hand-off between the calling thread and the workers.
+  std::mutex StateLock;
+  std::condition_variable WakeCondition;
+  std::condition_variable DoneCondition;
+  unsigned long long Generation;
+  int ActiveWorkers;
+  int JobWorkers;
+  bool Stop;
+
+  // Description of the current job.
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+  vtk::detail::smp::ExecuteFunctorPtrType Executer;
+  void* Functor;
+};
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::StartWorkers()
+{
+  this->Queues.reset(new WorkerQueue[this->NumberOfThreads]);
+  this->Stop = false;
+  // The calling thread acts as worker 0.
+  for (int i = 1; i < this->NumberOfThreads; ++i)
+  {
+    this->Workers.emplace_back(
+      &vtkSMPThreadPool::WorkerLoop, this, i, this->Generation);
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->StateLock);
+    this->Stop = true;
+  }
+  this->WakeCondition.notify_all();
+  for (std::thread& worker : this->Workers)
+  {
+    worker.join();
+  }
+  this->Workers.clear();
+  this->Queues.reset();
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::WorkerLoop(int index, unsigned long long generation)
+{
+  // Workers are started between jobs; only wake up for the jobs that are
+  // issued after that point.
+  unsigned long long seen = generation;
+  std::unique_lock<std::mutex> lock(this->StateLock);
+  for (;;)
+  {
+    this->WakeCondition.wait(lock,
+      [&]() { return this->Stop || this->Generation != seen; });
+    if (this->Stop)
+    {
+      return;
+    }
+    seen = this->Generation;
+    if (index >= this->JobWorkers)
+    {
+      continue;
+    }
+
+    lock.unlock();
+    this->Work(index);
+    lock.lock();
+
+    if (--this->ActiveWorkers == 0)
+    {
+      this->DoneCondition.notify_one();
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::PopFront(int index, vtkIdType& chunk)
+{
+  WorkerQueue& queue = this->Queues[index];
+  std::lock_guard<std::mutex> lock(queue.Lock);
+  if (queue.Begin >= queue.End)
+  {
+    return false;
+  }
+  chunk = queue.Begin++;
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::Steal(int victim, int thief)
+{
+  vtkIdType begin, end;
+  {
+    WorkerQueue& queue = this->Queues[victim];
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    vtkIdType remaining = queue.End - queue.Begin;
+    if (remaining <= 0)
+    {
+      return false;
+    }
+    // Take the back half, leaving the front (which the owner is about to
+    // process next) in place.
+    end = queue.End;
+    begin = queue.End - (remaining + 1) / 2;
+    queue.End = begin;
+  }
+
+  WorkerQueue& queue = this->Queues[thief];
+  std::lock_guard<std::mutex> lock(queue.Lock);
+  queue.Begin = begin;
+  queue.End = end;
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::Work(int index)
+{
+  vtkSMPInParallelRegion = true;
+  vtkIdType chunk;
+  for (;;)
+  {
+    while (this->PopFront(index, chunk))
+    {
+      this->ExecuteChunk(chunk);
+    }
+
+    // No work left locally, look for a victim. Chunks are only ever removed
+    // from the queues, so a full pass without finding any work means that the
+    // job is finished as far as this worker is concerned.
+    bool stolen = false;
+    for (int i = 1; i < this->JobWorkers && !stolen; ++i)
+    {
+      stolen = this->Steal((index + i) % this->JobWorkers, index);
+    }
+    if (!stolen)
+    {
+      break;
+    }
+  }
+  vtkSMPInParallelRegion = false;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::Run(vtkIdType first, vtkIdType last, vtkIdType grain,
+  vtk::detail::smp::ExecuteFunctorPtrType executer, void* functor)
+{
+  std::unique_lock<std::mutex> runLock(this->RunLock, std::defer_lock);
+  if (vtkSMPInParallelRegion || !runLock.try_lock() ||
+      this->NumberOfThreads == 1)
+  {
+    // Nested or concurrent parallel region: run serially on this thread.
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      executer(functor, from, grain, last);
+    }
+    return;
+  }
+
+  if (!this->Queues)
+  {
+    this->StartWorkers();
+  }
+
+  const vtkIdType numChunks = (last - first + grain - 1) / grain;
+  const int numWorkers = static_cast<int>(
+    std::min(static_cast<vtkIdType>(this->NumberOfThreads), numChunks));
+  for (int i = 0; i < numWorkers; ++i)
+  {
+    this->Queues[i].Begin = numChunks * i / numWorkers;
+    this->Queues[i].End = numChunks * (i + 1) / numWorkers;
+  }
+
+  this->First = first;
+  this->Last = last;
+  this->Grain = grain;
+  this->Executer = executer;
+  this->Functor = functor;
+
+  {
+    std::lock_guard<std::mutex> lock(this->StateLock);
+    this->JobWorkers = numWorkers;
+    this->ActiveWorkers = numWorkers - 1;
+    ++this->Generation;
+  }
+  if (numWorkers > 1)
+  {
+    this->WakeCondition.notify_all();
+  }
+
+  this->Work(0);
+
+  // The functor lives on the caller's stack: wait for every helper to be
+  // done with it before returning.
+  std::unique_lock<std::mutex> lock(this->StateLock);
+  this->DoneCondition.wait(lock, [this]() { return this->ActiveWorkers == 0; });
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool& GetThreadPool()
+{
+  static vtkSMPThreadPool pool;
+  return pool;
+}
+
+//--------------------------------------------------------------------------------
+void Initialize(int numThreads)
+{
+  GetThreadPool().SetNumberOfThreads(numThreads);
+}
+
+//--------------------------------------------------------------------------------
+int GetEstimatedNumberOfThreads()
+{
+  return GetThreadPool().GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor)
+{
+  vtkSMPThreadPool& pool = GetThreadPool();
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first) / (pool.GetNumberOfThreads() * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  pool.Run(first, last, grain, functorExecuter, functor);
+}
+
+}
+
+//--------------------------------------------------------------------------------
+const vtk::detail::smp::vtkSMPToolsBackend&
+vtk::detail::smp::GetSTDThreadBackend()
+{
+  static const vtkSMPToolsBackend backend = { "STDThread",
+    BackendType::STDThread, &Initialize, &GetEstimatedNumberOfThreads, &For };
+  return backend;
+}
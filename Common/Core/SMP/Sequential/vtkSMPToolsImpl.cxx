@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,16 +13,43 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "SMP/Common/vtkSMPToolsImpl.h"
 
 // Simple implementation that runs everything sequentially.
 
-//--------------------------------------------------------------------------------
-void vtkSMPTools::Initialize(int)
+namespace
+{
+
+void Initialize(int)
 {
 }
 
-int vtkSMPTools::GetEstimatedNumberOfThreads()
+int GetEstimatedNumberOfThreads()
 {
   return 1;
 }
+
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor)
+{
+  if (grain <= 0)
+  {
+    grain = last - first;
+  }
+
+  for (vtkIdType from = first; from < last; from += grain)
+  {
+    functorExecuter(functor, from, grain, last);
+  }
+}
+
+}
+
+//--------------------------------------------------------------------------------
+const vtk::detail::smp::vtkSMPToolsBackend&
+vtk::detail::smp::GetSequentialBackend()
+{
+  static const vtkSMPToolsBackend backend = { "Sequential",
+    BackendType::Sequential, &Initialize, &GetEstimatedNumberOfThreads, &For };
+  return backend;
+}
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#include "vtkCriticalSection.h"
+
+#ifdef _MSC_VER
+#  pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#  define __TBB_NO_IMPLICIT_LINKAGE 1
+#endif
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#ifdef _MSC_VER
+#  pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#endif
+
+namespace
+{
+
+struct vtkSMPToolsInit
+{
+  tbb::task_scheduler_init Init;
+
+  vtkSMPToolsInit(int numThreads) : Init(numThreads)
+  {
+  }
+};
+
+bool vtkSMPToolsInitialized = 0;
+int vtkTBBNumSpecifiedThreads = 0;
+vtkSimpleCriticalSection vtkSMPToolsCS;
+
+//--------------------------------------------------------------------------------
+void Initialize(int numThreads)
+{
+  vtkSMPToolsCS.Lock();
+  if (!vtkSMPToolsInitialized)
+  {
+    // If numThreads <= 0, don't create a task_scheduler_init
+    // and let TBB do the default thing.
+    if (numThreads > 0)
+    {
+      static vtkSMPToolsInit aInit(numThreads);
+      vtkTBBNumSpecifiedThreads = numThreads;
+    }
+    vtkSMPToolsInitialized = true;
+  }
+  vtkSMPToolsCS.Unlock();
+}
+
+//--------------------------------------------------------------------------------
+int GetEstimatedNumberOfThreads()
+{
+  return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
+    : tbb::task_scheduler_init::default_num_threads();
+}
+
+//--------------------------------------------------------------------------------
+class FuncCall
+{
+  vtk::detail::smp::ExecuteFunctorPtrType FunctorExecuter;
+  void* Functor;
+
+  void operator=(const FuncCall&) = delete;
+
+public:
+  void operator() (const tbb::blocked_range<vtkIdType>& r) const
+  {
+    this->FunctorExecuter(this->Functor, r.begin(), r.end() - r.begin(),
+                          r.end());
+  }
+
+  FuncCall(vtk::detail::smp::ExecuteFunctorPtrType functorExecuter,
+           void* functor)
+    : FunctorExecuter(functorExecuter), Functor(functor)
+  {
+  }
+};
+
+//--------------------------------------------------------------------------------
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor)
+{
+  if (grain > 0)
+  {
+    tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last, grain),
+                      FuncCall(functorExecuter, functor));
+  }
+  else
+  {
+    tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last),
+                      FuncCall(functorExecuter, functor));
+  }
+}
+
+}
+
+//--------------------------------------------------------------------------------
+const vtk::detail::smp::vtkSMPToolsBackend&
+vtk::detail::smp::GetTBBBackend()
+{
+  static const vtkSMPToolsBackend backend = { "TBB",
+    BackendType::TBB, &Initialize, &GetEstimatedNumberOfThreads, &For };
+  return backend;
+}
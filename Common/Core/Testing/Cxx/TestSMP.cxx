@@ -16,6 +16,7 @@
 #include "vtkNew.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTestUtilities.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
 #include <functional>
@@ -91,13 +92,39 @@ public:
 
 };
 
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  vtkSMPThreadLocal<int> OutOfScope;
+
+  NestedFunctor(): Counter(0), OutOfScope(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    if (!vtkSMPTools::IsParallelScope())
+    {
+      this->OutOfScope.Local()++;
+    }
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      // Parallel region started from within another one.
+      vtkSMPTools::For(0, 100, [this](vtkIdType b, vtkIdType e)
+      {
+        this->Counter.Local() += static_cast<int>(e - b);
+      });
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
-int TestSMP(int, char*[])
+static int TestSMPBackend()
 {
-  //vtkSMPTools::Initialize(8);
-
   ARangeFunctor functor1;
 
   vtkSMPTools::For(0, Target, functor1);
@@ -140,6 +167,38 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  NestedFunctor functor3;
+
+  vtkSMPTools::For(0, 100, 1, functor3);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr3 = functor3.Counter.begin();
+       itr3 != functor3.Counter.end(); ++itr3)
+  {
+    total += *itr3;
+  }
+
+  if (total != 100 * 100)
+  {
+    cerr << "Error: NestedFunctor did not generate " << 100 * 100 << endl;
+    return 1;
+  }
+
+  for (vtkSMPThreadLocal<int>::iterator itr3 = functor3.OutOfScope.begin();
+       itr3 != functor3.OutOfScope.end(); ++itr3)
+  {
+    if (*itr3)
+    {
+      cerr << "Error: IsParallelScope() is false in a parallel region" << endl;
+      return 1;
+    }
+  }
+  if (vtkSMPTools::IsParallelScope())
+  {
+    cerr << "Error: IsParallelScope() is true after a parallel region" << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -169,3 +228,35 @@ int TestSMP(int, char*[])
 
   return 0;
 }
+
+int TestSMP(int, char*[])
+{
+  if (vtkSMPTools::SetBackend("NoSuchBackend"))
+  {
+    cerr << "Error: SetBackend() accepted an unknown backend" << endl;
+    return 1;
+  }
+
+  // Run the tests with all the backends compiled in, with and without
+  // nested parallelism.
+  const bool success = vtkSMPTestUtilities::ForEachBackend(
+    [](const char* backend)
+    {
+      cout << "Testing backend " << vtkSMPTools::GetBackend() << endl;
+
+      for (int nested = 0; nested < 2; ++nested)
+      {
+        vtkSMPTools::SetNestedParallelism(nested != 0);
+        if (TestSMPBackend())
+        {
+          cerr << "Error: Failed with backend " << backend
+               << (nested ? " and nested parallelism" : "") << endl;
+          return false;
+        }
+      }
+      return true;
+    });
+  vtkSMPTools::SetNestedParallelism(false);
+
+  return success ? 0 : 1;
+}
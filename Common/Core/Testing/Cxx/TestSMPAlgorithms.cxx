@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPAlgorithms.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test the STL-like algorithms of vtkSMPTools.
+// .SECTION Description
+// Compare vtkSMPTools::Fill, Transform, Reduce, InclusiveScan, ExclusiveScan
+// and Partition with their sequential STL counterparts, for all the
+// available backends and a range of sizes around the block boundaries.
+
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+#define CHECK(cond, msg)                                                      \
+  if (!(cond))                                                                \
+  {                                                                           \
+    cerr << "Error: " << msg << " (size " << size << ")" << endl;            \
+    return false;                                                             \
+  }
+
+// Not commutative: checks that the items are combined in order.
+struct Concatenate
+{
+  std::string operator()(const std::string& a, const std::string& b) const
+  {
+    return a + b;
+  }
+};
+
+struct IsOdd
+{
+  bool operator()(int value) const { return (value % 2) != 0; }
+};
+
+//------------------------------------------------------------------------------
+bool TestAlgorithms(vtkIdType size)
+{
+  std::vector<int> values(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    values[i] = static_cast<int>((i * 7919) % 1000);
+  }
+
+  // Fill
+  std::vector<int> filled(size, 0);
+  vtkSMPTools::Fill(filled.begin(), filled.end(), 42);
+  CHECK(std::count(filled.begin(), filled.end(), 42) == size, "Fill");
+
+  // Unary and binary Transform
+  std::vector<int> doubled(size);
+  vtkSMPTools::Transform(values.begin(), values.end(), doubled.begin(),
+                         [](int v) { return 2 * v; });
+  std::vector<int> sums(size);
+  vtkSMPTools::Transform(values.begin(), values.end(), doubled.begin(),
+                         sums.begin(), std::plus<int>());
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    CHECK(doubled[i] == 2 * values[i], "unary Transform");
+    CHECK(sums[i] == 3 * values[i], "binary Transform");
+  }
+
+  // Reduce
+  const long long expectedSum =
+    std::accumulate(values.begin(), values.end(), 5LL);
+  CHECK(vtkSMPTools::Reduce(values.begin(), values.end(), 5LL) == expectedSum,
+        "Reduce");
+
+  // Scans, out of place and in place
+  std::vector<int> expected(size);
+  std::vector<int> scanned(size);
+  std::partial_sum(values.begin(), values.end(), expected.begin());
+  CHECK(vtkSMPTools::InclusiveScan(values.begin(), values.end(),
+                                   scanned.begin()) == scanned.end(),
+        "InclusiveScan return value");
+  CHECK(scanned == expected, "InclusiveScan");
+  scanned = values;
+  vtkSMPTools::InclusiveScan(scanned.begin(), scanned.end(), scanned.begin());
+  CHECK(scanned == expected, "in place InclusiveScan");
+
+  int sum = 3;
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    expected[i] = sum;
+    sum += values[i];
+  }
+  CHECK(vtkSMPTools::ExclusiveScan(values.begin(), values.end(),
+                                   scanned.begin(), 3) == scanned.end(),
+        "ExclusiveScan return value");
+  CHECK(scanned == expected, "ExclusiveScan");
+  scanned = values;
+  vtkSMPTools::ExclusiveScan(
+    scanned.begin(), scanned.end(), scanned.begin(), 3);
+  CHECK(scanned == expected, "in place ExclusiveScan");
+
+  // Non commutative operation; the scan of strings is quadratic, so only
+  // check the small sizes.
+  if (size <= 1000)
+  {
+    std::vector<std::string> words(size);
+    for (vtkIdType i = 0; i < size; ++i)
+    {
+      words[i] = std::string(1, static_cast<char>('a' + i % 26));
+    }
+    const std::string expectedWord =
+      std::accumulate(words.begin(), words.end(), std::string(">"));
+    CHECK(vtkSMPTools::Reduce(words.begin(), words.end(), std::string(">"),
+                              Concatenate()) == expectedWord,
+          "non commutative Reduce");
+
+    std::vector<std::string> expectedWords(size);
+    std::vector<std::string> scannedWords(size);
+    std::partial_sum(words.begin(), words.end(), expectedWords.begin(),
+                     Concatenate());
+    vtkSMPTools::InclusiveScan(words.begin(), words.end(),
+                               scannedWords.begin(), Concatenate());
+    CHECK(scannedWords == expectedWords, "non commutative InclusiveScan");
+  }
+
+  // Partition must be stable
+  std::vector<int> partitioned = values;
+  expected = values;
+  std::vector<int>::iterator expectedMiddle =
+    std::stable_partition(expected.begin(), expected.end(), IsOdd());
+  std::vector<int>::iterator middle = vtkSMPTools::Partition(
+    partitioned.begin(), partitioned.end(), IsOdd());
+  CHECK(middle - partitioned.begin() == expectedMiddle - expected.begin(),
+        "Partition return value");
+  CHECK(partitioned == expected, "Partition");
+
+  return true;
+}
+
+#undef CHECK
+
+}
+
+//------------------------------------------------------------------------------
+int TestSMPAlgorithms(int, char*[])
+{
+  const vtkIdType sizes[] = { 0, 1, 2, 15, 16, 17, 1000, 100003 };
+  auto testBackend = [&](const char* backend) {
+    cout << "Testing backend " << vtkSMPTools::GetBackend() << endl;
+
+    for (vtkIdType size : sizes)
+    {
+      if (!TestAlgorithms(size))
+      {
+        cerr << "Error: Failed with backend " << backend << endl;
+        return false;
+      }
+    }
+    return true;
+  };
+
+  return vtkSMPTestUtilities::ForEachBackend(testBackend) ? EXIT_SUCCESS
+                                                         : EXIT_FAILURE;
+}
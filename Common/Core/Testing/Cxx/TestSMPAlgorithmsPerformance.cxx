@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPAlgorithmsPerformance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test speed of the vtkSMPTools algorithms.
+// .SECTION Description
+// Time vtkSMPTools::Fill, Transform, Reduce, ExclusiveScan and Partition
+// against their sequential STL counterparts, for every available backend.
+
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// How many times the tests are run to average the elapsed time.
+static const int STRESS_COUNT = 5;
+
+// Number of items processed by each algorithm.
+static const vtkIdType ARRAY_SIZE = 4000000;
+
+// Description:
+// Type of console outputs.
+// CDash writes perfs as <DartMeasurement ...> for unit test regression
+// Details writes more timing information
+enum VerboseType
+{
+  None = 0x0,
+  CDash = 0x1,
+  Details = 0x2
+};
+
+static const int VERBOSE_MODE = CDash;
+
+//------------------------------------------------------------------------------
+// Times run() STRESS_COUNT times and reports the mean duration.
+template <typename Run>
+static double TimeAlgorithm(const std::string& name, Run run)
+{
+  vtkNew<vtkTimerLog> timer;
+  double meanDuration = 0.0;
+  for (int i = 0; i < STRESS_COUNT; ++i)
+  {
+    timer->StartTimer();
+    run();
+    timer->StopTimer();
+    meanDuration += timer->GetElapsedTime();
+  }
+  meanDuration /= STRESS_COUNT;
+  if (VERBOSE_MODE & CDash)
+  {
+    std::cout << "<DartMeasurement name=\"" << name
+              << "\" type=\"numeric/double\">"
+              << meanDuration << "</DartMeasurement>" << std::endl;
+  }
+  return meanDuration;
+}
+
+//------------------------------------------------------------------------------
+static bool RunAlgorithms(const std::string& prefix, bool smp)
+{
+  std::vector<double> values(ARRAY_SIZE);
+  std::vector<double> result(ARRAY_SIZE);
+  std::vector<vtkIdType> counts(ARRAY_SIZE);
+  std::vector<vtkIdType> offsets(ARRAY_SIZE);
+  for (vtkIdType i = 0; i < ARRAY_SIZE; ++i)
+  {
+    counts[i] = i % 7;
+  }
+
+  auto isSmall = [](double v) { return v < 0.5; };
+  auto transform = [](double v) { return std::sqrt(v) * std::sin(v); };
+  double sum = 0.0;
+
+  TimeAlgorithm(prefix + "Fill", [&]() {
+    if (smp)
+    {
+      vtkSMPTools::Fill(values.begin(), values.end(), 1.0);
+    }
+    else
+    {
+      std::fill(values.begin(), values.end(), 1.0);
+    }
+  });
+  for (vtkIdType i = 0; i < ARRAY_SIZE; ++i)
+  {
+    values[i] = static_cast<double>(i % 1000) / 1000.0;
+  }
+  TimeAlgorithm(prefix + "Transform", [&]() {
+    if (smp)
+    {
+      vtkSMPTools::Transform(
+        values.begin(), values.end(), result.begin(), transform);
+    }
+    else
+    {
+      std::transform(values.begin(), values.end(), result.begin(), transform);
+    }
+  });
+  TimeAlgorithm(prefix + "Reduce", [&]() {
+    sum = smp ? vtkSMPTools::Reduce(values.begin(), values.end(), 0.0)
+              : std::accumulate(values.begin(), values.end(), 0.0);
+  });
+  TimeAlgorithm(prefix + "ExclusiveScan", [&]() {
+    if (smp)
+    {
+      vtkSMPTools::ExclusiveScan(
+        counts.begin(), counts.end(), offsets.begin(), vtkIdType(0));
+    }
+    else
+    {
+      vtkIdType offset = 0;
+      for (vtkIdType i = 0; i < ARRAY_SIZE; ++i)
+      {
+        offsets[i] = offset;
+        offset += counts[i];
+      }
+    }
+  });
+  TimeAlgorithm(prefix + "Partition", [&]() {
+    result = values;
+    if (smp)
+    {
+      vtkSMPTools::Partition(result.begin(), result.end(), isSmall);
+    }
+    else
+    {
+      std::stable_partition(result.begin(), result.end(), isSmall);
+    }
+  });
+
+  // Sanity check of the last results.
+  const bool valid = std::abs(sum - ARRAY_SIZE * 0.4995) < 1.0 &&
+    offsets[ARRAY_SIZE - 1] + counts[ARRAY_SIZE - 1] ==
+      std::accumulate(counts.begin(), counts.end(), vtkIdType(0)) &&
+    isSmall(result[0]) && !isSmall(result[ARRAY_SIZE - 1]);
+  if (!valid)
+  {
+    std::cerr << "Error: Wrong results for " << prefix << std::endl;
+  }
+  if (VERBOSE_MODE & Details)
+  {
+    std::cout << prefix << "sum: " << sum << std::endl;
+  }
+  return valid;
+}
+
+//------------------------------------------------------------------------------
+int TestSMPAlgorithmsPerformance(int, char*[])
+{
+  bool res = RunAlgorithms("STL-", false);
+
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  for (const char* backend : backends)
+  {
+    if (vtkSMPTools::SetBackend(backend))
+    {
+      res &= RunAlgorithms(std::string(backend) + "-", true);
+    }
+  }
+
+  return res ? EXIT_SUCCESS : EXIT_FAILURE;
+}
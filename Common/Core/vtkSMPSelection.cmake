@@ -1,49 +1,82 @@
 set(VTK_SMP_IMPLEMENTATION_TYPE "Sequential"
-  CACHE STRING "Which multi-threaded parallelism implementation to use. Options are Sequential, OpenMP or TBB")
+  CACHE STRING "Which multi-threaded parallelism implementation to use by default. Options are Sequential, STDThread, OpenMP or TBB")
 set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
   PROPERTY
-    STRINGS Sequential OpenMP TBB)
+    STRINGS Sequential STDThread OpenMP TBB)
 
 if (NOT (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP" OR
-         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB"))
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB" OR
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread"))
   set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
     PROPERTY
       VALUE "Sequential")
 endif ()
 
+# Every enabled implementation is compiled into VTK::CommonCore and may be
+# selected at runtime with `vtkSMPTools::SetBackend`. Sequential is always
+# available.
+option(VTK_SMP_ENABLE_STDTHREAD "Enable the STDThread vtkSMPTools implementation" ON)
+option(VTK_SMP_ENABLE_OPENMP "Enable the OpenMP vtkSMPTools implementation" OFF)
+option(VTK_SMP_ENABLE_TBB "Enable the TBB vtkSMPTools implementation" OFF)
+mark_as_advanced(
+  VTK_SMP_ENABLE_STDTHREAD
+  VTK_SMP_ENABLE_OPENMP
+  VTK_SMP_ENABLE_TBB)
+
+# The default implementation is always enabled.
+if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread")
+  set(VTK_SMP_ENABLE_STDTHREAD ON)
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+  set(VTK_SMP_ENABLE_OPENMP ON)
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+  set(VTK_SMP_ENABLE_TBB ON)
+endif ()
+
 set(vtk_smp_headers_to_configure)
 set(vtk_smp_defines)
 set(vtk_smp_use_default_atomics ON)
 
-if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+list(APPEND vtk_smp_sources
+  vtkSMPTools.cxx
+  vtkSMPThreadLocalImpl.cxx
+  "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Common/vtkSMPToolsImpl.h"
+  "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential/vtkSMPToolsImpl.cxx")
+
+if (VTK_SMP_ENABLE_TBB)
   vtk_module_find_package(PACKAGE TBB)
   list(APPEND vtk_smp_libraries
     TBB::tbb)
 
-  set(vtk_smp_use_default_atomics OFF)
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB")
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkAtomic.h
-    vtkSMPToolsInternal.h
-    vtkSMPThreadLocal.h)
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB/vtkSMPToolsImpl.cxx")
+endif ()
 
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+if (VTK_SMP_ENABLE_OPENMP)
   vtk_module_find_package(PACKAGE OpenMP)
 
   list(APPEND vtk_smp_libraries
     OpenMP::OpenMP_CXX)
 
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP")
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx"
-    "${vtk_smp_implementation_dir}/vtkSMPThreadLocalImpl.cxx")
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP/vtkSMPToolsImpl.cxx")
+endif ()
+
+if (VTK_SMP_ENABLE_STDTHREAD)
+  # Only needs the C++11 thread support library, which `VTK::CommonCore`
+  # already links to through `Threads::Threads`.
+  list(APPEND vtk_smp_sources
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread/vtkSMPToolsImpl.cxx")
+endif ()
+
+# Atomics follow the default implementation.
+if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+  set(vtk_smp_use_default_atomics OFF)
+  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB")
   list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
-    vtkSMPThreadLocalImpl.h
-    vtkSMPToolsInternal.h)
+    vtkAtomic.h)
 
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP")
   if (OpenMP_CXX_SPEC_DATE AND NOT "${OpenMP_CXX_SPEC_DATE}" LESS "201107")
     set(vtk_smp_use_default_atomics OFF)
     list(APPEND vtk_smp_sources
@@ -59,14 +92,6 @@ elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
       "Required OpenMP version (3.1) for atomics not detected. Using default "
       "atomics implementation.")
   endif()
-
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "Sequential")
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential")
-  list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
-    vtkSMPToolsInternal.h)
 endif()
 
 if (vtk_smp_use_default_atomics)
@@ -110,4 +135,7 @@ endforeach()
 
 list(APPEND vtk_smp_headers
   vtkSMPTools.h
-  vtkSMPThreadLocalObject.h)
+  vtkSMPThreadLocal.h
+  vtkSMPThreadLocalImpl.h
+  vtkSMPThreadLocalObject.h
+  vtkSMPToolsInternal.h)
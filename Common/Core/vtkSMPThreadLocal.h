@@ -30,6 +30,17 @@
 // write/accumulate data to local object when executing in parallel and
 // then having a sequential code block that iterates over the whole storage
 // using the iterators to do the final accumulation.
+//
+// This implementation does not depend on the vtkSMPTools backend in use, so
+// thread local objects remain valid when the backend is switched at runtime
+// (but not while a parallel region is executing).
+//
+// .SECTION Warning
+// There is absolutely no guarantee to the order in which the local objects
+// will be stored and hence the order in which they will be traversed when
+// using iterators. If you need to store values related to each other and
+// iterate over them together, use a struct or class to group them together
+// and use a thread local of that class.
 
 #ifndef vtkSMPThreadLocal_h
 #define vtkSMPThreadLocal_h
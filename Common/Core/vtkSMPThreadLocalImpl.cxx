@@ -15,8 +15,6 @@
 
 #include "vtkSMPThreadLocalImpl.h"
 
-#include <omp.h>
-
 #include <algorithm>
 
 namespace detail
@@ -24,8 +22,9 @@ namespace detail
 
 static ThreadIdType GetThreadId()
 {
-  static int threadPrivateData;
-#pragma omp threadprivate(threadPrivateData)
+  // The address of a thread_local variable is unique among all the threads
+  // that are alive at a given time.
+  static thread_local int threadPrivateData;
   return &threadPrivateData;
 }
 
@@ -49,60 +48,9 @@ inline HashType GetHash(ThreadIdType id)
 }
 
 
-class LockGuard
-{
-public:
-  LockGuard(omp_lock_t &lock, bool wait) : Lock(lock), Status(0)
-  {
-    if (wait)
-    {
-      omp_set_lock(&this->Lock);
-      this->Status = 1;
-    }
-    else
-    {
-      this->Status = omp_test_lock(&this->Lock);
-    }
-  }
-
-  bool Success() const
-  {
-    return this->Status != 0;
-  }
-
-  void Release()
-  {
-    if (this->Status)
-    {
-      omp_unset_lock(&this->Lock);
-      this->Status = 0;
-    }
-  }
-
-  ~LockGuard()
-  {
-    this->Release();
-  }
-
-private:
-  // not copyable
-  LockGuard(const LockGuard&);
-  void operator=(const LockGuard&);
-
-  omp_lock_t &Lock;
-  int Status;
-};
-
-
 Slot::Slot()
-  : ThreadId(0), Storage(0)
-{
-  omp_init_lock(&this->ModifyLock);
-}
-
-Slot::~Slot()
+  : ThreadId(nullptr), Storage(nullptr)
 {
-  omp_destroy_lock(&this->ModifyLock);
 }
 
 
@@ -167,8 +115,8 @@ static Slot* AcquireSlot(HashTableArray *array, ThreadIdType threadId,
     if (!slotThreadId) // unused?
     {
       // empty slot means threadId does not exist, try to acquire the slot
-      LockGuard lguard(slot->ModifyLock, false); // try to get exclusive access
-      if (lguard.Success())
+      std::unique_lock<std::mutex> lguard(slot->ModifyLock, std::try_to_lock);
+      if (lguard.owns_lock())
       {
         size_t size = ++array->NumberOfEntries; // atomic
         if ((size * 2) > array->Size) // load factor is above threshold
@@ -255,7 +203,7 @@ StoragePointerType& ThreadSpecific::GetStorage()
     slot = AcquireSlot(array, threadId, hash, firstAccess);
     if (!slot) // not enough room, resize
     {
-#     pragma omp critical (HashTableResize)
+      std::lock_guard<std::mutex> lock(this->ResizeLock);
       if (this->Root == array)
       {
         HashTableArray *newArray = new HashTableArray(array->SizeLg + 1);
@@ -28,16 +28,19 @@
 // faster lookup next time. The ThreadSpecific::GetStorage() function is thread
 // safe and only blocks when a new array needs to be allocated, which should be
 // rare.
+//
+// Threads are identified by the address of a thread_local variable, so the
+// same storage works with the threads of every vtkSMPTools backend.
 
 #ifndef vtkSMPThreadLocalImpl_h
 #define vtkSMPThreadLocalImpl_h
 
 #include "vtkCommonCoreModule.h" // For export macro
-#include "vtkAtomic.h"
 #include "vtkConfigure.h"
 #include "vtkSystemIncludes.h"
 
-#include <omp.h>
+#include <atomic>
+#include <mutex>
 
 
 namespace detail
@@ -50,24 +53,24 @@ typedef void* StoragePointerType;
 
 struct Slot
 {
-  vtkAtomic<ThreadIdType> ThreadId;
-  omp_lock_t ModifyLock;
+  std::atomic<ThreadIdType> ThreadId;
+  std::mutex ModifyLock;
   StoragePointerType Storage;
 
   Slot();
-  ~Slot();
+  ~Slot() = default;
 
 private:
   // not copyable
-  Slot(const Slot&);
-  void operator=(const Slot&);
+  Slot(const Slot&) = delete;
+  void operator=(const Slot&) = delete;
 };
 
 
 struct HashTableArray
 {
   size_t Size, SizeLg;
-  vtkAtomic<size_t> NumberOfEntries;
+  std::atomic<size_t> NumberOfEntries;
   Slot *Slots;
   HashTableArray *Prev;
 
@@ -76,8 +79,8 @@ struct HashTableArray
 
 private:
   // disallow copying
-  HashTableArray(const HashTableArray&);
-  void operator=(const HashTableArray&);
+  HashTableArray(const HashTableArray&) = delete;
+  void operator=(const HashTableArray&) = delete;
 };
 
 
@@ -91,8 +94,9 @@ public:
   size_t Size() const;
 
 private:
-  vtkAtomic<HashTableArray*> Root;
-  vtkAtomic<size_t> Count;
+  std::atomic<HashTableArray*> Root;
+  std::atomic<size_t> Count;
+  std::mutex ResizeLock;
 
   friend class ThreadSpecificStorageIterator;
 };
@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+using vtk::detail::smp::vtkSMPToolsBackend;
+
+namespace
+{
+
+// Set while the current thread executes a chunk of a parallel region.
+thread_local bool vtkSMPInParallelScope = false;
+
+std::atomic<bool> vtkSMPNestedParallelism(false);
+
+std::mutex vtkSMPBackendLock;
+int vtkSMPSpecifiedNumberOfThreads = 0;
+
+//--------------------------------------------------------------------------------
+const vtkSMPToolsBackend* FindBackend(const char* name)
+{
+  if (!name)
+  {
+    return nullptr;
+  }
+
+  const std::string upperName = vtksys::SystemTools::UpperCase(name);
+  if (upperName == "SEQUENTIAL")
+  {
+    return &vtk::detail::smp::GetSequentialBackend();
+  }
+#ifdef VTK_SMP_ENABLE_STDTHREAD
+  if (upperName == "STDTHREAD")
+  {
+    return &vtk::detail::smp::GetSTDThreadBackend();
+  }
+#endif
+#ifdef VTK_SMP_ENABLE_OPENMP
+  if (upperName == "OPENMP")
+  {
+    return &vtk::detail::smp::GetOpenMPBackend();
+  }
+#endif
+#ifdef VTK_SMP_ENABLE_TBB
+  if (upperName == "TBB")
+  {
+    return &vtk::detail::smp::GetTBBBackend();
+  }
+#endif
+  return nullptr;
+}
+
+//--------------------------------------------------------------------------------
+// The backend selected at configure time, unless the VTK_SMP_BACKEND_IN_USE
+// environment variable names another available one.
+const vtkSMPToolsBackend* GetInitialBackend()
+{
+  const vtkSMPToolsBackend* backend =
+    FindBackend(std::getenv("VTK_SMP_BACKEND_IN_USE"));
+  if (!backend)
+  {
+    backend = FindBackend(VTK_SMP_BACKEND);
+  }
+  return backend ? backend : &vtk::detail::smp::GetSequentialBackend();
+}
+
+//--------------------------------------------------------------------------------
+std::atomic<const vtkSMPToolsBackend*>& GetBackendInUse()
+{
+  static std::atomic<const vtkSMPToolsBackend*> backend(GetInitialBackend());
+  return backend;
+}
+
+//--------------------------------------------------------------------------------
+// Wraps the functor of a parallel region so that the threads executing it know
+// that they are inside a parallel scope.
+struct vtkSMPScopedFunctor
+{
+  vtk::detail::smp::ExecuteFunctorPtrType FunctorExecuter;
+  void* Functor;
+};
+
+void ExecuteInParallelScope(void* scopedFunctor, vtkIdType from,
+                            vtkIdType grain, vtkIdType last)
+{
+  const vtkSMPScopedFunctor* sf =
+    static_cast<const vtkSMPScopedFunctor*>(scopedFunctor);
+  const bool wasInParallelScope = vtkSMPInParallelScope;
+  vtkSMPInParallelScope = true;
+  sf->FunctorExecuter(sf->Functor, from, grain, last);
+  vtkSMPInParallelScope = wasInParallelScope;
+}
+
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPBackendLock);
+  if (numThreads > 0)
+  {
+    vtkSMPSpecifiedNumberOfThreads = numThreads;
+    GetBackendInUse().load()->Initialize(numThreads);
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char* backend)
+{
+  const vtkSMPToolsBackend* newBackend = FindBackend(backend);
+  if (!newBackend || vtkSMPTools::IsParallelScope())
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(vtkSMPBackendLock);
+  if (vtkSMPSpecifiedNumberOfThreads > 0)
+  {
+    newBackend->Initialize(vtkSMPSpecifiedNumberOfThreads);
+  }
+  GetBackendInUse().store(newBackend);
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+const char* vtkSMPTools::GetBackend()
+{
+  return GetBackendInUse().load()->Name;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::SetNestedParallelism(bool isNested)
+{
+  vtkSMPNestedParallelism = isNested;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::GetNestedParallelism()
+{
+  return vtkSMPNestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::IsParallelScope()
+{
+  return vtkSMPInParallelScope;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  return GetBackendInUse().load()->GetEstimatedNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::BackendType vtk::detail::smp::GetBackendType()
+{
+  return GetBackendInUse().load()->Type;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_Backend(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  if (vtkSMPInParallelScope && !vtkSMPNestedParallelism)
+  {
+    // Nested region: the enclosing one already keeps the cores busy.
+    functorExecuter(functor, first, last - first, last);
+    return;
+  }
+
+  vtkSMPScopedFunctor scopedFunctor = { functorExecuter, functor };
+  GetBackendInUse().load()->For(first, last, grain,
+                                ExecuteInParallelScope, &scopedFunctor);
+}
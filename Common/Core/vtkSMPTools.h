@@ -19,8 +19,9 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
+ * delegated to. All the back-ends enabled at configure time are compiled in
+ * and the one in use can be changed at runtime with SetBackend().
 */
 
 #ifndef vtkSMPTools_h
@@ -32,6 +33,12 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::fill, std::transform
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <utility> // For std::move
+#include <vector> // For the temporary storage of the algorithms
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -129,6 +136,238 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+//--------------------------------------------------------------------------------
+// Helpers for the STL-like algorithms. The two-pass algorithms (Reduce, the
+// scans and Partition) split the range in a fixed number of contiguous
+// blocks, so that their results do not depend on the scheduling.
+inline vtkIdType vtkSMPTools_GetNumberOfBlocks(vtkIdType size)
+{
+  const vtkIdType numThreads = static_cast<vtkIdType>(GetNumberOfThreads());
+  vtkIdType numBlocks = numThreads > 1 ? numThreads * 4 : 1;
+  if (numBlocks > size)
+  {
+    numBlocks = size;
+  }
+  return numBlocks > 0 ? numBlocks : 1;
+}
+
+inline vtkIdType vtkSMPTools_GetBlockBegin(
+  vtkIdType size, vtkIdType numBlocks, vtkIdType block)
+{
+  return size * block / numBlocks;
+}
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_FillFunctor
+{
+  Iterator Begin;
+  const T& Value;
+
+  vtkSMPTools_FillFunctor(Iterator begin, const T& value)
+    : Begin(begin), Value(value)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    std::fill(this->Begin + begin, this->Begin + end, this->Value);
+  }
+};
+
+template <typename InputIt, typename OutputIt, typename Functor>
+struct vtkSMPTools_UnaryTransformFunctor
+{
+  InputIt In;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_UnaryTransformFunctor(InputIt in, OutputIt out, Functor& transform)
+    : In(in), Out(out), Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    std::transform(this->In + begin, this->In + end, this->Out + begin,
+                   this->Transform);
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename Functor>
+struct vtkSMPTools_BinaryTransformFunctor
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_BinaryTransformFunctor(InputIt1 in1, InputIt2 in2, OutputIt out,
+                                     Functor& transform)
+    : In1(in1), In2(in2), Out(out), Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    std::transform(this->In1 + begin, this->In1 + end, this->In2 + begin,
+                   this->Out + begin, this->Transform);
+  }
+};
+
+// Reduce each block to a single value (blocks are never empty).
+template <typename Iterator, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockReduceFunctor
+{
+  Iterator In;
+  vtkIdType Size;
+  vtkIdType NumberOfBlocks;
+  BinaryOp& Op;
+  std::vector<T>& Partials;
+
+  vtkSMPTools_BlockReduceFunctor(Iterator in, vtkIdType size,
+    vtkIdType numBlocks, BinaryOp& op, std::vector<T>& partials)
+    : In(in), Size(size), NumberOfBlocks(numBlocks), Op(op), Partials(partials)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock) const
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType i = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block);
+      const vtkIdType last = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block + 1);
+      T value = this->In[i];
+      for (++i; i < last; ++i)
+      {
+        value = this->Op(value, this->In[i]);
+      }
+      this->Partials[block] = value;
+    }
+  }
+};
+
+// Scan each block starting from the value carried over from the previous
+// blocks. With an inclusive scan, the first block has no carry.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockScanFunctor
+{
+  InputIt In;
+  OutputIt Out;
+  vtkIdType Size;
+  vtkIdType NumberOfBlocks;
+  BinaryOp& Op;
+  const std::vector<T>& Carries;
+  bool Inclusive;
+
+  vtkSMPTools_BlockScanFunctor(InputIt in, OutputIt out, vtkIdType size,
+    vtkIdType numBlocks, BinaryOp& op, const std::vector<T>& carries,
+    bool inclusive)
+    : In(in), Out(out), Size(size), NumberOfBlocks(numBlocks), Op(op),
+      Carries(carries), Inclusive(inclusive)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock) const
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType i = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block);
+      const vtkIdType last = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block + 1);
+      if (this->Inclusive)
+      {
+        T sum = block > 0 ? this->Carries[block] : T(this->In[i++]);
+        if (block == 0)
+        {
+          this->Out[0] = sum;
+        }
+        for (; i < last; ++i)
+        {
+          sum = this->Op(sum, this->In[i]);
+          this->Out[i] = sum;
+        }
+      }
+      else
+      {
+        T sum = this->Carries[block];
+        for (; i < last; ++i)
+        {
+          // Read before writing so that the scan may be done in place.
+          T value = this->In[i];
+          this->Out[i] = sum;
+          sum = this->Op(sum, value);
+        }
+      }
+    }
+  }
+};
+
+template <typename Iterator, typename Predicate>
+struct vtkSMPTools_PartitionFunctor
+{
+  Iterator In;
+  vtkIdType Size;
+  vtkIdType NumberOfBlocks;
+  Predicate& Pred;
+  std::vector<unsigned char>& Selected;
+  std::vector<vtkIdType>& Offsets;
+  typename std::iterator_traits<Iterator>::value_type* Buffer;
+  vtkIdType NumberOfSelected;
+  int Pass;
+
+  vtkSMPTools_PartitionFunctor(Iterator in, vtkIdType size,
+    vtkIdType numBlocks, Predicate& pred, std::vector<unsigned char>& selected,
+    std::vector<vtkIdType>& offsets)
+    : In(in), Size(size), NumberOfBlocks(numBlocks), Pred(pred),
+      Selected(selected), Offsets(offsets), Buffer(nullptr),
+      NumberOfSelected(0), Pass(0)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock) const
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType first = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block);
+      const vtkIdType last = vtkSMPTools_GetBlockBegin(
+        this->Size, this->NumberOfBlocks, block + 1);
+      if (this->Pass == 0)
+      {
+        // Evaluate the predicate once per item and count the selected ones.
+        vtkIdType count = 0;
+        for (vtkIdType i = first; i < last; ++i)
+        {
+          const bool selected = this->Pred(this->In[i]) ? true : false;
+          this->Selected[i] = selected;
+          count += selected;
+        }
+        this->Offsets[block] = count;
+      }
+      else if (this->Pass == 1)
+      {
+        // Move the items of the block to their final position in the buffer,
+        // keeping their relative order.
+        vtkIdType selected = this->Offsets[block];
+        vtkIdType rejected = this->NumberOfSelected + first - selected;
+        for (vtkIdType i = first; i < last; ++i)
+        {
+          const vtkIdType dest = this->Selected[i] ? selected++ : rejected++;
+          this->Buffer[dest] = std::move(this->In[i]);
+        }
+      }
+      else
+      {
+        std::move(this->Buffer + first, this->Buffer + last, this->In + first);
+      }
+    }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -210,13 +449,51 @@ public:
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
    * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
-   * it before any other parallel operation.
-   * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
-   * the number of threads used in the thread pool.
+   * supports it (currently STDThread, OpenMP and TBB). Make sure to call
+   * it before any other parallel operation. The STDThread backend also
+   * accepts later calls, which resize its thread pool.
    */
   static void Initialize(int numThreads=0);
 
+  /**
+   * Select the backend used by all the subsequent parallel operations:
+   * "Sequential", "STDThread", "OpenMP" or "TBB" (case insensitive). Only
+   * the backends enabled at configure time (VTK_SMP_ENABLE_STDTHREAD,
+   * VTK_SMP_ENABLE_OPENMP, VTK_SMP_ENABLE_TBB, Sequential is always
+   * available) can be selected. The initial backend is
+   * VTK_SMP_IMPLEMENTATION_TYPE, or the one named by the
+   * VTK_SMP_BACKEND_IN_USE environment variable. The number of threads
+   * given to Initialize() is forwarded to the new backend. Returns false,
+   * and keeps the current backend, if the backend is not available or if
+   * called from within a parallel region.
+   */
+  static bool SetBackend(const char* backend);
+
+  /**
+   * Get the name of the backend in use.
+   */
+  static const char* GetBackend();
+
+  //@{
+  /**
+   * Control what happens when a parallel operation is started from within
+   * another one, for example by a filter using vtkSMPTools::For() that is
+   * itself executed per block by vtkThreadedCompositeDataPipeline. When off
+   * (the default), the nested operation runs serially on the calling thread
+   * so that the cores are not oversubscribed. When on, it is handed to the
+   * backend: TBB schedules it on its worker threads, OpenMP follows its own
+   * nesting settings (OMP_MAX_ACTIVE_LEVELS) and STDThread still runs it
+   * serially since its thread pool is busy with the enclosing operation.
+   */
+  static void SetNestedParallelism(bool isNested);
+  static bool GetNestedParallelism();
+  //@}
+
+  /**
+   * Return true if the calling thread is executing a parallel operation.
+   */
+  static bool IsParallelScope();
+
   /**
    * Get the estimated number of threads being used by the backend.
    * This should be used as just an estimate since the number of threads may
@@ -249,6 +526,219 @@ public:
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
   }
 
+  /**
+   * Assign value to all the items of the range [begin, end) in parallel.
+   * It is a drop in replacement for std::fill() with random access
+   * iterators.
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_FillFunctor<Iterator, T> fill(begin, value);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end - begin), fill);
+  }
+
+  /**
+   * Apply transform to all the items of [inBegin, inEnd) and store the
+   * results starting at outBegin, in parallel. It is a drop in replacement
+   * for std::transform() with random access iterators; transform must be
+   * safe to call from several threads at once.
+   */
+  template <typename InputIt, typename OutputIt, typename Functor>
+  static void Transform(
+    InputIt inBegin, InputIt inEnd, OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransformFunctor<InputIt, OutputIt,
+      Functor> worker(inBegin, outBegin, transform);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd - inBegin), worker);
+  }
+
+  /**
+   * Binary version of Transform(): store transform(*in1, *in2) for the
+   * items of [inBegin1, inEnd) and the matching items starting at inBegin2.
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename Functor>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd, InputIt2 inBegin2,
+                        OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransformFunctor<InputIt1, InputIt2,
+      OutputIt, Functor> worker(inBegin1, inBegin2, outBegin, transform);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd - inBegin1), worker);
+  }
+
+  /**
+   * Combine init and all the items of [begin, end) with op, in parallel.
+   * op must be associative, but does not need to be commutative: the items
+   * are combined in order. The range is split in a number of blocks that
+   * only depends on the number of threads, so the result is reproducible
+   * for a given number of threads, even with floating point values. T must
+   * be default constructible.
+   */
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    const vtkIdType size = static_cast<vtkIdType>(end - begin);
+    if (size <= 0)
+    {
+      return init;
+    }
+    const vtkIdType numBlocks =
+      vtk::detail::smp::vtkSMPTools_GetNumberOfBlocks(size);
+    std::vector<T> partials(numBlocks);
+    vtk::detail::smp::vtkSMPTools_BlockReduceFunctor<Iterator, T, BinaryOp>
+      reduce(begin, size, numBlocks, op, partials);
+    vtkSMPTools::For(0, numBlocks, 1, reduce);
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+      init = op(init, partials[block]);
+    }
+    return init;
+  }
+
+  /**
+   * Sum init and all the items of [begin, end) in parallel.
+   */
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+
+  //@{
+  /**
+   * Compute the inclusive prefix "sum" of [begin, end) with op (std::plus
+   * by default) in parallel: out[i] = in[0] op in[1] op ... op in[i].
+   * op must be associative. The output may be the input range itself.
+   * Returns the end of the output range.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static OutputIt InclusiveScan(
+    InputIt begin, InputIt end, OutputIt out, BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::Scan<InputIt, OutputIt, T>(
+      begin, end, out, nullptr, op);
+  }
+  template <typename InputIt, typename OutputIt>
+  static OutputIt InclusiveScan(InputIt begin, InputIt end, OutputIt out)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::InclusiveScan(begin, end, out, std::plus<T>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Compute the exclusive prefix "sum" of [begin, end) with op (std::plus by
+   * default) in parallel: out[0] = init, and
+   * out[i] = init op in[0] op ... op in[i-1].
+   * This is the usual way of turning per-item counts into offsets. op must
+   * be associative. The output may be the input range itself. Returns the
+   * end of the output range.
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt ExclusiveScan(
+    InputIt begin, InputIt end, OutputIt out, T init, BinaryOp op)
+  {
+    return vtkSMPTools::Scan<InputIt, OutputIt, T>(
+      begin, end, out, &init, op);
+  }
+  template <typename InputIt, typename OutputIt, typename T>
+  static OutputIt ExclusiveScan(
+    InputIt begin, InputIt end, OutputIt out, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, out, init, std::plus<T>());
+  }
+  //@}
+
+  /**
+   * Reorder [begin, end) in parallel so that the items for which pred
+   * returns true come before the others. Unlike std::partition(), the
+   * relative order of the items is preserved in both groups (as with
+   * std::stable_partition()). pred is called once per item. Requires a
+   * temporary copy of the range. Returns an iterator to the first item of
+   * the second group.
+   */
+  template <typename Iterator, typename Predicate>
+  static Iterator Partition(Iterator begin, Iterator end, Predicate pred)
+  {
+    const vtkIdType size = static_cast<vtkIdType>(end - begin);
+    const vtkIdType numBlocks =
+      vtk::detail::smp::vtkSMPTools_GetNumberOfBlocks(size);
+    if (numBlocks <= 1)
+    {
+      return std::stable_partition(begin, end, pred);
+    }
+
+    std::vector<unsigned char> selected(size);
+    std::vector<vtkIdType> offsets(numBlocks);
+    vtk::detail::smp::vtkSMPTools_PartitionFunctor<Iterator, Predicate>
+      partition(begin, size, numBlocks, pred, selected, offsets);
+    vtkSMPTools::For(0, numBlocks, 1, partition);
+
+    // Number of selected items before each block.
+    partition.NumberOfSelected = 0;
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+      const vtkIdType count = offsets[block];
+      offsets[block] = partition.NumberOfSelected;
+      partition.NumberOfSelected += count;
+    }
+
+    std::vector<typename std::iterator_traits<Iterator>::value_type>
+      buffer(size);
+    partition.Buffer = buffer.data();
+    partition.Pass = 1;
+    vtkSMPTools::For(0, numBlocks, 1, partition);
+    partition.Pass = 2;
+    vtkSMPTools::For(0, numBlocks, 1, partition);
+
+    return begin + partition.NumberOfSelected;
+  }
+
+private:
+  // Common implementation of the scans; an inclusive scan has no init.
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt Scan(
+    InputIt begin, InputIt end, OutputIt out, const T* init, BinaryOp& op)
+  {
+    const vtkIdType size = static_cast<vtkIdType>(end - begin);
+    if (size <= 0)
+    {
+      return out;
+    }
+
+    const bool inclusive = (init == nullptr);
+    const vtkIdType numBlocks =
+      vtk::detail::smp::vtkSMPTools_GetNumberOfBlocks(size);
+
+    // First pass: reduce each block, except the last one whose total is not
+    // needed.
+    std::vector<T> carries(numBlocks);
+    if (numBlocks > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_BlockReduceFunctor<InputIt, T, BinaryOp>
+        reduce(begin, size, numBlocks, op, carries);
+      vtkSMPTools::For(0, numBlocks - 1, 1, reduce);
+    }
+
+    // Turn the block totals into the values carried into each block.
+    T carry = inclusive ? T() : *init;
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+      T total = carries[block];
+      carries[block] = carry;
+      carry = (inclusive && block == 0) ? total : op(carry, total);
+    }
+
+    // Second pass: scan each block.
+    vtk::detail::smp::vtkSMPTools_BlockScanFunctor<InputIt, OutputIt, T,
+      BinaryOp> scan(begin, out, size, numBlocks, op, carries, inclusive);
+    vtkSMPTools::For(0, numBlocks, 1, scan);
+
+    return out + size;
+  }
 };
 
 #endif
@@ -17,10 +17,26 @@
 #define vtkSMPToolsInternal_h
 
 #include "vtkCommonCoreModule.h" // For export macro
+#include "vtkConfigure.h" // For VTK_SMP_ENABLE_TBB
+#include "vtkType.h" // For vtkIdType
 
 #include <algorithm> //for std::sort()
 
 #ifndef __VTK_WRAP__
+
+#ifdef VTK_SMP_ENABLE_TBB
+#ifdef _MSC_VER
+#  pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#  define __TBB_NO_IMPLICIT_LINKAGE 1
+#endif
+
+#include <tbb/parallel_sort.h>
+
+#ifdef _MSC_VER
+#  pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#endif
+#endif
+
 namespace vtk
 {
 namespace detail
@@ -28,10 +44,19 @@ namespace detail
 namespace smp
 {
 
+enum class BackendType
+{
+  Sequential = 0,
+  STDThread = 1,
+  OpenMP = 2,
+  TBB = 3
+};
+
 typedef void (*ExecuteFunctorPtrType)(void *, vtkIdType, vtkIdType, vtkIdType);
 
 int VTKCOMMONCORE_EXPORT GetNumberOfThreads();
-void VTKCOMMONCORE_EXPORT vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
+BackendType VTKCOMMONCORE_EXPORT GetBackendType();
+void VTKCOMMONCORE_EXPORT vtkSMPTools_Impl_For_Backend(vtkIdType first,
   vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
   void *functor);
 
@@ -66,8 +91,8 @@ void vtkSMPTools_Impl_For(vtkIdType first, vtkIdType last,
   }
   else
   {
-    vtkSMPTools_Impl_For_OpenMP(first, last, grain,
-                                ExecuteFunctor<FunctorInternal>, &fi);
+    vtkSMPTools_Impl_For_Backend(first, last, grain,
+                                 ExecuteFunctor<FunctorInternal>, &fi);
   }
 }
 
@@ -76,6 +101,13 @@ template<typename RandomAccessIterator>
 void vtkSMPTools_Impl_Sort(RandomAccessIterator begin,
                                   RandomAccessIterator end)
 {
+#ifdef VTK_SMP_ENABLE_TBB
+  if (GetBackendType() == BackendType::TBB)
+  {
+    tbb::parallel_sort(begin, end);
+    return;
+  }
+#endif
   std::sort(begin, end);
 }
 
@@ -85,6 +117,13 @@ void vtkSMPTools_Impl_Sort(RandomAccessIterator begin,
                                   RandomAccessIterator end,
                                   Compare comp)
 {
+#ifdef VTK_SMP_ENABLE_TBB
+  if (GetBackendType() == BackendType::TBB)
+  {
+    tbb::parallel_sort(begin, end, comp);
+    return;
+  }
+#endif
   std::sort(begin, end, comp);
 }
 
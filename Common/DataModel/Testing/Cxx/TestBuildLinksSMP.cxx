@@ -0,0 +1,220 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBuildLinksSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the static links built by vtkPolyData::BuildLinks() and
+// vtkUnstructuredGrid::BuildLinks() with several threads match vtkCellLinks,
+// and that editing the links converts them to editable links.
+
+#include <vtkCellArray.h>
+#include <vtkCellLinks.h>
+#include <vtkCellType.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkStaticCellLinks.h>
+#include <vtkUnstructuredGrid.h>
+
+namespace
+{
+const int Dim = 40;
+
+// A grid of triangles, with a few vertices, lines and strips.
+void ConstructPolyData(vtkPolyData *pd)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < Dim; ++j)
+  {
+    for (int i = 0; i < Dim; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.0);
+    }
+  }
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int j = 0; j < Dim - 1; ++j)
+  {
+    for (int i = 0; i < Dim - 1; ++i)
+    {
+      vtkIdType p = j * Dim + i;
+      vtkIdType tri0[3] = { p, p + 1, p + Dim + 1 };
+      vtkIdType tri1[3] = { p, p + Dim + 1, p + Dim };
+      polys->InsertNextCell(3, tri0);
+      polys->InsertNextCell(3, tri1);
+    }
+    vtkIdType p = j * Dim;
+    verts->InsertNextCell(1, &p);
+    vtkIdType line[2] = { p, p + Dim };
+    lines->InsertNextCell(2, line);
+    vtkIdType strip[4] = { p, p + Dim, p + 1, p + Dim + 1 };
+    strips->InsertNextCell(4, strip);
+  }
+  pd->SetPoints(points);
+  pd->SetVerts(verts);
+  pd->SetLines(lines);
+  pd->SetPolys(polys);
+  pd->SetStrips(strips);
+}
+
+// A grid of hexahedra.
+void ConstructGrid(vtkUnstructuredGrid *ug)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < Dim / 2; ++k)
+  {
+    for (int j = 0; j < Dim / 2; ++j)
+    {
+      for (int i = 0; i < Dim / 2; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  ug->SetPoints(points);
+  const vtkIdType d = Dim / 2;
+  ug->Allocate((d - 1) * (d - 1) * (d - 1));
+  for (vtkIdType k = 0; k < d - 1; ++k)
+  {
+    for (vtkIdType j = 0; j < d - 1; ++j)
+    {
+      for (vtkIdType i = 0; i < d - 1; ++i)
+      {
+        vtkIdType p = (k * d + j) * d + i;
+        vtkIdType hex[8] = { p, p + 1, p + d + 1, p + d,
+          p + d * d, p + d * d + 1, p + d * d + d + 1, p + d * d + d };
+        ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+}
+
+// Compare the cells using each point with vtkCellLinks.
+bool CheckLinks(vtkDataSet *ds, const char *what)
+{
+  vtkNew<vtkCellLinks> reference;
+  reference->Allocate(ds->GetNumberOfPoints());
+  reference->BuildLinks(ds);
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    ds->GetPointCells(ptId, cellIds);
+    vtkIdType ncells = reference->GetNcells(ptId);
+    const vtkIdType *cells = reference->GetCells(ptId);
+    bool same = cellIds->GetNumberOfIds() == ncells;
+    for (vtkIdType i = 0; same && i < ncells; ++i)
+    {
+      same = cellIds->GetId(i) == cells[i];
+    }
+    if (!same)
+    {
+      std::cerr << "Error: wrong cells for point " << ptId << " of "
+                << ds->GetClassName() << " with " << what << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestBuildLinksSMP(int, char *[])
+{
+  auto testBackend = [&](const char *backend)
+  {
+    vtkNew<vtkPolyData> pd;
+    ConstructPolyData(pd);
+    pd->BuildCells();
+    pd->DeleteCell(5);
+    pd->BuildLinks();
+    if (!CheckLinks(pd, backend))
+    {
+      return false;
+    }
+
+    vtkNew<vtkUnstructuredGrid> ug;
+    ConstructGrid(ug);
+    ug->BuildLinks();
+    if (!CheckLinks(ug, backend))
+    {
+      return false;
+    }
+
+    // Split cell storage is read serially.
+    ug->GetCells()->SetStorageModeTo32Bit();
+    ug->BuildLinks();
+    if (!CheckLinks(ug, "split storage"))
+    {
+      return false;
+    }
+    return true;
+  };
+  if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Editing the links converts them to editable links.
+  vtkNew<vtkPolyData> pd;
+  ConstructPolyData(pd);
+  pd->BuildLinks();
+  vtkIdType ncells, nedited;
+  vtkIdType *cells;
+  pd->GetPointCells(0, ncells, cells);
+  vtkIdType tri[3] = { 0, 1, Dim };
+  vtkIdType cellId = pd->InsertNextLinkedCell(VTK_TRIANGLE, 3, tri);
+  unsigned short nshort;
+  pd->GetPointCells(0, nshort, cells);
+  pd->GetPointCells(0, nedited, cells);
+  if (nedited != ncells + 1 || nshort != nedited ||
+      cells[nedited - 1] != cellId || !CheckLinks(pd, "editable links"))
+  {
+    std::cerr << "Error: wrong links after InsertNextLinkedCell()"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // GetLinks() returns the static links as they are, GetCellLinks()
+  // converts them into editable links.
+  vtkNew<vtkUnstructuredGrid> ug;
+  ConstructGrid(ug);
+  ug->BuildLinks();
+  if (!vtkStaticCellLinks::SafeDownCast(ug->GetLinks()))
+  {
+    std::cerr << "Error: no static links from GetLinks()" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkCellLinks *links = ug->GetCellLinks();
+  if (!links || links != ug->GetLinks() || !CheckLinks(ug, "converted links"))
+  {
+    std::cerr << "Error: wrong links from GetCellLinks()" << std::endl;
+    return EXIT_FAILURE;
+  }
+  ug->RemoveReferenceToCell(0, 0);
+  if (links != ug->GetCellLinks() || links->GetNcells(0) != 0)
+  {
+    std::cerr << "Error: wrong links after RemoveReferenceToCell()"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  ug->BuildLinks(1);
+  if (!ug->GetCellLinks() || !CheckLinks(ug, "editable links"))
+  {
+    std::cerr << "Error: wrong links from BuildLinks(1)" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,338 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArraySplitStorage.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the split storage of vtkCellArray gives the same cells and
+// locations as the legacy storage, that external offsets and connectivity
+// arrays are used without copy, and that the 32-bit storage switches to the
+// 64-bit storage for values that do not fit.
+
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+
+#include <cstring>
+
+namespace
+{
+// Cells of 0 to 6 points, inserted with all the insertion methods.
+void InsertCells(vtkCellArray *cells)
+{
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < 100; ++cellId)
+  {
+    const vtkIdType npts = cellId % 7;
+    vtkIdType pts[6];
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      pts[i] = 3 * cellId + i;
+    }
+    switch (cellId % 3)
+    {
+      case 0:
+        cells->InsertNextCell(npts, pts);
+        break;
+      case 1:
+        ids->SetNumberOfIds(npts);
+        std::copy(pts, pts + npts, ids->GetPointer(0));
+        cells->InsertNextCell(ids);
+        break;
+      default:
+        // Start with a wrong count, and update it afterwards.
+        cells->InsertNextCell(static_cast<int>(npts + 1));
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          cells->InsertCellPoint(pts[i]);
+        }
+        cells->UpdateCellCount(static_cast<int>(npts));
+    }
+  }
+}
+
+bool SamePoints(vtkIdType npts1, const vtkIdType *pts1,
+                vtkIdType npts2, const vtkIdType *pts2)
+{
+  return npts1 == npts2 &&
+    (npts1 == 0 || std::memcmp(pts1, pts2, npts1 * sizeof(vtkIdType)) == 0);
+}
+
+bool SameCells(vtkCellArray *legacy, vtkCellArray *split)
+{
+  if (legacy->GetNumberOfCells() != split->GetNumberOfCells() ||
+      legacy->GetNumberOfConnectivityEntries() !=
+        split->GetNumberOfConnectivityEntries() ||
+      legacy->GetMaxCellSize() != split->GetMaxCellSize())
+  {
+    std::cerr << "Error: different sizes" << std::endl;
+    return false;
+  }
+
+  // Traversal and access by location.
+  vtkIdType npts1, *pts1, npts2, *pts2;
+  vtkIdType cellId = 0;
+  legacy->InitTraversal();
+  split->InitTraversal();
+  while (legacy->GetNextCell(npts1, pts1))
+  {
+    if (!split->GetNextCell(npts2, pts2) ||
+        !SamePoints(npts1, pts1, npts2, pts2) ||
+        legacy->GetTraversalLocation() != split->GetTraversalLocation())
+    {
+      std::cerr << "Error: different cell " << cellId << " in traversal"
+                << std::endl;
+      return false;
+    }
+
+    const vtkIdType loc = legacy->GetTraversalLocation(npts1);
+    split->GetCell(loc, npts2, pts2);
+    if (!SamePoints(npts1, pts1, npts2, pts2) ||
+        split->GetCellSize(cellId) != npts1)
+    {
+      std::cerr << "Error: different cell " << cellId << " at location "
+                << loc << std::endl;
+      return false;
+    }
+
+    split->GetCellAtId(cellId, npts2, pts2);
+    if (!SamePoints(npts1, pts1, npts2, pts2))
+    {
+      std::cerr << "Error: different cell " << cellId << std::endl;
+      return false;
+    }
+    ++cellId;
+  }
+  return !split->GetNextCell(npts2, pts2);
+}
+
+int TestStorageMode(int mode)
+{
+  vtkNew<vtkCellArray> legacy;
+  InsertCells(legacy);
+
+  // Insertion in split storage.
+  vtkNew<vtkCellArray> split;
+  split->SetStorageMode(mode);
+  InsertCells(split);
+  if (split->GetStorageMode() != mode ||
+      legacy->GetInsertLocation(0) != split->GetInsertLocation(0) ||
+      !SameCells(legacy, split))
+  {
+    std::cerr << "Error: insertion in storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+  const vtkIdType ncells = split->GetNumberOfCells();
+  if (split->GetOffsetsArray()->GetNumberOfTuples() != ncells + 1 ||
+      split->GetConnectivityArray()->GetNumberOfTuples() !=
+        legacy->GetNumberOfConnectivityEntries() - ncells)
+  {
+    std::cerr << "Error: wrong split arrays in storage mode " << mode
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Modification by location.
+  legacy->InitTraversal();
+  split->InitTraversal();
+  vtkIdType npts, *pts;
+  for (int i = 0; i < 40; ++i)
+  {
+    legacy->GetNextCell(npts, pts);
+  }
+  split->SetTraversalLocation(legacy->GetTraversalLocation());
+  const vtkIdType loc = legacy->GetTraversalLocation();
+  legacy->ReverseCell(loc);
+  split->ReverseCell(loc);
+  const vtkIdType newPts[6] = { 7, 6, 5, 4, 3, 2 };
+  legacy->GetNextCell(npts, pts);
+  split->ReplaceCell(loc, static_cast<int>(npts), newPts);
+  legacy->ReplaceCell(loc, static_cast<int>(npts), newPts);
+  if (!SameCells(legacy, split))
+  {
+    std::cerr << "Error: modification in storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Conversions, deep copies and reset.
+  vtkNew<vtkCellArray> converted;
+  converted->DeepCopy(legacy);
+  converted->SetStorageMode(mode);
+  vtkNew<vtkCellArray> copy;
+  copy->DeepCopy(split);
+  if (!SameCells(legacy, converted) || !SameCells(legacy, copy) ||
+      copy->GetStorageMode() != mode)
+  {
+    std::cerr << "Error: conversion to storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+  converted->SetStorageMode(mode == vtkCellArray::SPLIT_STORAGE_32BIT ?
+                            vtkCellArray::SPLIT_STORAGE_64BIT :
+                            vtkCellArray::SPLIT_STORAGE_32BIT);
+  if (!SameCells(legacy, converted))
+  {
+    std::cerr << "Error: conversion from storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+  // The legacy form is a copy: the split storage is kept.
+  const vtkIdType size = legacy->GetNumberOfConnectivityEntries();
+  if (split->GetData()->GetNumberOfValues() != size ||
+      split->GetStorageMode() != mode ||
+      std::memcmp(split->GetPointer(), legacy->GetPointer(),
+                  size * sizeof(vtkIdType)) != 0 ||
+      split->GetLegacyCell(loc)[0] != npts ||
+      std::memcmp(split->GetLegacyCell(loc), legacy->GetPointer() + loc,
+                  (npts + 1) * sizeof(vtkIdType)) != 0)
+  {
+    std::cerr << "Error: legacy form of storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+  const bool shareable = mode == vtkCellArray::SPLIT_STORAGE_32BIT ?
+    sizeof(vtkIdType) == 4 : sizeof(vtkIdType) == 8;
+  if (split->IsStorageShareable() != shareable ||
+      !legacy->IsStorageShareable())
+  {
+    std::cerr << "Error: wrong sharing of storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  copy->Reset();
+  if (copy->GetNumberOfCells() != 0 ||
+      copy->GetNumberOfConnectivityEntries() != 0 ||
+      copy->GetStorageMode() != mode)
+  {
+    std::cerr << "Error: reset in storage mode " << mode << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Adopt external arrays, and check that insertions go into them.
+template <typename ArrayT>
+int TestSetData(int mode)
+{
+  vtkNew<ArrayT> offsets;
+  vtkNew<ArrayT> connectivity;
+  const typename ArrayT::ValueType offsetValues[] = { 0, 3, 7, 7, 9 };
+  const typename ArrayT::ValueType pointIds[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+  for (auto offset : offsetValues)
+  {
+    offsets->InsertNextValue(offset);
+  }
+  for (auto ptId : pointIds)
+  {
+    connectivity->InsertNextValue(ptId);
+  }
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+  const vtkIdType pts[2] = { 10, 11 };
+  cells->InsertNextCell(2, pts);
+  vtkNew<vtkIdList> ids;
+  cells->GetCellAtId(1, ids);
+  if (cells->GetStorageMode() != mode || cells->GetNumberOfCells() != 5 ||
+      cells->GetOffsetsArray() != offsets.GetPointer() ||
+      cells->GetConnectivityArray() != connectivity.GetPointer() ||
+      offsets->GetValue(5) != 11 || connectivity->GetValue(10) != 11 ||
+      cells->GetCellSize(2) != 0 || ids->GetNumberOfIds() != 4 ||
+      ids->GetId(0) != 3 || ids->GetId(3) != 6)
+  {
+    std::cerr << "Error: adoption of arrays in storage mode " << mode
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // An empty offsets array stands for no cells, and is left empty.
+  vtkNew<ArrayT> emptyOffsets;
+  vtkNew<ArrayT> emptyConnectivity;
+  cells->SetData(emptyOffsets, emptyConnectivity);
+  cells->InsertNextCell(2, pts);
+  if (cells->GetNumberOfCells() != 1 || cells->GetCellSize(0) != 2 ||
+      cells->GetOffsetsArray() == emptyOffsets.GetPointer() ||
+      emptyOffsets->GetNumberOfValues() != 0 ||
+      emptyConnectivity->GetNumberOfValues() != 2)
+  {
+    std::cerr << "Error: adoption of empty arrays in storage mode " << mode
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Point ids that do not fit in 32 bits switch to the 64-bit storage.
+int TestPromotion()
+{
+  if (sizeof(vtkIdType) == 4)
+  {
+    return EXIT_SUCCESS;
+  }
+
+  const vtkIdType large = static_cast<vtkIdType>(1) << 32;
+  const vtkIdType pts[3] = { 1, 2, 3 };
+  const vtkIdType largePts[3] = { 1, large, 3 };
+  vtkNew<vtkIdList> ids;
+  vtkNew<vtkCellArray> cells;
+  cells->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+  cells->InsertNextCell(3, pts);
+  cells->InsertNextCell(3, largePts);
+  cells->GetCellAtId(1, ids);
+  if (cells->GetStorageMode() != vtkCellArray::SPLIT_STORAGE_64BIT ||
+      ids->GetId(1) != large)
+  {
+    std::cerr << "Error: no promotion on insertion" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  cells->Initialize();
+  cells->InsertNextCell(3, pts);
+  cells->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+  cells->ReplaceCell(0, 3, largePts);
+  cells->GetCellAtId(0, ids);
+  if (cells->GetStorageMode() != vtkCellArray::SPLIT_STORAGE_64BIT ||
+      ids->GetId(1) != large)
+  {
+    std::cerr << "Error: no promotion on replacement" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  cells->Initialize();
+  cells->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+  cells->InsertNextCell(2);
+  cells->InsertCellPoint(1);
+  cells->InsertCellPoint(large);
+  cells->GetCellAtId(0, ids);
+  if (cells->GetStorageMode() != vtkCellArray::SPLIT_STORAGE_64BIT ||
+      ids->GetNumberOfIds() != 2 || ids->GetId(1) != large)
+  {
+    std::cerr << "Error: no promotion on point insertion" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestCellArraySplitStorage(int, char *[])
+{
+  if (TestStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT) != EXIT_SUCCESS ||
+      TestStorageMode(vtkCellArray::SPLIT_STORAGE_64BIT) != EXIT_SUCCESS ||
+      TestSetData<vtkTypeInt32Array>(vtkCellArray::SPLIT_STORAGE_32BIT) !=
+        EXIT_SUCCESS ||
+      TestSetData<vtkTypeInt64Array>(vtkCellArray::SPLIT_STORAGE_64BIT) !=
+        EXIT_SUCCESS ||
+      TestPromotion() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,360 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArraySplitStorageSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that polygonal data and unstructured grids keep the split storage of
+// their cells, and that their cells are read correctly by several threads at
+// once whatever the storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellType.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vector>
+
+namespace
+{
+const int Dim = 12;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return (k * (Dim + 1) + j) * (Dim + 1) + i;
+}
+
+void InsertPoints(vtkPointSet *dataSet)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= Dim; ++k)
+  {
+    for (int j = 0; j <= Dim; ++j)
+    {
+      for (int i = 0; i <= Dim; ++i)
+      {
+        points->InsertNextPoint(i, 1.5 * j, 2.0 * k);
+      }
+    }
+  }
+  dataSet->SetPoints(points);
+}
+
+// Cells of all the polygonal types, of 1 to 6 points.
+void ConstructPolyData(vtkPolyData *pd)
+{
+  InsertPoints(pd);
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim; ++j)
+    {
+      vtkIdType pts[6];
+      for (int i = 0; i < 6; ++i)
+      {
+        pts[i] = PointId(i, j, k);
+      }
+      const vtkIdType npts = (j + k) % 6 + 1;
+      verts->InsertNextCell(npts, pts);
+      lines->InsertNextCell(npts < 2 ? 2 : npts, pts);
+      vtkIdType quad[4] = { PointId(0, j, k), PointId(1, j, k),
+        PointId(1, j + 1, k), PointId(0, j + 1, k) };
+      polys->InsertNextCell(npts < 3 ? 3 : npts == 5 ? 4 : npts,
+                            npts == 5 ? quad : pts);
+      vtkIdType strip[4] = { PointId(0, j, k), PointId(0, j + 1, k),
+        PointId(1, j, k), PointId(1, j + 1, k) };
+      strips->InsertNextCell(4, strip);
+    }
+  }
+  pd->SetVerts(verts);
+  pd->SetLines(lines);
+  pd->SetPolys(polys);
+  pd->SetStrips(strips);
+}
+
+// Hexahedra, tetrahedra and wedges.
+void ConstructGrid(vtkUnstructuredGrid *ug)
+{
+  InsertPoints(ug);
+  ug->Allocate(Dim * Dim * Dim);
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim; ++j)
+    {
+      for (int i = 0; i < Dim; ++i)
+      {
+        vtkIdType pts[8] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + j + k) % 3)
+        {
+          case 0:
+            ug->InsertNextCell(VTK_HEXAHEDRON, 8, pts);
+            break;
+          case 1:
+          {
+            vtkIdType tetra[4] = { pts[0], pts[1], pts[3], pts[4] };
+            ug->InsertNextCell(VTK_TETRA, 4, tetra);
+            break;
+          }
+          default:
+          {
+            vtkIdType wedge[6] = { pts[0], pts[1], pts[3],
+              pts[4], pts[5], pts[7] };
+            ug->InsertNextCell(VTK_WEDGE, 6, wedge);
+          }
+        }
+      }
+    }
+  }
+}
+
+bool SameIds(const std::vector<vtkIdType> &expected, vtkIdType npts,
+             const vtkIdType *pts)
+{
+  if (static_cast<vtkIdType>(expected.size()) != npts)
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    if (expected[i] != pts[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Read each cell with all the random access methods, and compare it with
+// the point ids and bounds read from the legacy storage.
+template <typename DataSetT>
+struct ReadCells
+{
+  DataSetT *DataSet;
+  const std::vector<std::vector<vtkIdType> > &PointIds;
+  const std::vector<double> &Bounds;
+  std::vector<char> &Failures;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+
+  ReadCells(DataSetT *dataSet,
+            const std::vector<std::vector<vtkIdType> > &pointIds,
+            const std::vector<double> &bounds, std::vector<char> &failures)
+    : DataSet(dataSet), PointIds(pointIds), Bounds(bounds),
+      Failures(failures)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkIdList *ids = this->Ids.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const std::vector<vtkIdType> &expected = this->PointIds[cellId];
+      vtkIdType npts, *pts;
+      this->DataSet->GetCellPoints(cellId, npts, pts);
+      bool same = SameIds(expected, npts, pts);
+      this->DataSet->GetCellPoints(cellId, ids);
+      same = same &&
+        SameIds(expected, ids->GetNumberOfIds(), ids->GetPointer(0));
+      this->DataSet->GetCell(cellId, cell);
+      same = same && SameIds(expected, cell->GetNumberOfPoints(),
+                             cell->GetPointIds()->GetPointer(0));
+      for (vtkIdType i = 0; same && i < cell->GetNumberOfPoints(); ++i)
+      {
+        double x[3], y[3];
+        this->DataSet->GetPoint(expected[i], x);
+        cell->GetPoints()->GetPoint(i, y);
+        same = x[0] == y[0] && x[1] == y[1] && x[2] == y[2];
+      }
+      double bounds[6];
+      this->DataSet->GetCellBounds(cellId, bounds);
+      for (int i = 0; i < 6; ++i)
+      {
+        same = same && bounds[i] == this->Bounds[6 * cellId + i];
+      }
+      this->Failures[cellId] = !same;
+    }
+  }
+};
+
+template <typename DataSetT>
+bool CheckCells(DataSetT *legacy, DataSetT *split, const char *what)
+{
+  const vtkIdType numCells = legacy->GetNumberOfCells();
+  std::vector<std::vector<vtkIdType> > pointIds(numCells);
+  std::vector<double> bounds(6 * numCells);
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    legacy->GetCellPoints(cellId, ids);
+    pointIds[cellId].assign(ids->GetPointer(0),
+                            ids->GetPointer(0) + ids->GetNumberOfIds());
+    legacy->GetCellBounds(cellId, &bounds[6 * cellId]);
+  }
+
+  // Read the cells several times over, so that threads work on the same
+  // cells at once.
+  std::vector<char> failures(numCells, 0);
+  ReadCells<DataSetT> reader(split, pointIds, bounds, failures);
+  for (int pass = 0; pass < 4; ++pass)
+  {
+    vtkSMPTools::For(0, numCells, 7, reader);
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      if (failures[cellId] || split->GetCellType(cellId) !=
+          legacy->GetCellType(cellId))
+      {
+        std::cerr << "Error: wrong cell " << cellId << " with " << what
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool HasStorage(vtkCellArray *cells, int mode, const char *what)
+{
+  if (cells->GetStorageMode() != mode)
+  {
+    std::cerr << "Error: the storage of the cells changed with " << what
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int TestPolyData(int mode, const char *backend)
+{
+  vtkNew<vtkPolyData> legacy;
+  ConstructPolyData(legacy);
+
+  vtkNew<vtkPolyData> split;
+  split->SetPoints(legacy->GetPoints());
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  vtkCellArray *cellArrays[4] = { verts, lines, polys, strips };
+  vtkCellArray *legacyArrays[4] = { legacy->GetVerts(), legacy->GetLines(),
+    legacy->GetPolys(), legacy->GetStrips() };
+  for (int i = 0; i < 4; ++i)
+  {
+    cellArrays[i]->DeepCopy(legacyArrays[i]);
+    cellArrays[i]->SetStorageMode(mode);
+  }
+  split->SetVerts(verts);
+  split->SetLines(lines);
+  split->SetPolys(polys);
+  split->SetStrips(strips);
+  split->BuildCells();
+  for (vtkCellArray *cells : cellArrays)
+  {
+    if (!HasStorage(cells, mode, "vtkPolyData::BuildCells()"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!CheckCells<vtkPolyData>(legacy, split, backend))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The legacy form of a cell, and point replacement.
+  const vtkIdType cellId = legacy->GetNumberOfCells() / 2 + 3;
+  vtkIdType *cell1, *cell2;
+  legacy->GetCell(cellId, cell1);
+  split->GetCell(cellId, cell2);
+  if (!SameIds(std::vector<vtkIdType>(cell1, cell1 + cell1[0] + 1),
+               cell2[0] + 1, cell2))
+  {
+    std::cerr << "Error: wrong legacy form of cell " << cellId << std::endl;
+    return EXIT_FAILURE;
+  }
+  const vtkIdType ptId = cell1[2];
+  legacy->ReplaceCellPoint(cellId, ptId, 0);
+  split->ReplaceCellPoint(cellId, ptId, 0);
+  for (vtkCellArray *cells : cellArrays)
+  {
+    if (!HasStorage(cells, mode, "vtkPolyData::GetCell()"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return CheckCells<vtkPolyData>(legacy, split, "replaced points") ?
+    EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int TestUnstructuredGrid(int mode, const char *backend)
+{
+  vtkNew<vtkUnstructuredGrid> legacy;
+  ConstructGrid(legacy);
+  vtkNew<vtkUnstructuredGrid> split;
+  ConstructGrid(split);
+  split->GetCells()->SetStorageMode(mode);
+  if (!CheckCells<vtkUnstructuredGrid>(legacy, split, backend) ||
+      !HasStorage(split->GetCells(), mode, "vtkUnstructuredGrid::GetCell()"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Cells inserted into the split storage.
+  vtkIdType tetra[4] = { 0, 1, Dim + 1, (Dim + 1) * (Dim + 1) };
+  legacy->InsertNextCell(VTK_TETRA, 4, tetra);
+  split->InsertNextCell(VTK_TETRA, 4, tetra);
+  if (!CheckCells<vtkUnstructuredGrid>(legacy, split, "a new cell") ||
+      !HasStorage(split->GetCells(), mode,
+                  "vtkUnstructuredGrid::InsertNextCell()"))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestCellArraySplitStorageSMP(int, char *[])
+{
+  const int modes[] = { vtkCellArray::LEGACY_STORAGE,
+    vtkCellArray::SPLIT_STORAGE_32BIT, vtkCellArray::SPLIT_STORAGE_64BIT };
+  auto testBackend = [&](const char *backend)
+  {
+    for (int mode : modes)
+    {
+      if (TestPolyData(mode, backend) != EXIT_SUCCESS ||
+          TestUnstructuredGrid(mode, backend) != EXIT_SUCCESS)
+      {
+        std::cerr << "Error: storage mode " << mode << std::endl;
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestKdTreeSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded build of vtkKdTree gives the same regions
+// as a serial build, and that the batched queries give the same ids as the
+// queries of one position at a time.
+
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkKdTree.h>
+#include <vtkKdTreePointLocator.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// A cloud of points on a twisted helix with a cluster of duplicates, so
+// that the median finds have repeated coordinates.
+vtkSmartPointer<vtkPoints> ConstructPoints(int dataType)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(dataType);
+  for (int i = 0; i < 8000; ++i)
+  {
+    const double t = 0.025 * i;
+    points->InsertNextPoint(std::cos(t) + 0.1 * std::sin(37.0 * i),
+                            std::sin(t) + 0.1 * std::cos(53.0 * i),
+                            0.05 * t + 0.1 * std::sin(71.0 * i));
+  }
+  for (int i = 0; i < 200; ++i)
+  {
+    points->InsertNextPoint(0.5, 0.25, 0.125 * (i % 4));
+  }
+  return points;
+}
+
+// The regions of the tree with the original ids of their points.
+std::vector<double> Regions(vtkKdTree *tree)
+{
+  std::vector<double> regions;
+  for (int regionId = 0; regionId < tree->GetNumberOfRegions(); ++regionId)
+  {
+    double bounds[6];
+    tree->GetRegionBounds(regionId, bounds);
+    regions.insert(regions.end(), bounds, bounds + 6);
+    tree->GetRegionDataBounds(regionId, bounds);
+    regions.insert(regions.end(), bounds, bounds + 6);
+    vtkIdTypeArray *ids = tree->GetPointsInRegion(regionId);
+    regions.push_back(static_cast<double>(ids->GetNumberOfTuples()));
+    for (vtkIdType i = 0; i < ids->GetNumberOfTuples(); ++i)
+    {
+      regions.push_back(static_cast<double>(ids->GetValue(i)));
+    }
+    ids->Delete();
+  }
+  return regions;
+}
+
+vtkSmartPointer<vtkKdTree> BuildTree(vtkPoints *points, int options)
+{
+  vtkSmartPointer<vtkKdTree> tree = vtkSmartPointer<vtkKdTree>::New();
+  tree->SetMaxLevel(options & 1 ? 20 : 6);
+  tree->SetMinCells(options & 2 ? 1 : 64);
+  if (options & 4)
+  {
+    tree->OmitZPartitioning();
+  }
+  vtkPoints *ptArrays[1] = { points };
+  tree->BuildLocatorFromPoints(ptArrays, 1);
+  return tree;
+}
+
+std::vector<vtkIdType> Ids(vtkIdList *ids)
+{
+  return std::vector<vtkIdType>(ids->GetPointer(0),
+                                ids->GetPointer(0) + ids->GetNumberOfIds());
+}
+
+// The results of the batched queries, or of the queries of one position
+// at a time.
+std::vector<vtkIdType> Query(vtkKdTree *tree, vtkPoints *positions,
+                             bool batched)
+{
+  const int N = 7;
+  const double R = 0.08;
+  std::vector<vtkIdType> results;
+  vtkNew<vtkIdList> ids;
+  vtkNew<vtkIdList> offsets;
+  if (batched)
+  {
+    tree->FindClosestNPoints(N, positions, ids);
+    results = Ids(ids);
+    tree->FindPointsWithinRadius(R, positions, ids, offsets);
+    std::vector<vtkIdType> found = Ids(ids);
+    results.insert(results.end(), found.begin(), found.end());
+    found = Ids(offsets);
+    results.insert(results.end(), found.begin(), found.end());
+    return results;
+  }
+
+  for (vtkIdType i = 0; i < positions->GetNumberOfPoints(); ++i)
+  {
+    tree->FindClosestNPoints(N, positions->GetPoint(i), ids);
+    std::vector<vtkIdType> found = Ids(ids);
+    results.insert(results.end(), found.begin(), found.end());
+  }
+  std::vector<vtkIdType> offsetIds(1, 0);
+  for (vtkIdType i = 0; i < positions->GetNumberOfPoints(); ++i)
+  {
+    tree->FindPointsWithinRadius(R, positions->GetPoint(i), ids);
+    std::vector<vtkIdType> found = Ids(ids);
+    results.insert(results.end(), found.begin(), found.end());
+    offsetIds.push_back(offsetIds.back() + ids->GetNumberOfIds());
+  }
+  results.insert(results.end(), offsetIds.begin(), offsetIds.end());
+  return results;
+}
+}
+
+int TestKdTreeSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPoints> inputs[] = { ConstructPoints(VTK_FLOAT),
+                                          ConstructPoints(VTK_DOUBLE) };
+  vtkNew<vtkPoints> positions;
+  for (int i = 0; i < 1000; ++i)
+  {
+    positions->InsertNextPoint(1.5 * std::sin(0.7 * i), 1.5 * std::cos(1.1 * i),
+                               0.5 + 0.8 * std::sin(0.3 * i));
+  }
+
+  for (vtkPoints *input : inputs)
+  {
+    for (int options = 0; options < 8; ++options)
+    {
+      std::vector<double> reference;
+      std::vector<vtkIdType> queries;
+      auto computeReference = [&]()
+      {
+        vtkSmartPointer<vtkKdTree> tree = BuildTree(input, options);
+        reference = Regions(tree);
+        queries = Query(tree, positions, false);
+        if (tree->GetNumberOfRegions() < 2 ||
+            Query(tree, positions, true) != queries)
+        {
+          std::cerr << "Error: wrong batched queries with options " << options
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkKdTree> tree = BuildTree(input, options);
+        if (Regions(tree) != reference)
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "regions with options " << options << std::endl;
+          return false;
+        }
+        if (Query(tree, positions, true) != queries)
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "batched queries with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The point locator forwards the batched queries to its tree.
+  vtkNew<vtkPolyData> cloud;
+  cloud->SetPoints(inputs[0]);
+  vtkNew<vtkKdTreePointLocator> locator;
+  locator->SetDataSet(cloud);
+  locator->BuildLocator();
+  vtkNew<vtkIdList> ids;
+  locator->FindClosestNPoints(3, positions, ids);
+  vtkNew<vtkIdList> single;
+  locator->FindClosestNPoints(3, positions->GetPoint(11), single);
+  if (ids->GetNumberOfIds() != 3 * positions->GetNumberOfPoints() ||
+      ids->GetId(33) != single->GetId(0))
+  {
+    std::cerr << "Error: wrong batched query of the point locator"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
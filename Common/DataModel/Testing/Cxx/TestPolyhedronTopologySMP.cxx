@@ -0,0 +1,299 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyhedronTopologySMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the polyhedra returned by vtkUnstructuredGrid::GetCell(), set up
+// from the topology built once for the grid with several threads, match
+// polyhedra initialized on their own, also when they are read concurrently,
+// and check the face neighbors.
+
+#include <vtkCellType.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyhedron.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+const int Dim = 6;
+
+// Insert the cube of corner p as a polyhedron.
+vtkIdType InsertCube(vtkUnstructuredGrid *ug, vtkIdType p)
+{
+  const vtkIdType d = Dim + 1;
+  vtkIdType pts[8] = { p, p + 1, p + d + 1, p + d,
+    p + d * d, p + d * d + 1, p + d * d + d + 1, p + d * d + d };
+  vtkIdType faces[30] = {
+    4, pts[0], pts[3], pts[2], pts[1],
+    4, pts[4], pts[5], pts[6], pts[7],
+    4, pts[0], pts[1], pts[5], pts[4],
+    4, pts[1], pts[2], pts[6], pts[5],
+    4, pts[2], pts[3], pts[7], pts[6],
+    4, pts[3], pts[0], pts[4], pts[7] };
+  return ug->InsertNextCell(VTK_POLYHEDRON, 8, pts, 6, faces);
+}
+
+// A grid of cubes stored as polyhedra, and a tetrahedron.
+void ConstructGrid(vtkUnstructuredGrid *ug)
+{
+  const vtkIdType d = Dim + 1;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < d; ++k)
+  {
+    for (int j = 0; j < d; ++j)
+    {
+      for (int i = 0; i < d; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  ug->SetPoints(points);
+  ug->Allocate(Dim * Dim * Dim + 1);
+  for (vtkIdType k = 0; k < Dim; ++k)
+  {
+    for (vtkIdType j = 0; j < Dim; ++j)
+    {
+      for (vtkIdType i = 0; i < Dim; ++i)
+      {
+        InsertCube(ug, (k * d + j) * d + i);
+      }
+    }
+  }
+  vtkIdType tetra[4] = { 0, 1, d, d * d };
+  ug->InsertNextCell(VTK_TETRA, 4, tetra);
+}
+
+// Compare a polyhedron with one initialized on its own.
+bool SamePolyhedron(vtkUnstructuredGrid *ug, vtkIdType cellId,
+                    vtkCell *cell)
+{
+  vtkNew<vtkPolyhedron> reference;
+  reference->PointIds->DeepCopy(cell->PointIds);
+  reference->Points->DeepCopy(cell->Points);
+  reference->SetFaces(ug->GetFaces(cellId));
+  reference->Initialize();
+
+  if (cell->GetNumberOfEdges() != reference->GetNumberOfEdges() ||
+      cell->GetNumberOfFaces() != reference->GetNumberOfFaces())
+  {
+    return false;
+  }
+  for (int i = 0; i < reference->GetNumberOfEdges(); ++i)
+  {
+    vtkCell *edge = cell->GetEdge(i);
+    vtkIdType pts[2] = { edge->GetPointId(0), edge->GetPointId(1) };
+    edge = reference->GetEdge(i);
+    if (pts[0] != edge->GetPointId(0) || pts[1] != edge->GetPointId(1))
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> facePts;
+  for (int i = 0; i < reference->GetNumberOfFaces(); ++i)
+  {
+    vtkCell *face = cell->GetFace(i);
+    facePts->DeepCopy(face->PointIds);
+    double x[3];
+    face->Points->GetPoint(0, x);
+    face = reference->GetFace(i);
+    if (facePts->GetNumberOfIds() != face->GetNumberOfPoints() ||
+        x[0] != face->Points->GetPoint(0)[0] ||
+        x[1] != face->Points->GetPoint(0)[1] ||
+        x[2] != face->Points->GetPoint(0)[2])
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < facePts->GetNumberOfIds(); ++j)
+    {
+      if (facePts->GetId(j) != face->GetPointId(j))
+      {
+        return false;
+      }
+    }
+  }
+  return static_cast<vtkPolyhedron *>(cell)->IsConvex() ==
+    reference->IsConvex();
+}
+
+bool CheckPolyhedra(vtkUnstructuredGrid *ug, const char *what)
+{
+  vtkNew<vtkGenericCell> genericCell;
+  for (vtkIdType cellId = 0; cellId < ug->GetNumberOfCells(); ++cellId)
+  {
+    if (ug->GetCellType(cellId) != VTK_POLYHEDRON)
+    {
+      continue;
+    }
+    ug->GetCell(cellId, genericCell);
+    if (!SamePolyhedron(ug, cellId, genericCell->GetRepresentativeCell()) ||
+        !SamePolyhedron(ug, cellId, ug->GetCell(cellId)))
+    {
+      std::cerr << "Error: wrong polyhedron " << cellId << " with " << what
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Get the polyhedra with several threads, the first ones building the
+// topology of the grid while the others wait for it.
+bool CheckPolyhedraConcurrently(vtkUnstructuredGrid *ug, const char *what)
+{
+  const vtkIdType numCells = ug->GetNumberOfCells();
+  std::vector<char> same(numCells, 1);
+  vtkSMPThreadLocalObject<vtkGenericCell> threadCell;
+  vtkSMPTools::For(0, numCells, 1, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkGenericCell *genericCell = threadCell.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      if (ug->GetCellType(cellId) == VTK_POLYHEDRON)
+      {
+        ug->GetCell(cellId, genericCell);
+        same[cellId] = SamePolyhedron(ug, cellId,
+          genericCell->GetRepresentativeCell());
+      }
+    }
+  });
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (!same[cellId])
+    {
+      std::cerr << "Error: wrong polyhedron " << cellId
+                << " read concurrently with " << what << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the face neighbors with GetCellNeighbors().
+bool CheckFaceNeighbors(vtkUnstructuredGrid *ug, const char *what)
+{
+  vtkNew<vtkIdList> facePts;
+  vtkNew<vtkIdList> neighbors;
+  std::vector<vtkIdType> faceNeighbors;
+  for (vtkIdType cellId = 0; cellId < ug->GetNumberOfCells(); ++cellId)
+  {
+    vtkIdType *faces = ug->GetFaces(cellId);
+    for (int i = 0; faces && i < faces[0]; ++i)
+    {
+      faceNeighbors.push_back(ug->GetPolyhedronFaceNeighbor(cellId, i));
+    }
+  }
+
+  ug->BuildLinks();
+  std::size_t n = 0;
+  for (vtkIdType cellId = 0; cellId < ug->GetNumberOfCells(); ++cellId)
+  {
+    vtkIdType *faces = ug->GetFaces(cellId);
+    if (!faces)
+    {
+      continue;
+    }
+    vtkIdType *face = faces + 1;
+    for (int i = 0; i < faces[0]; ++i, face += face[0] + 1)
+    {
+      facePts->SetNumberOfIds(face[0]);
+      std::copy(face + 1, face + 1 + face[0], facePts->GetPointer(0));
+      ug->GetCellNeighbors(cellId, facePts, neighbors);
+      vtkIdType expected = -1;
+      for (vtkIdType j = 0; j < neighbors->GetNumberOfIds(); ++j)
+      {
+        if (expected < 0 || neighbors->GetId(j) < expected)
+        {
+          expected = neighbors->GetId(j);
+        }
+      }
+      if (faceNeighbors[n++] != expected)
+      {
+        std::cerr << "Error: wrong neighbor of face " << i << " of cell "
+                  << cellId << " with " << what << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestPolyhedronTopologySMP(int, char *[])
+{
+  auto testBackend = [&](const char *backend)
+  {
+    vtkNew<vtkUnstructuredGrid> concurrentGrid;
+    ConstructGrid(concurrentGrid);
+    if (!CheckPolyhedraConcurrently(concurrentGrid, backend))
+    {
+      return false;
+    }
+
+    vtkNew<vtkUnstructuredGrid> ug;
+    ConstructGrid(ug);
+    if (!CheckPolyhedra(ug, backend) || !CheckFaceNeighbors(ug, backend))
+    {
+      return false;
+    }
+    if (ug->GetPolyhedronFaceNeighbor(ug->GetNumberOfCells() - 1, 0) != -1)
+    {
+      std::cerr << "Error: face neighbor of a tetrahedron" << std::endl;
+      return false;
+    }
+
+    // A new cell invalidates the topology: the copy of the first cube is
+    // the neighbor of all its faces.
+    vtkIdType cellId = InsertCube(ug, 0);
+    if (!CheckPolyhedra(ug, "a new cell") ||
+        !CheckFaceNeighbors(ug, "a new cell") ||
+        ug->GetPolyhedronFaceNeighbor(0, 0) != cellId ||
+        ug->GetPolyhedronFaceNeighbor(cellId, 0) != 0)
+    {
+      return false;
+    }
+
+    // Inserting and getting cells in turn, the polyhedra are set up from an
+    // out of date topology only when it has been rebuilt.
+    for (vtkIdType p = 0; p < Dim; ++p)
+    {
+      cellId = InsertCube(ug, p);
+      if (!SamePolyhedron(ug, cellId, ug->GetCell(cellId)))
+      {
+        std::cerr << "Error: wrong polyhedron " << cellId
+                  << " after its insertion" << std::endl;
+        return false;
+      }
+    }
+    ug->BuildPolyhedronTopology();
+    if (!CheckPolyhedraConcurrently(ug, "inserted cells"))
+    {
+      return false;
+    }
+    return true;
+  };
+  if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -242,6 +242,10 @@ struct ArrayList
   void ExcludeArray(vtkDataArray *da);
   vtkTypeBool IsExcluded(vtkDataArray *da);
 
+  // Check whether AddArrays() processes all the arrays of the given field
+  // data, so that a threaded filter can rely on it to copy them.
+  static bool ProcessesAllArrays(vtkFieldData *fd);
+
   // Loop over the array pairs and copy data from one to another
   void Copy(vtkIdType inId, vtkIdType outId)
   {
@@ -214,4 +214,24 @@ AddSelfInterpolatingArrays(vtkIdType numOutPts, vtkDataSetAttributes *attr, doub
   }//for each candidate array
 }
 
+//----------------------------------------------------------------------------
+// AddArrays() pairs the arrays by name and dispatches them with
+// vtkTemplateMacro, which skips the bit arrays: the arrays without a name,
+// the bit arrays and the arrays that are not data arrays are not processed.
+inline bool ArrayList::
+ProcessesAllArrays(vtkFieldData *fd)
+{
+  int i, numArrays = fd->GetNumberOfArrays();
+  for (i=0; i < numArrays; ++i)
+  {
+    vtkAbstractArray *array = fd->GetAbstractArray(i);
+    if ( !vtkArrayDownCast<vtkDataArray>(array) || !array->GetName() ||
+         array->GetDataType() == VTK_BIT )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 #endif
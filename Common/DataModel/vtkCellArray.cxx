@@ -14,46 +14,779 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkTypeInt64Array.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 
 vtkStandardNewMacro(vtkCellArray);
 
+// Execute call with VTK_TT defined as the array type of the split storage.
+#define vtkCellArraySplitMacro(call)                                   \
+  switch (this->StorageMode)                                           \
+  {                                                                    \
+    case SPLIT_STORAGE_32BIT: { typedef vtkTypeInt32Array VTK_TT; call; }; break; \
+    case SPLIT_STORAGE_64BIT: { typedef vtkTypeInt64Array VTK_TT; call; }; break; \
+    default: break;                                                    \
+  }
+
+namespace
+{
+// Return the point ids of a cell of the connectivity array: the connectivity
+// itself when it holds vtkIdType values, a copy in the buffer otherwise.
+template <typename ValueT,
+          bool IsIdType = std::is_same<ValueT, vtkIdType>::value>
+struct CellPoints
+{
+  static vtkIdType* Get(ValueT* conn, vtkIdType npts, vtkIdList* buffer)
+  {
+    vtkIdType* pts = buffer->WritePointer(0, npts);
+    std::copy(conn, conn + npts, pts);
+    return pts;
+  }
+};
+
+template <typename ValueT>
+struct CellPoints<ValueT, true>
+{
+  static vtkIdType* Get(ValueT* conn, vtkIdType, vtkIdList*)
+  {
+    return conn;
+  }
+};
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void GetSplitCell(ArrayT* offsets, ArrayT* conn, vtkIdType cellId,
+                  vtkIdType& npts, vtkIdType*& pts, vtkIdList* buffer)
+{
+  const vtkIdType begin = offsets->GetValue(cellId);
+  npts = offsets->GetValue(cellId + 1) - begin;
+  pts = CellPoints<typename ArrayT::ValueType>::Get(
+    conn->GetPointer(begin), npts, buffer);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void GetSplitCell(ArrayT* offsets, ArrayT* conn, vtkIdType cellId,
+                  vtkIdList* pts)
+{
+  const vtkIdType begin = offsets->GetValue(cellId);
+  const vtkIdType npts = offsets->GetValue(cellId + 1) - begin;
+  const typename ArrayT::ValueType* cellPts = conn->GetPointer(begin);
+  pts->SetNumberOfIds(npts);
+  for (vtkIdType i = 0; i < npts; i++)
+  {
+    pts->SetId(i, static_cast<vtkIdType>(cellPts[i]));
+  }
+}
+
+//----------------------------------------------------------------------------
+// Copy a cell in the legacy form (npts,id1,id2,...,idn) into the buffer.
+template <typename ArrayT>
+vtkIdType* GetSplitLegacyCell(ArrayT* offsets, ArrayT* conn, vtkIdType cellId,
+                              vtkIdList* buffer)
+{
+  const vtkIdType begin = offsets->GetValue(cellId);
+  const vtkIdType npts = offsets->GetValue(cellId + 1) - begin;
+  vtkIdType* cell = buffer->WritePointer(0, npts + 1);
+  cell[0] = npts;
+  std::copy(conn->GetPointer(begin), conn->GetPointer(begin) + npts,
+            cell + 1);
+  return cell;
+}
+
+//----------------------------------------------------------------------------
+// The legacy location of cell i is offsets[i] + i, which strictly increases
+// with i.
+template <typename ArrayT>
+vtkIdType GetSplitCellId(ArrayT* offsets, vtkIdType ncells, vtkIdType loc)
+{
+  vtkIdType first = 0;
+  vtkIdType last = ncells;
+  while (first < last)
+  {
+    const vtkIdType middle = first + (last - first) / 2;
+    if (offsets->GetValue(middle) + middle < loc)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+  return first;
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void InsertSplitCell(ArrayT* offsets, ArrayT* conn, vtkIdType npts,
+                     const vtkIdType pts[])
+{
+  typedef typename ArrayT::ValueType ValueT;
+  const vtkIdType end = conn->GetNumberOfValues();
+  ValueT* cellPts = conn->WritePointer(end, npts);
+  for (vtkIdType i = 0; i < npts; i++)
+  {
+    cellPts[i] = static_cast<ValueT>(pts[i]);
+  }
+  offsets->InsertNextValue(static_cast<ValueT>(end + npts));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void InsertSplitCellPoint(ArrayT* offsets, ArrayT* conn, vtkIdType ncells,
+                          vtkIdType id)
+{
+  typedef typename ArrayT::ValueType ValueT;
+  conn->InsertNextValue(static_cast<ValueT>(id));
+  offsets->SetValue(ncells, static_cast<ValueT>(conn->GetNumberOfValues()));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void UpdateSplitCellCount(ArrayT* offsets, ArrayT* conn, vtkIdType ncells,
+                          vtkIdType npts)
+{
+  typedef typename ArrayT::ValueType ValueT;
+  const vtkIdType end = offsets->GetValue(ncells - 1) + npts;
+  conn->SetNumberOfValues(end);
+  offsets->SetValue(ncells, static_cast<ValueT>(end));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void ReverseSplitCell(ArrayT* offsets, ArrayT* conn, vtkIdType cellId)
+{
+  std::reverse(conn->GetPointer(offsets->GetValue(cellId)),
+               conn->GetPointer(offsets->GetValue(cellId + 1)));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void ReplaceSplitCell(ArrayT* offsets, ArrayT* conn, vtkIdType cellId,
+                      vtkIdType npts, const vtkIdType pts[])
+{
+  typedef typename ArrayT::ValueType ValueT;
+  ValueT* cellPts = conn->GetPointer(offsets->GetValue(cellId));
+  for (vtkIdType i = 0; i < npts; i++)
+  {
+    cellPts[i] = static_cast<ValueT>(pts[i]);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+vtkIdType GetSplitMaxCellSize(ArrayT* offsets, vtkIdType ncells)
+{
+  vtkIdType maxSize = 0;
+  for (vtkIdType cellId = 0; cellId < ncells; cellId++)
+  {
+    maxSize = std::max(maxSize, static_cast<vtkIdType>(
+      offsets->GetValue(cellId + 1) - offsets->GetValue(cellId)));
+  }
+  return maxSize;
+}
+
+//----------------------------------------------------------------------------
+// Fill the split storage from the legacy array, and return the number of
+// cells.
+template <typename ArrayT>
+vtkIdType LegacyToSplit(vtkIdTypeArray* legacy, ArrayT* offsets,
+                        ArrayT* conn)
+{
+  typedef typename ArrayT::ValueType ValueT;
+  const vtkIdType size = legacy->GetMaxId() + 1;
+  const vtkIdType* cells = legacy->GetPointer(0);
+  vtkIdType ncells = 0;
+  for (vtkIdType loc = 0; loc < size; loc += cells[loc] + 1)
+  {
+    ncells++;
+  }
+
+  offsets->SetNumberOfValues(ncells + 1);
+  conn->SetNumberOfValues(size - ncells);
+  ValueT* offset = offsets->GetPointer(0);
+  ValueT* cellPts = conn->GetPointer(0);
+  vtkIdType end = 0;
+  *offset++ = 0;
+  for (vtkIdType cellId = 0; cellId < ncells; cellId++)
+  {
+    const vtkIdType npts = *cells++;
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      *cellPts++ = static_cast<ValueT>(*cells++);
+    }
+    end += npts;
+    *offset++ = static_cast<ValueT>(end);
+  }
+  return ncells;
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void SplitToLegacy(ArrayT* offsets, ArrayT* conn, vtkIdType ncells,
+                   vtkIdTypeArray* legacy)
+{
+  legacy->SetNumberOfValues(conn->GetNumberOfValues() + ncells);
+  vtkIdType* cells = legacy->GetPointer(0);
+  const typename ArrayT::ValueType* cellPts = conn->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < ncells; cellId++)
+  {
+    const vtkIdType npts =
+      offsets->GetValue(cellId + 1) - offsets->GetValue(cellId);
+    *cells++ = npts;
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      *cells++ = static_cast<vtkIdType>(*cellPts++);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool FitsIn32Bit(vtkIdType value)
+{
+  return value >= std::numeric_limits<vtkTypeInt32>::min() &&
+    value <= std::numeric_limits<vtkTypeInt32>::max();
+}
+
+//----------------------------------------------------------------------------
+// Return whether the n values, and their count, fit in the 32-bit storage.
+template <typename ValueT>
+bool ValuesFitIn32Bit(const ValueT* values, vtkIdType n)
+{
+  if (!FitsIn32Bit(n))
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    if (!FitsIn32Bit(static_cast<vtkIdType>(values[i])))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* NewSplitArray(int mode)
+{
+  if (mode == vtkCellArray::SPLIT_STORAGE_32BIT)
+  {
+    return vtkTypeInt32Array::New();
+  }
+  return vtkTypeInt64Array::New();
+}
+}
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
+  this->StorageMode = LEGACY_STORAGE;
   this->Ia = vtkIdTypeArray::New();
+  this->Offsets = nullptr;
+  this->Connectivity = nullptr;
+  this->TempCells = nullptr;
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::DeepCopy (vtkCellArray *ca)
 {
   // Do nothing on a nullptr input.
-  if (ca == nullptr)
+  if (ca == nullptr || ca == this)
   {
     return;
   }
 
-  this->Ia->DeepCopy(ca->Ia);
+  this->ReleaseSplitStorage();
+  if (ca->StorageMode != LEGACY_STORAGE)
+  {
+    this->Ia->Initialize();
+    this->Offsets = NewSplitArray(ca->StorageMode);
+    this->Offsets->DeepCopy(ca->Offsets);
+    this->Connectivity = NewSplitArray(ca->StorageMode);
+    this->Connectivity->DeepCopy(ca->Connectivity);
+    if (!this->TempCells)
+    {
+      this->TempCells = new vtkSMPThreadLocalObject<vtkIdList>;
+    }
+    this->StorageMode = ca->StorageMode;
+  }
+  else
+  {
+    this->Ia->DeepCopy(ca->Ia);
+  }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
+  this->ReleaseSplitStorage();
   this->Ia->Delete();
+  delete this->TempCells;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseSplitStorage()
+{
+  if (this->Offsets)
+  {
+    this->Offsets->Delete();
+    this->Offsets = nullptr;
+  }
+  if (this->Connectivity)
+  {
+    this->Connectivity->Delete();
+    this->Connectivity = nullptr;
+  }
+  this->StorageMode = LEGACY_STORAGE;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetStorageMode(int mode)
+{
+  if (mode == this->StorageMode)
+  {
+    return;
+  }
+  if (mode < LEGACY_STORAGE || mode > SPLIT_STORAGE_64BIT)
+  {
+    vtkErrorMacro("Unknown storage mode " << mode);
+    return;
+  }
+
+  // The cells do not change, so the cell array is not marked as modified.
+  if (mode == LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      SplitToLegacy(static_cast<VTK_TT*>(this->Offsets),
+                    static_cast<VTK_TT*>(this->Connectivity),
+                    this->NumberOfCells, this->Ia));
+    this->ReleaseSplitStorage();
+    return;
+  }
+
+  if (mode == SPLIT_STORAGE_32BIT)
+  {
+    bool fits = true;
+    if (this->StorageMode == LEGACY_STORAGE)
+    {
+      fits = ValuesFitIn32Bit(this->Ia->GetPointer(0), this->Ia->GetMaxId() + 1);
+    }
+    else if (this->StorageMode == SPLIT_STORAGE_64BIT)
+    {
+      vtkTypeInt64Array* conn =
+        static_cast<vtkTypeInt64Array*>(this->Connectivity);
+      fits = ValuesFitIn32Bit(conn->GetPointer(0), conn->GetNumberOfValues());
+    }
+    if (!fits)
+    {
+      vtkErrorMacro("The cells do not fit in the 32-bit storage");
+      return;
+    }
+  }
+
+  vtkDataArray* offsets = NewSplitArray(mode);
+  vtkDataArray* connectivity = NewSplitArray(mode);
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    if (mode == SPLIT_STORAGE_32BIT)
+    {
+      this->NumberOfCells = LegacyToSplit(this->Ia,
+        static_cast<vtkTypeInt32Array*>(offsets),
+        static_cast<vtkTypeInt32Array*>(connectivity));
+    }
+    else
+    {
+      this->NumberOfCells = LegacyToSplit(this->Ia,
+        static_cast<vtkTypeInt64Array*>(offsets),
+        static_cast<vtkTypeInt64Array*>(connectivity));
+    }
+    this->Ia->Initialize();
+  }
+  else
+  {
+    offsets->DeepCopy(this->Offsets);
+    connectivity->DeepCopy(this->Connectivity);
+    this->ReleaseSplitStorage();
+  }
+
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  if (!this->TempCells)
+  {
+    this->TempCells = new vtkSMPThreadLocalObject<vtkIdList>;
+  }
+  this->StorageMode = mode;
+  this->TraversalCellId = this->GetCellIdAtLocation(this->TraversalLocation);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkTypeInt32Array *offsets,
+                           vtkTypeInt32Array *connectivity)
+{
+  this->SetSplitData(SPLIT_STORAGE_32BIT, offsets, connectivity);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkTypeInt64Array *offsets,
+                           vtkTypeInt64Array *connectivity)
+{
+  this->SetSplitData(SPLIT_STORAGE_64BIT, offsets, connectivity);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetSplitData(int mode, vtkDataArray *offsets,
+                                vtkDataArray *connectivity)
+{
+  if (!offsets || !connectivity)
+  {
+    vtkErrorMacro("Offsets and connectivity arrays are required");
+    return;
+  }
+
+  const vtkIdType numOffsets = offsets->GetNumberOfValues();
+  if (numOffsets > 0 &&
+      (offsets->GetComponent(0, 0) != 0 ||
+       static_cast<vtkIdType>(offsets->GetComponent(numOffsets - 1, 0)) !=
+         connectivity->GetNumberOfValues()))
+  {
+    vtkErrorMacro("The offsets must start at 0 and end at the number of "
+                  "values of the connectivity array");
+    return;
+  }
+
+  // The caller's empty offsets array is left alone: an array holding the
+  // first offset is used in its place.
+  if (numOffsets == 0)
+  {
+    offsets = NewSplitArray(mode);
+    offsets->InsertNextTuple1(0);
+  }
+  else
+  {
+    offsets->Register(this);
+  }
+  connectivity->Register(this);
+  this->ReleaseSplitStorage();
+  this->Ia->Initialize();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  if (!this->TempCells)
+  {
+    this->TempCells = new vtkSMPThreadLocalObject<vtkIdList>;
+  }
+  this->StorageMode = mode;
+  this->NumberOfCells = offsets->GetNumberOfValues() - 1;
+  this->InsertLocation =
+    connectivity->GetNumberOfValues() + this->NumberOfCells;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      VTK_TT* offsets = static_cast<VTK_TT*>(this->Offsets);
+      return offsets->GetValue(cellId + 1) - offsets->GetValue(cellId));
+  }
+  vtkIdType npts, *pts;
+  this->GetCellAtId(cellId, npts, pts);
+  return npts;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                               vtkIdType* &pts)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      GetSplitCell(static_cast<VTK_TT*>(this->Offsets),
+                   static_cast<VTK_TT*>(this->Connectivity),
+                   cellId, npts, pts, this->TempCells->Local()));
+    return;
+  }
+
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < cellId; i++)
+  {
+    loc += this->Ia->GetValue(loc) + 1;
+  }
+  this->GetCell(loc, npts, pts);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      GetSplitCell(static_cast<VTK_TT*>(this->Offsets),
+                   static_cast<VTK_TT*>(this->Connectivity), cellId, pts));
+    return;
+  }
+
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < cellId; i++)
+  {
+    loc += this->Ia->GetValue(loc) + 1;
+  }
+  this->GetCell(loc, pts);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::IsStorageShareable()
+{
+  switch (this->StorageMode)
+  {
+    case SPLIT_STORAGE_32BIT:
+      return std::is_same<vtkTypeInt32, vtkIdType>::value;
+    case SPLIT_STORAGE_64BIT:
+      return std::is_same<vtkTypeInt64, vtkIdType>::value;
+    default:
+      return true;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType *vtkCellArray::GetLegacyCell(vtkIdType loc)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      return GetSplitLegacyCell(static_cast<VTK_TT*>(this->Offsets),
+                                static_cast<VTK_TT*>(this->Connectivity),
+                                this->GetCellIdAtLocation(loc),
+                                this->TempCells->Local()));
+  }
+  return this->Ia->GetPointer(loc);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ExportLegacyFormat()
+{
+  vtkCellArraySplitMacro(
+    SplitToLegacy(static_cast<VTK_TT*>(this->Offsets),
+                  static_cast<VTK_TT*>(this->Connectivity),
+                  this->NumberOfCells, this->Ia));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::PromoteSplitStorage(vtkIdType npts, const vtkIdType pts[],
+                                       vtkIdType numValues)
+{
+  if (this->StorageMode == SPLIT_STORAGE_32BIT &&
+      (!FitsIn32Bit(numValues) || !ValuesFitIn32Bit(pts, npts)))
+  {
+    this->SetStorageMode(SPLIT_STORAGE_64BIT);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdAtLocation(vtkIdType loc)
+{
+  vtkCellArraySplitMacro(
+    return GetSplitCellId(static_cast<VTK_TT*>(this->Offsets),
+                          this->NumberOfCells, loc));
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::SplitInsertNextCell(vtkIdType npts,
+                                            const vtkIdType pts[])
+{
+  this->PromoteSplitStorage(
+    npts, pts, this->Connectivity->GetNumberOfValues() + npts);
+  vtkCellArraySplitMacro(
+    InsertSplitCell(static_cast<VTK_TT*>(this->Offsets),
+                    static_cast<VTK_TT*>(this->Connectivity), npts, pts));
+  this->NumberOfCells++;
+  this->InsertLocation += npts + 1;
+  return this->NumberOfCells - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SplitInsertCellPoint(vtkIdType id)
+{
+  this->PromoteSplitStorage(
+    1, &id, this->Connectivity->GetNumberOfValues() + 1);
+  vtkCellArraySplitMacro(
+    InsertSplitCellPoint(static_cast<VTK_TT*>(this->Offsets),
+                         static_cast<VTK_TT*>(this->Connectivity),
+                         this->NumberOfCells, id));
+  this->InsertLocation++;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SplitUpdateCellCount(int npts)
+{
+  if (this->NumberOfCells == 0)
+  {
+    return;
+  }
+  this->PromoteSplitStorage(0, nullptr, static_cast<vtkIdType>(
+    this->Offsets->GetComponent(this->NumberOfCells - 1, 0)) + npts);
+  vtkCellArraySplitMacro(
+    UpdateSplitCellCount(static_cast<VTK_TT*>(this->Offsets),
+                         static_cast<VTK_TT*>(this->Connectivity),
+                         this->NumberOfCells, npts));
+  this->InsertLocation =
+    this->Connectivity->GetNumberOfValues() + this->NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::SplitGetNextCell(vtkIdType& npts, vtkIdType* &pts)
+{
+  if (this->TraversalCellId < this->NumberOfCells)
+  {
+    this->GetCellAtId(this->TraversalCellId++, npts, pts);
+    this->TraversalLocation += npts + 1;
+    return 1;
+  }
+  npts = 0;
+  pts = nullptr;
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SplitGetCell(vtkIdType loc, vtkIdType &npts,
+                                vtkIdType* &pts)
+{
+  this->GetCellAtId(this->GetCellIdAtLocation(loc), npts, pts);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SplitReverseCell(vtkIdType loc)
+{
+  vtkCellArraySplitMacro(
+    ReverseSplitCell(static_cast<VTK_TT*>(this->Offsets),
+                     static_cast<VTK_TT*>(this->Connectivity),
+                     this->GetCellIdAtLocation(loc)));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SplitReplaceCell(vtkIdType loc, int npts,
+                                    const vtkIdType pts[])
+{
+  this->PromoteSplitStorage(npts, pts, 0);
+  vtkCellArraySplitMacro(
+    ReplaceSplitCell(static_cast<VTK_TT*>(this->Offsets),
+                     static_cast<VTK_TT*>(this->Connectivity),
+                     this->GetCellIdAtLocation(loc), npts, pts));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetTraversalLocation(vtkIdType loc)
+{
+  this->TraversalLocation = loc;
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->TraversalCellId = this->GetCellIdAtLocation(loc);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkTypeBool vtkCellArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->Reset();
+    return this->Connectivity->Allocate(sz, ext);
+  }
+  return this->Ia->Allocate(sz,ext);
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
   this->Ia->Initialize();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->Offsets->Initialize();
+    this->Offsets->InsertNextTuple1(0);
+    this->Connectivity->Initialize();
+  }
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Reset()
+{
+  this->NumberOfCells = 0;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Ia->Reset();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->Offsets->Reset();
+    this->Offsets->InsertNextTuple1(0);
+    this->Connectivity->Reset();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  this->Ia->Squeeze();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->Offsets->GetSize() + this->Connectivity->GetSize();
+  }
+  return this->Ia->GetSize();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->Connectivity->GetNumberOfValues() + this->NumberOfCells;
+  }
+  return this->Ia->GetMaxId()+1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
+                                      const vtkIdType size)
+{
+  this->ReleaseSplitStorage();
+  this->NumberOfCells = ncells;
+  this->InsertLocation = size;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  return this->Ia->WritePointer(0,size);
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +794,13 @@ void vtkCellArray::Initialize()
 // defining the cell.
 int vtkCellArray::GetMaxCellSize()
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    vtkCellArraySplitMacro(
+      return static_cast<int>(GetSplitMaxCellSize(
+        static_cast<VTK_TT*>(this->Offsets), this->NumberOfCells)));
+  }
+
   int npts=0, maxSize=0;
   vtkIdType i;
 
@@ -81,6 +821,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
   if ( cells && cells != this->Ia )
   {
     this->Modified();
+    this->ReleaseSplitStorage();
     this->Ia->Delete();
     this->Ia = cells;
     this->Ia->Register(this);
@@ -88,13 +829,20 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
     this->NumberOfCells = ncells;
     this->InsertLocation = cells->GetMaxId() + 1;
     this->TraversalLocation = 0;
+    this->TraversalCellId = 0;
   }
 }
 
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+  }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -116,6 +864,11 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->GetCellAtId(this->GetCellIdAtLocation(loc), pts);
+    return;
+  }
   vtkIdType npts = this->Ia->GetValue(loc++);
   vtkIdType *ppts = this->Ia->GetPointer(loc);
   pts->SetNumberOfIds(npts);
@@ -130,6 +883,18 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "Storage Mode: ";
+  switch (this->StorageMode)
+  {
+    case SPLIT_STORAGE_32BIT:
+      os << "Split 32-bit" << endl;
+      break;
+    case SPLIT_STORAGE_64BIT:
+      os << "Split 64-bit" << endl;
+      break;
+    default:
+      os << "Legacy" << endl;
+  }
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
@@ -28,6 +28,23 @@
  * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
  * the data structure.
  *
+ * Alternatively, the cells may be stored in two separate arrays (see
+ * SetStorageMode()): an offsets array of NumberOfCells+1 entries, where the
+ * points of cell i are found at [offsets[i], offsets[i+1]) in a connectivity
+ * array that only holds point ids. Both arrays are either 32-bit or 64-bit
+ * integer arrays, so that small meshes can halve their memory use even when
+ * vtkIdType is 64-bit. This split storage gives random access to the cells
+ * in constant time with GetCellAtId(), and external offsets and connectivity
+ * buffers can be adopted without copy with SetData(). The traversal and
+ * insertion methods keep working on top of the split storage, with
+ * locations that have the same values as in the legacy storage. However,
+ * when the storage width differs from vtkIdType, the pts pointers returned
+ * by these methods point to a buffer of the calling thread that is only
+ * valid until its next call, so that writing through them does not change
+ * the cells (see IsStorageShareable()). The methods that expose the legacy
+ * array (GetPointer(), GetData()) return a copy of the cells in the legacy
+ * form and leave the split storage unchanged.
+ *
  * @sa
  * vtkCellTypes vtkCellLinks
 */
@@ -41,6 +58,11 @@
 #include "vtkIdTypeArray.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
 
+class vtkDataArray;
+class vtkTypeInt32Array;
+class vtkTypeInt64Array;
+template <typename T> class vtkSMPThreadLocalObject;
+
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -52,11 +74,94 @@ public:
    */
   static vtkCellArray *New();
 
+  /**
+   * The ways the cells can be stored: either in a single legacy array of the
+   * form (n,id1,id2,...,idn, ...), or in separate offsets and connectivity
+   * arrays of 32-bit or 64-bit integers.
+   */
+  enum StorageModes
+  {
+    LEGACY_STORAGE = 0,
+    SPLIT_STORAGE_32BIT,
+    SPLIT_STORAGE_64BIT
+  };
+
+  //@{
+  /**
+   * Set/Get the storage of the cells. Changing the storage mode converts the
+   * cells already in the array; the traversal and insertion locations are
+   * preserved. The default is LEGACY_STORAGE. The 32-bit storage is refused
+   * when the point ids or the number of values do not fit in 32 bits, and a
+   * 32-bit cell array switches to the 64-bit storage when such values are
+   * inserted.
+   */
+  void SetStorageMode(int mode);
+  int GetStorageMode()
+    {return this->StorageMode;}
+  void SetStorageModeToLegacy()
+    {this->SetStorageMode(LEGACY_STORAGE);}
+  void SetStorageModeTo32Bit()
+    {this->SetStorageMode(SPLIT_STORAGE_32BIT);}
+  void SetStorageModeTo64Bit()
+    {this->SetStorageMode(SPLIT_STORAGE_64BIT);}
+  //@}
+
+  //@{
+  /**
+   * Use the given offsets and connectivity arrays as the split storage of
+   * the cells, without copying them. The offsets array must hold
+   * NumberOfCells+1 entries, starting at 0 and ending at the number of values
+   * of the connectivity array; an empty offsets array stands for no cells and
+   * is replaced by an array of its own. The previous cells are discarded.
+   */
+  void SetData(vtkTypeInt32Array *offsets, vtkTypeInt32Array *connectivity);
+  void SetData(vtkTypeInt64Array *offsets, vtkTypeInt64Array *connectivity);
+  //@}
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays of the split storage, or
+   * nullptr with the legacy storage.
+   */
+  vtkDataArray* GetOffsetsArray()
+    {return this->Offsets;}
+  vtkDataArray* GetConnectivityArray()
+    {return this->Connectivity;}
+  //@}
+
+  /**
+   * Return the number of points of the cell cellId. This takes constant time
+   * with the split storage, and a traversal of the cells otherwise.
+   */
+  vtkIdType GetCellSize(vtkIdType cellId);
+
+  /**
+   * Return whether the pts pointers returned by the traversal and random
+   * access methods point into the storage of the cells, that is with the
+   * legacy storage and with split storage that has the width of vtkIdType.
+   * Otherwise they point to a copy of the point ids, and the cells must be
+   * changed with ReplaceCell() rather than by writing through them.
+   */
+  bool IsStorageShareable();
+
+  /**
+   * Return the point ids of the cell cellId. This takes constant time with
+   * the split storage, and a traversal of the cells otherwise. Unless the
+   * storage is shareable, pts points to a buffer of the calling thread that
+   * is only valid until its next call.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts)
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Return the point ids of the cell cellId in the given list.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList *pts);
+
   /**
    * Allocate memory and set the size to extend by.
    */
-  vtkTypeBool Allocate(vtkIdType sz, vtkIdType ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  vtkTypeBool Allocate(vtkIdType sz, vtkIdType ext=1000);
 
   /**
    * Free any memory and reset to an empty state.
@@ -73,7 +178,8 @@ public:
   //@{
   /**
    * Set the number of cells in the array.
-   * DO NOT do any kind of allocation, advanced use only.
+   * DO NOT do any kind of allocation, advanced use only. This is only
+   * meaningful with the legacy storage.
    */
   vtkSetMacro(NumberOfCells, vtkIdType);
   //@}
@@ -93,7 +199,8 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  InitTraversal() initializes the traversal of the list of cells.
    */
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal()
+    {this->TraversalLocation=0; this->TraversalCellId=0;}
 
   /**
    * A cell traversal methods that is more efficient than vtkDataSet traversal
@@ -114,16 +221,14 @@ public:
   /**
    * Get the size of the allocated connectivity array.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
    * Get the total number of entries (i.e., data values) in the connectivity
    * array. This may be much less than the allocated size (i.e., return value
    * from GetSize().)
    */
-  vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  vtkIdType GetNumberOfConnectivityEntries();
 
   /**
    * Internal method used to retrieve a cell given an offset into
@@ -140,6 +245,14 @@ public:
   void GetCell(vtkIdType loc, vtkIdList* pts)
     VTK_EXPECTS(0 <= loc && loc < GetSize());
 
+  /**
+   * Internal method used to retrieve a cell in the legacy form
+   * (npts,id1,id2,...,idn) given an offset into the internal array. With the
+   * split storage, the cell is copied into a buffer of the calling thread
+   * that is only valid until its next call.
+   */
+  vtkIdType *GetLegacyCell(vtkIdType loc);
+
   /**
    * Insert a cell object. Return the cell id of the cell.
    */
@@ -190,8 +303,7 @@ public:
    */
   vtkIdType GetTraversalLocation()
     {return this->TraversalLocation;}
-  void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  void SetTraversalLocation(vtkIdType loc);
 
   /**
    * Computes the current traversal location within the internal array. Used
@@ -224,15 +336,16 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to array of cell data. With the split storage, this is a
+   * copy of the cells in the legacy form, made in linear time at each call.
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {return this->GetData()->GetPointer(0);}
 
   /**
    * Get pointer to data array for purpose of direct writes of data. Size is the
    * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * represented in the array. The cell array switches to the legacy storage.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -243,7 +356,7 @@ public:
    * referring these cells becomes invalid (for example, if BuildCells() has
    * been called see vtkPolyData).  The traversal location is reset to the
    * beginning of the list; the insertion location is set to the end of the
-   * list.
+   * list. The cell array switches to the legacy storage.
    */
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
@@ -253,10 +366,19 @@ public:
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the underlying data as a data array. With the split storage, this
+   * is a copy of the cells in the legacy form, made in linear time at each
+   * call: changing it does not change the cells, and it must not be
+   * requested by several threads at once.
    */
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+  {
+    if (this->StorageMode != LEGACY_STORAGE)
+    {
+      this->ExportLegacyFormat();
+    }
+    return this->Ia;
+  }
 
   /**
    * Reuse list. Reset to initial condition.
@@ -266,8 +388,7 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -283,10 +404,42 @@ protected:
   vtkCellArray();
   ~vtkCellArray() override;
 
+  // Split storage counterparts of the inline methods.
+  vtkIdType SplitInsertNextCell(vtkIdType npts, const vtkIdType pts[]);
+  void SplitInsertCellPoint(vtkIdType id);
+  void SplitUpdateCellCount(int npts);
+  int SplitGetNextCell(vtkIdType& npts, vtkIdType* &pts);
+  void SplitGetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
+  void SplitReverseCell(vtkIdType loc);
+  void SplitReplaceCell(vtkIdType loc, int npts, const vtkIdType pts[]);
+
+  // Return the id of the cell at the given legacy location.
+  vtkIdType GetCellIdAtLocation(vtkIdType loc);
+
+  // Release the arrays of the split storage.
+  void ReleaseSplitStorage();
+
+  // Adopt the arrays of the split storage, see SetData().
+  void SetSplitData(int mode, vtkDataArray *offsets,
+                    vtkDataArray *connectivity);
+
+  // Switch the 32-bit storage to the 64-bit storage if the point ids, or
+  // the number of values once they are inserted, do not fit in 32 bits.
+  void PromoteSplitStorage(vtkIdType npts, const vtkIdType pts[],
+                           vtkIdType numValues);
+
+  // Copy the split storage in the legacy form into Ia.
+  void ExportLegacyFormat();
+
+  int StorageMode;
   vtkIdType NumberOfCells;
   vtkIdType InsertLocation;     //keep track of current insertion point
   vtkIdType TraversalLocation;   //keep track of traversal position
+  vtkIdType TraversalCellId;     //cell at the traversal position
   vtkIdTypeArray *Ia;
+  vtkDataArray *Offsets;         //split storage
+  vtkDataArray *Connectivity;
+  vtkSMPThreadLocalObject<vtkIdList> *TempCells; //copies of narrower cells
 
 private:
   vtkCellArray(const vtkCellArray&) = delete;
@@ -298,6 +451,11 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType pts[]) VTK_SIZEHINT(pts, npts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->SplitInsertNextCell(npts, pts);
+  }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -315,6 +473,12 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    // The points are counted as they are inserted.
+    return this->SplitInsertNextCell(0, nullptr);
+  }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -324,12 +488,22 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->SplitInsertCellPoint(id);
+    return;
+  }
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->SplitUpdateCellCount(npts);
+    return;
+  }
   this->Ia->SetValue(this->InsertLocation-npts-1, npts);
 }
 
@@ -346,18 +520,13 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
                               cell->PointIds->GetPointer(0));
 }
 
-//----------------------------------------------------------------------------
-inline void vtkCellArray::Reset()
-{
-  this->NumberOfCells = 0;
-  this->InsertLocation = 0;
-  this->TraversalLocation = 0;
-  this->Ia->Reset();
-}
-
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->SplitGetNextCell(npts, pts);
+  }
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
   {
@@ -375,6 +544,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->SplitGetCell(loc, npts, pts);
+    return;
+  }
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -382,6 +556,11 @@ inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
 //----------------------------------------------------------------------------
 inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->SplitReverseCell(loc);
+    return;
+  }
   int i;
   vtkIdType tmp;
   vtkIdType npts=this->Ia->GetValue(loc);
@@ -398,6 +577,11 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType pts[])
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->SplitReplaceCell(loc, npts, pts);
+    return;
+  }
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
   {
@@ -405,14 +589,4 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
   }
 }
 
-//----------------------------------------------------------------------------
-inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
-                                             const vtkIdType size)
-{
-  this->NumberOfCells = ncells;
-  this->InsertLocation = size;
-  this->TraversalLocation = 0;
-  return this->Ia->WritePointer(0,size);
-}
-
 #endif
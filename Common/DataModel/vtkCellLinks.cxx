@@ -19,6 +19,10 @@
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinks.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkCellLinks);
 
@@ -283,6 +287,30 @@ void vtkCellLinks::DeepCopy(vtkCellLinks *src)
   this->MaxId = src->MaxId;
 }
 
+//----------------------------------------------------------------------------
+// Copy static links into editable lists. The lists are allocated and filled
+// concurrently.
+void vtkCellLinks::DeepCopy(vtkStaticCellLinks *src)
+{
+  vtkIdType numPts = src->GetNumberOfPoints();
+  this->Initialize();
+  this->Allocate(numPts);
+  this->MaxId = numPts - 1;
+
+  vtkCellLinks::Link *array = this->Array;
+  vtkSMPTools::For(0, numPts, [array, src](vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdType ncells = src->GetNumberOfCells(ptId);
+      array[ptId].ncells = ncells;
+      array[ptId].cells = new vtkIdType[ncells];
+      std::copy(src->GetCells(ptId), src->GetCells(ptId) + ncells,
+                array[ptId].cells);
+    }
+  });
+}
+
 //----------------------------------------------------------------------------
 void vtkCellLinks::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -40,6 +40,7 @@
 
 class vtkDataSet;
 class vtkCellArray;
+class vtkStaticCellLinks;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellLinks : public vtkAbstractCellLinks
 {
@@ -161,6 +162,12 @@ public:
    */
   void DeepCopy(vtkCellLinks *src);
 
+  /**
+   * Copy links built by vtkStaticCellLinks, so that they can be edited.
+   * The lists of cells keep their order.
+   */
+  void DeepCopy(vtkStaticCellLinks *src);
+
 protected:
   vtkCellLinks():Array(nullptr),Size(0),MaxId(-1),Extend(1000) {}
   ~vtkCellLinks() override;
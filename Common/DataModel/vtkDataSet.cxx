@@ -338,6 +338,13 @@ void vtkDataSet::GetCellBounds(vtkIdType cellId, double bounds[6])
   cell->Delete();
 }
 
+//----------------------------------------------------------------------------
+void vtkDataSet::PrepareForConcurrentReads()
+{
+  this->GetPointGhostArray();
+  this->GetCellGhostArray();
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSet::Squeeze()
 {
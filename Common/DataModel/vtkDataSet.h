@@ -180,6 +180,26 @@ public:
   virtual void GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                                 vtkIdList *cellIds);
 
+  /**
+   * Return whether the thread safe methods above that read the cells
+   * (GetCell() with a vtkGenericCell, GetCellBounds(), GetCellType() and
+   * GetCellPoints() with a vtkIdList) may be called by several threads at
+   * once, after PrepareForConcurrentReads() and as long as the dataset is
+   * not modified. Returns false by default: the datasets known to support it
+   * return true.
+   */
+  virtual bool SupportsConcurrentReads()
+    { return false; }
+
+  /**
+   * Build on a single thread what the first call to the methods reading the
+   * cells would build otherwise, such as the cells of polygonal data and the
+   * cached ghost arrays read by the blanking of structured data, so that
+   * several threads can then read the cells of a dataset that
+   * SupportsConcurrentReads(). The point to cell links are not built here.
+   */
+  virtual void PrepareForConcurrentReads();
+
   //@{
   /**
    * Locate the closest point to the global coordinate x. Return the
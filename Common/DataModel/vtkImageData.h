@@ -67,6 +67,7 @@ public:
   vtkCell *GetCell(int i, int j, int k) override;
   void GetCell(vtkIdType cellId, vtkGenericCell *cell) override;
   void GetCellBounds(vtkIdType cellId, double bounds[6]) override;
+  bool SupportsConcurrentReads() override { return true; }
   virtual vtkIdType FindPoint(double x, double y, double z)
   {
     return this->vtkDataSet::FindPoint(x, y, z);
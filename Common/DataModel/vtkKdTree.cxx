@@ -42,12 +42,16 @@
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkCallbackCommand.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
 #include <list>
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 namespace
 {
@@ -906,7 +910,7 @@ void vtkKdTree::BuildLocator()
 
     this->ProgressOffset += this->ProgressScale;
     this->ProgressScale = 0.7;
-    this->DivideRegion(kd, ptarray, nullptr, 0);
+    this->DivideRegionInParallel(kd, ptarray, nullptr);
 
     TIMERDONE("Build tree");
 
@@ -1235,6 +1239,26 @@ int vtkKdTree::DivideTest(int size, int level)
 }
 //----------------------------------------------------------------------------
 int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
+{
+  if (!this->SplitRegion(kd, c1, ids, level))
+  {
+    return 0;   // unable to divide region further
+  }
+
+  int nleft = kd->GetLeft()->GetNumberOfPoints();
+
+  int *leftIds  = ids;
+  int *rightIds = ids ? ids + nleft : nullptr;
+
+  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
+
+  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::SplitRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 {
   int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
 
@@ -1289,21 +1313,79 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 
   this->DoMedianFind(kd, c1, ids, dim1, dim2, dim3);
 
-  if (kd->GetLeft() == nullptr)
+  return kd->GetLeft() != nullptr;
+}
+
+//----------------------------------------------------------------------------
+// The regions of a level own disjoint ranges of the point array, and the
+// median find of a region only depends on its own range, so the regions
+// can be divided in any order.  The top levels, which have few regions,
+// are divided one level at a time.  Once there are enough regions to keep
+// the threads busy, their subtrees are built with the serial recursion.
+//
+void vtkKdTree::DivideRegionInParallel(vtkKdNode *kd, float *c1, int *ids)
+{
+  const int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+
+  if (numThreads < 2)
   {
-    return 0;   // unable to divide region further
+    this->DivideRegion(kd, c1, ids, 0);
+    return;
   }
 
-  int nleft = kd->GetLeft()->GetNumberOfPoints();
+  struct PendingRegion
+  {
+    vtkKdNode *Node;
+    int Offset;   // first point of the region in c1 and ids
+  };
 
-  int *leftIds  = ids;
-  int *rightIds = ids ? ids + nleft : nullptr;
+  std::vector<PendingRegion> regions(1, PendingRegion{kd, 0});
+  std::vector<PendingRegion> children;
+  std::vector<unsigned char> divided;
+  int level = 0;
 
-  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
+  while (!regions.empty() &&
+         regions.size() < static_cast<size_t>(4 * numThreads))
+  {
+    divided.assign(regions.size(), 0);
 
-  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(regions.size()), 1,
+      [&](vtkIdType begin, vtkIdType end)
+      {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          const PendingRegion &region = regions[i];
+          divided[i] = static_cast<unsigned char>(this->SplitRegion(
+            region.Node, c1 + 3*region.Offset,
+            ids ? ids + region.Offset : nullptr, level));
+        }
+      });
 
-  return 0;
+    children.clear();
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+      if (divided[i])
+      {
+        vtkKdNode *left = regions[i].Node->GetLeft();
+        children.push_back(PendingRegion{left, regions[i].Offset});
+        children.push_back(PendingRegion{regions[i].Node->GetRight(),
+          regions[i].Offset + left->GetNumberOfPoints()});
+      }
+    }
+    regions.swap(children);
+    level++;
+  }
+
+  vtkSMPTools::For(0, static_cast<vtkIdType>(regions.size()), 1,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const PendingRegion &region = regions[i];
+        this->DivideRegion(region.Node, c1 + 3*region.Offset,
+          ids ? ids + region.Offset : nullptr, level);
+      }
+    });
 }
 
 //----------------------------------------------------------------------------
@@ -1861,7 +1943,7 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints **ptArrays, int numPtArrays)
 
   TIMER("Build tree");
 
-  this->DivideRegion(kd, points, ptIds, 0);
+  this->DivideRegionInParallel(kd, points, ptIds);
 
   this->SetActualLevel();
   this->BuildRegionList();
@@ -2713,6 +2795,125 @@ void vtkKdTree::FindClosestNPoints(int N, const double x[3],
   orderedPoints.GetSortedIds(result);
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTree::FindClosestNPoints(int N, vtkPoints *points, vtkIdList *result)
+{
+  result->Reset();
+  if (N <= 0 || !points)
+  {
+    return;
+  }
+  if (!this->LocatorPoints)
+  {
+    vtkErrorMacro(<< "vtkKdTree::FindClosestNPoints - must build locator first");
+    return;
+  }
+
+  int numTotalPoints = this->Top->GetNumberOfPoints();
+  if (numTotalPoints < N)
+  {
+    vtkWarningMacro("Number of requested points is greater than total number of points in KdTree");
+    N = numTotalPoints;
+  }
+
+  vtkIdType numPoints = points->GetNumberOfPoints();
+  result->SetNumberOfIds(numPoints * N);
+  vtkIdType *resultIds = result->GetPointer(0);
+
+  vtkSMPThreadLocalObject<vtkIdList> localIds;
+  vtkSMPTools::For(0, numPoints,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *ids = localIds.Local();
+      double x[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        points->GetPoint(ptId, x);
+        this->FindClosestNPoints(N, x, ids);
+        std::copy(ids->GetPointer(0), ids->GetPointer(0) + N,
+                  resultIds + ptId * N);
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTree::FindPointsWithinRadius(double R, vtkPoints *points,
+                                       vtkIdList *result, vtkIdList *offsets)
+{
+  result->Reset();
+  offsets->Reset();
+  if (!points)
+  {
+    return;
+  }
+  if (!this->LocatorPoints)
+  {
+    vtkErrorMacro(<< "vtkKdTree::FindPointsWithinRadius - must build locator first");
+    return;
+  }
+
+  // Each thread keeps the ids found for the consecutive positions it
+  // queried, and the ids are gathered in the order of the positions once
+  // the offsets are known.
+
+  struct Chunk
+  {
+    vtkIdType Begin;
+    std::vector<vtkIdType> Ids;
+  };
+
+  vtkIdType numPoints = points->GetNumberOfPoints();
+  offsets->SetNumberOfIds(numPoints + 1);
+  vtkIdType *counts = offsets->GetPointer(0);
+  counts[numPoints] = 0;
+
+  vtkSMPThreadLocalObject<vtkIdList> localIds;
+  vtkSMPThreadLocal<std::vector<Chunk> > localChunks;
+  vtkSMPTools::For(0, numPoints,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *ids = localIds.Local();
+      std::vector<Chunk> &chunks = localChunks.Local();
+      chunks.push_back(Chunk());
+      Chunk &chunk = chunks.back();
+      chunk.Begin = begin;
+      double x[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        points->GetPoint(ptId, x);
+        this->FindPointsWithinRadius(R, x, ids);
+        vtkIdType numIds = ids->GetNumberOfIds();
+        counts[ptId] = numIds;
+        chunk.Ids.insert(chunk.Ids.end(), ids->GetPointer(0),
+                         ids->GetPointer(0) + numIds);
+      }
+    });
+
+  vtkSMPTools::ExclusiveScan(counts, counts + numPoints + 1, counts,
+                             static_cast<vtkIdType>(0));
+  result->SetNumberOfIds(counts[numPoints]);
+  vtkIdType *resultIds = result->GetPointer(0);
+
+  std::vector<Chunk*> allChunks;
+  for (std::vector<Chunk> &chunks : localChunks)
+  {
+    for (Chunk &chunk : chunks)
+    {
+      allChunks.push_back(&chunk);
+    }
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(allChunks.size()),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const Chunk *chunk = allChunks[i];
+        std::copy(chunk->Ids.begin(), chunk->Ids.end(),
+                  resultIds + counts[chunk->Begin]);
+      }
+    });
+}
+
 
 //----------------------------------------------------------------------------
 vtkIdTypeArray *vtkKdTree::GetPointsInRegion(int regionId)
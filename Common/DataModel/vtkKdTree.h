@@ -49,6 +49,15 @@
  *     tolerance, or you can use FindPoint and FindClosestPoint to
  *     locate points in the original set that the tree was built from.
  *
+ *     When several threads are available, the regions of each level of
+ *     the tree are divided concurrently with vtkSMPTools, and then the
+ *     deeper subtrees are built concurrently.  The regions own disjoint
+ *     ranges of the point array, so the tree is the same as the one built
+ *     by a single thread.  SelectCutDirection may then be called from
+ *     several threads at once.  FindClosestNPoints and
+ *     FindPointsWithinRadius also accept a batch of positions, which are
+ *     queried concurrently.
+ *
  * @sa
  *      vtkLocator vtkCellLocator vtkPKdTree
 */
@@ -558,6 +567,24 @@ public:
    */
   void FindClosestNPoints(int N, const double x[3], vtkIdList *result);
 
+  /**
+   * Find the closest N points to each of the given positions, querying
+   * several positions at a time with vtkSMPTools.  The result holds N ids
+   * per position, sorted from closest to farthest, one position after the
+   * other.  N is clamped to the number of points in the tree.
+   */
+  void FindClosestNPoints(int N, vtkPoints *points, vtkIdList *result);
+
+  /**
+   * Find all points within a specified radius R of each of the given
+   * positions, querying several positions at a time with vtkSMPTools.
+   * The ids found for position i are stored in result from index
+   * offsets->GetId(i) up to offsets->GetId(i+1), in the order given by
+   * FindPointsWithinRadius for a single position.
+   */
+  void FindPointsWithinRadius(double R, vtkPoints *points,
+                              vtkIdList *result, vtkIdList *offsets);
+
   /**
    * Get a list of the original IDs of all points in a region.  You
    * must have called BuildLocatorFromPoints before calling this.
@@ -785,6 +812,13 @@ protected:
 
   int DivideRegion(vtkKdNode *kd, float *c1, int *ids, int nlevels);
 
+  // Divide one region in two, without dividing its children.  Returns 1
+  // if the region was divided.
+  int SplitRegion(vtkKdNode *kd, float *c1, int *ids, int level);
+
+  // Same tree as DivideRegion(kd, c1, ids, 0), built with vtkSMPTools.
+  void DivideRegionInParallel(vtkKdNode *kd, float *c1, int *ids);
+
   void DoMedianFind(vtkKdNode *kd, float *c1, int *ids, int d1, int d2, int d3);
 
   void SelfRegister(vtkKdNode *kd);
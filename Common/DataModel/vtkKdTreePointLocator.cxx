@@ -62,6 +62,21 @@ void vtkKdTreePointLocator::FindPointsWithinRadius(double R, const double x[3],
   this->KdTree->FindPointsWithinRadius(R, x, result);
 }
 
+void vtkKdTreePointLocator::FindClosestNPoints(int N, vtkPoints *points,
+                                               vtkIdList* result)
+{
+  this->BuildLocator();
+  this->KdTree->FindClosestNPoints(N, points, result);
+}
+
+void vtkKdTreePointLocator::FindPointsWithinRadius(double R, vtkPoints *points,
+                                                   vtkIdList* result,
+                                                   vtkIdList* offsets)
+{
+  this->BuildLocator();
+  this->KdTree->FindPointsWithinRadius(R, points, result, offsets);
+}
+
 void vtkKdTreePointLocator::FreeSearchStructure()
 {
   if(this->KdTree)
@@ -31,6 +31,7 @@
 
 class vtkIdList;
 class vtkKdTree;
+class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkKdTreePointLocator : public vtkAbstractPointLocator
 {
@@ -75,6 +76,17 @@ public:
   void FindPointsWithinRadius(double R, const double x[3],
                               vtkIdList *result) override;
 
+  //@{
+  /**
+   * Query a batch of positions at a time with vtkSMPTools. See
+   * vtkKdTree::FindClosestNPoints and vtkKdTree::FindPointsWithinRadius
+   * for the layout of the results.
+   */
+  void FindClosestNPoints(int N, vtkPoints *points, vtkIdList *result);
+  void FindPointsWithinRadius(double R, vtkPoints *points,
+                              vtkIdList *result, vtkIdList *offsets);
+  //@}
+
   //@{
   /**
    * See vtkLocator interface documentation.
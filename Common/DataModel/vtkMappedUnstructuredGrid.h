@@ -76,7 +76,7 @@
  * implementation-dependent vtkUnstructuredGrid methods:
  * - vtkUnstructuredGrid::GetCellTypesArray()
  * - vtkUnstructuredGrid::GetCellLocationsArray()
- * - vtkUnstructuredGrid::GetCellLinks()
+ * - vtkUnstructuredGrid::GetCellLinks() and GetLinks()
  * - vtkUnstructuredGrid::GetCells()
  * Access to the values returned by these methods should be replaced by the
  * equivalent random-access lookup methods in the vtkUnstructuredGridBase API,
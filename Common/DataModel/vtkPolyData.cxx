@@ -30,6 +30,7 @@
 #include "vtkPolyVertex.h"
 #include "vtkPolygon.h"
 #include "vtkQuad.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleStrip.h"
 #include "vtkVertex.h"
@@ -60,7 +61,7 @@ vtkPolyData::vtkPolyData () :
   Vertex(nullptr), PolyVertex(nullptr), Line(nullptr), PolyLine(nullptr),
   Triangle(nullptr), Quad(nullptr), Polygon(nullptr), TriangleStrip(nullptr),
   EmptyCell(nullptr), Verts(nullptr), Lines(nullptr), Polys(nullptr),
-  Strips(nullptr), Cells(nullptr), Links(nullptr)
+  Strips(nullptr), Cells(nullptr), Links(nullptr), StaticLinks(nullptr)
 {
   this->Information->Set(vtkDataObject::DATA_EXTENT_TYPE(), VTK_PIECES_EXTENT);
   this->Information->Set(vtkDataObject::DATA_PIECE_NUMBER(), -1);
@@ -202,11 +203,7 @@ void vtkPolyData::CopyStructure(vtkDataSet *ds)
     this->Cells = nullptr;
   }
 
-  if ( this->Links )
-  {
-    this->Links->UnRegister(this);
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 }
 
 //----------------------------------------------------------------------------
@@ -339,7 +336,6 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
 void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
   vtkIdType       i, loc;
-  vtkIdType       *pts=nullptr;
   vtkIdType       numPts;
   unsigned char   type;
   double           x[3];
@@ -356,61 +352,49 @@ void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   {
     case VTK_VERTEX:
       cell->SetCellTypeToVertex();
-      this->Verts->GetCell(loc,numPts,pts);
       break;
 
     case VTK_POLY_VERTEX:
       cell->SetCellTypeToPolyVertex();
-      this->Verts->GetCell(loc,numPts,pts);
-      cell->PointIds->SetNumberOfIds(numPts); //reset number of points
-      cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_LINE:
       cell->SetCellTypeToLine();
-      this->Lines->GetCell(loc,numPts,pts);
       break;
 
     case VTK_POLY_LINE:
       cell->SetCellTypeToPolyLine();
-      this->Lines->GetCell(loc,numPts,pts);
-      cell->PointIds->SetNumberOfIds(numPts); //reset number of points
-      cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE:
       cell->SetCellTypeToTriangle();
-      this->Polys->GetCell(loc,numPts,pts);
       break;
 
     case VTK_QUAD:
       cell->SetCellTypeToQuad();
-      this->Polys->GetCell(loc,numPts,pts);
       break;
 
     case VTK_POLYGON:
       cell->SetCellTypeToPolygon();
-      this->Polys->GetCell(loc,numPts,pts);
-      cell->PointIds->SetNumberOfIds(numPts); //reset number of points
-      cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE_STRIP:
       cell->SetCellTypeToTriangleStrip();
-      this->Strips->GetCell(loc,numPts,pts);
-      cell->PointIds->SetNumberOfIds(numPts); //reset number of points
-      cell->Points->SetNumberOfPoints(numPts);
       break;
 
     default:
       cell->SetCellTypeToEmptyCell();
-      numPts = 0;
+      return;
   }
 
+  // The point ids are copied into the generic cell rather than read through
+  // a pointer, which with the split storage points to a copy.
+  this->GetCellArrayOfType(type)->GetCell(loc, cell->PointIds);
+  numPts = cell->PointIds->GetNumberOfIds();
+  cell->Points->SetNumberOfPoints(numPts);
   for (i=0; i < numPts; i++)
   {
-    cell->PointIds->SetId(i,pts[i]);
-    this->Points->GetPoint(pts[i], x);
+    this->Points->GetPoint(cell->PointIds->GetId(i), x);
     cell->Points->SetPoint(i, x);
   }
 }
@@ -562,6 +546,15 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyData::PrepareForConcurrentReads()
+{
+  if ( this->NeedToBuildCells() )
+  {
+    this->BuildCells();
+  }
+  this->Superclass::PrepareForConcurrentReads();
+}
 
 //----------------------------------------------------------------------------
 void vtkPolyData::ComputeBounds()
@@ -805,11 +798,7 @@ void vtkPolyData::Cleanup()
     this->Cells = nullptr;
   }
 
-  if ( this->Links )
-  {
-    this->Links->UnRegister(this);
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 }
 
 //----------------------------------------------------------------------------
@@ -905,11 +894,7 @@ vtkIdType vtkPolyData::GetNumberOfStrips()
 void vtkPolyData::DeleteCells()
 {
   // if we have Links, we need to delete them (they are no longer valid)
-  if (this->Links)
-  {
-    this->Links->UnRegister( this );
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 
   if (this->Cells)
   {
@@ -918,6 +903,25 @@ void vtkPolyData::DeleteCells()
   }
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Return the legacy array of the cells, or nullptr with the split storage,
+// which is read through the cell sizes rather than converted.
+const vtkIdType *GetLegacyCells(vtkCellArray *cells)
+{
+  return cells->GetStorageMode() == vtkCellArray::LEGACY_STORAGE ?
+    cells->GetPointer() : nullptr;
+}
+
+// Return the number of points of the cell cellId at location loc.
+inline vtkIdType GetCellSize(vtkCellArray *cells, const vtkIdType *legacy,
+                             vtkIdType cellId, vtkIdType loc)
+{
+  return legacy ? legacy[loc] : cells->GetCellSize(cellId);
+}
+}
+
 //----------------------------------------------------------------------------
 // Create data structure that allows random access of cells.
 void vtkPolyData::BuildCells()
@@ -953,14 +957,14 @@ void vtkPolyData::BuildCells()
   vtkIdType nextCellPts;
   if (nVerts)
   {
-    vtkIdType *pVerts = vertCells->GetData()->GetPointer(0);
-    numCellPts = pVerts[0];
+    const vtkIdType *pVerts = GetLegacyCells(vertCells);
+    numCellPts = GetCellSize(vertCells, pVerts, 0, 0);
     nextCellPts = numCellPts + 1;
     pLocs[0] = 0;
     pTypes[0] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
     for (vtkIdType i = 1; i < nVerts; ++i)
     {
-      numCellPts = pVerts[nextCellPts];
+      numCellPts = GetCellSize(vertCells, pVerts, i, nextCellPts);
       pLocs[i] = nextCellPts;
       pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
       nextCellPts += numCellPts + 1;
@@ -972,8 +976,8 @@ void vtkPolyData::BuildCells()
   // lines
   if (nLines)
   {
-    vtkIdType *pLines = lineCells->GetData()->GetPointer(0);
-    numCellPts = pLines[0];
+    const vtkIdType *pLines = GetLegacyCells(lineCells);
+    numCellPts = GetCellSize(lineCells, pLines, 0, 0);
     pLocs[0] = 0;
     pTypes[0] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
     if (numCellPts == 1)
@@ -984,7 +988,7 @@ void vtkPolyData::BuildCells()
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nLines; ++i)
     {
-      numCellPts = pLines[nextCellPts];
+      numCellPts = GetCellSize(lineCells, pLines, i, nextCellPts);
       pLocs[i] = nextCellPts;
       pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
       if (numCellPts == 1)
@@ -1001,8 +1005,8 @@ void vtkPolyData::BuildCells()
   // polys
   if (nPolys)
   {
-    vtkIdType *pPolys = polyCells->GetData()->GetPointer(0);
-    numCellPts = pPolys[0];
+    const vtkIdType *pPolys = GetLegacyCells(polyCells);
+    numCellPts = GetCellSize(polyCells, pPolys, 0, 0);
     pLocs[0] = 0;
     if (numCellPts < 3)
     {
@@ -1014,7 +1018,7 @@ void vtkPolyData::BuildCells()
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nPolys; ++i)
     {
-      numCellPts = pPolys[nextCellPts];
+      numCellPts = GetCellSize(polyCells, pPolys, i, nextCellPts);
       pLocs[i] = nextCellPts;
       if (numCellPts < 3)
       {
@@ -1034,13 +1038,13 @@ void vtkPolyData::BuildCells()
   if (nStrips)
   {
     std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
-    vtkIdType *pStrips = stripCells->GetData()->GetPointer(0);
-    numCellPts = pStrips[0];
+    const vtkIdType *pStrips = GetLegacyCells(stripCells);
+    numCellPts = GetCellSize(stripCells, pStrips, 0, 0);
     pLocs[0] = 0;
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nStrips; ++i)
     {
-      numCellPts = pStrips[nextCellPts];
+      numCellPts = GetCellSize(stripCells, pStrips, i, nextCellPts);
       pLocs[i] = nextCellPts;
       nextCellPts += numCellPts + 1;
     }
@@ -1063,63 +1067,110 @@ void vtkPolyData::DeleteLinks()
     this->Links->UnRegister( this );
     this->Links = nullptr;
   }
+  if (this->StaticLinks)
+  {
+    this->StaticLinks->UnRegister( this );
+    this->StaticLinks = nullptr;
+  }
 }
 
 //----------------------------------------------------------------------------
 // Create upward links from points to cells that use each point. Enables
-// topologically complex queries.
+// topologically complex queries. Unless an initial size is given for links
+// that are going to be edited, static links are built; they are converted
+// to editable links by the first operation that edits them.
 void vtkPolyData::BuildLinks(int initialSize)
 {
-  if ( this->Links )
-  {
-    this->DeleteLinks();
-  }
+  this->DeleteLinks();
 
   if ( this->Cells == nullptr )
   {
     this->BuildCells();
   }
 
-  this->Links = vtkCellLinks::New();
   if ( initialSize > 0 )
   {
+    this->Links = vtkCellLinks::New();
     this->Links->Allocate(initialSize);
+    this->Links->Register(this);
+    this->Links->Delete();
+
+    this->Links->BuildLinks(this);
+    return;
   }
-  else
+
+  this->StaticLinks = vtkStaticCellLinks::New();
+  this->StaticLinks->Register(this);
+  this->StaticLinks->Delete();
+
+  this->StaticLinks->BuildLinks(this);
+}
+
+//----------------------------------------------------------------------------
+// Convert static links into editable links. The static links are released.
+void vtkPolyData::MakeLinksEditable()
+{
+  if ( ! this->StaticLinks )
   {
-    this->Links->Allocate(this->GetNumberOfPoints());
+    return;
   }
+
+  this->Links = vtkCellLinks::New();
   this->Links->Register(this);
   this->Links->Delete();
+  this->Links->DeepCopy(this->StaticLinks);
 
-  this->Links->BuildLinks(this);
+  this->StaticLinks->UnRegister(this);
+  this->StaticLinks = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
+                                vtkIdType* &cells)
+{
+  vtkIdType numCells;
+  this->GetPointCells(ptId, numCells, cells);
+  if ( numCells > VTK_UNSIGNED_SHORT_MAX )
+  {
+    vtkErrorMacro("Point " << ptId << " is used by " << numCells
+                  << " cells, more than an unsigned short can count");
+    numCells = VTK_UNSIGNED_SHORT_MAX;
+  }
+  ncells = static_cast<unsigned short>(numCells);
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::GetLinkedCells(vtkIdType ptId, vtkIdType &ncells,
+                                 vtkIdType* &cells)
+{
+  if ( this->StaticLinks )
+  {
+    ncells = this->StaticLinks->GetNumberOfCells(ptId);
+    // Static links are never edited in place; see MakeLinksEditable().
+    cells = const_cast<vtkIdType *>(this->StaticLinks->GetCells(ptId));
+  }
+  else
+  {
+    ncells = this->Links->GetNcells(ptId);
+    cells = this->Links->GetCells(ptId);
+  }
 }
 
 //----------------------------------------------------------------------------
 // Copy a cells point ids into list provided. (Less efficient.)
 void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i;
-  vtkIdType *pts, npts;
-
   ptIds->Reset();
   if ( this->Cells == nullptr )
   {
     this->BuildCells();
   }
 
-  this->vtkPolyData::GetCellPoints(cellId, npts, pts);
-  if ( npts < 1 )
+  vtkCellArray *cells =
+    this->GetCellArrayOfType(this->Cells->GetCellType(cellId));
+  if ( cells )
   {
-    ptIds->Reset();
-  }
-  else
-  {
-    ptIds->InsertId(npts-1,pts[npts-1]);
-    for (i=0; i<npts-1; i++)
-    {
-      ptIds->SetId(i,pts[i]);
-    }
+    cells->GetCell(this->Cells->GetCellLocation(cellId), ptIds);
   }
 }
 
@@ -1130,14 +1181,13 @@ void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
   vtkIdType numCells;
   vtkIdType i;
 
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  this->GetLinkedCells(ptId, numCells, cells);
 
   for (i=0; i < numCells; i++)
   {
@@ -1467,6 +1517,7 @@ void vtkPolyData::ReverseCell(vtkIdType cellId)
 // use this method, make sure points are available and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 {
+  this->MakeLinksEditable();
   return this->Links->InsertNextPoint(numLinks);
 }
 
@@ -1477,6 +1528,7 @@ vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 // and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(double x[3], int numLinks)
 {
+  this->MakeLinksEditable();
   this->Links->InsertNextPoint(numLinks);
   return this->Points->InsertNextPoint(x);
 }
@@ -1489,6 +1541,7 @@ vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, const vtkIdType
 {
   vtkIdType i, id;
 
+  this->MakeLinksEditable();
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
@@ -1507,6 +1560,7 @@ vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, const vtkIdType
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
+  this->MakeLinksEditable();
   this->Links->RemoveCellReference(cellId, ptId);
 }
 
@@ -1517,6 +1571,7 @@ void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
+  this->MakeLinksEditable();
   this->Links->AddCellReference(cellId, ptId);
 }
 
@@ -1569,6 +1624,7 @@ void vtkPolyData::ReplaceCell(vtkIdType cellId, int npts, const vtkIdType pts[])
 // link list is changing size.
 void vtkPolyData::ReplaceLinkedCell(vtkIdType cellId, int npts, const vtkIdType pts[])
 {
+  this->MakeLinksEditable();
   vtkIdType loc = this->Cells->GetCellLocation(cellId);
   int type = this->Cells->GetCellType(cellId);
 
@@ -1609,14 +1665,16 @@ void vtkPolyData::GetCellEdgeNeighbors(vtkIdType cellId, vtkIdType p1,
 {
   cellIds->Reset();
 
-  const vtkCellLinks::Link &link1(this->Links->GetLink(p1));
-  const vtkCellLinks::Link &link2(this->Links->GetLink(p2));
+  vtkIdType ncells1, ncells2;
+  vtkIdType *linkedCells1, *linkedCells2;
+  this->GetLinkedCells(p1, ncells1, linkedCells1);
+  this->GetLinkedCells(p2, ncells2, linkedCells2);
 
-  const vtkIdType *cells1 = link1.cells;
-  const vtkIdType *cells1End = cells1 + link1.ncells;
+  const vtkIdType *cells1 = linkedCells1;
+  const vtkIdType *cells1End = cells1 + ncells1;
 
-  const vtkIdType *cells2 = link2.cells;
-  const vtkIdType *cells2End = cells2 + link2.ncells;
+  const vtkIdType *cells2 = linkedCells2;
+  const vtkIdType *cells2End = cells2 + ncells2;
 
   while (cells1 != cells1End)
   {
@@ -1644,7 +1702,7 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
   vtkIdType i, j, numPts, cellNum;
   int allFound, oneFound;
 
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
@@ -1653,8 +1711,9 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   // load list with candidate cells, remove current cell
   vtkIdType ptId = ptIds->GetId(0);
-  int numPrime = this->Links->GetNcells(ptId);
-  vtkIdType *primeCells = this->Links->GetCells(ptId);
+  vtkIdType numPrime;
+  vtkIdType *primeCells;
+  this->GetLinkedCells(ptId, numPrime, primeCells);
   numPts = ptIds->GetNumberOfIds();
 
   // for each potential cell
@@ -1667,8 +1726,9 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
       for (allFound=1, i=1; i < numPts && allFound; i++)
       {
         ptId = ptIds->GetId(i);
-        int numCurrent = this->Links->GetNcells(ptId);
-        vtkIdType *currentCells = this->Links->GetCells(ptId);
+        vtkIdType numCurrent;
+        vtkIdType *currentCells;
+        this->GetLinkedCells(ptId, numCurrent, currentCells);
         oneFound = 0;
         for (j = 0; j < numCurrent; j++)
         {
@@ -1693,7 +1753,7 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
 int vtkPolyData::IsEdge(vtkIdType p1, vtkIdType p2)
 {
-  unsigned short int ncells;
+  vtkIdType ncells;
   vtkIdType cellType;
   vtkIdType npts;
   vtkIdType i, j;
@@ -1794,6 +1854,10 @@ unsigned long vtkPolyData::GetActualMemorySize()
   {
     size += this->Links->GetActualMemorySize();
   }
+  if ( this->StaticLinks )
+  {
+    size += this->StaticLinks->GetActualMemorySize();
+  }
   return size;
 }
 
@@ -1831,6 +1895,16 @@ void vtkPolyData::ShallowCopy(vtkDataObject *dataObject)
     {
       this->Links->Register(this);
     }
+
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Delete();
+    }
+    this->StaticLinks = polyData->StaticLinks;
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Register(this);
+    }
   }
 
   // Do superclass
@@ -1880,12 +1954,8 @@ void vtkPolyData::DeepCopy(vtkDataObject *dataObject)
       this->BuildCells();
     }
 
-    if ( this->Links )
-    {
-      this->Links->UnRegister(this);
-      this->Links = nullptr;
-    }
-    if (polyData->Links)
+    this->DeleteLinks();
+    if (polyData->Links || polyData->StaticLinks)
     {
       this->BuildLinks();
     }
@@ -2141,7 +2211,7 @@ int vtkPolyData::GetScalarFieldCriticalIndex (vtkIdType pointId,
     return vtkPolyData::ERR_INCORRECT_FIELD;
 
   /* make sure the connectivity is built */
-  if(!this->Links) this->BuildLinks();
+  if(!this->Links && !this->StaticLinks) this->BuildLinks();
 
   /* build the lower and upper links */
   this->GetPointCells(pointId, starTriangleList);
@@ -74,6 +74,7 @@ class vtkQuad;
 class vtkPolygon;
 class vtkTriangleStrip;
 class vtkEmptyCell;
+class vtkStaticCellLinks;
 struct vtkPolyDataDummyContainter;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkPolyData : public vtkPointSet
@@ -106,6 +107,8 @@ public:
   void GetCellBounds(vtkIdType cellId, double bounds[6]) override;
   void GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                         vtkIdList *cellIds) override;
+  bool SupportsConcurrentReads() override { return true; }
+  void PrepareForConcurrentReads() override;
   //@}
 
   /**
@@ -263,9 +266,13 @@ public:
 
   /**
    * Create upward links from points to cells that use each point. Enables
-   * topologically complex queries. Normally the links array is allocated
-   * based on the number of points in the vtkPolyData. The optional
-   * initialSize parameter can be used to allocate a larger size initially.
+   * topologically complex queries. Normally static links (see
+   * vtkStaticCellLinks) are built, with several threads when available;
+   * they are compact and fast to query, and are converted to editable
+   * vtkCellLinks by the first method that edits the links (e.g.,
+   * InsertNextLinkedCell(), ReplaceLinkedCell() or ResizeCellList()). The
+   * optional initialSize parameter builds editable links directly, with a
+   * larger initial size for the points that are going to be added.
    */
   void BuildLinks(int initialSize=0);
 
@@ -281,11 +288,18 @@ public:
    */
   void DeleteLinks();
 
+  //@{
   /**
-   * Special (efficient) operations on poly data. Use carefully.
+   * Special (efficient) operations on poly data. Use carefully. The links
+   * must have been built. The unsigned short overload is kept for
+   * compatibility: for a point used by more cells than it can count, it
+   * reports an error and returns the first VTK_UNSIGNED_SHORT_MAX cells.
    */
+  void GetPointCells(vtkIdType ptId, vtkIdType& ncells,
+                     vtkIdType* &cells) VTK_SIZEHINT(cells, ncells);
   void GetPointCells(vtkIdType ptId, unsigned short& ncells,
                      vtkIdType* &cells) VTK_SIZEHINT(cells, ncells);
+  //@}
 
   /**
    * Get the neighbors at an edge. More efficient than the general
@@ -564,6 +578,12 @@ protected:
   // built only when necessary
   vtkCellTypes *Cells;
   vtkCellLinks *Links;
+  vtkStaticCellLinks *StaticLinks;
+
+  /**
+   * Convert the static links, if any, into editable links.
+   */
+  void MakeLinksEditable();
 
 private:
   // Hide these from the user and the compiler.
@@ -576,21 +596,34 @@ private:
 
   void Cleanup();
 
+  // Get the cells using a point from the static or editable links.
+  void GetLinkedCells(vtkIdType ptId, vtkIdType &ncells, vtkIdType* &cells);
+
+  // Return the cell array holding the cells of the given type, or nullptr.
+  vtkCellArray *GetCellArrayOfType(unsigned char type);
+
 private:
   vtkPolyData(const vtkPolyData&) = delete;
   void operator=(const vtkPolyData&) = delete;
 };
 
-inline void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
+inline void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdType& ncells,
                                        vtkIdType* &cells)
 {
-  ncells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  if ( this->StaticLinks )
+  {
+    this->GetLinkedCells(ptId, ncells, cells);
+  }
+  else
+  {
+    ncells = this->Links->GetNcells(ptId);
+    cells = this->Links->GetCells(ptId);
+  }
 }
 
 inline int vtkPolyData::IsTriangle(int v1, int v2, int v3)
 {
-  unsigned short int n1;
+  vtkIdType n1;
   int i, j, tVerts[3];
   vtkIdType *cells, *tVerts2, n2;
 
@@ -636,6 +669,10 @@ inline int vtkPolyData::IsPointUsedByCell(vtkIdType ptId, vtkIdType cellId)
 
 inline void vtkPolyData::DeletePoint(vtkIdType ptId)
 {
+  if ( this->StaticLinks )
+  {
+    this->MakeLinksEditable();
+  }
   this->Links->DeletePoint(ptId);
 }
 
@@ -648,6 +685,10 @@ inline void vtkPolyData::RemoveCellReference(vtkIdType cellId)
 {
   vtkIdType *pts, npts;
 
+  if ( this->StaticLinks )
+  {
+    this->MakeLinksEditable();
+  }
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
@@ -659,6 +700,10 @@ inline void vtkPolyData::AddCellReference(vtkIdType cellId)
 {
   vtkIdType *pts, npts;
 
+  if ( this->StaticLinks )
+  {
+    this->MakeLinksEditable();
+  }
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
@@ -668,6 +713,10 @@ inline void vtkPolyData::AddCellReference(vtkIdType cellId)
 
 inline void vtkPolyData::ResizeCellList(vtkIdType ptId, int size)
 {
+  if ( this->StaticLinks )
+  {
+    this->MakeLinksEditable();
+  }
   this->Links->ResizeCellList(ptId,size);
 }
 
@@ -683,11 +732,39 @@ inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
     if ( verts[i] == oldPtId )
     {
       verts[i] = newPtId; // this is very nasty! direct write!
+      vtkCellArray *cells =
+        this->GetCellArrayOfType(this->Cells->GetCellType(cellId));
+      if ( !cells->IsStorageShareable() )
+      {
+        // verts is a copy of the point ids: store it back into the cells.
+        cells->ReplaceCell(this->Cells->GetCellLocation(cellId), nverts, verts);
+      }
       return;
     }
   }
 }
 
+inline vtkCellArray *vtkPolyData::GetCellArrayOfType(unsigned char type)
+{
+  switch (type)
+  {
+    case VTK_VERTEX: case VTK_POLY_VERTEX:
+      return this->Verts;
+
+    case VTK_LINE: case VTK_POLY_LINE:
+      return this->Lines;
+
+    case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
+      return this->Polys;
+
+    case VTK_TRIANGLE_STRIP:
+      return this->Strips;
+
+    default:
+      return nullptr;
+  }
+}
+
 inline unsigned char vtkPolyData::GetCellPoints(
     vtkIdType cellId, vtkIdType& npts, vtkIdType* &pts)
 {
@@ -751,7 +828,7 @@ inline unsigned char vtkPolyData::GetCell(
       return 0;
   }
   int loc = this->Cells->GetCellLocation(cellId);
-  cell = cells->GetData()->GetPointer(loc);
+  cell = cells->GetLegacyCell(loc);
   return type;
 }
 
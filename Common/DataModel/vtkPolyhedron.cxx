@@ -32,6 +32,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkVector.h"
 #include "vtkMath.h"
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -156,6 +157,7 @@ vtkPolyhedron::vtkPolyhedron()
   this->GlobalFaces = vtkIdTypeArray::New();
   this->FaceLocations = vtkIdTypeArray::New();
   this->PointIdMap = new vtkPointIdMap;
+  this->PointIdMapGenerated = 0;
 
   this->EdgesGenerated = 0;
   this->EdgeTable = vtkEdgeTable::New();
@@ -303,18 +305,9 @@ ComputePositionFromParametricCoordinate(const double pc[3], double x[3])
 // points, point ids, and faces have been loaded.
 void vtkPolyhedron::Initialize()
 {
-  // Clear out any remaining memory.
-  this->PointIdMap->clear();
-
-  // We need to create a reverse map from the point ids to their canonical cell
-  // ids. This is a fancy way of saying that we have to be able to rapidly go
-  // from a PointId[i] to the location i in the cell.
-  vtkIdType i, id, numPointIds = this->PointIds->GetNumberOfIds();
-  for (i = 0; i < numPointIds; ++i)
-  {
-    id = this->PointIds->GetId(i);
-    (*this->PointIdMap)[id] = i;
-  }
+  // The map from the point ids to their canonical cell ids is rebuilt when
+  // needed.
+  this->PointIdMapGenerated = 0;
 
   // Edges have to be reset
   this->EdgesGenerated = 0;
@@ -339,6 +332,28 @@ void vtkPolyhedron::Initialize()
   this->LocatorConstructed = 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyhedron::GeneratePointIdMap()
+{
+  if (this->PointIdMapGenerated)
+  {
+    return;
+  }
+
+  // We need to create a reverse map from the point ids to their canonical cell
+  // ids. This is a fancy way of saying that we have to be able to rapidly go
+  // from a PointId[i] to the location i in the cell.
+  this->PointIdMap->clear();
+  vtkIdType i, id, numPointIds = this->PointIds->GetNumberOfIds();
+  for (i = 0; i < numPointIds; ++i)
+  {
+    id = this->PointIds->GetId(i);
+    (*this->PointIdMap)[id] = i;
+  }
+
+  this->PointIdMapGenerated = 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkPolyhedron::GetNumberOfEdges()
 {
@@ -398,6 +413,8 @@ int vtkPolyhedron::GenerateEdges()
     return 0;
   }
 
+  this->GeneratePointIdMap();
+
   // Loop over all faces, inserting edges into the table
   vtkIdType *faces = this->GlobalFaces->GetPointer(0);
   vtkIdType nfaces = faces[0];
@@ -465,6 +482,7 @@ void vtkPolyhedron::GenerateFaces()
 
   // Basically we just run through the faces and change the global ids to the
   // canonical ids using the PointIdMap.
+  this->GeneratePointIdMap();
   this->Faces->SetNumberOfTuples(this->GlobalFaces->GetNumberOfTuples());
   vtkIdType *gFaces = this->GlobalFaces->GetPointer(0);
   vtkIdType *faces = this->Faces->GetPointer(0);
@@ -501,9 +519,11 @@ vtkCell *vtkPolyhedron::GetFace(int faceId)
 
   this->GenerateFaces();
 
-  // Okay load up the polygon
-  vtkIdType i, p, loc = this->FaceLocations->GetValue(faceId);
+  // Okay load up the polygon. The canonical faces are laid out as the
+  // global ones.
+  vtkIdType i, loc = this->FaceLocations->GetValue(faceId);
   vtkIdType *face = this->GlobalFaces->GetPointer(loc);
+  vtkIdType *localFace = this->Faces->GetPointer(loc);
 
   this->Polygon->PointIds->SetNumberOfIds(face[0]);
   this->Polygon->Points->SetNumberOfPoints(face[0]);
@@ -512,8 +532,7 @@ vtkCell *vtkPolyhedron::GetFace(int faceId)
   for (i = 0; i < face[0]; ++i)
   {
     this->Polygon->PointIds->SetId(i, face[i + 1]);
-    p = (*this->PointIdMap)[face[i + 1]];
-    this->Polygon->Points->SetPoint(i, this->Points->GetPoint(p));
+    this->Polygon->Points->SetPoint(i, this->Points->GetPoint(localFace[i + 1]));
   }
 
   return this->Polygon;
@@ -555,6 +574,30 @@ void vtkPolyhedron::SetFaces(vtkIdType *faces)
   } //for all faces
 }
 
+//----------------------------------------------------------------------------
+// Load the canonical faces and the edges computed beforehand.
+void vtkPolyhedron::SetTopology(const vtkIdType *faces, vtkIdType numEdges,
+                                const vtkIdType *edges,
+                                const vtkIdType *edgeFaces)
+{
+  vtkIdType size = this->GlobalFaces->GetNumberOfTuples();
+  if (!faces || size == 0)
+  {
+    return;
+  }
+
+  this->Faces->SetNumberOfTuples(size);
+  std::copy(faces, faces + size, this->Faces->GetPointer(0));
+  this->FacesGenerated = 1;
+
+  this->EdgeTable->Reset();
+  this->Edges->SetNumberOfTuples(numEdges);
+  this->EdgeFaces->SetNumberOfTuples(numEdges);
+  std::copy(edges, edges + 2*numEdges, this->Edges->GetPointer(0));
+  std::copy(edgeFaces, edgeFaces + 2*numEdges, this->EdgeFaces->GetPointer(0));
+  this->EdgesGenerated = 1;
+}
+
 //----------------------------------------------------------------------------
 // Return the list of faces for this cell.
 vtkIdType *vtkPolyhedron::GetFaces()
@@ -803,7 +846,7 @@ bool vtkPolyhedron::IsConvex()
 {
   double x[2][3], n[3], c[3], c0[3], c1[3], c0p[3], c1p[3], n0[3], n1[3];
   double n0p[3], n1p[3], np[3], tmp0, tmp1;
-  vtkIdType i, w[2], p0, p1, edgeId, edgeFaces[2], loc, v, *face, r = 0;
+  vtkIdType i, w[2], edgeId, edgeFaces[2], loc, v, *face, r = 0;
   const double eps = FLT_EPSILON;
 
   std::vector<double> p(this->PointIds->GetNumberOfIds());
@@ -815,32 +858,31 @@ bool vtkPolyhedron::IsConvex()
   this->ConstructPolyData();
   this->ComputeBounds();
 
-  // loop over all edges in the polyhedron
-  this->EdgeTable->InitTraversal();
-  while ((edgeId = this->EdgeTable->GetNextEdge(w[0], w[1])) >= 0)
+  // loop over all edges in the polyhedron. The result does not depend on
+  // the order of the edges.
+  vtkIdType numEdges = this->Edges->GetNumberOfTuples();
+  for (edgeId = 0; edgeId < numEdges; ++edgeId)
   {
-    // get the global point ids
-    p0 = this->PointIds->GetId(w[0]);
-    p1 = this->PointIds->GetId(w[1]);
+    this->Edges->GetTypedTuple(edgeId, w);
 
-    // get the edge points
-    this->Points->GetPoint(p0, x[0]);
-    this->Points->GetPoint(p1, x[1]);
+    // get the edge points, which are indexed by canonical ids
+    this->Points->GetPoint(w[0], x[0]);
+    this->Points->GetPoint(w[1], x[1]);
 
     // get the local face ids
     this->EdgeFaces->GetTypedTuple(edgeId, edgeFaces);
 
-    // get the face vertex ids for the first face
+    // get the canonical face vertex ids for the first face
     loc = this->FaceLocations->GetValue(edgeFaces[0]);
-    face = this->GlobalFaces->GetPointer(loc);
+    face = this->Faces->GetPointer(loc);
 
     // compute the centroid and normal for the first face
     vtkPolygon::ComputeCentroid(this->Points, face[0], face + 1, c0);
     vtkPolygon::ComputeNormal(this->Points, face[0], face + 1, n0);
 
-    // get the face vertex ids for the second face
+    // get the canonical face vertex ids for the second face
     loc = this->FaceLocations->GetValue(edgeFaces[1]);
-    face = this->GlobalFaces->GetPointer(loc);
+    face = this->Faces->GetPointer(loc);
 
     // compute the centroid and normal for the second face
     vtkPolygon::ComputeCentroid(this->Points, face[0], face + 1, c1);
@@ -1861,6 +1903,8 @@ void vtkPolyhedron::Contour(double value,
   vtkIdType cellId,
   vtkCellData *outCd)
 {
+  this->GeneratePointIdMap();
+
   EdgeFaceSetMap edgeFaceMap;
   FaceEdgesVector faceEdgesVector;
   PointIndexEdgeMultiMap contourPointEdgeMultiMap;
@@ -2154,6 +2198,8 @@ void vtkPolyhedron::Clip(double value,
   vtkCellData *outCd,
   int insideOut)
 {
+  this->GeneratePointIdMap();
+
   // set the compare function
   function<bool(double, double)> c = [insideOut](double a, double b)
   {
@@ -216,6 +216,18 @@ public:
   vtkIdType *GetFaces() override;
   //@}
 
+  /**
+   * Load the faces in canonical (local) point ids, laid out as in
+   * SetFaces(), and the edges as pairs of canonical point ids with the two
+   * faces using each of them, numbered as GenerateEdges() does. It must be
+   * called after SetFaces() and Initialize(). Datasets that precompute the
+   * topology of all their polyhedra (see
+   * vtkUnstructuredGrid::BuildPolyhedronTopology()) use it so that the edges
+   * and faces are not generated again every time a cell is fetched.
+   */
+  void SetTopology(const vtkIdType *faces, vtkIdType numEdges,
+                   const vtkIdType *edges, const vtkIdType *edgeFaces);
+
   /**
    * A method particular to vtkPolyhedron. It determines whether a point x[3]
    * is inside the polyhedron or not (returns 1 is the point is inside, 0
@@ -254,8 +266,10 @@ protected:
   // (global cell ids corresponding to cell canonical numbering (0,1,2,....)).
   // These data members are implicitly organized in canonical space, i.e., where
   // the cell point ids are (0,1,...,npts-1). The PointIdMap maps global point id
-  // back to these canonoical point ids.
+  // back to these canonoical point ids. It is only built when needed.
   vtkPointIdMap  *PointIdMap;
+  int             PointIdMapGenerated;
+  void            GeneratePointIdMap();
 
   // If edges are needed. Note that the edge numbering is in
   // canonical space.
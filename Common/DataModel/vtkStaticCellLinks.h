@@ -70,6 +70,12 @@ public:
   void BuildLinks(vtkDataSet *ds) override
     {this->Impl->BuildLinks(ds);}
 
+  /**
+   * Get the number of points for which links were built.
+   */
+  vtkIdType GetNumberOfPoints()
+    {return this->Impl->GetNumberOfPoints();}
+
   /**
    * Get the number of cells using the point specified by ptId.
    */
@@ -95,6 +101,12 @@ public:
   void Initialize()
     {this->Impl->Initialize();}
 
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize()
+    {return this->Impl->GetActualMemorySize();}
+
 protected:
   vtkStaticCellLinks();
   ~vtkStaticCellLinks() override;
@@ -38,6 +38,14 @@
  * although it uses vtkIdType and thereby loses some speed and memory
  * advantage.
  *
+ * The links of polygonal data and unstructured grids are built with
+ * vtkSMPTools when several threads are available: the uses of each point
+ * are counted concurrently, the counts are turned into offsets with a
+ * parallel scan, and the cell ids are then scattered concurrently. In
+ * either case, the cells using a point are listed in increasing order, as
+ * in vtkCellLinks. Cell arrays with the split storage of vtkCellArray are
+ * read serially.
+ *
  * @sa
  * vtkCellLinks vtkStaticCellLinks
 */
@@ -89,6 +97,14 @@ public:
    */
   void BuildLinks(vtkUnstructuredGrid *ugrid);
 
+  /**
+   * Get the number of points for which links were built.
+   */
+  vtkIdType GetNumberOfPoints()
+  {
+      return this->NumPts;
+  }
+
   /**
    * Get the number of cells using the point specified by ptId.
    */
@@ -105,6 +121,11 @@ public:
       return this->Links + this->Offsets[ptId];
   }
 
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize();
+
 protected:
   // The various templated data members
   TIds LinksSize;
@@ -115,6 +136,11 @@ protected:
   TIds *Links; //contiguous runs of cell ids
   TIds *Offsets; //offsets for each point into the link array
 
+  // Build the links from an accessor to the points of the cells, with
+  // several threads if threaded is true. NumPts and NumCells must be set.
+  template <typename TCells>
+  void BuildLinksFromCells(const TCells& cells, bool threaded);
+
 private:
   vtkStaticCellLinksTemplate(const vtkStaticCellLinksTemplate&) = delete;
   void operator=(const vtkStaticCellLinksTemplate&) = delete;
@@ -19,14 +19,71 @@
 
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
+#include "vtkIdList.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Accessors to the points of the cells. Visit() calls visitor(ptId) for each
+// point of a cell.
+namespace vtk
+{
+namespace detail
+{
+namespace links
+{
+
+// Cells of polydata and unstructured grids. This is thread-safe when the
+// cell arrays have the legacy storage.
+template <typename TDataSet>
+struct vtkStaticCellLinks_CellPoints
+{
+  TDataSet *DataSet;
+
+  vtkStaticCellLinks_CellPoints(TDataSet *ds) : DataSet(ds) {}
+
+  template <typename Visitor>
+  void Visit(vtkIdType cellId, const Visitor &visitor) const
+  {
+    vtkIdType npts, *pts;
+    this->DataSet->GetCellPoints(cellId, npts, pts);
+    for (vtkIdType i=0; i < npts; ++i)
+    {
+      visitor(pts[i]);
+    }
+  }
+};
+
+// Cells of any other dataset. This is not thread-safe.
+struct vtkStaticCellLinks_CellPointIds
+{
+  vtkDataSet *DataSet;
+  vtkIdList *PointIds;
+
+  vtkStaticCellLinks_CellPointIds(vtkDataSet *ds, vtkIdList *ptIds) :
+    DataSet(ds), PointIds(ptIds) {}
+
+  template <typename Visitor>
+  void Visit(vtkIdType cellId, const Visitor &visitor) const
+  {
+    this->DataSet->GetCellPoints(cellId, this->PointIds);
+    vtkIdType npts = this->PointIds->GetNumberOfIds();
+    for (vtkIdType i=0; i < npts; ++i)
+    {
+      visitor(this->PointIds->GetId(i));
+    }
+  }
+};
+
+} // namespace links
+} // namespace detail
+} // namespace vtk
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -43,6 +100,22 @@ Initialize()
     delete [] this->Offsets;
     this->Offsets = nullptr;
   }
+  this->LinksSize = 0;
+  this->NumPts = 0;
+  this->NumCells = 0;
+}
+
+//----------------------------------------------------------------------------
+template <typename TIds> unsigned long vtkStaticCellLinksTemplate<TIds>::
+GetActualMemorySize()
+{
+  if ( ! this->Offsets )
+  {
+    return 0;
+  }
+  double size = static_cast<double>(this->LinksSize + this->NumPts + 2) *
+    sizeof(TIds);
+  return static_cast<unsigned long>(std::ceil(size/1024.0)); // kibibytes
 }
 
 //----------------------------------------------------------------------------
@@ -65,56 +138,13 @@ BuildLinks(vtkDataSet *ds)
   // Any other type of dataset. Generally this is not called as datasets have
   // their own, more efficient ways of getting similar information.
   // Make sure that we clear out previous allocation.
+  this->Initialize();
   this->NumCells = ds->GetNumberOfCells();
   this->NumPts = ds->GetNumberOfPoints();
 
-  vtkIdType npts, ptId;
-  vtkIdType cellId, j;
   vtkIdList *cellPts = vtkIdList::New();
-
-  // Traverse data to determine number of uses of each point. Also count the
-  // number of links to allocate.
-  this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  for (this->LinksSize=0, cellId=0; cellId < this->NumCells; cellId++)
-  {
-    ds->GetCellPoints(cellId,cellPts);
-    npts = cellPts->GetNumberOfIds();
-    for (j=0; j < npts; j++)
-    {
-      this->Offsets[cellPts->GetId(j)]++;
-      this->LinksSize++;
-    }
-  }
-
-  // Allocate space for links. Perform prefix sum.
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
-
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
-
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    ds->GetCellPoints(cellId,cellPts);
-    npts = cellPts->GetNumberOfIds();
-    for (j=0; j<npts; ++j)
-    {
-      ptId = cellPts->GetId(j);
-      this->Offsets[ptId]--;
-      this->Links[this->Offsets[ptId]] = cellId;
-    }
-  }
-  this->Offsets[this->NumPts] = this->LinksSize;
-
+  vtk::detail::links::vtkStaticCellLinks_CellPointIds cells(ds, cellPts);
+  this->BuildLinksFromCells(cells, false);
   cellPts->Delete();
 }
 
@@ -124,150 +154,181 @@ template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkUnstructuredGrid *ugrid)
 {
   // Basic information about the grid
+  this->Initialize();
   this->NumCells = ugrid->GetNumberOfCells();
   this->NumPts = ugrid->GetNumberOfPoints();
 
-  // We're going to get into the guts of the class
+  // The cells can only be read concurrently with the legacy storage.
   vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
-
-  // I love this trick: the size of the Links array is equal to
-  // the size of the cell array, minus the number of cells.
-  this->LinksSize =
-    cellArray->GetNumberOfConnectivityEntries() - this->NumCells;
-
-  // Extra one allocated to simplify later pointer manipulation
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
-  this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
-  int i;
-
-  // Count number of point uses
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell++]++;
-    }
-  }
-
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  bool threaded = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+    cellArray != nullptr &&
+    cellArray->GetStorageMode() == vtkCellArray::LEGACY_STORAGE;
 
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
-    }
-  }
-  this->Offsets[this->NumPts] = this->LinksSize;
+  vtk::detail::links::vtkStaticCellLinks_CellPoints<vtkUnstructuredGrid>
+    cells(ugrid);
+  this->BuildLinksFromCells(cells, threaded);
 }
 
 //----------------------------------------------------------------------------
-// Build the link list array for poly data. This is more complex because there
-// are potentially fout different cell arrays to contend with.
+// Build the link list array for poly data. The cells are numbered as in the
+// polydata, which may hold them in four different cell arrays.
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
   // Basic information about the grid
+  this->Initialize();
+  if ( pd->NeedToBuildCells() )
+  {
+    pd->BuildCells();
+  }
   this->NumCells = pd->GetNumberOfCells();
   this->NumPts = pd->GetNumberOfPoints();
 
+  // The cells can only be read concurrently with the legacy storage.
   vtkCellArray *cellArrays[4];
-  vtkIdType numCells[4];
-  vtkIdType sizes[4];
-  int i, j;
-
   cellArrays[0] = pd->GetVerts();
   cellArrays[1] = pd->GetLines();
   cellArrays[2] = pd->GetPolys();
   cellArrays[3] = pd->GetStrips();
 
-  for (i=0; i<4; ++i)
+  bool threaded = vtkSMPTools::GetEstimatedNumberOfThreads() > 1;
+  for (int i=0; i<4; ++i)
   {
-    if ( cellArrays[i] != nullptr )
+    if ( cellArrays[i]->GetStorageMode() != vtkCellArray::LEGACY_STORAGE )
     {
-      numCells[i] = cellArrays[i]->GetNumberOfCells();
-      sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
+      threaded = false;
     }
-    else
-    {
-      numCells[i] = 0;
-      sizes[i] = 0;
-    }
-  }//for the four polydata arrays
-
-  // Allocate
-  this->LinksSize = sizes[0] + sizes[1] + sizes[2] + sizes[3];
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
-  this->Offsets = new TIds[this->NumPts+1];
-  this->Offsets[this->NumPts] = this->LinksSize;
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
-
-  // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  }
+
+  vtk::detail::links::vtkStaticCellLinks_CellPoints<vtkPolyData> cells(pd);
+  this->BuildLinksFromCells(cells, threaded);
+}
+
+//----------------------------------------------------------------------------
+// Count the uses of each point, turn the counts into offsets with a prefix
+// sum, and then insert the cells. The cells using each point are listed in
+// increasing order.
+template <typename TIds> template <typename TCells>
+void vtkStaticCellLinksTemplate<TIds>::
+BuildLinksFromCells(const TCells& cells, bool threaded)
+{
+  const vtkIdType numPts = this->NumPts;
+  const vtkIdType numCells = this->NumCells;
+  TIds *offsets = this->Offsets = new TIds[numPts+1];
+
+  if ( ! threaded )
   {
     // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    std::fill_n(offsets, numPts+1, 0);
+    for ( vtkIdType cellId=0; cellId < numCells; ++cellId )
     {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
+      cells.Visit(cellId, [offsets](vtkIdType ptId) { ++offsets[ptId]; });
+    }
+
+    // Perform prefix sum. Each offset now points to the end of the run of
+    // its point.
+    TIds sum = 0;
+    for ( vtkIdType ptId=0; ptId < numPts; ++ptId )
+    {
+      sum += offsets[ptId];
+      offsets[ptId] = sum;
+    }
+    this->LinksSize = sum;
+
+    // Extra one allocated to simplify later pointer manipulation
+    TIds *links = this->Links = new TIds[this->LinksSize+1];
+    links[this->LinksSize] = this->NumPts;
+
+    // Now build the links. Each time a cell is inserted, the offset of its
+    // point is decremented; visiting the cells backwards leaves the cells in
+    // increasing order. In the end, the offset array points to the
+    // beginning of each cell run.
+    for ( vtkIdType cellId=numCells-1; cellId >= 0; --cellId )
+    {
+      const TIds id = static_cast<TIds>(cellId);
+      cells.Visit(cellId, [offsets, links, id](vtkIdType ptId)
       {
-        this->Offsets[CellId+(*cell++)]++;
-      }
+        links[--offsets[ptId]] = id;
+      });
     }
-    CellId += numCells[j];
-  } //for each of the four polydata cell arrays
+    offsets[numPts] = this->LinksSize;
+    return;
+  }
 
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
+  // Count the point uses concurrently.
+  std::unique_ptr<std::atomic<TIds>[]> uses(new std::atomic<TIds>[numPts]);
+  std::atomic<TIds> *counts = uses.get();
+  vtkSMPTools::For(0, numPts, [counts](vtkIdType ptId, vtkIdType endPtId)
   {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      counts[ptId].store(0, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&cells, counts](
+    vtkIdType cellId, vtkIdType endCellId)
+  {
+    auto count = [counts](vtkIdType ptId)
+    {
+      counts[ptId].fetch_add(1, std::memory_order_relaxed);
+    };
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      cells.Visit(cellId, count);
+    }
+  });
 
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( CellId=0, j=0; j < 4; ++j )
+  // Turn the counts into offsets.
+  vtkSMPTools::For(0, numPts, [counts, offsets](
+    vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      offsets[ptId] = counts[ptId].load(std::memory_order_relaxed);
+    }
+  });
+  offsets[numPts] = 0;
+  vtkSMPTools::ExclusiveScan(offsets, offsets+numPts+1, offsets, TIds(0));
+  this->LinksSize = offsets[numPts];
+
+  TIds *links = this->Links = new TIds[this->LinksSize+1];
+  links[this->LinksSize] = this->NumPts;
+
+  // Scatter the cells concurrently, the counts now being the next free
+  // position of each point, and sort the cells of each point. The threads
+  // fill the list of a point in an unspecified order; sorting it gives the
+  // increasing order of the serial build above and of vtkCellLinks, so that
+  // the filters summing over the cells of a point give the same results
+  // whatever the number of threads. The lists hold as many cells as the
+  // valence of their point, so they are sorted in about linear time.
+  vtkSMPTools::For(0, numPts, [counts, offsets](
+    vtkIdType ptId, vtkIdType endPtId)
   {
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    for ( ; ptId < endPtId; ++ptId)
     {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
+      counts[ptId].store(offsets[ptId], std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&cells, counts, links](
+    vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const TIds id = static_cast<TIds>(cellId);
+      cells.Visit(cellId, [counts, links, id](vtkIdType ptId)
       {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
-      }
+        links[counts[ptId].fetch_add(1, std::memory_order_relaxed)] = id;
+      });
+    }
+  });
+  vtkSMPTools::For(0, numPts, [offsets, links](
+    vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      std::sort(links + offsets[ptId], links + offsets[ptId+1]);
     }
-    CellId += numCells[j];
-  }//for each of the four polydata arrays
-  this->Offsets[this->NumPts] = this->LinksSize;
+  });
 }
 
 #endif
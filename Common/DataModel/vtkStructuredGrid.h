@@ -88,6 +88,7 @@ public:
   void GetCellBounds(vtkIdType cellId, double bounds[6]) override;
   int GetCellType(vtkIdType cellId) override;
   vtkIdType GetNumberOfCells() override;
+  bool SupportsConcurrentReads() override { return true; }
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) override;
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) override
   {
@@ -52,6 +52,10 @@
 #include "vtkQuadraticQuad.h"
 #include "vtkQuadraticTetra.h"
 #include "vtkQuadraticTriangle.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkTetra.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleStrip.h"
@@ -68,10 +72,185 @@
 #include "vtkBiQuadraticQuadraticHexahedron.h"
 #include "vtkBiQuadraticTriangle.h"
 
+#include <algorithm>
 #include <set>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkUnstructuredGrid);
 
+//----------------------------------------------------------------------------
+// Topology of the polyhedron cells, shared by all the polyhedra returned by
+// GetCell(). The edges and the face neighbors of all the cells are stored
+// contiguously, with offsets indexed by cell id.
+class vtkUnstructuredGrid::vtkPolyhedronTopology
+{
+public:
+  // Faces in point ids local to their cell, laid out as the Faces array.
+  std::vector<vtkIdType> LocalFaces;
+
+  // Edges as pairs of local point ids, and the two faces using each edge,
+  // numbered as in vtkPolyhedron.
+  std::vector<vtkIdType> EdgeOffsets;
+  std::vector<vtkIdType> Edges;
+  std::vector<vtkIdType> EdgeFaces;
+
+  // Cell on the other side of each face, or -1.
+  std::vector<vtkIdType> FaceOffsets;
+  std::vector<vtkIdType> FaceNeighbors;
+
+  vtkIdType NumberOfCells;
+  vtkTimeStamp BuildTime;
+};
+
+namespace
+{
+// An edge of a polyhedron seen from one of its faces, in local point ids.
+struct vtkPolyhedronHalfEdge
+{
+  vtkIdType Min, Max; // the edge
+  vtkIdType Start, End; // the edge in the orientation of the face
+  vtkIdType Face;
+  vtkIdType Order; // order of traversal of the faces
+
+  bool operator<(const vtkPolyhedronHalfEdge& other) const
+  {
+    if (this->Min != other.Min)
+    {
+      return this->Min < other.Min;
+    }
+    if (this->Max != other.Max)
+    {
+      return this->Max < other.Max;
+    }
+    return this->Order < other.Order;
+  }
+};
+
+// An edge of a polyhedron and the two faces using it.
+struct vtkPolyhedronEdge
+{
+  vtkIdType Order;
+  vtkIdType Points[2];
+  vtkIdType Faces[2];
+
+  bool operator<(const vtkPolyhedronEdge& other) const
+  {
+    return this->Order < other.Order;
+  }
+};
+
+// Buffers of a thread.
+struct vtkPolyhedronWorkspace
+{
+  std::vector<std::pair<vtkIdType, vtkIdType> > PointMap;
+  std::vector<vtkPolyhedronHalfEdge> HalfEdges;
+  std::vector<vtkPolyhedronEdge> Edges;
+};
+
+// Convert the faces of a polyhedron to local point ids, and list its edges.
+// This gives the same results as vtkPolyhedron::GenerateFaces() and
+// vtkPolyhedron::GenerateEdges(): a point id used twice by the cell maps to
+// its last use, the edges are numbered in the order they are met in the
+// faces, and the second face of an edge is the last face using it.
+void GeneratePolyhedronTopology(vtkIdType npts, const vtkIdType *pts,
+  const vtkIdType *faceStream, vtkIdType *localFaces,
+  vtkPolyhedronWorkspace& ws)
+{
+  ws.PointMap.resize(npts);
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    ws.PointMap[i] = std::make_pair(pts[i], i);
+  }
+  std::sort(ws.PointMap.begin(), ws.PointMap.end());
+  auto localId = [&ws](vtkIdType ptId)
+  {
+    auto it = std::upper_bound(ws.PointMap.begin(), ws.PointMap.end(),
+      std::make_pair(ptId, VTK_ID_MAX));
+    return (it != ws.PointMap.begin() && (--it)->first == ptId) ?
+      it->second : 0;
+  };
+
+  ws.HalfEdges.clear();
+  const vtkIdType nfaces = faceStream[0];
+  const vtkIdType *face = faceStream + 1;
+  vtkIdType *localFace = nullptr;
+  if (localFaces)
+  {
+    localFaces[0] = nfaces;
+    localFace = localFaces + 1;
+  }
+  vtkIdType order = 0;
+  for (vtkIdType fid = 0; fid < nfaces; ++fid)
+  {
+    const vtkIdType nfacePts = face[0];
+    const std::size_t first = ws.HalfEdges.size();
+    for (vtkIdType i = 1; i <= nfacePts; ++i)
+    {
+      vtkPolyhedronHalfEdge edge;
+      edge.Start = localId(face[i]);
+      edge.Face = fid;
+      edge.Order = order++;
+      ws.HalfEdges.push_back(edge);
+    }
+    for (vtkIdType i = 0; i < nfacePts; ++i)
+    {
+      vtkPolyhedronHalfEdge& edge = ws.HalfEdges[first + i];
+      edge.End = ws.HalfEdges[first + (i + 1) % nfacePts].Start;
+      edge.Min = std::min(edge.Start, edge.End);
+      edge.Max = std::max(edge.Start, edge.End);
+    }
+    if (localFaces)
+    {
+      localFace[0] = nfacePts;
+      for (vtkIdType i = 0; i < nfacePts; ++i)
+      {
+        localFace[i + 1] = ws.HalfEdges[first + i].Start;
+      }
+      localFace += nfacePts + 1;
+    }
+    face += nfacePts + 1;
+  }
+
+  // Group the uses of each edge, then number the edges by their first use.
+  std::sort(ws.HalfEdges.begin(), ws.HalfEdges.end());
+  ws.Edges.clear();
+  for (std::size_t i = 0; i < ws.HalfEdges.size(); )
+  {
+    const vtkPolyhedronHalfEdge& firstUse = ws.HalfEdges[i];
+    std::size_t j = i + 1;
+    while (j < ws.HalfEdges.size() && ws.HalfEdges[j].Min == firstUse.Min &&
+           ws.HalfEdges[j].Max == firstUse.Max)
+    {
+      ++j;
+    }
+    vtkPolyhedronEdge edge;
+    edge.Order = firstUse.Order;
+    edge.Points[0] = firstUse.Start;
+    edge.Points[1] = firstUse.End;
+    edge.Faces[0] = firstUse.Face;
+    edge.Faces[1] = j - i > 1 ? ws.HalfEdges[j - 1].Face : -1;
+    ws.Edges.push_back(edge);
+    i = j;
+  }
+  std::sort(ws.Edges.begin(), ws.Edges.end());
+}
+
+// Run a functor over ranges of cells, with several threads or serially.
+template <typename Functor>
+void ForEachCell(vtkIdType numCells, bool threaded, const Functor& functor)
+{
+  if (threaded)
+  {
+    vtkSMPTools::For(0, numCells, functor);
+  }
+  else
+  {
+    functor(0, numCells);
+  }
+}
+}
+
 vtkUnstructuredGrid::vtkUnstructuredGrid ()
 {
   this->Vertex = nullptr;
@@ -124,11 +303,15 @@ vtkUnstructuredGrid::vtkUnstructuredGrid ()
 
   this->Connectivity = nullptr;
   this->Links = nullptr;
+  this->StaticLinks = nullptr;
   this->Types = nullptr;
   this->Locations = nullptr;
 
   this->Faces = nullptr;
   this->FaceLocations = nullptr;
+  this->PolyhedronTopology = nullptr;
+  this->PolyhedronTopologyLock = new vtkSimpleCriticalSection;
+  this->PolyhedronTopologyMisses = 0;
 
   this->Allocate(1000,1000);
 }
@@ -147,6 +330,8 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
     extSize = 1000;
   }
 
+  this->ReleasePolyhedronTopology();
+
   if ( this->Connectivity )
   {
     this->Connectivity->UnRegister(this);
@@ -179,6 +364,7 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
 vtkUnstructuredGrid::~vtkUnstructuredGrid()
 {
   this->Cleanup();
+  delete this->PolyhedronTopologyLock;
 
   if(this->Vertex)
   {
@@ -372,6 +558,8 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
   // If ds is a vtkUnstructuredGrid, do a shallow copy of the cell data.
   if (vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(ds))
   {
+    this->ReleasePolyhedronTopology();
+
     if (this->Connectivity != ug->Connectivity)
     {
       if ( this->Connectivity )
@@ -398,6 +586,19 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
       }
     }
 
+    if (this->StaticLinks != ug->StaticLinks)
+    {
+      if ( this->StaticLinks )
+      {
+        this->StaticLinks->UnRegister(this);
+      }
+      this->StaticLinks = ug->StaticLinks;
+      if (this->StaticLinks)
+      {
+        this->StaticLinks->Register(this);
+      }
+    }
+
     if (this->Types != ug->Types)
     {
       if ( this->Types )
@@ -457,6 +658,8 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::Cleanup()
 {
+  this->ReleasePolyhedronTopology();
+
   if ( this->Connectivity )
   {
     this->Connectivity->UnRegister(this);
@@ -469,6 +672,12 @@ void vtkUnstructuredGrid::Cleanup()
     this->Links = nullptr;
   }
 
+  if ( this->StaticLinks )
+  {
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
+
   if ( this->Types )
   {
     this->Types->UnRegister(this);
@@ -881,24 +1090,21 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
     cell->Initialize();
   }
 
+  if ( cell == this->Polyhedron )
+  {
+    this->LoadPolyhedronTopology(cellId, this->Polyhedron);
+  }
+
   return cell;
 }
 
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
-  vtkIdType loc;
-  vtkIdType *pts, numPts;
-
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   cell->SetCellType(cellType);
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-
-  cell->PointIds->SetNumberOfIds(numPts);
-
-  std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+  this->vtkUnstructuredGrid::GetCellPoints(cellId, cell->PointIds);
   this->Points->GetPoints(cell->PointIds, cell->Points);
 
   // Explicit face representation
@@ -913,6 +1119,12 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   {
     cell->Initialize();
   }
+
+  if ( cellType == VTK_POLYHEDRON )
+  {
+    this->LoadPolyhedronTopology(cellId,
+      static_cast<vtkPolyhedron *>(cell->GetRepresentativeCell()));
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -921,12 +1133,10 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
   vtkIdType i;
-  vtkIdType loc;
   double x[3];
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->vtkUnstructuredGrid::GetCellPoints(cellId, numPts, pts);
 
   // carefully compute the bounds
   if (numPts)
@@ -1056,7 +1266,8 @@ vtkIdType vtkUnstructuredGrid::InternalInsertNextCell(int type, vtkIdType npts,
     }
 
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetNumberOfConnectivityEntries());
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -1330,6 +1541,8 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
                                    vtkIdTypeArray *faceLocations,
                                    vtkIdTypeArray *faces)
 {
+  this->ReleasePolyhedronTopology();
+
   if ( this->Connectivity )
   {
     this->Connectivity->UnRegister(this);
@@ -1382,35 +1595,363 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
 }
 
 //----------------------------------------------------------------------------
-void vtkUnstructuredGrid::BuildLinks()
+// Build static links, with several threads when available. They are
+// converted to editable links by the first operation that edits them.
+void vtkUnstructuredGrid::BuildLinks(int initialSize)
 {
   // Remove the old links if they are already built
   if (this->Links)
   {
     this->Links->UnRegister(this);
+    this->Links = nullptr;
+  }
+  if (this->StaticLinks)
+  {
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
+
+  if ( initialSize > 0 )
+  {
+    this->Links = vtkCellLinks::New();
+    this->Links->Allocate(
+      std::max<vtkIdType>(initialSize, this->GetNumberOfPoints()));
+    this->Links->Register(this);
+    this->Links->BuildLinks(this, this->Connectivity);
+    this->Links->Delete();
+    return;
+  }
+
+  this->StaticLinks = vtkStaticCellLinks::New();
+  this->StaticLinks->Register(this);
+  this->StaticLinks->BuildLinks(this);
+  this->StaticLinks->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractCellLinks *vtkUnstructuredGrid::GetLinks()
+{
+  if ( this->StaticLinks )
+  {
+    return this->StaticLinks;
+  }
+  return this->Links;
+}
+
+//----------------------------------------------------------------------------
+vtkCellLinks *vtkUnstructuredGrid::GetCellLinks()
+{
+  this->MakeLinksEditable();
+  return this->Links;
+}
+
+//----------------------------------------------------------------------------
+// Convert static links into editable links. The static links are released.
+void vtkUnstructuredGrid::MakeLinksEditable()
+{
+  if ( ! this->StaticLinks )
+  {
+    return;
   }
 
   this->Links = vtkCellLinks::New();
-  this->Links->Allocate(this->GetNumberOfPoints());
   this->Links->Register(this);
-  this->Links->BuildLinks(this, this->Connectivity);
   this->Links->Delete();
+  this->Links->DeepCopy(this->StaticLinks);
+
+  this->StaticLinks->UnRegister(this);
+  this->StaticLinks = nullptr;
 }
 
 //----------------------------------------------------------------------------
-void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
+void vtkUnstructuredGrid::GetLinkedCells(vtkIdType ptId, vtkIdType &ncells,
+                                         vtkIdType* &cells)
 {
-  vtkIdType i, loc;
-  vtkIdType *pts, numPts;
+  if ( this->StaticLinks )
+  {
+    ncells = this->StaticLinks->GetNumberOfCells(ptId);
+    // Static links are never edited in place; see MakeLinksEditable().
+    cells = const_cast<vtkIdType *>(this->StaticLinks->GetCells(ptId));
+  }
+  else
+  {
+    ncells = this->Links->GetNcells(ptId);
+    cells = this->Links->GetCells(ptId);
+  }
+}
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-  ptIds->SetNumberOfIds(numPts);
-  for (i=0; i<numPts; i++)
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::BuildPolyhedronTopology()
+{
+  this->GetPolyhedronTopology(true);
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::PrepareForConcurrentReads()
+{
+  if ( this->Faces )
   {
-    ptIds->SetId(i,pts[i]);
+    this->BuildPolyhedronTopology();
   }
+  this->Superclass::PrepareForConcurrentReads();
+}
+
+//----------------------------------------------------------------------------
+// Return the topology of the polyhedra, built by the first thread needing it
+// while the others wait. Unless build is set, an out of date topology is only
+// rebuilt once it has been missed for a sixteenth of the cells, the
+// polyhedra generating their own edges and faces meanwhile: inserting and
+// getting cells in turn then costs a linear time overall. Return nullptr if
+// the topology is out of date.
+const vtkUnstructuredGrid::vtkPolyhedronTopology *
+vtkUnstructuredGrid::GetPolyhedronTopology(bool build)
+{
+  this->PolyhedronTopologyLock->Lock();
+  bool valid = this->IsPolyhedronTopologyValid();
+  if ( ! valid && ( build ||
+       16 * ++this->PolyhedronTopologyMisses >= this->GetNumberOfCells() ) )
+  {
+    this->ComputePolyhedronTopology();
+    this->PolyhedronTopologyMisses = 0;
+    valid = true;
+  }
+  const vtkPolyhedronTopology *topology =
+    valid ? this->PolyhedronTopology : nullptr;
+  this->PolyhedronTopologyLock->Unlock();
+  return topology;
+}
+
+//----------------------------------------------------------------------------
+// Build the topology of all the polyhedra. A first pass counts the edges and
+// faces of each cell and converts the faces to local point ids, the counts
+// are turned into offsets, then a second pass stores the edges and a third
+// one looks up the cell on the other side of each face. The cells can only be
+// read concurrently with the legacy storage. Within a parallel operation, the
+// build runs serially on the calling thread, which holds the lock.
+void vtkUnstructuredGrid::ComputePolyhedronTopology()
+{
+  this->ReleasePolyhedronTopology();
+  vtkPolyhedronTopology *topology = new vtkPolyhedronTopology;
+  this->PolyhedronTopology = topology;
+
+  const vtkIdType numCells = this->GetNumberOfCells();
+  topology->NumberOfCells = numCells;
+  topology->EdgeOffsets.assign(numCells + 1, 0);
+  topology->FaceOffsets.assign(numCells + 1, 0);
+  if ( ! this->Faces || ! this->FaceLocations || numCells == 0 )
+  {
+    topology->BuildTime.Modified();
+    return;
+  }
+  topology->LocalFaces.resize(this->Faces->GetNumberOfValues());
+
+  const bool threaded = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+    ! vtkSMPTools::IsParallelScope() &&
+    this->Connectivity->GetStorageMode() == vtkCellArray::LEGACY_STORAGE;
+  const unsigned char *types = this->Types->GetPointer(0);
+  const vtkIdType numFaceLocations = this->FaceLocations->GetNumberOfValues();
+  const vtkIdType *faceLocations = this->FaceLocations->GetPointer(0);
+  const vtkIdType *faces = this->Faces->GetPointer(0);
+  auto faceStream = [=](vtkIdType cellId) -> const vtkIdType *
+  {
+    return ( types[cellId] != VTK_POLYHEDRON || cellId >= numFaceLocations ||
+             faceLocations[cellId] < 0 ) ?
+      nullptr : faces + faceLocations[cellId];
+  };
+
+  vtkSMPThreadLocal<vtkPolyhedronWorkspace> workspaces;
+  vtkIdType *localFaces = topology->LocalFaces.data();
+  vtkIdType *edgeOffsets = topology->EdgeOffsets.data();
+  vtkIdType *faceOffsets = topology->FaceOffsets.data();
+  ForEachCell(numCells, threaded, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkPolyhedronWorkspace& ws = workspaces.Local();
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *stream = faceStream(cellId);
+      if ( stream )
+      {
+        vtkIdType npts, *pts;
+        this->GetCellPoints(cellId, npts, pts);
+        GeneratePolyhedronTopology(npts, pts, stream,
+          localFaces + faceLocations[cellId], ws);
+        edgeOffsets[cellId] = static_cast<vtkIdType>(ws.Edges.size());
+        faceOffsets[cellId] = stream[0];
+      }
+    }
+  });
+  vtkSMPTools::ExclusiveScan(edgeOffsets, edgeOffsets + numCells + 1,
+                             edgeOffsets, vtkIdType(0));
+  vtkSMPTools::ExclusiveScan(faceOffsets, faceOffsets + numCells + 1,
+                             faceOffsets, vtkIdType(0));
+
+  topology->Edges.resize(2 * edgeOffsets[numCells]);
+  topology->EdgeFaces.resize(2 * edgeOffsets[numCells]);
+  vtkIdType *edges = topology->Edges.data();
+  vtkIdType *edgeFaces = topology->EdgeFaces.data();
+  ForEachCell(numCells, threaded, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkPolyhedronWorkspace& ws = workspaces.Local();
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *stream = faceStream(cellId);
+      if ( stream )
+      {
+        vtkIdType npts, *pts;
+        this->GetCellPoints(cellId, npts, pts);
+        GeneratePolyhedronTopology(npts, pts, stream, nullptr, ws);
+        vtkIdType offset = 2 * edgeOffsets[cellId];
+        for (const vtkPolyhedronEdge& edge : ws.Edges)
+        {
+          edges[offset] = edge.Points[0];
+          edges[offset + 1] = edge.Points[1];
+          edgeFaces[offset] = edge.Faces[0];
+          edgeFaces[offset + 1] = edge.Faces[1];
+          offset += 2;
+        }
+      }
+    }
+  });
 
+  // The face neighbors are found with temporary links: the links of the
+  // grid, if any, may not be up to date.
+  vtkNew<vtkStaticCellLinks> links;
+  links->BuildLinks(this);
+  auto linkedCells = [&links](vtkIdType ptId, vtkIdType &ncells,
+                              const vtkIdType* &cells)
+  {
+    ncells = links->GetNumberOfCells(ptId);
+    cells = links->GetCells(ptId);
+  };
+
+  topology->FaceNeighbors.resize(faceOffsets[numCells]);
+  vtkIdType *faceNeighbors = topology->FaceNeighbors.data();
+  ForEachCell(numCells, threaded, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *stream = faceStream(cellId);
+      if ( ! stream )
+      {
+        continue;
+      }
+      const vtkIdType *face = stream + 1;
+      vtkIdType *neighbor = faceNeighbors + faceOffsets[cellId];
+      for (vtkIdType fid = 0; fid < stream[0]; ++fid, face += face[0] + 1)
+      {
+        // The smallest other cell using all the points of the face.
+        neighbor[fid] = -1;
+        if ( face[0] < 1 )
+        {
+          continue;
+        }
+        vtkIdType ncells;
+        const vtkIdType *cells;
+        linkedCells(face[1], ncells, cells);
+        for (vtkIdType i = 0; i < ncells; ++i)
+        {
+          const vtkIdType other = cells[i];
+          if ( other == cellId ||
+               ( neighbor[fid] >= 0 && other >= neighbor[fid] ) )
+          {
+            continue;
+          }
+          bool usesFace = true;
+          for (vtkIdType j = 2; usesFace && j <= face[0]; ++j)
+          {
+            vtkIdType nothers;
+            const vtkIdType *others;
+            linkedCells(face[j], nothers, others);
+            usesFace = std::find(others, others + nothers, other) !=
+              others + nothers;
+          }
+          if ( usesFace )
+          {
+            neighbor[fid] = other;
+          }
+        }
+      }
+    }
+  });
+
+  topology->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkUnstructuredGrid::GetPolyhedronFaceNeighbor(vtkIdType cellId,
+                                                         int faceId)
+{
+  const vtkPolyhedronTopology *topology = this->GetPolyhedronTopology(true);
+  if ( ! topology || cellId < 0 || cellId >= topology->NumberOfCells )
+  {
+    return -1;
+  }
+  const vtkIdType begin = topology->FaceOffsets[cellId];
+  if ( faceId < 0 || faceId >= topology->FaceOffsets[cellId + 1] - begin )
+  {
+    return -1;
+  }
+  return topology->FaceNeighbors[begin + faceId];
+}
+
+//----------------------------------------------------------------------------
+// The topology is released by the methods that modify the cells; the
+// modification times catch the arrays edited through GetFaces() and
+// GetCells().
+bool vtkUnstructuredGrid::IsPolyhedronTopologyValid()
+{
+  const vtkPolyhedronTopology *topology = this->PolyhedronTopology;
+  if ( ! topology || topology->NumberOfCells != this->GetNumberOfCells() )
+  {
+    return false;
+  }
+  const vtkMTimeType buildTime = topology->BuildTime.GetMTime();
+  return ( ! this->Faces || this->Faces->GetMTime() < buildTime ) &&
+    ( ! this->FaceLocations || this->FaceLocations->GetMTime() < buildTime ) &&
+    this->Connectivity->GetMTime() < buildTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::ReleasePolyhedronTopology()
+{
+  delete this->PolyhedronTopology;
+  this->PolyhedronTopology = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// Set up a polyhedron returned by GetCell() from the topology of the grid,
+// when it is up to date. Otherwise the polyhedron generates its edges and
+// faces itself.
+void vtkUnstructuredGrid::LoadPolyhedronTopology(vtkIdType cellId,
+                                                 vtkPolyhedron *polyhedron)
+{
+  if ( ! this->GetFaces(cellId) )
+  {
+    return;
+  }
+  const vtkPolyhedronTopology *topology = this->GetPolyhedronTopology(false);
+  if ( ! topology )
+  {
+    return;
+  }
+  const vtkIdType begin = topology->EdgeOffsets[cellId];
+  polyhedron->SetTopology(
+    topology->LocalFaces.data() + this->FaceLocations->GetValue(cellId),
+    topology->EdgeOffsets[cellId + 1] - begin,
+    topology->Edges.data() + 2 * begin,
+    topology->EdgeFaces.data() + 2 * begin);
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
+{
+  // The split storage is read by cell id, in constant time.
+  if (this->Connectivity->GetStorageMode() != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->GetCellAtId(cellId, ptIds);
+    return;
+  }
+  this->Connectivity->GetCell(this->Locations->GetValue(cellId), ptIds);
 }
 
 //----------------------------------------------------------------------------
@@ -1419,11 +1960,12 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                                         vtkIdType* &pts)
 {
-  vtkIdType loc;
-
-  loc = this->Locations->GetValue(cellId);
-
-  this->Connectivity->GetCell(loc,npts,pts);
+  if (this->Connectivity->GetStorageMode() != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->GetCellAtId(cellId, npts, pts);
+    return;
+  }
+  this->Connectivity->GetCell(this->Locations->GetValue(cellId), npts, pts);
 }
 
 //----------------------------------------------------------------------------
@@ -1484,17 +2026,16 @@ void vtkUnstructuredGrid::GetFaceStream(vtkIdType cellId, vtkIdType& nfaces,
 void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
 {
   vtkIdType *cells;
-  int numCells;
-  int i;
+  vtkIdType numCells;
+  vtkIdType i;
 
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  this->GetLinkedCells(ptId, numCells, cells);
 
   cellIds->SetNumberOfIds(numCells);
   for (i=0; i < numCells; i++)
@@ -1514,6 +2055,7 @@ vtkCellIterator *vtkUnstructuredGrid::NewCellIterator()
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::Reset()
 {
+  this->ReleasePolyhedronTopology();
   if ( this->Connectivity )
   {
     this->Connectivity->Reset();
@@ -1522,6 +2064,11 @@ void vtkUnstructuredGrid::Reset()
   {
     this->Links->Reset();
   }
+  if ( this->StaticLinks )
+  {
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
   if ( this->Types )
   {
     this->Types->Reset();
@@ -1579,6 +2126,7 @@ void vtkUnstructuredGrid::Squeeze()
 void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
                                                 vtkIdType cellId)
 {
+  this->MakeLinksEditable();
   this->Links->RemoveCellReference(cellId, ptId);
 }
 
@@ -1589,6 +2137,7 @@ void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
 // operator ResizeCellList() to do this if necessary.
 void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
+  this->MakeLinksEditable();
   this->Links->AddCellReference(cellId, ptId);
 }
 
@@ -1597,6 +2146,7 @@ void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // that BuildLinks() has been called.)
 void vtkUnstructuredGrid::ResizeCellList(vtkIdType ptId, int size)
 {
+  this->MakeLinksEditable();
   this->Links->ResizeCellList(ptId,size);
 }
 
@@ -1612,6 +2162,7 @@ void vtkUnstructuredGrid::InternalReplaceCell(vtkIdType cellId, int npts,
 
   loc = this->Locations->GetValue(cellId);
   this->Connectivity->ReplaceCell(loc,npts,pts);
+  this->ReleasePolyhedronTopology();
 }
 
 //----------------------------------------------------------------------------
@@ -1623,6 +2174,7 @@ vtkIdType vtkUnstructuredGrid::InsertNextLinkedCell(int type, int npts,
 {
   vtkIdType i, id;
 
+  this->MakeLinksEditable();
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
@@ -1648,6 +2200,11 @@ unsigned long vtkUnstructuredGrid::GetActualMemorySize()
     size += this->Links->GetActualMemorySize();
   }
 
+  if ( this->StaticLinks )
+  {
+    size += this->StaticLinks->GetActualMemorySize();
+  }
+
   if ( this->Types )
   {
     size += this->Types->GetActualMemorySize();
@@ -1668,6 +2225,17 @@ unsigned long vtkUnstructuredGrid::GetActualMemorySize()
     size += this->FaceLocations->GetActualMemorySize();
   }
 
+  if ( this->PolyhedronTopology )
+  {
+    const vtkPolyhedronTopology *topology = this->PolyhedronTopology;
+    std::size_t numIds = topology->LocalFaces.size() +
+      topology->EdgeOffsets.size() + topology->Edges.size() +
+      topology->EdgeFaces.size() + topology->FaceOffsets.size() +
+      topology->FaceNeighbors.size();
+    size += static_cast<unsigned long>(
+      (numIds * sizeof(vtkIdType) + 1023) / 1024); // kibibytes
+  }
+
   return size;
 }
 
@@ -1678,6 +2246,8 @@ void vtkUnstructuredGrid::ShallowCopy(vtkDataObject *dataObject)
   {
     // I do not know if this is correct but.
 
+    this->ReleasePolyhedronTopology();
+
     if (this->Connectivity)
     {
       this->Connectivity->UnRegister(this);
@@ -1698,6 +2268,16 @@ void vtkUnstructuredGrid::ShallowCopy(vtkDataObject *dataObject)
       this->Links->Register(this);
     }
 
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Delete();
+    }
+    this->StaticLinks = grid->StaticLinks;
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Register(this);
+    }
+
     if (this->Types)
     {
       this->Types->UnRegister(this);
@@ -1766,6 +2346,8 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
 
   if ( grid != nullptr )
   {
+    this->ReleasePolyhedronTopology();
+
     if ( this->Connectivity )
     {
       this->Connectivity->UnRegister(this);
@@ -1784,6 +2366,11 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
       this->Links->UnRegister(this);
       this->Links = nullptr;
     }
+    if ( this->StaticLinks )
+    {
+      this->StaticLinks->UnRegister(this);
+      this->StaticLinks = nullptr;
+    }
     if ( this->Types )
     {
       this->Types->UnRegister(this);
@@ -1847,7 +2434,7 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
   }
 
   // Finally Build Links if we need to
-  if (grid && grid->Links)
+  if (grid && (grid->Links || grid->StaticLinks))
   {
     this->BuildLinks();
   }
@@ -1872,7 +2459,7 @@ void vtkUnstructuredGrid::PrintSelf(ostream& os, vtkIndent indent)
 void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                                            vtkIdList *cellIds)
 {
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
@@ -1888,14 +2475,15 @@ void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   //Find the point used by the fewest number of cells
   vtkIdType *pts = ptIds->GetPointer(0);
-  int minNumCells = VTK_INT_MAX;
+  vtkIdType minNumCells = VTK_ID_MAX;
   vtkIdType *minCells = nullptr;
   vtkIdType minPtId = 0;
   for (vtkIdType i=0; i<numPts; i++)
   {
     vtkIdType ptId = pts[i];
-    int numCells = this->Links->GetNcells(ptId);
-    vtkIdType *cells = this->Links->GetCells(ptId);
+    vtkIdType numCells;
+    vtkIdType *cells;
+    this->GetLinkedCells(ptId, numCells, cells);
     if ( numCells < minNumCells )
     {
       minNumCells = numCells;
@@ -30,8 +30,10 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkUnstructuredGridBase.h"
 
+class vtkAbstractCellLinks;
 class vtkCellArray;
 class vtkCellLinks;
+class vtkStaticCellLinks;
 class vtkConvexPointSet;
 class vtkEmptyCell;
 class vtkHexahedron;
@@ -60,6 +62,7 @@ class vtkQuadraticPyramid;
 class vtkQuadraticQuad;
 class vtkQuadraticTetra;
 class vtkQuadraticTriangle;
+class vtkSimpleCriticalSection;
 class vtkTetra;
 class vtkTriangle;
 class vtkTriangleStrip;
@@ -114,6 +117,8 @@ public:
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) override;
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) override;
   vtkCellIterator* NewCellIterator() override;
+  bool SupportsConcurrentReads() override { return true; }
+  void PrepareForConcurrentReads() override;
   //@}
 
   int GetCellType(vtkIdType cellId) override;
@@ -122,8 +127,38 @@ public:
   void Squeeze() override;
   void Initialize() override;
   int GetMaxCellSize() override;
-  void BuildLinks();
-  vtkCellLinks *GetCellLinks() {return this->Links;};
+
+  /**
+   * Build the upward links from points to the cells using them. Static
+   * links (see vtkStaticCellLinks) are built, with several threads when
+   * available. They are converted to editable vtkCellLinks by the first
+   * method that edits them (AddReferenceToCell(), ResizeCellList(), ...).
+   * A positive initialSize builds editable links directly, for at least
+   * initialSize points, as vtkPolyData::BuildLinks() does.
+   */
+  void BuildLinks(int initialSize=0);
+
+  /**
+   * Return the links built by BuildLinks(), static or editable, or nullptr
+   * if they are not built.
+   */
+  vtkAbstractCellLinks *GetLinks();
+
+  /**
+   * Return the editable links, converting the static links built by
+   * BuildLinks() if necessary, or nullptr if the links are not built.
+   * GetLinks() and GetPointCells() read the links without converting them.
+   */
+  vtkCellLinks *GetCellLinks();
+
+  /**
+   * Get the cells using the point ptId, without copying them. The links
+   * must have been built.
+   */
+  void GetPointCells(vtkIdType ptId, vtkIdType& ncells, vtkIdType* &cells)
+    VTK_SIZEHINT(cells, ncells)
+    { this->GetLinkedCells(ptId, ncells, cells); }
+
   virtual void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                              vtkIdType* &pts);
 
@@ -253,6 +288,31 @@ public:
   vtkIdTypeArray* GetFaceLocations(){return this->FaceLocations;};
   //@}
 
+  /**
+   * Build the topology of all the polyhedron cells at once, unless it is up
+   * to date: their faces in point ids local to the cell, their edges with
+   * the two faces using each of them, and the cell on the other side of each
+   * face. It is computed with several threads when vtkSMPTools provides them.
+   * GetCell() loads it into the vtkPolyhedron instead of generating the edges
+   * and faces of every cell again. The topology is released when the cells
+   * change; GetCell() then builds it again once it has returned a number of
+   * polyhedra proportional to the number of cells, so that inserting and
+   * getting cells in turn does not rebuild it every time.
+   * PrepareForConcurrentReads() calls this method, so that the threads
+   * reading the cells use the topology from the first cell. The build is
+   * guarded by a lock, so that GetCell() can be called concurrently.
+   */
+  void BuildPolyhedronTopology();
+
+  /**
+   * Return the cell on the other side of the face faceId of the polyhedron
+   * cellId, that is the cell with the smallest id, other than cellId, using
+   * all the points of the face. Return -1 if the face is on the boundary or
+   * if cellId is not a polyhedron. The polyhedron topology is built if
+   * needed.
+   */
+  vtkIdType GetPolyhedronFaceNeighbor(vtkIdType cellId, int faceId);
+
   /**
    * Special function used by vtkUnstructuredGridReader.
    * By default vtkUnstructuredGrid does not contain face information, which is
@@ -383,6 +443,7 @@ protected:
   // point data (i.e., scalars, vectors, normals, tcoords) inherited
   vtkCellArray *Connectivity;
   vtkCellLinks *Links;
+  vtkStaticCellLinks *StaticLinks;
   vtkUnsignedCharArray *Types;
   vtkIdTypeArray *Locations;
 
@@ -400,12 +461,31 @@ protected:
     vtkIdType nfaces, const vtkIdType faces[]) override;
   void InternalReplaceCell(vtkIdType cellId, int npts, const vtkIdType pts[]) override;
 
+  /**
+   * Convert the static links, if any, into editable links.
+   */
+  void MakeLinksEditable();
+
 private:
   // Hide these from the user and the compiler.
   vtkUnstructuredGrid(const vtkUnstructuredGrid&) = delete;
   void operator=(const vtkUnstructuredGrid&) = delete;
 
   void Cleanup();
+
+  // Get the cells using a point from the static or editable links.
+  void GetLinkedCells(vtkIdType ptId, vtkIdType &ncells, vtkIdType* &cells);
+
+  // Topology of the polyhedron cells, see BuildPolyhedronTopology().
+  class vtkPolyhedronTopology;
+  vtkPolyhedronTopology *PolyhedronTopology;
+  vtkSimpleCriticalSection *PolyhedronTopologyLock;
+  vtkIdType PolyhedronTopologyMisses;
+  const vtkPolyhedronTopology *GetPolyhedronTopology(bool build);
+  void ComputePolyhedronTopology();
+  bool IsPolyhedronTopologyValid();
+  void ReleasePolyhedronTopology();
+  void LoadPolyhedronTopology(vtkIdType cellId, vtkPolyhedron *polyhedron);
 };
 
 #endif
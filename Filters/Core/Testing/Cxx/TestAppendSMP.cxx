@@ -0,0 +1,318 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAppendSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the bulk appending of vtkAppendFilter and vtkAppendPolyData does
+// not depend on the SMP backend, and that vtkAppendFilter merges the points
+// of identical inputs with the same numbering as the first input.
+
+#include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// A sphere with verts, lines and strips, and a grid of hexahedra and
+// tetrahedra, both with point and cell data.
+vtkSmartPointer<vtkPolyData> ConstructSphere(double center)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(center, 0.0, 0.0);
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(10);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> strips;
+  for (vtkIdType i = 0; i < 5; ++i)
+  {
+    const vtkIdType vert = 3 * i;
+    verts->InsertNextCell(1, &vert);
+    const vtkIdType line[3] = { i, i + 7, i + 9 };
+    lines->InsertNextCell(3, line);
+    const vtkIdType strip[4] = { i, i + 1, i + 17, i + 18 };
+    strips->InsertNextCell(4, strip);
+  }
+  input->SetVerts(verts);
+  input->SetLines(lines);
+  input->SetStrips(strips);
+
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfComponents(2);
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    ints->InsertNextTuple2(ptId, center);
+  }
+  input->GetPointData()->AddArray(ints);
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    values->InsertNextValue(0.5 * cellId + center);
+  }
+  input->GetCellData()->AddArray(values);
+  return input;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid(double center)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfComponents(2);
+  for (int k = 0; k < 4; ++k)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        const vtkIdType ptId =
+          points->InsertNextPoint(center + 0.5 * i, 0.5 * j, 0.5 * k);
+        ints->InsertNextTuple2(ptId, -center);
+      }
+    }
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> input =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  input->SetPoints(points);
+  input->GetPointData()->AddArray(ints);
+  input->Allocate(27);
+  for (int k = 0; k < 3; ++k)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        const vtkIdType p = i + 4 * j + 16 * k;
+        if ((i + j + k) % 2)
+        {
+          const vtkIdType hexahedron[8] =
+            { p, p + 1, p + 5, p + 4, p + 16, p + 17, p + 21, p + 20 };
+          input->InsertNextCell(VTK_HEXAHEDRON, 8, hexahedron);
+        }
+        else
+        {
+          const vtkIdType tetra[4] = { p, p + 1, p + 4, p + 16 };
+          input->InsertNextCell(VTK_TETRA, 4, tetra);
+        }
+      }
+    }
+  }
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    values->InsertNextValue(cellId + center);
+  }
+  input->GetCellData()->AddArray(values);
+  return input;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Append(
+  const std::vector<vtkSmartPointer<vtkDataSet> >& inputs, bool merge)
+{
+  vtkNew<vtkAppendFilter> append;
+  for (vtkDataSet *input : inputs)
+  {
+    append->AddInputData(input);
+  }
+  append->SetMergePoints(merge);
+  append->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->DeepCopy(append->GetOutput());
+  return output;
+}
+
+vtkSmartPointer<vtkPolyData> AppendPolyData(
+  const std::vector<vtkSmartPointer<vtkPolyData> >& inputs)
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (vtkPolyData *input : inputs)
+  {
+    append->AddInputData(input);
+  }
+  append->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(append->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray *cells1, vtkCellArray *cells2)
+{
+  const vtkIdType size = cells1->GetNumberOfConnectivityEntries();
+  return cells1->GetNumberOfCells() == cells2->GetNumberOfCells() &&
+    size == cells2->GetNumberOfConnectivityEntries() &&
+    (size == 0 || std::memcmp(cells1->GetPointer(), cells2->GetPointer(),
+                              size * sizeof(vtkIdType)) == 0);
+}
+
+bool SameOutputs(vtkUnstructuredGrid *output1, vtkUnstructuredGrid *output2)
+{
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    SameCells(output1->GetCells(), output2->GetCells()) &&
+    SameArrays(output1->GetCellTypesArray(), output2->GetCellTypesArray()) &&
+    SameArrays(output1->GetCellLocationsArray(),
+               output2->GetCellLocationsArray()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    SameCells(output1->GetVerts(), output2->GetVerts()) &&
+    SameCells(output1->GetLines(), output2->GetLines()) &&
+    SameCells(output1->GetPolys(), output2->GetPolys()) &&
+    SameCells(output1->GetStrips(), output2->GetStrips()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestAppendSMP(int, char *[])
+{
+  std::vector<vtkSmartPointer<vtkDataSet> > dataSets;
+  std::vector<vtkSmartPointer<vtkPolyData> > polyData;
+  for (int i = 0; i < 8; ++i)
+  {
+    dataSets.push_back(ConstructGrid(1.5 * i));
+    dataSets.push_back(ConstructSphere(1.5 * i));
+    polyData.push_back(ConstructSphere(2.0 * i));
+  }
+
+  // Identical grids merge into the first one.
+  vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid(0.0);
+  std::vector<vtkSmartPointer<vtkDataSet> > grids(5, grid);
+  vtkSmartPointer<vtkUnstructuredGrid> merged = Append(grids, true);
+  if (!SameArrays(grid->GetPoints()->GetData(),
+                  merged->GetPoints()->GetData()) ||
+      merged->GetNumberOfCells() != 5 * grid->GetNumberOfCells() ||
+      merged->GetCellLocationsArray()->GetValue(grid->GetNumberOfCells()) !=
+        grid->GetCells()->GetNumberOfConnectivityEntries() ||
+      !SameArrays(grid->GetPointData()->GetArray("Ints"),
+                  merged->GetPointData()->GetArray("Ints")))
+  {
+    std::cerr << "Error: wrong merging of identical grids" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType cellId = 0; cellId < merged->GetNumberOfCells(); ++cellId)
+  {
+    vtkIdType npts1, *pts1, npts2, *pts2;
+    grid->GetCellPoints(cellId % grid->GetNumberOfCells(), npts1, pts1);
+    merged->GetCellPoints(cellId, npts2, pts2);
+    if (npts1 != npts2 ||
+        std::memcmp(pts1, pts2, npts1 * sizeof(vtkIdType)) != 0)
+    {
+      std::cerr << "Error: wrong merged cell " << cellId << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (int merge = 0; merge < 2; ++merge)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> reference;
+    vtkSmartPointer<vtkPolyData> polyDataReference;
+    auto computeReference = [&]()
+    {
+      reference = Append(dataSets, merge);
+      polyDataReference = AppendPolyData(polyData);
+      return true;
+    };
+    auto compare = [&](const char *backend)
+    {
+      if (!SameOutputs(reference, Append(dataSets, merge)))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a "
+                  << "different unstructured grid with merging " << merge
+                  << std::endl;
+        return false;
+      }
+      if (!SameOutputs(polyDataReference, AppendPolyData(polyData)))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a "
+                  << "different polygonal data" << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
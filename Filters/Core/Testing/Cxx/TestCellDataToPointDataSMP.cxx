@@ -0,0 +1,233 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkCellDataToPointData gives exactly the
+// same output as a serial execution, for unstructured grids and polydata
+// with cells of several dimensions.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellDataToPointData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+// Cell attributes of several types.
+void AddCellData(vtkDataSet *dataSet)
+{
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  vtkNew<vtkUnsignedCharArray> chars;
+  chars->SetName("Chars");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    doubles->InsertNextTuple3(0.1 * cellId, 1.0 / (cellId + 1), -0.3 * cellId);
+    floats->InsertNextValue(static_cast<float>(cellId % 17) / 3.0f);
+    ints->InsertNextValue(static_cast<int>(cellId * 7));
+    chars->InsertNextValue(static_cast<unsigned char>(cellId % 251));
+  }
+  dataSet->GetCellData()->AddArray(doubles);
+  dataSet->GetCellData()->AddArray(floats);
+  dataSet->GetCellData()->AddArray(ints);
+  dataSet->GetCellData()->SetScalars(chars);
+}
+
+// Convert the wavelet to an unstructured grid, with a few cells of lower
+// dimensions in between.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-8, 8, -8, 8, -8, 8);
+  source->Update();
+  vtkImageData *image = source->GetOutput();
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->SetPoint(ptId, image->GetPoint(ptId));
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+
+  vtkNew<vtkIdList> ids;
+  grid->Allocate(image->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, ids);
+    const vtkIdType *v = ids->GetPointer(0);
+    switch (cellId % 5)
+    {
+      case 1:
+        grid->InsertNextCell(VTK_PIXEL, 4, v);
+        break;
+      case 2:
+        grid->InsertNextCell(VTK_LINE, 2, v + 3);
+        break;
+      case 3:
+        grid->InsertNextCell(VTK_VERTEX, 1, v + 7);
+        break;
+      default:
+        break;
+    }
+    grid->InsertNextCell(VTK_VOXEL, ids);
+  }
+  AddCellData(grid);
+  return grid;
+}
+
+// A sphere, with vertices and lines.
+vtkSmartPointer<vtkPolyData> ConstructPolyData()
+{
+  vtkNew<vtkSphereSource> source;
+  source->SetThetaResolution(40);
+  source->SetPhiResolution(30);
+  source->Update();
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->DeepCopy(source->GetOutput());
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType ptId = 0; ptId + 1 < polyData->GetNumberOfPoints(); ptId += 3)
+  {
+    verts->InsertNextCell(1, &ptId);
+    const vtkIdType line[2] = { ptId, ptId + 1 };
+    lines->InsertNextCell(2, line);
+  }
+  polyData->SetVerts(verts);
+  polyData->SetLines(lines);
+  AddCellData(polyData);
+  return polyData;
+}
+
+vtkSmartPointer<vtkDataSet> Convert(vtkDataSet *input, int options)
+{
+  vtkNew<vtkCellDataToPointData> convert;
+  convert->SetInputData(input);
+  convert->SetContributingCellOption(options % 3);
+  convert->SetPassCellData(options >= 3);
+  convert->Update();
+
+  vtkSmartPointer<vtkDataSet> output;
+  output.TakeReference(convert->GetOutput()->NewInstance());
+  output->DeepCopy(convert->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestCellDataToPointDataSMP(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid();
+  vtkSmartPointer<vtkPolyData> polyData = ConstructPolyData();
+  vtkDataSet *inputs[] = { grid, polyData };
+
+  for (vtkDataSet *input : inputs)
+  {
+    for (int options = 0; options < 6; ++options)
+    {
+      vtkSmartPointer<vtkDataSet> reference;
+      auto computeReference = [&]()
+      {
+        reference = Convert(input, options);
+        if (!reference->GetPointData()->GetArray("Doubles"))
+        {
+          std::cerr << "Error: no point data for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkDataSet> output = Convert(input, options);
+        if (!SameAttributes(reference->GetPointData(),
+                            output->GetPointData()) ||
+            !SameAttributes(reference->GetCellData(), output->GetCellData()))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different result for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
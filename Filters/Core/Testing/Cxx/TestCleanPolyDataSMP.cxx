@@ -0,0 +1,208 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel mode of vtkCleanPolyData gives the same cells as
+// the serial mode, for cells in the legacy and split storage. Only the
+// numbering of the output points may differ, so the cells are compared
+// through the coordinates of their points.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+// Build a "soup" where every cell has its own points, from the triangles of
+// a sphere. Some cells are made degenerate, and some points are unused.
+vtkSmartPointer<vtkPolyData> ConstructSoup()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+  vtkPolyData *mesh = sphere->GetOutput();
+  vtkPoints *meshPts = mesh->GetPoints();
+
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts, lines, polys, strips;
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  vtkIdType npts, *pts, newPts[4], cellId = 0;
+  vtkCellArray *meshPolys = mesh->GetPolys();
+  for (meshPolys->InitTraversal(); meshPolys->GetNextCell(npts, pts); ++cellId)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      newPts[i] = points->InsertNextPoint(meshPts->GetPoint(pts[i]));
+    }
+    points->InsertNextPoint(0.0, 0.0, 0.0); // unused
+    switch (cellId % 7)
+    {
+      case 0: // degenerate triangle
+        newPts[1] = newPts[0];
+        polys->InsertNextCell(npts, newPts);
+        break;
+      case 1:
+        verts->InsertNextCell(1, newPts);
+        break;
+      case 2: // polyline, degenerate for a pole of the sphere
+        lines->InsertNextCell(npts, newPts);
+        break;
+      case 3: // strip degenerate to a triangle
+        newPts[3] = newPts[2];
+        strips->InsertNextCell(4, newPts);
+        break;
+      case 4: // degenerate line
+        newPts[1] = newPts[0];
+        lines->InsertNextCell(2, newPts);
+        break;
+      default:
+        polys->InsertNextCell(npts, newPts);
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> soup = vtkSmartPointer<vtkPolyData>::New();
+  soup->SetPoints(points);
+  soup->SetVerts(verts);
+  soup->SetLines(lines);
+  soup->SetPolys(polys);
+  soup->SetStrips(strips);
+  cellIds->SetNumberOfTuples(soup->GetNumberOfCells());
+  for (vtkIdType i = 0; i < soup->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  soup->GetCellData()->AddArray(cellIds);
+  // A point attribute which does not depend on which point is kept.
+  soup->GetPointData()->SetScalars(points->GetData());
+  return soup;
+}
+
+vtkSmartPointer<vtkPolyData> Clean(vtkPolyData *input, bool parallel,
+                                   int options)
+{
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputData(input);
+  clean->SetParallelProcessing(parallel);
+  clean->SetPointMerging(options & 1);
+  clean->SetConvertLinesToPoints((options >> 1) & 1);
+  clean->SetConvertPolysToLines((options >> 2) & 1);
+  clean->SetConvertStripsToPolys((options >> 3) & 1);
+  clean->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(clean->GetOutput());
+  return output;
+}
+
+bool SameCells(vtkPolyData *output1, vtkPolyData *output2)
+{
+  if (output1->GetNumberOfPoints() != output2->GetNumberOfPoints() ||
+      output1->GetNumberOfVerts() != output2->GetNumberOfVerts() ||
+      output1->GetNumberOfLines() != output2->GetNumberOfLines() ||
+      output1->GetNumberOfPolys() != output2->GetNumberOfPolys() ||
+      output1->GetNumberOfStrips() != output2->GetNumberOfStrips())
+  {
+    std::cerr << "Error: different number of points or cells" << std::endl;
+    return false;
+  }
+
+  vtkIdTypeArray *cellIds1 = vtkArrayDownCast<vtkIdTypeArray>(
+    output1->GetCellData()->GetArray("CellIds"));
+  vtkIdTypeArray *cellIds2 = vtkArrayDownCast<vtkIdTypeArray>(
+    output2->GetCellData()->GetArray("CellIds"));
+  vtkDataArray *scalars2 = output2->GetPointData()->GetScalars();
+  vtkNew<vtkIdList> pts1, pts2;
+  for (vtkIdType cellId = 0; cellId < output1->GetNumberOfCells(); ++cellId)
+  {
+    output1->GetCellPoints(cellId, pts1);
+    output2->GetCellPoints(cellId, pts2);
+    if (output1->GetCellType(cellId) != output2->GetCellType(cellId) ||
+        pts1->GetNumberOfIds() != pts2->GetNumberOfIds() ||
+        cellIds1->GetValue(cellId) != cellIds2->GetValue(cellId))
+    {
+      std::cerr << "Error: different cell " << cellId << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < pts1->GetNumberOfIds(); ++i)
+    {
+      double x1[3], x2[3], s2[3];
+      output1->GetPoint(pts1->GetId(i), x1);
+      output2->GetPoint(pts2->GetId(i), x2);
+      scalars2->GetTuple(pts2->GetId(i), s2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2] ||
+          x2[0] != s2[0] || x2[1] != s2[1] || x2[2] != s2[2])
+      {
+        std::cerr << "Error: different point in cell " << cellId << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestCleanPolyDataSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> input = ConstructSoup();
+  vtkNew<vtkPolyData> splitInput;
+  splitInput->DeepCopy(input);
+  vtkCellArray *splitCells[4] = { splitInput->GetVerts(),
+    splitInput->GetLines(), splitInput->GetPolys(), splitInput->GetStrips() };
+  for (vtkCellArray *cells : splitCells)
+  {
+    cells->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+  }
+
+  for (int options = 0; options < 16; ++options)
+  {
+    vtkSmartPointer<vtkPolyData> reference = Clean(input, false, options);
+    if ((options & 1) &&
+        reference->GetNumberOfPoints() * 4 > input->GetNumberOfPoints())
+    {
+      std::cerr << "Error: points were not merged" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    auto testBackend = [&](const char *backend)
+    {
+      vtkSmartPointer<vtkPolyData> output = Clean(input, true, options);
+      vtkSmartPointer<vtkPolyData> splitOutput =
+        Clean(splitInput, true, options);
+      if (!SameCells(reference, output) ||
+          !SameCells(reference, splitOutput) ||
+          splitInput->GetPolys()->GetStorageMode() !=
+            vtkCellArray::SPLIT_STORAGE_32BIT)
+      {
+        std::cerr << "Error: the " << backend << " backend gives a different "
+                  << "result with options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
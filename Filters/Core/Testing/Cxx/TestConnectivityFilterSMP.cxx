@@ -0,0 +1,349 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel labeling of vtkConnectivityFilter and
+// vtkPolyDataConnectivityFilter extracts the same cells, with the same
+// region ids, as the serial traversal, in all the extraction modes. Only the
+// order of the output points may differ: it must be the input order.
+
+#include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkConnectivityFilter.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataConnectivityFilter.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+// Spheres of several sizes, two of them joined by a line, with their cells
+// shuffled, a few isolated vertices and unused points.
+vtkSmartPointer<vtkPolyData> ConstructPolyData()
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (int i = 0; i < 12; ++i)
+  {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(3.0 * i, 0.0, 0.0);
+    sphere->SetThetaResolution(4 + i % 5);
+    sphere->SetPhiResolution(3 + i % 4);
+    sphere->Update();
+    append->AddInputData(sphere->GetOutput());
+  }
+  append->Update();
+  vtkPolyData *spheres = append->GetOutput();
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  points->DeepCopy(spheres->GetPoints());
+  const vtkIdType numSpherePts = points->GetNumberOfPoints();
+  for (int i = 0; i < 10; ++i)
+  {
+    points->InsertNextPoint(0.5 * i, 5.0, 0.0);
+  }
+  polyData->SetPoints(points);
+
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType ptId = numSpherePts; ptId < numSpherePts + 10; ptId += 3)
+  {
+    verts->InsertNextCell(1, &ptId);
+  }
+  vtkNew<vtkCellArray> lines;
+  const vtkIdType line[2] = { 0, numSpherePts - 1 };
+  lines->InsertNextCell(2, line);
+  vtkNew<vtkCellArray> polys;
+  const vtkIdType numPolys = spheres->GetNumberOfPolys();
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < numPolys; ++i)
+  {
+    spheres->GetCellPoints((i * 37) % numPolys, ptIds);
+    polys->InsertNextCell(ptIds);
+  }
+  polyData->SetVerts(verts);
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("PointIds");
+  for (vtkIdType ptId = 0; ptId < polyData->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->InsertNextValue(ptId);
+  }
+  polyData->GetPointData()->AddArray(pointIds);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < polyData->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+  }
+  polyData->GetCellData()->AddArray(cellIds);
+  return polyData;
+}
+
+void SetExtraction(int options, vtkIdList *seeds, vtkIdList *regions)
+{
+  seeds->Reset();
+  regions->Reset();
+  switch (options % 6)
+  {
+    case VTK_EXTRACT_POINT_SEEDED_REGIONS:
+      seeds->InsertNextId(5);
+      seeds->InsertNextId(200);
+      break;
+    case VTK_EXTRACT_CELL_SEEDED_REGIONS:
+      seeds->InsertNextId(1);
+      seeds->InsertNextId(100);
+      seeds->InsertNextId(101);
+      break;
+    case VTK_EXTRACT_SPECIFIED_REGIONS:
+      regions->InsertNextId(1);
+      regions->InsertNextId(4);
+      break;
+    default:
+      break;
+  }
+}
+
+vtkSmartPointer<vtkPointSet> Extract(vtkDataSet *input, int options,
+                                     bool parallel, int &numRegions)
+{
+  vtkNew<vtkIdList> seeds;
+  vtkNew<vtkIdList> regions;
+  SetExtraction(options, seeds, regions);
+  const int mode = options % 6 == 0 ? VTK_EXTRACT_CLOSEST_POINT_REGION :
+                                      options % 6;
+
+  vtkNew<vtkConnectivityFilter> connectivity;
+  connectivity->SetInputData(input);
+  connectivity->SetExtractionMode(mode);
+  connectivity->SetColorRegions(options >= 6);
+  connectivity->SetRegionIdAssignmentMode(options >= 12 ?
+    vtkConnectivityFilter::CELL_COUNT_DESCENDING :
+    vtkConnectivityFilter::UNSPECIFIED);
+  connectivity->SetClosestPoint(15.0, 0.5, 0.0);
+  for (vtkIdType i = 0; i < seeds->GetNumberOfIds(); ++i)
+  {
+    connectivity->AddSeed(seeds->GetId(i));
+  }
+  for (vtkIdType i = 0; i < regions->GetNumberOfIds(); ++i)
+  {
+    connectivity->AddSpecifiedRegion(static_cast<int>(regions->GetId(i)));
+  }
+  connectivity->SetParallelLabeling(parallel);
+  connectivity->Update();
+  numRegions = connectivity->GetNumberOfExtractedRegions();
+
+  vtkSmartPointer<vtkPointSet> output;
+  output.TakeReference(vtkPointSet::SafeDownCast(
+    connectivity->GetOutput()->NewInstance()));
+  output->DeepCopy(connectivity->GetOutput());
+  return output;
+}
+
+vtkSmartPointer<vtkPolyData> ExtractPolyData(vtkPolyData *input, int options,
+                                             bool parallel,
+                                             vtkIdTypeArray *regionSizes)
+{
+  vtkNew<vtkIdList> seeds;
+  vtkNew<vtkIdList> regions;
+  SetExtraction(options, seeds, regions);
+  const int mode = options % 6 == 0 ? VTK_EXTRACT_CLOSEST_POINT_REGION :
+                                      options % 6;
+
+  vtkNew<vtkPolyDataConnectivityFilter> connectivity;
+  connectivity->SetInputData(input);
+  connectivity->SetExtractionMode(mode);
+  connectivity->SetColorRegions(options >= 6);
+  connectivity->SetClosestPoint(15.0, 0.5, 0.0);
+  for (vtkIdType i = 0; i < seeds->GetNumberOfIds(); ++i)
+  {
+    connectivity->AddSeed(static_cast<int>(seeds->GetId(i)));
+  }
+  for (vtkIdType i = 0; i < regions->GetNumberOfIds(); ++i)
+  {
+    connectivity->AddSpecifiedRegion(static_cast<int>(regions->GetId(i)));
+  }
+  connectivity->SetParallelLabeling(parallel);
+  connectivity->Update();
+  regionSizes->DeepCopy(connectivity->GetRegionSizes());
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(connectivity->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+// The cells and cell data must be identical. The points must be the same
+// input points, in increasing order for the parallel output, with the same
+// region ids.
+bool SameOutputs(vtkPointSet *serial, vtkPointSet *parallel)
+{
+  vtkDataArray *serialIds = serial->GetPointData()->GetArray("PointIds");
+  vtkDataArray *parallelIds = parallel->GetPointData()->GetArray("PointIds");
+  vtkDataArray *serialRegions = serial->GetPointData()->GetArray("RegionId");
+  vtkDataArray *parallelRegions =
+    parallel->GetPointData()->GetArray("RegionId");
+  if (serial->GetNumberOfCells() == 0 ||
+      serial->GetNumberOfCells() != parallel->GetNumberOfCells() ||
+      serial->GetNumberOfPoints() != parallel->GetNumberOfPoints() ||
+      (serialRegions == nullptr) != (parallelRegions == nullptr))
+  {
+    return false;
+  }
+  for (int i = 0; i < serial->GetCellData()->GetNumberOfArrays(); ++i)
+  {
+    // vtkConnectivityFilter gives cell region ids for all the input cells,
+    // only set for the extracted ones.
+    vtkDataArray *array = serial->GetCellData()->GetArray(i);
+    if (array->GetNumberOfTuples() != serial->GetNumberOfCells())
+    {
+      continue;
+    }
+    if (!SameArrays(array,
+                    parallel->GetCellData()->GetArray(array->GetName())))
+    {
+      std::cerr << "Error: different " << array->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+
+  for (vtkIdType ptId = 1; ptId < parallel->GetNumberOfPoints(); ++ptId)
+  {
+    if (parallelIds->GetTuple1(ptId - 1) >= parallelIds->GetTuple1(ptId))
+    {
+      std::cerr << "Error: points out of order" << std::endl;
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> serialPts;
+  vtkNew<vtkIdList> parallelPts;
+  for (vtkIdType cellId = 0; cellId < serial->GetNumberOfCells(); ++cellId)
+  {
+    serial->GetCellPoints(cellId, serialPts);
+    parallel->GetCellPoints(cellId, parallelPts);
+    if (serial->GetCellType(cellId) != parallel->GetCellType(cellId) ||
+        serialPts->GetNumberOfIds() != parallelPts->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < serialPts->GetNumberOfIds(); ++i)
+    {
+      const vtkIdType ptId1 = serialPts->GetId(i);
+      const vtkIdType ptId2 = parallelPts->GetId(i);
+      if (serialIds->GetTuple1(ptId1) != parallelIds->GetTuple1(ptId2) ||
+          (serialRegions && serialRegions->GetTuple1(ptId1) !=
+                              parallelRegions->GetTuple1(ptId2)))
+      {
+        std::cerr << "Error: different points for cell " << cellId
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestConnectivityFilterSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> polyData = ConstructPolyData();
+  vtkNew<vtkAppendFilter> toGrid;
+  toGrid->SetInputData(polyData);
+  toGrid->Update();
+  vtkDataSet *inputs[] = { polyData, toGrid->GetOutput() };
+
+  for (int options = 0; options < 18; ++options)
+  {
+    for (vtkDataSet *input : inputs)
+    {
+      int numRegions, numParallelRegions;
+      vtkSmartPointer<vtkPointSet> reference =
+        Extract(input, options, false, numRegions);
+      auto testBackend = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPointSet> output =
+          Extract(input, options, true, numParallelRegions);
+        if (numRegions != numParallelRegions ||
+            !SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different result for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (options >= 12)
+    {
+      continue;
+    }
+    vtkNew<vtkIdTypeArray> regionSizes;
+    vtkSmartPointer<vtkPolyData> reference =
+      ExtractPolyData(polyData, options, false, regionSizes);
+    auto testBackend = [&](const char *backend)
+    {
+      vtkNew<vtkIdTypeArray> parallelRegionSizes;
+      vtkSmartPointer<vtkPolyData> output =
+        ExtractPolyData(polyData, options, true, parallelRegionSizes);
+      if (!SameArrays(regionSizes, parallelRegionSizes) ||
+          !SameOutputs(reference, output))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a "
+                  << "different result for vtkPolyDataConnectivityFilter "
+                  << "with options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
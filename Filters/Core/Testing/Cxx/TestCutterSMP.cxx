@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkCutter gives exactly the same output as a
+// serial execution, for unstructured grids with cells of all dimensions, in
+// the legacy and split storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCutter.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+// Split the cells of the wavelet into cells of several types and dimensions.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-10, 10, -10, 10, -10, 10);
+  source->Update();
+  vtkImageData *image = source->GetOutput();
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->SetPoint(ptId, image->GetPoint(ptId));
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+
+  vtkNew<vtkIdList> ids;
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->SetNumberOfComponents(2);
+  grid->Allocate(image->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, ids);
+    const vtkIdType *v = ids->GetPointer(0);
+    const vtkIdType c[8] = { v[0], v[1], v[3], v[2], v[4], v[5], v[7], v[6] };
+    switch (cellId % 5)
+    {
+      case 0:
+        grid->InsertNextCell(VTK_VOXEL, ids);
+        break;
+      case 1:
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+        grid->InsertNextCell(VTK_LINE, 2, c + 5);
+        break;
+      case 2:
+      {
+        const vtkIdType wedge1[6] = { c[0], c[1], c[3], c[4], c[5], c[7] };
+        const vtkIdType wedge2[6] = { c[1], c[2], c[3], c[5], c[6], c[7] };
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+        break;
+      }
+      case 3:
+      {
+        const vtkIdType pyramid[5] = { c[0], c[1], c[2], c[3], c[6] };
+        const vtkIdType tetra[4] = { c[0], c[6], c[7], c[3] };
+        grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+        grid->InsertNextCell(VTK_TETRA, 4, tetra);
+        grid->InsertNextCell(VTK_VERTEX, 1, c + 4);
+        break;
+      }
+      default:
+        grid->InsertNextCell(VTK_QUAD, 4, c);
+        grid->InsertNextCell(VTK_TRIANGLE, 3, c + 4);
+    }
+    while (cellValues->GetNumberOfTuples() < grid->GetNumberOfCells())
+    {
+      cellValues->InsertNextTuple2(cellId, grid->GetNumberOfCells());
+    }
+  }
+  grid->GetCellData()->AddArray(cellValues);
+  return grid;
+}
+
+vtkSmartPointer<vtkPolyData> Cut(vtkUnstructuredGrid *input, int options)
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.5, 0.25, 0.125);
+  plane->SetNormal(1.0, 2.0, 3.0);
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(1.0, -0.5, 0.25);
+  sphere->SetRadius(1.0);
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputData(input);
+  if (options & 1)
+  {
+    cutter->SetCutFunction(sphere);
+    cutter->SetValue(0, 0.0);
+    cutter->SetValue(1, 15.0);
+    cutter->SetValue(2, 49.0);
+  }
+  else
+  {
+    cutter->SetCutFunction(plane);
+    cutter->GenerateValues(5, -20.0, 20.0);
+  }
+  cutter->SetGenerateCutScalars((options >> 1) & 1);
+  cutter->SetOutputPointsPrecision(options & 4 ?
+    vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+  cutter->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(cutter->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    // The generated cut scalars are not named.
+    if (!SameArrays(attributes1->GetArray(i), attributes2->GetArray(i)))
+    {
+      std::cerr << "Error: different arrays " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray *cells1, vtkCellArray *cells2)
+{
+  const vtkIdType size = cells1->GetNumberOfConnectivityEntries();
+  return cells1->GetNumberOfCells() == cells2->GetNumberOfCells() &&
+    size == cells2->GetNumberOfConnectivityEntries() &&
+    (size == 0 || std::memcmp(cells1->GetPointer(), cells2->GetPointer(),
+                              size * sizeof(vtkIdType)) == 0);
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    SameCells(output1->GetVerts(), output2->GetVerts()) &&
+    SameCells(output1->GetLines(), output2->GetLines()) &&
+    SameCells(output1->GetPolys(), output2->GetPolys()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestCutterSMP(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> input = ConstructGrid();
+  vtkNew<vtkUnstructuredGrid> splitInput;
+  splitInput->DeepCopy(input);
+  splitInput->GetCells()->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+
+  for (int options = 0; options < 8; ++options)
+  {
+    vtkSmartPointer<vtkPolyData> reference;
+    auto computeReference = [&]()
+    {
+      reference = Cut(input, options);
+      if (reference->GetNumberOfVerts() == 0 ||
+          reference->GetNumberOfLines() == 0 ||
+          reference->GetNumberOfPolys() == 0)
+      {
+        std::cerr << "Error: missing cells with options " << options
+                  << std::endl;
+        return false;
+      }
+      return true;
+    };
+    auto compare = [&](const char *backend)
+    {
+      vtkSmartPointer<vtkPolyData> output = Cut(input, options);
+      vtkSmartPointer<vtkPolyData> splitOutput = Cut(splitInput, options);
+      if (!SameOutputs(reference, output) ||
+          !SameOutputs(reference, splitOutput))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a "
+                  << "different cut with options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFeatureEdgesSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkFeatureEdges extracts the same edges as a
+// serial execution, with all the combinations of edge types.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkFeatureEdges.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+void AddAttributes(vtkPolyData *input)
+{
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  ints->SetNumberOfComponents(2);
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    scalars->InsertNextValue(0.25f * ptId);
+    ints->InsertNextTuple2(ptId, -ptId);
+  }
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->AddArray(ints);
+
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    values->InsertNextValue(1.5 * cellId);
+    ghosts->InsertNextValue(cellId % 23 == 0 ?
+      vtkDataSetAttributes::DUPLICATECELL : 0);
+  }
+  input->GetCellData()->AddArray(values);
+  input->GetCellData()->AddArray(ghosts);
+}
+
+// A bumpy sphere whose points are split along the sharp edges, so that
+// coincident points have to be merged.
+vtkSmartPointer<vtkPolyData> ConstructSphere()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(24);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> bumpy = vtkSmartPointer<vtkPolyData>::New();
+  bumpy->DeepCopy(sphere->GetOutput());
+  vtkPoints *points = bumpy->GetPoints();
+  for (vtkIdType ptId = 0; ptId < bumpy->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    const double scale = 1.0 + 0.2 * std::sin(5.0 * ptId);
+    points->SetPoint(ptId, scale * x[0], scale * x[1], scale * x[2]);
+  }
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(bumpy);
+  normals->SetFeatureAngle(20.0);
+  normals->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(normals->GetOutput());
+  input->GetPointData()->Initialize();
+  AddAttributes(input);
+  return input;
+}
+
+// A bumpy plane of quads with holes, and a fan of triangles sharing a
+// non-manifold edge.
+vtkSmartPointer<vtkPolyData> ConstructPlane()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(20, 15);
+  plane->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(plane->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    x[2] = 0.3 * std::fabs(x[0]) + 0.05 * std::sin(3.0 * ptId);
+    points->SetPoint(ptId, x);
+  }
+
+  vtkNew<vtkCellArray> polys;
+  vtkIdType npts, *pts;
+  vtkIdType cellId = 0;
+  vtkCellArray *quads = input->GetPolys();
+  for (quads->InitTraversal(); quads->GetNextCell(npts, pts); ++cellId)
+  {
+    if (cellId % 17 != 5)
+    {
+      polys->InsertNextCell(npts, pts);
+    }
+  }
+  const vtkIdType p0 = points->InsertNextPoint(1.0, 0.0, 0.0);
+  const vtkIdType p1 = points->InsertNextPoint(1.0, 1.0, 0.0);
+  for (int i = 0; i < 4; ++i)
+  {
+    const vtkIdType triangle[3] = { p0, p1, points->InsertNextPoint(
+      1.0 + std::cos(1.3 * i), 0.5, std::sin(1.3 * i)) };
+    polys->InsertNextCell(3, triangle);
+  }
+  input->SetPolys(polys);
+  input->GetPointData()->Initialize();
+  AddAttributes(input);
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> ExtractEdges(vtkPolyData *input, int options)
+{
+  vtkNew<vtkFeatureEdges> edges;
+  edges->SetInputData(input);
+  edges->SetBoundaryEdges(options & 1);
+  edges->SetFeatureEdges((options >> 1) & 1);
+  edges->SetNonManifoldEdges((options >> 2) & 1);
+  edges->SetManifoldEdges((options >> 3) & 1);
+  edges->SetColoring((options >> 4) & 1);
+  edges->SetFeatureAngle(options & 32 ? 10.0 : 40.0);
+  edges->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(edges->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  vtkCellArray *lines1 = output1->GetLines();
+  vtkCellArray *lines2 = output2->GetLines();
+  const vtkIdType size = lines1->GetNumberOfConnectivityEntries();
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    lines1->GetNumberOfCells() == lines2->GetNumberOfCells() &&
+    size == lines2->GetNumberOfConnectivityEntries() &&
+    (size == 0 || std::memcmp(lines1->GetPointer(), lines2->GetPointer(),
+                              size * sizeof(vtkIdType)) == 0) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestFeatureEdgesSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> inputs[] = { ConstructSphere(),
+                                            ConstructPlane() };
+
+  for (vtkPolyData *input : inputs)
+  {
+    for (int options = 0; options < 64; ++options)
+    {
+      vtkSmartPointer<vtkPolyData> reference;
+      auto computeReference = [&]()
+      {
+        reference = ExtractEdges(input, options);
+        if ((options & 1) && reference->GetNumberOfLines() == 0)
+        {
+          std::cerr << "Error: no boundary edges with options " << options
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output = ExtractEdges(input, options);
+        if (!SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "edges with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,289 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkGlyph3D gives the same glyphs as a serial
+// execution, with all the scaling and coloring modes.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkGlyph3D.h>
+#include <vtkIntArray.h>
+#include <vtkLineSource.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPointSource.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTransform.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Random points with scalars, vectors, normals, another attribute and a few
+// duplicated ghost points.
+vtkSmartPointer<vtkPolyData> ConstructInput()
+{
+  vtkNew<vtkPointSource> source;
+  source->SetNumberOfPoints(2000);
+  source->SetRadius(10.0);
+  source->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->ShallowCopy(source->GetOutput());
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    input->GetPoint(ptId, x);
+    scalars->InsertNextValue(static_cast<float>(ptId % 13) / 6.0f - 0.5f);
+    if (ptId % 11 == 0)
+    {
+      vectors->InsertNextTuple3(-x[0], 0.0, 0.0);
+    }
+    else
+    {
+      vectors->InsertNextTuple3(x[1], -x[0], 0.5 * x[2]);
+    }
+    normals->InsertNextTuple3(x[2], x[0], -x[1]);
+    ints->InsertNextValue(static_cast<int>(ptId * 3));
+    ghosts->InsertNextValue(ptId % 17 == 0 ?
+      vtkDataSetAttributes::DUPLICATEPOINT : 0);
+  }
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->SetNormals(normals);
+  input->GetPointData()->AddArray(ints);
+  input->GetPointData()->AddArray(ghosts);
+  return input;
+}
+
+// A source whose verts, lines and polygons are interleaved.
+vtkSmartPointer<vtkPolyData> ConstructMixedSource()
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.0, 0.0);
+  points->InsertNextPoint(0.0, 1.0, 0.0);
+  points->InsertNextPoint(0.0, 0.0, 1.0);
+  vtkSmartPointer<vtkPolyData> source = vtkSmartPointer<vtkPolyData>::New();
+  source->SetPoints(points);
+  source->Allocate(10);
+  vtkIdType vert[1] = { 3 };
+  vtkIdType line[2] = { 0, 3 };
+  vtkIdType triangle[3] = { 0, 1, 2 };
+  vtkIdType quad[4] = { 0, 1, 3, 2 };
+  source->InsertNextCell(VTK_VERTEX, 1, vert);
+  source->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  source->InsertNextCell(VTK_LINE, 2, line);
+  source->InsertNextCell(VTK_QUAD, 4, quad);
+  source->InsertNextCell(VTK_VERTEX, 1, triangle);
+  return source;
+}
+
+vtkSmartPointer<vtkPolyData> Glyph(vtkPolyData *input, vtkPolyData *source,
+                                   int options)
+{
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateX(30.0);
+  sourceTransform->Scale(1.0, 2.0, 0.5);
+
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceData(source);
+  glyph->SetScaleMode(options % 4);
+  glyph->SetColorMode(options % 3);
+  glyph->SetVectorMode(options == 5 ? VTK_USE_NORMAL : VTK_USE_VECTOR);
+  glyph->SetScaleFactor(0.25);
+  glyph->SetFillCellData(options & 1);
+  glyph->SetGeneratePointIds((options >> 1) & 1);
+  if (options & 4)
+  {
+    glyph->SetSourceTransform(sourceTransform);
+  }
+  glyph->SetClamping((options >> 3) & 1);
+  glyph->SetRange(0.0, 5.0);
+  glyph->SetOutputPointsPrecision(options & 8 ?
+    vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+  glyph->Update();
+
+  // The output is kept as is: a deep copy would renumber its cells by type.
+  return glyph->GetOutput();
+}
+
+// Points and normals may differ by rounding with compilers contracting
+// floating point expressions differently, the rest must be identical.
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2, bool exact)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  if (exact)
+  {
+    return size == 0 ||
+      std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                  size * array1->GetDataTypeSize()) == 0;
+  }
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    const double value1 = array1->GetComponent(i / 3, i % 3);
+    const double value2 = array2->GetComponent(i / 3, i % 3);
+    if (std::fabs(value1 - value2) > 1e-6 * (1.0 + std::fabs(value1)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    vtkDataArray *array2 = attributes2->GetArray(array1->GetName());
+    if (!SameArrays(array1, array2, array1 != attributes1->GetNormals()))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES;
+       ++attribute)
+  {
+    vtkDataArray *array1 = attributes1->GetAttribute(attribute);
+    vtkDataArray *array2 = attributes2->GetAttribute(attribute);
+    if ((array1 == nullptr) != (array2 == nullptr) ||
+        (array1 && std::strcmp(array1->GetName(), array2->GetName()) != 0))
+    {
+      std::cerr << "Error: different attribute " << attribute << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray *cells1, vtkCellArray *cells2)
+{
+  const vtkIdType size = cells1->GetNumberOfConnectivityEntries();
+  return cells1->GetNumberOfCells() == cells2->GetNumberOfCells() &&
+    size == cells2->GetNumberOfConnectivityEntries() &&
+    (size == 0 || std::memcmp(cells1->GetPointer(), cells2->GetPointer(),
+                              size * sizeof(vtkIdType)) == 0);
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  if (output1->GetNumberOfCells() != output2->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType cellId = 0; cellId < output1->GetNumberOfCells(); ++cellId)
+  {
+    if (output1->GetCellType(cellId) != output2->GetCellType(cellId))
+    {
+      return false;
+    }
+  }
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData(), false) &&
+    SameCells(output1->GetVerts(), output2->GetVerts()) &&
+    SameCells(output1->GetLines(), output2->GetLines()) &&
+    SameCells(output1->GetPolys(), output2->GetPolys()) &&
+    SameCells(output1->GetStrips(), output2->GetStrips()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestGlyph3DSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> input = ConstructInput();
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(12);
+  sphere->SetPhiResolution(8);
+  sphere->Update();
+  vtkNew<vtkLineSource> line;
+  line->SetResolution(4);
+  line->Update();
+  vtkSmartPointer<vtkPolyData> mixed = ConstructMixedSource();
+  vtkPolyData *sources[] = { sphere->GetOutput(), line->GetOutput(), mixed };
+
+  for (vtkPolyData *source : sources)
+  {
+    for (int options = 0; options < 16; ++options)
+    {
+      vtkSmartPointer<vtkPolyData> reference;
+      auto computeReference = [&]()
+      {
+        reference = Glyph(input, source, options);
+        if (reference->GetNumberOfPoints() == 0)
+        {
+          std::cerr << "Error: no glyphs with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output = Glyph(input, source, options);
+        if (!SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "glyphs with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkPolyDataNormals gives exactly the same
+// result as a serial execution, for polygons in the legacy and the 32-bit
+// split storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+#include <cstring>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> ComputeNormals(vtkPolyData *input, int options)
+{
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(input);
+  normals->SetSplitting(options & 1);
+  normals->SetConsistency((options >> 1) & 1);
+  normals->SetAutoOrientNormals((options >> 2) & 1);
+  normals->SetFlipNormals((options >> 3) & 1);
+  normals->SetComputeCellNormals(1);
+  normals->SetFeatureAngle(10.0);
+  normals->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(normals->GetOutput());
+  return output;
+}
+
+bool SameFloatArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  vtkFloatArray *a1 = vtkArrayDownCast<vtkFloatArray>(array1);
+  vtkFloatArray *a2 = vtkArrayDownCast<vtkFloatArray>(array2);
+  if (!a1 || !a2)
+  {
+    return a1 == a2;
+  }
+  const vtkIdType size =
+    a1->GetNumberOfTuples() * a1->GetNumberOfComponents();
+  return size == a2->GetNumberOfTuples() * a2->GetNumberOfComponents() &&
+    std::memcmp(a1->GetPointer(0), a2->GetPointer(0),
+                size * sizeof(float)) == 0;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  vtkCellArray *polys1 = output1->GetPolys();
+  vtkCellArray *polys2 = output2->GetPolys();
+  const vtkIdType size = polys1->GetNumberOfConnectivityEntries();
+  return output1->GetNumberOfPoints() == output2->GetNumberOfPoints() &&
+    size == polys2->GetNumberOfConnectivityEntries() &&
+    std::memcmp(polys1->GetPointer(), polys2->GetPointer(),
+                size * sizeof(vtkIdType)) == 0 &&
+    SameFloatArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    SameFloatArrays(output1->GetPointData()->GetNormals(),
+                    output2->GetPointData()->GetNormals()) &&
+    SameFloatArrays(output1->GetCellData()->GetNormals(),
+                    output2->GetCellData()->GetNormals());
+}
+}
+
+int TestPolyDataNormalsSMP(int, char *[])
+{
+  // With a small feature angle, most edges of a coarse sphere are feature
+  // edges. Reverse some of its polygons so that the consistency traversal
+  // has something to do.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(12);
+  sphere->Update();
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+  input->BuildCells();
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); cellId += 3)
+  {
+    input->ReverseCell(cellId);
+  }
+  vtkNew<vtkPolyData> splitInput;
+  splitInput->DeepCopy(input);
+  splitInput->GetPolys()->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+
+  for (int options = 0; options < 16; ++options)
+  {
+    vtkSmartPointer<vtkPolyData> reference;
+    auto computeReference = [&]()
+    {
+      reference = ComputeNormals(input, options);
+      if ((options & 1) &&
+          reference->GetNumberOfPoints() <= input->GetNumberOfPoints())
+      {
+        std::cerr << "Error: no point was split" << std::endl;
+        return false;
+      }
+      if (!SameOutputs(reference, ComputeNormals(splitInput, options)))
+      {
+        std::cerr << "Error: the split storage gives a different result with "
+                  << "options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    auto compare = [&](const char *backend)
+    {
+      vtkSmartPointer<vtkPolyData> output = ComputeNormals(input, options);
+      vtkSmartPointer<vtkPolyData> splitOutput =
+        ComputeNormals(splitInput, options);
+      if (!SameOutputs(reference, output) ||
+          !SameOutputs(reference, splitOutput))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a different "
+                  << "result with options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
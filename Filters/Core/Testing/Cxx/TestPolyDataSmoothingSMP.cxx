@@ -0,0 +1,251 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataSmoothingSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded iterations of vtkWindowedSincPolyDataFilter
+// give the same points as a serial execution, and that the parallel
+// smoothing of vtkSmoothPolyDataFilter does not depend on the SMP backend
+// and stays close to the serial smoothing.
+
+#include <vtkCellArray.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSmoothPolyDataFilter.h>
+#include <vtkSphereSource.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// A bumpy sphere, and a bumpy plane with free boundary edges, a feature
+// ridge, a polyline crossing it and a few vertices.
+vtkSmartPointer<vtkPolyData> ConstructSphere()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(sphere->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    const double scale = 1.0 + 0.05 * std::sin(7.0 * ptId);
+    points->SetPoint(ptId, scale * x[0], scale * x[1], scale * x[2]);
+  }
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> ConstructPlane()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(50, 40);
+  plane->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(plane->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    x[2] = 0.3 * std::fabs(x[0]) + 0.02 * std::sin(13.0 * ptId);
+    points->SetPoint(ptId, x);
+  }
+
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(20);
+  for (vtkIdType i = 0; i < 20; ++i)
+  {
+    lines->InsertCellPoint(51 * (i + 10) + 5 + i);
+  }
+  input->SetLines(lines);
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType ptId = 7; ptId < input->GetNumberOfPoints(); ptId += 97)
+  {
+    verts->InsertNextCell(1, &ptId);
+  }
+  input->SetVerts(verts);
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> SmoothWindowedSinc(vtkPolyData *input,
+                                                int options)
+{
+  vtkNew<vtkWindowedSincPolyDataFilter> smooth;
+  smooth->SetInputData(input);
+  smooth->SetNumberOfIterations(options & 1 ? 30 : 10);
+  smooth->SetFeatureEdgeSmoothing((options >> 1) & 1);
+  smooth->SetBoundarySmoothing((options >> 2) & 1);
+  smooth->SetNormalizeCoordinates((options >> 3) & 1);
+  smooth->GenerateErrorScalarsOn();
+  smooth->GenerateErrorVectorsOn();
+  smooth->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(smooth->GetOutput());
+  return output;
+}
+
+vtkSmartPointer<vtkPolyData> SmoothLaplacian(vtkPolyData *input, int options,
+                                             bool parallel)
+{
+  vtkNew<vtkSmoothPolyDataFilter> smooth;
+  smooth->SetInputData(input);
+  smooth->SetNumberOfIterations(50);
+  smooth->SetRelaxationFactor(0.1);
+  smooth->SetFeatureEdgeSmoothing((options >> 1) & 1);
+  smooth->SetBoundarySmoothing((options >> 2) & 1);
+  smooth->SetOutputPointsPrecision(options & 8 ?
+    vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+  smooth->SetParallelSmoothing(parallel);
+  smooth->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(smooth->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    // The error scalars are not named.
+    if (!SameArrays(attributes1->GetArray(i), attributes2->GetArray(i)))
+    {
+      std::cerr << "Error: different arrays " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData());
+}
+
+// Largest distance between the points of two outputs.
+double MaximumDistance(vtkPolyData *output1, vtkPolyData *output2)
+{
+  double maxDist = 0.0;
+  for (vtkIdType ptId = 0; ptId < output1->GetNumberOfPoints(); ++ptId)
+  {
+    double x1[3], x2[3];
+    output1->GetPoint(ptId, x1);
+    output2->GetPoint(ptId, x2);
+    maxDist = std::max(maxDist,
+      std::sqrt(vtkMath::Distance2BetweenPoints(x1, x2)));
+  }
+  return maxDist;
+}
+}
+
+int TestPolyDataSmoothingSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> inputs[] = { ConstructSphere(),
+                                            ConstructPlane() };
+
+  for (vtkPolyData *input : inputs)
+  {
+    for (int options = 0; options < 16; ++options)
+    {
+      vtkSmartPointer<vtkPolyData> sincReference;
+      vtkSmartPointer<vtkPolyData> laplacianReference;
+      auto computeReference = [&]()
+      {
+        sincReference = SmoothWindowedSinc(input, options);
+        vtkSmartPointer<vtkPolyData> serial =
+          SmoothLaplacian(input, options, false);
+        laplacianReference = SmoothLaplacian(input, options, true);
+
+        // The Jacobi iterations move the points about as much as the serial
+        // iterations.
+        const double displacement = MaximumDistance(input, serial);
+        const double difference = MaximumDistance(serial, laplacianReference);
+        if (displacement == 0.0 || difference > 0.1 * displacement)
+        {
+          std::cerr << "Error: parallel smoothing moved the points by "
+                    << difference << " from the serial smoothing, which moved "
+                    << "them by " << displacement << " with options "
+                    << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output =
+          SmoothWindowedSinc(input, options);
+        if (!SameOutputs(sincReference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different windowed sinc smoothing with options "
+                    << options << std::endl;
+          return false;
+        }
+        output = SmoothLaplacian(input, options, true);
+        if (!SameOutputs(laplacianReference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different Laplacian smoothing with options "
+                    << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel decimation of vtkQuadricDecimation reaches the
+// target reduction, and that its output does not depend on the SMP backend,
+// with and without attribute errors and volume preservation.
+
+#include <vtkCellArray.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTriangleFilter.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// A closed sphere and a bumpy plane with free boundary edges, both with
+// scalars and normals.
+vtkSmartPointer<vtkPolyData> ConstructSphere()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    input->GetPoint(ptId, x);
+    scalars->InsertNextValue(static_cast<float>(x[2] + 0.3 * x[0] * x[1]));
+  }
+  input->GetPointData()->SetScalars(scalars);
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> ConstructPlane()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(50, 40);
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(plane->GetOutputPort());
+  triangles->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(triangles->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    x[2] = 0.05 * std::sin(10.0 * x[0]) * std::cos(7.0 * x[1]);
+    points->SetPoint(ptId, x);
+    scalars->InsertNextValue(static_cast<float>(x[0] * x[0]));
+  }
+  input->GetPointData()->SetScalars(scalars);
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> Decimate(vtkPolyData *input, int options,
+                                      double &reduction)
+{
+  vtkNew<vtkQuadricDecimation> decimation;
+  decimation->SetInputData(input);
+  decimation->SetTargetReduction(0.8);
+  decimation->SetAttributeErrorMetric(options & 1);
+  decimation->SetVolumePreservation((options >> 1) & 1);
+  decimation->ParallelDecimationOn();
+  decimation->Update();
+  reduction = decimation->GetActualReduction();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(decimation->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  vtkCellArray *polys1 = output1->GetPolys();
+  vtkCellArray *polys2 = output2->GetPolys();
+  const vtkIdType size = polys1->GetNumberOfConnectivityEntries();
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    polys1->GetNumberOfCells() == polys2->GetNumberOfCells() &&
+    size == polys2->GetNumberOfConnectivityEntries() &&
+    std::memcmp(polys1->GetPointer(), polys2->GetPointer(),
+                size * sizeof(vtkIdType)) == 0 &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData());
+}
+}
+
+int TestQuadricDecimationSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> inputs[] = { ConstructSphere(),
+                                            ConstructPlane() };
+
+  for (vtkPolyData *input : inputs)
+  {
+    for (int options = 0; options < 4; ++options)
+    {
+      double reduction;
+      vtkSmartPointer<vtkPolyData> reference;
+      auto computeReference = [&]()
+      {
+        reference = Decimate(input, options, reduction);
+        if (reduction < 0.8 ||
+            reference->GetNumberOfPolys() !=
+              static_cast<vtkIdType>((1.0 - reduction) *
+                                     input->GetNumberOfPolys() + 0.5))
+        {
+          std::cerr << "Error: reduction of " << reduction << " with options "
+                    << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output =
+          Decimate(input, options, reduction);
+        if (!SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different decimation with options " << options
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkThreshold gives exactly the same output
+// as a serial execution, for cells in the legacy and split storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataObject.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkThreshold.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+// Convert the wavelet to an unstructured grid, with a few empty cells and a
+// cell attribute.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-12, 12, -12, 12, -12, 12);
+  source->Update();
+  vtkImageData *image = source->GetOutput();
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->SetPoint(ptId, image->GetPoint(ptId));
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+
+  vtkNew<vtkIdList> cellPts;
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->SetNumberOfComponents(2);
+  grid->Allocate(image->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    if (cellId % 101 == 0)
+    {
+      grid->InsertNextCell(VTK_EMPTY_CELL, 0, nullptr);
+      cellValues->InsertNextTuple2(-1, 0);
+    }
+    image->GetCellPoints(cellId, cellPts);
+    grid->InsertNextCell(VTK_VOXEL, cellPts);
+    cellValues->InsertNextTuple2(cellId, cellId % 400);
+  }
+  grid->GetCellData()->AddArray(cellValues);
+  return grid;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Threshold(vtkUnstructuredGrid *input,
+                                               int options)
+{
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(input);
+  if (options & 1)
+  {
+    threshold->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellValues");
+    threshold->SetComponentModeToUseAny();
+    threshold->ThresholdBetween(50, 100);
+  }
+  else
+  {
+    threshold->ThresholdBetween(100, 200);
+  }
+  threshold->SetAllScalars((options >> 1) & 1);
+  threshold->SetUseContinuousCellRange((options >> 2) & 1);
+  threshold->SetInvert((options >> 3) & 1);
+  threshold->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->DeepCopy(threshold->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkUnstructuredGrid *output1, vtkUnstructuredGrid *output2)
+{
+  return output1->GetNumberOfCells() == output2->GetNumberOfCells() &&
+    SameArrays(output1->GetPoints()->GetData(),
+               output2->GetPoints()->GetData()) &&
+    SameArrays(output1->GetCells()->GetData(),
+               output2->GetCells()->GetData()) &&
+    SameArrays(output1->GetCellTypesArray(), output2->GetCellTypesArray()) &&
+    SameArrays(output1->GetCellLocationsArray(),
+               output2->GetCellLocationsArray()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestThresholdSMP(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> input = ConstructGrid();
+  vtkNew<vtkUnstructuredGrid> splitInput;
+  splitInput->DeepCopy(input);
+  splitInput->GetCells()->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+
+  for (int options = 0; options < 16; ++options)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> reference;
+    auto computeReference = [&]()
+    {
+      reference = Threshold(input, options);
+      if (reference->GetNumberOfCells() == 0 ||
+          reference->GetNumberOfCells() == input->GetNumberOfCells())
+      {
+        std::cerr << "Error: nothing was thresholded with options " << options
+                  << std::endl;
+        return false;
+      }
+      return true;
+    };
+    auto compare = [&](const char *backend)
+    {
+      vtkSmartPointer<vtkUnstructuredGrid> output = Threshold(input, options);
+      vtkSmartPointer<vtkUnstructuredGrid> splitOutput =
+        Threshold(splitInput, options);
+      if (!SameOutputs(reference, output) ||
+          !SameOutputs(reference, splitOutput))
+      {
+        std::cerr << "Error: the " << backend << " backend gives a different "
+                  << "result with options " << options << std::endl;
+        return false;
+      }
+      return true;
+    };
+    if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
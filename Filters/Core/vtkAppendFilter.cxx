@@ -14,25 +14,125 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
+#include "vtkBitArray.h"
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSetCollection.h"
 #include "vtkExecutive.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalOctreePointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
+namespace
+{
+// Copy n tuples of input from inStart to output at outStart, with a memory
+// copy when both arrays store the same type contiguously.
+void CopyTuples(vtkAbstractArray* input, vtkAbstractArray* output,
+                vtkIdType inStart, vtkIdType n, vtkIdType outStart)
+{
+  if (n <= 0)
+  {
+    return;
+  }
+  vtkDataArray* inData = vtkDataArray::FastDownCast(input);
+  vtkDataArray* outData = vtkDataArray::FastDownCast(output);
+  if (!inData || !outData)
+  {
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      output->SetTuple(outStart + i, inStart + i, input);
+    }
+    return;
+  }
+  const int numComp = inData->GetNumberOfComponents();
+  if (inData->GetDataType() == outData->GetDataType() &&
+      inData->HasStandardMemoryLayout() && outData->HasStandardMemoryLayout())
+  {
+    memcpy(outData->GetVoidPointer(outStart * numComp),
+           inData->GetVoidPointer(inStart * numComp),
+           n * numComp * inData->GetDataTypeSize());
+    return;
+  }
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    for (int c = 0; c < numComp; ++c)
+    {
+      outData->SetComponent(outStart + i, c, inData->GetComponent(inStart + i, c));
+    }
+  }
+}
+
+// Point ids and type of a cell, without virtual calls. The cells of
+// polygonal data must have been built.
+unsigned char GetCell(vtkUnstructuredGrid* ug, vtkIdType cellId,
+                      vtkIdType& npts, vtkIdType*& pts)
+{
+  ug->GetCellPoints(cellId, npts, pts);
+  return ug->GetCellTypesArray()->GetValue(cellId);
+}
+
+unsigned char GetCell(vtkPolyData* pd, vtkIdType cellId,
+                      vtkIdType& npts, vtkIdType*& pts)
+{
+  return pd->GetCellPoints(cellId, npts, pts);
+}
+
+template <typename TDataSet>
+vtkIdType GetConnectivitySize(TDataSet* dataSet)
+{
+  vtkIdType size = 0;
+  vtkIdType npts, *pts;
+  const vtkIdType numCells = dataSet->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    GetCell(dataSet, cellId, npts, pts);
+    size += npts + 1;
+  }
+  return size;
+}
+
+// Copy the cells of a data set at location loc of the output connectivity,
+// with the output point ids.
+template <typename TDataSet>
+void CopyCells(TDataSet* dataSet, const vtkIdType* pointIds, vtkIdType loc,
+               vtkIdType* connectivity, unsigned char* types,
+               vtkIdType* locations)
+{
+  vtkIdType npts, *pts;
+  const vtkIdType numCells = dataSet->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    types[cellId] = GetCell(dataSet, cellId, npts, pts);
+    locations[cellId] = loc;
+    connectivity[loc++] = npts;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      connectivity[loc++] = pointIds[pts[i]];
+    }
+  }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkAppendFilter::vtkAppendFilter()
 {
@@ -178,9 +278,6 @@ int vtkAppendFilter::RequestData(
     return 1;
   }
 
-  // Now we can allocate memory
-  output->Allocate(totalNumCells);
-
   vtkSmartPointer<vtkPoints> newPts = vtkSmartPointer<vtkPoints>::New();
 
   // set precision for the points in the output
@@ -214,8 +311,19 @@ int vtkAppendFilter::RequestData(
     newPts->SetDataType(VTK_DOUBLE);
   }
 
+  // For optionally merging duplicate points
+  vtkIdType* globalIndices = new vtkIdType[totalNumPts];
+  const bool appendedInBulk =
+    this->AppendInBulk(inputs, newPts, reallyMergePoints, globalIndices, output);
+
+  // Now we can allocate memory
+  if (!appendedInBulk)
+  {
+    output->Allocate(totalNumCells);
+  }
+
   // If we aren't merging points, we need to allocate the points here.
-  if (!reallyMergePoints)
+  if (!reallyMergePoints && !appendedInBulk)
   {
     newPts->SetNumberOfPoints(totalNumPts);
   }
@@ -227,10 +335,8 @@ int vtkAppendFilter::RequestData(
 
   vtkIdType twentieth = (totalNumPts + totalNumCells)/20 + 1;
 
-  // For optionally merging duplicate points
-  vtkIdType* globalIndices = new vtkIdType[totalNumPts];
   vtkSmartPointer<vtkIncrementalOctreePointLocator> ptInserter;
-  if (reallyMergePoints)
+  if (reallyMergePoints && !appendedInBulk)
   {
     vtkBoundingBox outputBB;
 
@@ -258,7 +364,7 @@ int vtkAppendFilter::RequestData(
   float decimal = 0.0;
   inputs->InitTraversal(iter);
   int abort = 0;
-  while (!abort && (dataSet = inputs->GetNextDataSet(iter)))
+  while (!appendedInBulk && !abort && (dataSet = inputs->GetNextDataSet(iter)))
   {
     vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
     vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
@@ -342,8 +448,8 @@ int vtkAppendFilter::RequestData(
   output->GetCellData()->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
 
   // Now copy the array data
-  this->AppendArrays(
-    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
+  this->AppendArrays(vtkDataObject::POINT, inputVector,
+    reallyMergePoints ? globalIndices : nullptr, output, newPts->GetNumberOfPoints());
   this->UpdateProgress(0.75);
   this->AppendArrays(vtkDataObject::CELL, inputVector, nullptr, output, output->GetNumberOfCells());
   this->UpdateProgress(1.0);
@@ -383,6 +489,164 @@ vtkDataSetCollection* vtkAppendFilter::GetNonEmptyInputs(vtkInformationVector **
   return collection;
 }
 
+//----------------------------------------------------------------------------
+bool vtkAppendFilter::AppendInBulk(vtkDataSetCollection* inputs,
+                                   vtkPoints* newPts,
+                                   bool mergePoints,
+                                   vtkIdType* globalIds,
+                                   vtkUnstructuredGrid* output)
+{
+  // The incremental octree merges the points within the tolerance, compared
+  // as doubles in insertion order. The static locator gives the same points
+  // for exact duplicates, compared as stored in the output points.
+  if (mergePoints && this->Tolerance != 0.0)
+  {
+    return false;
+  }
+
+  std::vector<vtkPointSet*> dataSets;
+  vtkCollectionSimpleIterator iter;
+  vtkDataSet* dataSet = nullptr;
+  for (inputs->InitTraversal(iter); (dataSet = inputs->GetNextDataSet(iter)); )
+  {
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(dataSet);
+    if (ug ? ug->GetFaces() != nullptr : !pd)
+    {
+      return false;
+    }
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(dataSet);
+    if (mergePoints && ps->GetPoints() &&
+        ps->GetPoints()->GetDataType() != newPts->GetDataType())
+    {
+      return false;
+    }
+    dataSets.push_back(ps);
+  }
+
+  // Offsets of the points, cells and connectivity of each input in the
+  // output. The data sets are prepared first, so that their cells can be
+  // read concurrently.
+  const vtkIdType numDataSets = static_cast<vtkIdType>(dataSets.size());
+  std::vector<vtkIdType> ptOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> cellOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> connOffsets(numDataSets + 1, 0);
+  for (vtkIdType i = 0; i < numDataSets; ++i)
+  {
+    dataSets[i]->PrepareForConcurrentReads();
+    ptOffsets[i + 1] = ptOffsets[i] + dataSets[i]->GetNumberOfPoints();
+    cellOffsets[i + 1] = cellOffsets[i] + dataSets[i]->GetNumberOfCells();
+  }
+  vtkSMPTools::For(0, numDataSets, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    for ( ; begin < end; ++begin)
+    {
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSets[begin]);
+      connOffsets[begin + 1] = ug ? GetConnectivitySize(ug) :
+        GetConnectivitySize(vtkPolyData::SafeDownCast(dataSets[begin]));
+    }
+  });
+  for (vtkIdType i = 0; i < numDataSets; ++i)
+  {
+    connOffsets[i + 1] += connOffsets[i];
+  }
+
+  // Copy the points
+  const vtkIdType totalNumPts = ptOffsets[numDataSets];
+  const vtkIdType totalNumCells = cellOffsets[numDataSets];
+  newPts->SetNumberOfPoints(totalNumPts);
+  vtkSMPTools::For(0, numDataSets, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    for ( ; begin < end; ++begin)
+    {
+      if (vtkPoints* points = dataSets[begin]->GetPoints())
+      {
+        CopyTuples(points->GetData(), newPts->GetData(), 0,
+                   points->GetNumberOfPoints(), ptOffsets[begin]);
+      }
+    }
+  });
+
+  // Merge the coincident points, keeping the first one, and number the
+  // merged points in the order of their first use as the point inserter.
+  if (mergePoints)
+  {
+    std::vector<vtkIdType> mergeMap(totalNumPts);
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(newPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(cloud);
+    locator->BuildLocator();
+    locator->MergePoints(0.0, mergeMap.data());
+
+    vtkIdType numNewPts = 0;
+    for (vtkIdType ptId = 0; ptId < totalNumPts; ++ptId)
+    {
+      globalIds[ptId] = mergeMap[ptId] == ptId ? numNewPts++ :
+        globalIds[mergeMap[ptId]];
+    }
+    vtkNew<vtkPoints> mergedPts;
+    mergedPts->SetDataType(newPts->GetDataType());
+    mergedPts->SetNumberOfPoints(numNewPts);
+    vtkSMPTools::For(0, totalNumPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
+      {
+        if (mergeMap[begin] == begin)
+        {
+          CopyTuples(newPts->GetData(), mergedPts->GetData(), begin, 1,
+                     globalIds[begin]);
+        }
+      }
+    });
+    newPts->ShallowCopy(mergedPts);
+  }
+  else
+  {
+    vtkSMPTools::For(0, totalNumPts, [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
+      {
+        globalIds[begin] = begin;
+      }
+    });
+  }
+  this->UpdateProgress(0.25);
+
+  // Copy the cells with the output point ids
+  vtkNew<vtkCellArray> cells;
+  vtkIdType* connectivity =
+    cells->WritePointer(totalNumCells, connOffsets[numDataSets]);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(totalNumCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(totalNumCells);
+  vtkSMPTools::For(0, numDataSets, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    for ( ; begin < end; ++begin)
+    {
+      const vtkIdType* pointIds = globalIds + ptOffsets[begin];
+      unsigned char* cellTypes = types->GetPointer(cellOffsets[begin]);
+      vtkIdType* cellLocations = locations->GetPointer(cellOffsets[begin]);
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSets[begin]);
+      if (ug)
+      {
+        CopyCells(ug, pointIds, connOffsets[begin], connectivity,
+                  cellTypes, cellLocations);
+      }
+      else
+      {
+        CopyCells(vtkPolyData::SafeDownCast(dataSets[begin]), pointIds,
+                  connOffsets[begin], connectivity, cellTypes, cellLocations);
+      }
+    }
+  });
+  output->SetCells(types, locations, cells);
+  this->UpdateProgress(0.5);
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkAppendFilter::AppendArrays(int attributesType,
                                    vtkInformationVector **inputVector,
@@ -413,29 +677,97 @@ void vtkAppendFilter::AppendArrays(int attributesType,
   vtkDataSetAttributes* outputData = output->GetAttributes(attributesType);
   outputData->CopyAllocate(fieldList, totalNumberOfElements);
 
-  // copy arrays.
+  // Pair the arrays of each input with the output arrays. Bit arrays pack
+  // several tuples in a byte and are copied serially.
+  typedef std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*> > ArrayPairs;
+  std::vector<ArrayPairs> arrays;
+  std::vector<vtkIdType> offsets(1, 0);
+  bool serial = false;
   int inputIndex;
-  vtkIdType offset = 0;
   for (inputIndex = 0, dataSet = nullptr, inputs->InitTraversal(iter); (dataSet = inputs->GetNextDataSet(iter));)
   {
     if (auto inputData = dataSet->GetAttributes(attributesType))
     {
-      const auto numberOfInputTuples = inputData->GetNumberOfTuples();
-      if (globalIds != nullptr)
+      arrays.push_back(ArrayPairs());
+      ArrayPairs& pairs = arrays.back();
+      fieldList.TransformData(inputIndex, inputData, outputData,
+        [&](vtkAbstractArray* inArray, vtkAbstractArray* outArray)
+        {
+          pairs.push_back(std::make_pair(inArray, outArray));
+          serial |= vtkBitArray::SafeDownCast(outArray) != nullptr;
+        });
+      offsets.push_back(offsets.back() + inputData->GetNumberOfTuples());
+      ++inputIndex;
+    }
+  }
+
+  if (serial)
+  {
+    // copy arrays.
+    vtkIdType offset = 0;
+    for (inputIndex = 0, dataSet = nullptr, inputs->InitTraversal(iter); (dataSet = inputs->GetNextDataSet(iter));)
+    {
+      if (auto inputData = dataSet->GetAttributes(attributesType))
       {
-        for (vtkIdType id=0; id < numberOfInputTuples; ++id)
+        const auto numberOfInputTuples = inputData->GetNumberOfTuples();
+        if (globalIds != nullptr)
         {
-          fieldList.CopyData(inputIndex, inputData, id, outputData, globalIds[offset + id]);
+          for (vtkIdType id=0; id < numberOfInputTuples; ++id)
+          {
+            fieldList.CopyData(inputIndex, inputData, id, outputData, globalIds[offset + id]);
+          }
         }
+        else
+        {
+          fieldList.CopyData(inputIndex, inputData, 0, numberOfInputTuples, outputData, offset);
+        }
+        offset += numberOfInputTuples;
+        ++inputIndex;
       }
-      else
-      {
-        fieldList.CopyData(inputIndex, inputData, 0, numberOfInputTuples, outputData, offset);
-      }
-      offset += numberOfInputTuples;
-      ++inputIndex;
     }
+    return;
   }
+
+  // Copy the tuples of several inputs at a time. When points were merged,
+  // the tuple of the last of the coincident points is kept, as with serial
+  // copies.
+  for (int i = 0; i < outputData->GetNumberOfArrays(); ++i)
+  {
+    outputData->GetAbstractArray(i)->SetNumberOfTuples(totalNumberOfElements);
+  }
+  std::vector<vtkIdType> lastIds;
+  if (globalIds != nullptr)
+  {
+    lastIds.resize(totalNumberOfElements);
+    for (vtkIdType id = 0; id < offsets.back(); ++id)
+    {
+      lastIds[globalIds[id]] = id;
+    }
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(arrays.size()), 1,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
+      {
+        const vtkIdType offset = offsets[begin];
+        const vtkIdType numberOfInputTuples = offsets[begin + 1] - offset;
+        for (const auto& pair : arrays[begin])
+        {
+          if (globalIds == nullptr)
+          {
+            CopyTuples(pair.first, pair.second, 0, numberOfInputTuples, offset);
+            continue;
+          }
+          for (vtkIdType id = 0; id < numberOfInputTuples; ++id)
+          {
+            if (lastIds[globalIds[offset + id]] == offset + id)
+            {
+              pair.second->SetTuple(globalIds[offset + id], id, pair.first);
+            }
+          }
+        }
+      }
+    });
 }
 
 //----------------------------------------------------------------------------
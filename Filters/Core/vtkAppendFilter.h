@@ -23,6 +23,13 @@
  * (For example, if one dataset has scalars but another does not, scalars will
  * not be appended.)
  *
+ * When all the inputs are unstructured grids without polyhedra or polygonal
+ * data, the output arrays are sized once and the points, cells and
+ * attributes of the inputs are copied in bulk, several inputs at a time.
+ * Points are then merged (when MergePoints is on and Tolerance is 0) with a
+ * vtkStaticPointLocator over all the appended points. The output is the same
+ * as with the incremental appending used for the other inputs.
+ *
  * @sa
  * vtkAppendPolyData
 */
@@ -35,6 +42,7 @@
 
 class vtkDataSetAttributes;
 class vtkDataSetCollection;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkAppendFilter : public vtkUnstructuredGridAlgorithm
 {
@@ -124,6 +132,14 @@ private:
   // Caller must delete the returned vtkDataSetCollection.
   vtkDataSetCollection* GetNonEmptyInputs(vtkInformationVector ** inputVector);
 
+  // Append unstructured grids without polyhedra and polygonal data in bulk.
+  // Return false, leaving the output untouched, for the other inputs.
+  bool AppendInBulk(vtkDataSetCollection* inputs,
+                    vtkPoints* newPts,
+                    bool mergePoints,
+                    vtkIdType* globalIds,
+                    vtkUnstructuredGrid* output);
+
   void AppendArrays(int attributesType,
                     vtkInformationVector **inputVector,
                     vtkIdType* globalIds,
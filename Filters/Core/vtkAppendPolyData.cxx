@@ -17,6 +17,7 @@
 #include "vtkAssume.h"
 #include "vtkArrayDispatch.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkBitArray.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataArrayAccessor.h"
@@ -26,14 +27,71 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendPolyData);
 
+namespace
+{
+// Where the points, the verts, lines, polys and strips, and their
+// connectivity entries of an input start in the output, and the index of the
+// input in the point and cell field lists (-1 without points or cells).
+struct InputOffsets
+{
+  vtkIdType Points = 0;
+  vtkIdType Cells[4] = { 0, 0, 0, 0 };
+  vtkIdType Connectivity[4] = { 0, 0, 0, 0 };
+  int PointDataIndex = -1;
+  int CellDataIndex = -1;
+};
+
+// Copy n tuples of input from inStart to output at outStart, with a memory
+// copy when both arrays store the same type contiguously. The output must
+// already hold the tuples, so that several inputs can be copied at a time.
+void CopyTuples(vtkAbstractArray* input, vtkAbstractArray* output,
+                vtkIdType inStart, vtkIdType n, vtkIdType outStart)
+{
+  if (n <= 0)
+  {
+    return;
+  }
+  vtkDataArray* inData = vtkDataArray::FastDownCast(input);
+  vtkDataArray* outData = vtkDataArray::FastDownCast(output);
+  if (!inData || !outData)
+  {
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      output->SetTuple(outStart + i, inStart + i, input);
+    }
+    return;
+  }
+  const int numComp = inData->GetNumberOfComponents();
+  if (inData->GetDataType() == outData->GetDataType() &&
+      inData->HasStandardMemoryLayout() && outData->HasStandardMemoryLayout())
+  {
+    memcpy(outData->GetVoidPointer(outStart * numComp),
+           inData->GetVoidPointer(inStart * numComp),
+           n * numComp * inData->GetDataTypeSize());
+    return;
+  }
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    for (int c = 0; c < numComp; ++c)
+    {
+      outData->SetComponent(outStart + i, c, inData->GetComponent(inStart + i, c));
+    }
+  }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkAppendPolyData::vtkAppendPolyData()
 {
@@ -131,13 +189,12 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 {
   int idx;
   vtkPolyData *ds;
-  vtkPoints  *inPts;
   vtkPoints *newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
+  vtkCellArray *newVerts;
+  vtkCellArray *newLines;
+  vtkCellArray *newPolys;
   vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
+  vtkCellArray *newStrips;
   vtkIdType numPts, numCells;
   vtkPointData *inPD = nullptr;
   vtkCellData *inCD = nullptr;
@@ -340,70 +397,159 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
   outputPD->CopyAllocate(ptList,numPts);
   outputCD->CopyAllocate(cellList,numCells);
 
-  // loop over all input sets
-  vtkIdType ptOffset = 0;
-  vtkIdType vertOffset = 0;
-  vtkIdType linesOffset = numVerts;
-  vtkIdType polysOffset = numVerts+numLines;
-  vtkIdType stripsOffset = numVerts+numLines+numPolys;
+  // Offsets of the points, cells and connectivity of each input in the
+  // output, so that the inputs can be appended independently. The cell
+  // arrays are switched to the legacy storage here, before being read
+  // concurrently.
+  std::vector<InputOffsets> offsets(numInputs);
+  InputOffsets next;
+  next.Cells[1] = numVerts;
+  next.Cells[2] = numVerts+numLines;
+  next.Cells[3] = numVerts+numLines+numPolys;
   countPD = countCD = 0;
   for (idx = 0; idx < numInputs; ++idx)
   {
-    this->UpdateProgress(0.2 + 0.8*idx/numInputs);
+    offsets[idx] = next;
     ds = inputs[idx];
-    // this check is not necessary, but I'll put it in anyway
-    if (ds != nullptr)
+    if (ds == nullptr)
+    {
+      continue;
+    }
+    if (ds->GetNumberOfPoints() > 0)
+    {
+      offsets[idx].PointDataIndex = countPD++;
+      next.Points += ds->GetNumberOfPoints();
+    }
+    if (ds->GetNumberOfCells() > 0)
     {
-      numPts = ds->GetNumberOfPoints();
-      numCells = ds->GetNumberOfCells();
-      if ( numPts <= 0 && numCells <= 0 )
+      offsets[idx].CellDataIndex = countCD++;
+      vtkCellArray *cells[4] = { ds->GetVerts(), ds->GetLines(),
+                                 ds->GetPolys(), ds->GetStrips() };
+      for (int i = 0; i < 4; ++i)
       {
-        continue; //no input, just skip
+        if (cells[i])
+        {
+          cells[i]->GetPointer();
+          next.Cells[i] += cells[i]->GetNumberOfCells();
+          next.Connectivity[i] += cells[i]->GetNumberOfConnectivityEntries();
+        }
       }
+    }
+  }
 
-      inPD = ds->GetPointData();
-      inCD = ds->GetCellData();
+  // Pair the arrays of each input with the output arrays. Bit arrays pack
+  // several tuples in a byte, and are appended one input at a time.
+  typedef std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*> > ArrayPairs;
+  std::vector<ArrayPairs> ptArrays(numInputs);
+  std::vector<ArrayPairs> cellArrays(numInputs);
+  bool parallel = true;
+  for (idx = 0; idx < numInputs; ++idx)
+  {
+    ds = inputs[idx];
+    if (offsets[idx].PointDataIndex >= 0)
+    {
+      ArrayPairs& pairs = ptArrays[idx];
+      ptList.TransformData(offsets[idx].PointDataIndex, ds->GetPointData(), outputPD,
+        [&](vtkAbstractArray* inArray, vtkAbstractArray* outArray)
+        {
+          pairs.push_back(std::make_pair(inArray, outArray));
+          parallel &= vtkBitArray::SafeDownCast(outArray) == nullptr;
+        });
+    }
+    if (offsets[idx].CellDataIndex >= 0)
+    {
+      ArrayPairs& pairs = cellArrays[idx];
+      cellList.TransformData(offsets[idx].CellDataIndex, ds->GetCellData(), outputCD,
+        [&](vtkAbstractArray* inArray, vtkAbstractArray* outArray)
+        {
+          pairs.push_back(std::make_pair(inArray, outArray));
+          parallel &= vtkBitArray::SafeDownCast(outArray) == nullptr;
+        });
+    }
+  }
+  if (parallel)
+  {
+    for (int i = 0; i < outputPD->GetNumberOfArrays(); ++i)
+    {
+      outputPD->GetAbstractArray(i)->SetNumberOfTuples(numPts);
+    }
+    for (int i = 0; i < outputCD->GetNumberOfArrays(); ++i)
+    {
+      outputCD->GetAbstractArray(i)->SetNumberOfTuples(numCells);
+    }
+  }
 
-      inPts = ds->GetPoints();
-      inVerts = ds->GetVerts();
-      inLines = ds->GetLines();
-      inPolys = ds->GetPolys();
-      inStrips = ds->GetStrips();
+  // Append the points, cells and attributes of an input. The cells of each
+  // type are stored after each other in the input, and after the cells of
+  // the same type of the previous inputs in the output.
+  vtkIdType *pCells[4] = { pVerts, pLines, pPolys, pStrips };
+  auto appendInput = [&](vtkIdType inputIdx)
+  {
+    vtkPolyData *input = inputs[inputIdx];
+    const InputOffsets& offset = offsets[inputIdx];
+    if (offset.PointDataIndex >= 0)
+    {
+      // copy points directly
+      const vtkIdType inputNumPts = input->GetNumberOfPoints();
+      this->AppendData(newPts->GetData(), input->GetPoints()->GetData(), offset.Points);
+      if (!parallel)
+      {
+        outputPD->CopyData(ptList, input->GetPointData(), offset.PointDataIndex,
+                           offset.Points, inputNumPts, 0);
+      }
+      else
+      {
+        for (const auto& pair : ptArrays[inputIdx])
+        {
+          CopyTuples(pair.first, pair.second, 0, inputNumPts, offset.Points);
+        }
+      }
+    }
 
-      if (ds->GetNumberOfPoints() > 0)
+    if (offset.CellDataIndex >= 0)
+    {
+      vtkCellArray *cells[4] = { input->GetVerts(), input->GetLines(),
+                                 input->GetPolys(), input->GetStrips() };
+      vtkIdType inputCellId = 0;
+      for (int i = 0; i < 4; ++i)
       {
-        // copy points directly
-        this->AppendData(newPts->GetData(), inPts->GetData(), ptOffset);
-        outputPD->CopyData(ptList, inPD, countPD, ptOffset, numPts, 0);
-        ++countPD;
+        // copy the cells and their data
+        this->AppendCells(pCells[i] + offset.Connectivity[i], cells[i], offset.Points);
+        const vtkIdType inputNumCells = cells[i] ? cells[i]->GetNumberOfCells() : 0;
+        if (!parallel)
+        {
+          outputCD->CopyData(cellList, input->GetCellData(), offset.CellDataIndex,
+                             offset.Cells[i], inputNumCells, inputCellId);
+        }
+        else
+        {
+          for (const auto& pair : cellArrays[inputIdx])
+          {
+            CopyTuples(pair.first, pair.second, inputCellId,
+                       inputNumCells, offset.Cells[i]);
+          }
+        }
+        inputCellId += inputNumCells;
       }
+    }
+  };
 
-      if (ds->GetNumberOfCells() > 0)
+  this->UpdateProgress(0.2);
+  if (parallel)
+  {
+    vtkSMPTools::For(0, numInputs, 1, [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
       {
-        // These are the cellIDs at which each of the cell types start.
-        vtkIdType vertsIndex = 0;
-        vtkIdType linesIndex = ds->GetNumberOfVerts();
-        vtkIdType polysIndex = linesIndex + ds->GetNumberOfLines();
-        vtkIdType stripsIndex = polysIndex + ds->GetNumberOfPolys();
-
-        // copy the cells
-        pVerts = this->AppendCells(pVerts, inVerts, ptOffset);
-        pLines = this->AppendCells(pLines, inLines, ptOffset);
-        pPolys = this->AppendCells(pPolys, inPolys, ptOffset);
-        pStrips = this->AppendCells(pStrips, inStrips, ptOffset);
-
-        // copy cell data
-        outputCD->CopyData(cellList, inCD, countCD, vertOffset, ds->GetNumberOfVerts(), vertsIndex);
-        vertOffset += ds->GetNumberOfVerts();
-        outputCD->CopyData(cellList, inCD, countCD, linesOffset, ds->GetNumberOfLines(), linesIndex);
-        linesOffset += ds->GetNumberOfLines();
-        outputCD->CopyData(cellList, inCD, countCD, polysOffset, ds->GetNumberOfPolys(), polysIndex);
-        polysOffset += ds->GetNumberOfPolys();
-        outputCD->CopyData(cellList, inCD, countCD, stripsOffset, ds->GetNumberOfStrips(), stripsIndex);
-        stripsOffset += ds->GetNumberOfStrips();
-        ++countCD;
+        appendInput(begin);
       }
-      ptOffset += numPts;
+    });
+  }
+  else
+  {
+    for (idx = 0; idx < numInputs; ++idx)
+    {
+      appendInput(idx);
     }
   }
 
@@ -24,6 +24,10 @@
  * attributes available.  (For example, if one dataset has point scalars but
  * another does not, point scalars will not be appended.)
  *
+ * The output arrays are sized once, and the points, cells and attributes of
+ * several inputs are copied at a time with vtkSMPTools. Appending bit
+ * arrays is done one input at a time.
+ *
  * @sa
  * vtkAppendFilter
 */
@@ -14,16 +14,21 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedIntArray.h"
@@ -31,6 +36,7 @@
 #include <algorithm>
 #include <functional>
 #include <set>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -121,6 +127,126 @@ namespace
       }
     }
   }
+
+//----------------------------------------------------------------------------
+// Dimension of each cell of an unstructured grid or a polydata, computed in
+// parallel from the cell types.
+  void __cellDimensions (vtkDataSet* const src, std::vector<unsigned char>& dims)
+  {
+    unsigned char typeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    for (int type = 0; type < VTK_NUMBER_OF_CELL_TYPES; ++type)
+    {
+      vtkCell* cell = vtkGenericCell::InstantiateCell(type);
+      typeDimensions[type] =
+        cell ? static_cast<unsigned char>(cell->GetCellDimension()) : 0;
+      if (cell)
+      {
+        cell->Delete();
+      }
+    }
+
+    // The cells of a polydata must be built before GetCellType() is thread
+    // safe, which the preparation does.
+    src->PrepareForConcurrentReads();
+
+    dims.resize(src->GetNumberOfCells());
+    vtkSMPTools::For(0, src->GetNumberOfCells(),
+      [src, &dims, &typeDimensions](vtkIdType begin, vtkIdType end)
+      {
+        for (vtkIdType cid = begin; cid < end; ++cid)
+        {
+          int const type = src->GetCellType(cid);
+          dims[cid] = type < VTK_NUMBER_OF_CELL_TYPES ? typeDimensions[type] : 0;
+        }
+      });
+  }
+
+//----------------------------------------------------------------------------
+// Threaded counterpart of __spread: instead of scattering the cell data to
+// the points, each point gathers the data of the cells using it from static
+// cell links. The links list the cells in increasing id order: the values
+// are summed in the same order and with the same type as in __spread, and the
+// results are identical.
+  struct __gather
+  {
+    vtkStaticCellLinksTemplate<vtkIdType>* Links;
+    const unsigned char* CellDimensions;
+    int HighestCellDimension;
+    int ContributingCellOption;
+
+    template <typename SrcArrayT, typename DstArrayT>
+    void operator()(SrcArrayT* srcarray, DstArrayT* dstarray) const
+    {
+      typedef typename vtkDataArrayAccessor<SrcArrayT>::APIType T;
+      vtkDataArrayAccessor<SrcArrayT> src(srcarray);
+      vtkDataArrayAccessor<DstArrayT> dst(dstarray);
+      int const ncomps = srcarray->GetNumberOfComponents();
+      vtkIdType const npoints = dstarray->GetNumberOfTuples();
+
+      vtkSMPTools::For(0, npoints, [&](vtkIdType begin, vtkIdType end)
+      {
+        if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+        {
+          std::vector<T> data(ncomps);
+          for (vtkIdType pid = begin; pid < end; ++pid)
+          {
+            std::fill(data.begin(), data.end(), T(0));
+            unsigned int denom = 0;
+            vtkIdType const* const cells = this->Links->GetCells(pid);
+            vtkIdType const ncells = this->Links->GetNumberOfCells(pid);
+            for (vtkIdType i = 0; i < ncells; ++i)
+            {
+              vtkIdType const cid = cells[i];
+              if (this->CellDimensions[cid] >= this->HighestCellDimension)
+              {
+                ++denom;
+                for (int comp = 0; comp < ncomps; ++comp)
+                {
+                  data[comp] = std::plus<T>()(src.Get(cid, comp), data[comp]);
+                }
+              }
+            }
+            for (int comp = 0; comp < ncomps; ++comp)
+            {
+              dst.Set(pid, comp, denom ?
+                std::divides<T>()(data[comp], static_cast<T>(denom)) : data[comp]);
+            }
+          }
+        }
+        else
+        { // compute over cell patches
+          std::vector<T> data(4*ncomps);
+          for (vtkIdType pid = begin; pid < end; ++pid)
+          {
+            std::fill(data.begin(), data.end(), T(0));
+            T numPointCells[4] = {0, 0, 0, 0};
+            vtkIdType const* const cells = this->Links->GetCells(pid);
+            vtkIdType const ncells = this->Links->GetNumberOfCells(pid);
+            for (vtkIdType i = 0; i < ncells; ++i)
+            {
+              vtkIdType const cid = cells[i];
+              int const cellDimension = this->CellDimensions[cid];
+              numPointCells[cellDimension] += 1;
+              for (int comp = 0; comp < ncomps; ++comp)
+              {
+                data[comp+ncomps*cellDimension] += src.Get(cid, comp);
+              }
+            }
+            int dimension = 3;
+            while (dimension > 0 && !numPointCells[dimension])
+            {
+              --dimension;
+            }
+            for (int comp = 0; comp < ncomps; ++comp)
+            {
+              dst.Set(pid, comp, numPointCells[dimension] ?
+                data[comp+dimension*ncomps] / numPointCells[dimension] : T(0));
+            }
+          }
+        }
+      });
+    }
+  };
 } // end anonymous namespace
 
 class vtkCellDataToPointData::Internals
@@ -367,11 +493,26 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
-  // count the number of cells associated with each point. if we are doing patches
-  // though we will do that later on.
+  // With several threads, the points gather the cell data from static cell
+  // links. Otherwise, count the number of cells associated with each point.
+  // if we are doing patches though we will do that later on.
+  bool const threaded = vtkSMPTools::GetEstimatedNumberOfThreads() > 1;
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  std::vector<unsigned char> cellDimensions;
   vtkSmartPointer<vtkUnsignedIntArray> num;
   int highestCellDimension = 0;
-  if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+  if (threaded)
+  {
+    __cellDimensions(src, cellDimensions);
+    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
+    {
+      highestCellDimension = vtkSMPTools::Reduce(
+        cellDimensions.begin(), cellDimensions.end(), static_cast<unsigned char>(0),
+        [](unsigned char a, unsigned char b) { return std::max(a, b); });
+    }
+    links.BuildLinks(src);
+  }
+  else if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
   {
     num = vtkSmartPointer<vtkUnsignedIntArray>::New();
     num->SetNumberOfComponents(1);
@@ -459,7 +600,10 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
 
   const auto nfields = processedCellData->GetNumberOfArrays();
   int fid = 0;
-  auto f = [this, &fid, nfields, npoints, src, num, ncells, highestCellDimension](
+  __gather gather = { &links, cellDimensions.data(), highestCellDimension,
+                      this->ContributingCellOption };
+  auto f = [this, &fid, nfields, npoints, src, num, ncells, highestCellDimension,
+            threaded, &gather](
              vtkAbstractArray* aa_srcarray, vtkAbstractArray* aa_dstarray) {
     // update progress and check for an abort request.
     this->UpdateProgress((fid + 1.0) / nfields);
@@ -475,6 +619,16 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     if (srcarray && dstarray)
     {
       dstarray->SetNumberOfTuples(npoints);
+      if (threaded)
+      {
+        if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+              srcarray, dstarray, gather))
+        {
+          // Use vtkDataArray API when fast-path dispatch fails.
+          gather(srcarray, dstarray);
+        }
+        return;
+      }
       vtkIdType const ncomps = srcarray->GetNumberOfComponents();
       switch (srcarray->GetDataType())
       {
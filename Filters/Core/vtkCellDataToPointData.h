@@ -30,6 +30,11 @@
  * cells attached to a point. DataSetMax uses the highest cell dimension in
  * the entire data set.
  *
+ * When vtkSMPTools runs with several threads, unstructured grids and
+ * polydata are processed in parallel: the cell data is gathered at each
+ * point from static cell links, with typed array access. The output is the
+ * same as with a single thread.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -14,19 +14,321 @@
 =========================================================================*/
 #include "vtkCleanPolyData.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
+namespace { //anonymous
+
+// The kinds of cells, in the order of the output cells. A cell of a given
+// kind may become a cell of a lower kind when its points are merged.
+enum CellKind
+{
+  CLEAN_VERT = 0,
+  CLEAN_LINE = 1,
+  CLEAN_POLY = 2,
+  CLEAN_STRIP = 3,
+  CLEAN_NONE = 4
+};
+
+// The cells are processed in batches of consecutive cells. The output of a
+// batch is located with a prefix sum over the batches.
+const vtkIdType CLEAN_BATCH_SIZE = 1024;
+
+struct CellBatch
+{
+  int Kind; // kind of the input cells
+  vtkIdType CellId; // id of the first cell in the input
+  vtkIdType NumberOfCells;
+  vtkCellArray *Cells; // input cell array
+  vtkIdType FirstCell; // id of the first cell in the input cell array
+  vtkIdType Location; // location of the first cell in the input cell array
+  // Number of output cells and connectivity entries of each kind, replaced
+  // by the offsets of the batch in the output.
+  vtkIdType NumberOfOutputCells[4];
+  vtkIdType OutputSize[4];
+};
+
+//----------------------------------------------------------------------------
+// Split a cell array in batches, recording where each batch starts.
+void AddBatches(vtkCellArray *cells, int kind, vtkIdType &cellId,
+                std::vector<CellBatch> &batches)
+{
+  vtkIdType numCells = cells->GetNumberOfCells();
+  vtkIdType npts, *pts;
+  cells->InitTraversal();
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    if (i % CLEAN_BATCH_SIZE == 0)
+    {
+      CellBatch batch;
+      batch.Kind = kind;
+      batch.CellId = cellId + i;
+      batch.NumberOfCells = std::min(CLEAN_BATCH_SIZE, numCells - i);
+      batch.Cells = cells;
+      batch.FirstCell = i;
+      batch.Location = cells->GetTraversalLocation();
+      batches.push_back(batch);
+    }
+    cells->GetNextCell(npts, pts);
+  }
+  cellId += numCells;
+}
+
+//----------------------------------------------------------------------------
+// Copy the point ids of the cell at the given id and location of the batch
+// into the list of the calling thread: by location in the legacy storage,
+// by id in the split storage, where both take constant time.
+void GetBatchCell(const CellBatch &batch, vtkIdType cellId, vtkIdType loc,
+                  vtkIdList *ptIds)
+{
+  if (batch.Cells->GetStorageMode() == vtkCellArray::LEGACY_STORAGE)
+  {
+    batch.Cells->GetCell(loc, ptIds);
+  }
+  else
+  {
+    batch.Cells->GetCellAtId(cellId, ptIds);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Map the points of a cell, remove the consecutive duplicates and decide what
+// the cell becomes. Follows the rules of the serial implementation. Returns
+// the kind of the output cell (or CLEAN_NONE if the cell is removed).
+int CleanCell(int kind, vtkIdType npts, const vtkIdType *pts,
+              const vtkIdType *pointMap, const vtkTypeBool convert[3],
+              vtkIdType *newPts, vtkIdType &numNewPts)
+{
+  vtkIdType n = 0;
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    vtkIdType ptId = pointMap[pts[i]];
+    if (kind == CLEAN_VERT || i == 0 || ptId != newPts[n - 1])
+    {
+      newPts[n++] = ptId;
+    }
+  }
+  if (((kind == CLEAN_POLY && n > 2) || (kind == CLEAN_STRIP && n > 1)) &&
+      newPts[0] == newPts[n - 1])
+  {
+    n--;
+  }
+  numNewPts = n;
+
+  // A proper cell has at least kind+1 points. Otherwise, convert the
+  // degenerate cell as requested (convert[] is indexed by the target kind).
+  if (n > kind)
+  {
+    return kind;
+  }
+  if (n > 0 && (npts == n || convert[n - 1]))
+  {
+    return static_cast<int>(n - 1);
+  }
+  return CLEAN_NONE;
+}
+
+//----------------------------------------------------------------------------
+// Apply OperateOnPoint() to all the points.
+struct TransformPoints
+{
+  vtkCleanPolyData *Filter;
+  vtkPoints *InPts;
+  vtkPoints *OutPts;
+
+  TransformPoints(vtkCleanPolyData *filter, vtkPoints *inPts,
+                  vtkPoints *outPts) :
+    Filter(filter), InPts(inPts), OutPts(outPts)
+  {
+  }
+
+  void operator() (vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3], newx[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->InPts->GetPoint(ptId, x);
+      this->Filter->OperateOnPoint(x, newx);
+      this->OutPts->SetPoint(ptId, newx);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Mark the (merged) points used by the cells, and count the output cells and
+// connectivity entries of each batch.
+struct CountCells
+{
+  CellBatch *Batches;
+  const vtkIdType *MergeMap;
+  std::atomic<unsigned char> *Used;
+  const vtkTypeBool *Convert;
+  vtkIdType MaxCellSize;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  CountCells(CellBatch *batches, const vtkIdType *mergeMap,
+             std::atomic<unsigned char> *used, const vtkTypeBool *convert,
+             vtkIdType maxCellSize) :
+    Batches(batches), MergeMap(mergeMap), Used(used), Convert(convert),
+    MaxCellSize(maxCellSize)
+  {
+  }
+
+  void operator() (vtkIdType batchId, vtkIdType endBatchId)
+  {
+    std::vector<vtkIdType> newPts(this->MaxCellSize);
+    vtkIdType numNewPts;
+    vtkIdList *ptIds = this->PtIds.Local();
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      CellBatch &batch = this->Batches[batchId];
+      std::fill_n(batch.NumberOfOutputCells, 4, 0);
+      std::fill_n(batch.OutputSize, 4, 0);
+      vtkIdType loc = batch.Location;
+      for (vtkIdType i = 0; i < batch.NumberOfCells; ++i)
+      {
+        GetBatchCell(batch, batch.FirstCell + i, loc, ptIds);
+        const vtkIdType npts = ptIds->GetNumberOfIds();
+        const vtkIdType *pts = ptIds->GetPointer(0);
+        loc += npts + 1;
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          this->Used[this->MergeMap[pts[j]]].store(
+            1, std::memory_order_relaxed);
+        }
+        int kind = CleanCell(batch.Kind, npts, pts, this->MergeMap,
+                             this->Convert, newPts.data(), numNewPts);
+        if (kind != CLEAN_NONE)
+        {
+          batch.NumberOfOutputCells[kind]++;
+          batch.OutputSize[kind] += numNewPts + 1;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the used points and their attributes to the output, and replace the
+// merge map by the map from the input points to the output points.
+struct CopyPoints
+{
+  const std::atomic<unsigned char> *Used;
+  const vtkIdType *NewIds;
+  vtkIdType *PointMap;
+  vtkPoints *InPts;
+  vtkPoints *OutPts;
+  ArrayList Arrays;
+
+  CopyPoints(const std::atomic<unsigned char> *used, const vtkIdType *newIds,
+             vtkIdType *pointMap, vtkPoints *inPts, vtkPointData *inPD,
+             vtkIdType numNewPts, vtkPoints *outPts, vtkPointData *outPD) :
+    Used(used), NewIds(newIds), PointMap(pointMap), InPts(inPts),
+    OutPts(outPts)
+  {
+    this->Arrays.AddArrays(numNewPts, inPD, outPD, 0.0, false);
+  }
+
+  void operator() (vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      if (this->Used[ptId].load(std::memory_order_relaxed))
+      {
+        const vtkIdType newId = this->NewIds[ptId];
+        this->InPts->GetPoint(ptId, x);
+        this->OutPts->SetPoint(newId, x);
+        this->Arrays.Copy(ptId, newId);
+      }
+      this->PointMap[ptId] = this->NewIds[this->PointMap[ptId]];
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Write the output cells and copy their attributes. Each batch writes at the
+// offsets computed from the counts.
+struct GenerateCells
+{
+  const CellBatch *Batches;
+  const vtkIdType *PointMap;
+  const vtkTypeBool *Convert;
+  vtkIdType MaxCellSize;
+  vtkIdType *Connectivity[4];
+  vtkIdType CellIdOffsets[4];
+  ArrayList Arrays;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  GenerateCells(const CellBatch *batches, const vtkIdType *pointMap,
+                const vtkTypeBool *convert, vtkIdType maxCellSize,
+                vtkIdType *connectivity[4], vtkIdType cellIdOffsets[4],
+                vtkCellData *inCD, vtkIdType numNewCells,
+                vtkCellData *outCD) :
+    Batches(batches), PointMap(pointMap), Convert(convert),
+    MaxCellSize(maxCellSize)
+  {
+    std::copy_n(connectivity, 4, this->Connectivity);
+    std::copy_n(cellIdOffsets, 4, this->CellIdOffsets);
+    this->Arrays.AddArrays(numNewCells, inCD, outCD, 0.0, false);
+  }
+
+  void operator() (vtkIdType batchId, vtkIdType endBatchId)
+  {
+    std::vector<vtkIdType> newPts(this->MaxCellSize);
+    vtkIdType numNewPts, cellIds[4], locations[4];
+    vtkIdList *ptIds = this->PtIds.Local();
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      const CellBatch &batch = this->Batches[batchId];
+      for (int kind = 0; kind < 4; ++kind)
+      {
+        cellIds[kind] = this->CellIdOffsets[kind] +
+          batch.NumberOfOutputCells[kind];
+        locations[kind] = batch.OutputSize[kind];
+      }
+      vtkIdType loc = batch.Location;
+      for (vtkIdType i = 0; i < batch.NumberOfCells; ++i)
+      {
+        GetBatchCell(batch, batch.FirstCell + i, loc, ptIds);
+        loc += ptIds->GetNumberOfIds() + 1;
+        int kind = CleanCell(batch.Kind, ptIds->GetNumberOfIds(),
+                             ptIds->GetPointer(0), this->PointMap,
+                             this->Convert, newPts.data(), numNewPts);
+        if (kind != CLEAN_NONE)
+        {
+          vtkIdType *newCell = this->Connectivity[kind] + locations[kind];
+          *newCell++ = numNewPts;
+          std::copy_n(newPts.data(), numNewPts, newCell);
+          locations[kind] += numNewPts + 1;
+          this->Arrays.Copy(batch.CellId + i, cellIds[kind]++);
+        }
+      }
+    }
+  }
+};
+
+} //anonymous namespace
+
 //---------------------------------------------------------------------------
 // Specify a spatial locator for speeding the search process. By
 // default an instance of vtkPointLocator is used.
@@ -46,6 +348,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = nullptr;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelProcessing = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -138,6 +441,11 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
   }
+  if ( this->ParallelProcessing )
+  {
+    this->ParallelClean(input, output);
+    return 1;
+  }
   vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -619,6 +927,170 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// The points are transformed and merged first, then the cells are processed
+// twice in parallel: once to mark the used points and to count the output
+// cells, and once, after the points have been renumbered, to write the
+// output cells at offsets given by prefix sums.
+void vtkCleanPolyData::ParallelClean(vtkPolyData *input, vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *inPD = input->GetPointData();
+  vtkCellData *inCD = input->GetCellData();
+
+  vtkPoints *newPts = inPts->NewInstance();
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  // Points are merged after OperateOnPoint() has been applied.
+  vtkPoints *mappedPts = newPts->NewInstance();
+  mappedPts->SetDataType(newPts->GetDataType());
+  mappedPts->SetNumberOfPoints(numPts);
+  TransformPoints transform(this, inPts, mappedPts);
+  vtkSMPTools::For(0, numPts, transform);
+
+  // The merge map gives the representative point of each point.
+  vtkIdType *pointMap = new vtkIdType [numPts];
+  if ( this->PointMerging )
+  {
+    vtkPolyData *mappedInput = vtkPolyData::New();
+    mappedInput->SetPoints(mappedPts);
+    vtkStaticPointLocator *locator = vtkStaticPointLocator::New();
+    locator->SetDataSet(mappedInput);
+    locator->BuildLocator();
+    double tol = ( this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+                   this->Tolerance*input->GetLength() );
+    locator->MergePoints(tol, pointMap);
+    locator->Delete();
+    mappedInput->Delete();
+
+    // When merging within a tolerance, a representative point may itself
+    // be merged with a point of lower id.
+    if ( tol > 0.0 )
+    {
+      for (vtkIdType ptId=0; ptId < numPts; ++ptId)
+      {
+        pointMap[ptId] = pointMap[pointMap[ptId]];
+      }
+    }
+  }
+  else
+  {
+    for (vtkIdType ptId=0; ptId < numPts; ++ptId)
+    {
+      pointMap[ptId] = ptId;
+    }
+  }
+  this->UpdateProgress(0.25);
+
+  // Count the output cells, batch by batch.
+  vtkCellArray *inCells[4] = { input->GetVerts(), input->GetLines(),
+                               input->GetPolys(), input->GetStrips() };
+  std::vector<CellBatch> batches;
+  vtkIdType cellId = 0;
+  for (int kind=0; kind < 4; ++kind)
+  {
+    AddBatches(inCells[kind], kind, cellId, batches);
+  }
+  const vtkIdType numBatches = static_cast<vtkIdType>(batches.size());
+  const vtkIdType maxCellSize = input->GetMaxCellSize();
+  const vtkTypeBool convert[3] = { this->ConvertLinesToPoints,
+                                   this->ConvertPolysToLines,
+                                   this->ConvertStripsToPolys };
+
+  std::atomic<unsigned char> *used = new std::atomic<unsigned char> [numPts];
+  vtkSMPTools::Fill(used, used + numPts, static_cast<unsigned char>(0));
+  CountCells count(batches.data(), pointMap, used, convert, maxCellSize);
+  vtkSMPTools::For(0, numBatches, count);
+  this->UpdateProgress(0.5);
+
+  // Renumber the used points and copy them to the output.
+  vtkIdType *newIds = new vtkIdType [numPts];
+  vtkSMPTools::ExclusiveScan(used, used + numPts, newIds, vtkIdType(0));
+  vtkIdType numNewPts = newIds[numPts-1] + used[numPts-1];
+
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyAllocate(inPD, numNewPts);
+  newPts->SetNumberOfPoints(numNewPts);
+  CopyPoints copyPoints(used, newIds, pointMap, mappedPts, inPD, numNewPts,
+                        newPts, outPD);
+  vtkSMPTools::For(0, numPts, copyPoints);
+  delete [] newIds;
+  delete [] used;
+  mappedPts->Delete();
+  this->UpdateProgress(0.75);
+
+  // Offsets of the batches in the output, kind by kind.
+  vtkIdType numNewCells[4], sizes[4], cellIdOffsets[4];
+  for (int kind=0; kind < 4; ++kind)
+  {
+    numNewCells[kind] = sizes[kind] = 0;
+    for (CellBatch &batch : batches)
+    {
+      std::swap(numNewCells[kind], batch.NumberOfOutputCells[kind]);
+      numNewCells[kind] += batch.NumberOfOutputCells[kind];
+      std::swap(sizes[kind], batch.OutputSize[kind]);
+      sizes[kind] += batch.OutputSize[kind];
+    }
+    cellIdOffsets[kind] = (kind == 0 ? 0 :
+                           cellIdOffsets[kind-1] + numNewCells[kind-1]);
+  }
+
+  vtkCellArray *newCells[4];
+  vtkIdType *connectivity[4];
+  for (int kind=0; kind < 4; ++kind)
+  {
+    newCells[kind] = vtkCellArray::New();
+    connectivity[kind] =
+      newCells[kind]->WritePointer(numNewCells[kind], sizes[kind]);
+  }
+
+  vtkCellData *outCD = output->GetCellData();
+  const vtkIdType numCells = cellIdOffsets[3] + numNewCells[3];
+  outCD->CopyAllocate(inCD, numCells);
+  GenerateCells generate(batches.data(), pointMap, convert, maxCellSize,
+                         connectivity, cellIdOffsets, inCD, numCells, outCD);
+  vtkSMPTools::For(0, numBatches, generate);
+  delete [] pointMap;
+
+  vtkDebugMacro(<<"Removed " << numPts - numNewPts << " points and "
+                << input->GetNumberOfCells() - numCells << " cells");
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  if ( numNewCells[CLEAN_VERT] > 0 )
+  {
+    output->SetVerts(newCells[CLEAN_VERT]);
+  }
+  if ( numNewCells[CLEAN_LINE] > 0 )
+  {
+    output->SetLines(newCells[CLEAN_LINE]);
+  }
+  if ( numNewCells[CLEAN_POLY] > 0 )
+  {
+    output->SetPolys(newCells[CLEAN_POLY]);
+  }
+  if ( numNewCells[CLEAN_STRIP] > 0 )
+  {
+    output->SetStrips(newCells[CLEAN_STRIP]);
+  }
+  for (int kind=0; kind < 4; ++kind)
+  {
+    newCells[kind]->Delete();
+  }
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -700,6 +1172,8 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "ParallelProcessing: "
+     << (this->ParallelProcessing ? "On\n" : "Off\n");
 }
 
 //--------------------------------------------------------------------------
@@ -50,6 +50,16 @@
  * will not be used, and points that are not used by any cells will be
  * eliminated, but never merged.
  *
+ * If ParallelProcessing is enabled, the points are binned with a
+ * vtkStaticPointLocator and merged in parallel, and the cells are rewritten
+ * with vtkSMPTools. The Tolerance, PointMerging and conversion flags have
+ * the same meaning, and the output cells (and their cell data) are in the
+ * same order as in serial mode. However, the output points are ordered by
+ * increasing input id rather than by first use, and each merged point takes
+ * the coordinates and the point data of its representative input point.
+ * With a non-zero tolerance, which points get merged together may also
+ * differ from the serial (greedy, order dependent) algorithm.
+ *
  * @warning
  * Merging points can alter topology, including introducing non-manifold
  * forms. The tolerance should be chosen carefully to avoid these problems.
@@ -148,6 +158,20 @@ public:
   vtkBooleanMacro(PointMerging,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the cleaning is
+   * multi-threaded with vtkSMPTools. If on, the points are merged with a
+   * vtkStaticPointLocator instead of the incremental Locator, and the point
+   * numbering of the output differs from the serial mode (see the class
+   * documentation). OperateOnPoint() must then be thread safe. By default,
+   * parallel processing is off.
+   */
+  vtkSetMacro(ParallelProcessing,vtkTypeBool);
+  vtkGetMacro(ParallelProcessing,vtkTypeBool);
+  vtkBooleanMacro(ParallelProcessing,vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
@@ -209,6 +233,9 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
+  // Multi-threaded implementation of RequestData.
+  void ParallelClean(vtkPolyData *input, vtkPolyData *output);
+
   vtkTypeBool   PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
@@ -220,6 +247,7 @@ protected:
 
   vtkTypeBool PieceInvariant;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelProcessing;
 private:
   vtkCleanPolyData(const vtkCleanPolyData&) = delete;
   void operator=(const vtkCleanPolyData&) = delete;
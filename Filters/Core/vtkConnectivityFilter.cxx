@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityLabeling.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -28,10 +29,12 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkIdTypeArray.h"
 
 #include <map>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkConnectivityFilter);
 
@@ -62,6 +65,8 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->NewCellScalars = nullptr;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+
+  this->ParallelLabeling = 0;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
@@ -242,7 +247,12 @@ int vtkConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( this->ParallelLabeling &&
+       this->LabelRegionsInParallel(input, largestRegionId) )
+  {
+    this->UpdateProgress (0.9);
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -535,6 +545,113 @@ int vtkConnectivityFilter::RequestData(
 }
 
 
+// Label the regions with several threads, see vtkConnectivityLabeling.
+// Returns false when the input must be traversed serially.
+bool vtkConnectivityFilter::LabelRegionsInParallel(vtkDataSet *input,
+                                                   vtkIdType &largestRegionId)
+{
+  if ( this->InScalars || !input->SupportsConcurrentReads() )
+  {
+    return false;
+  }
+  input->PrepareForConcurrentReads();
+
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  std::vector<vtkIdType> pointRegions(numPts);
+  vtkConnectivityLabeling::LabelRegions(input, this->Visited,
+                                        pointRegions.data(),
+                                        this->RegionSizes);
+  this->UpdateProgress (0.5);
+
+  const vtkIdType numRegions = this->RegionSizes->GetNumberOfValues();
+  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+  {
+    vtkIdType maxCellsInRegion = 0;
+    for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+      if ( this->RegionSizes->GetValue(regionId) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(regionId);
+        largestRegionId = regionId;
+      }
+    }
+    this->RegionNumber = numRegions;
+  }
+  else // regions have been seeded, everything considered in same region
+  {
+    std::vector<unsigned char> seeded(numRegions, 0);
+    vtkIdType i;
+    if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
+    {
+      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
+      {
+        const vtkIdType pt = this->Seeds->GetId(i);
+        if ( pt >= 0 && pt < numPts && pointRegions[pt] >= 0 )
+        {
+          seeded[pointRegions[pt]] = 1;
+        }
+      }
+    }
+    else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
+    {
+      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
+      {
+        const vtkIdType cellId = this->Seeds->GetId(i);
+        if ( cellId >= 0 && cellId < numCells )
+        {
+          seeded[this->Visited[cellId]] = 1;
+        }
+      }
+    }
+    else
+    {//loop over points, find closest one
+      double minDist2, dist2, x[3];
+      vtkIdType minId = 0;
+      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {
+        input->GetPoint(i,x);
+        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
+        if ( dist2 < minDist2 )
+        {
+          minId = i;
+          minDist2 = dist2;
+        }
+      }
+      if ( pointRegions[minId] >= 0 )
+      {
+        seeded[pointRegions[minId]] = 1;
+      }
+    }
+    vtkConnectivityLabeling::MergeSeededRegions(seeded.data(), numCells,
+                                                this->Visited, numPts,
+                                                pointRegions.data(),
+                                                this->RegionSizes);
+    this->RegionNumber = 0;
+  }
+
+  // Keep the points of the labeled cells, in the order of the input.
+  this->PointNumber = vtkConnectivityLabeling::MapPoints(numPts,
+    pointRegions.data(), this->PointMap, this->NewScalars->GetPointer(0));
+  vtkIdType *regions = this->Visited;
+  vtkIdType *newCellScalars = this->NewCellScalars->GetPointer(0);
+  vtkSMPTools::For(0, numCells,
+    [regions, newCellScalars](vtkIdType cellId, vtkIdType endCellId)
+    {
+      for ( ; cellId < endCellId; ++cellId)
+      {
+        if ( regions[cellId] >= 0 )
+        {
+          newCellScalars[cellId] = regions[cellId];
+        }
+      }
+    });
+
+  return true;
+}
+
 // Mark current cell as visited and assign region number.  Note:
 // traversal occurs across shared vertices.
 //
@@ -778,4 +895,6 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
 }
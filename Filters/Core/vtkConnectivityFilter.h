@@ -50,6 +50,13 @@
  * was processed and has no other significance with respect to the size of
  * or number of cells.
  *
+ * When ParallelLabeling is on, the regions of polydata and unstructured grids
+ * are labeled with several threads by merging the points of each cell into a
+ * union-find forest. The RegionIds and the extracted cells are the same as
+ * with the serial traversal, but the output points are ordered by input id
+ * instead of traversal order. ScalarConnectivity always uses the serial
+ * traversal.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
 */
@@ -208,6 +215,18 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the labeling of the regions with several threads (see the
+   * class documentation). Other datasets than polydata and unstructured
+   * grids, and scalar connectivity, are handled serially. The default is
+   * off.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
   int ProcessRequest(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
 protected:
@@ -235,7 +254,10 @@ protected:
 
   int RegionIdAssignmentMode;
 
+  vtkTypeBool ParallelLabeling;
+
   void TraverseAndMark(vtkDataSet *input);
+  bool LabelRegionsInParallel(vtkDataSet *input, vtkIdType &largestRegionId);
 
   void OrderRegionIds(vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds);
 
@@ -0,0 +1,423 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityLabeling.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConnectivityLabeling.h"
+
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Lock-free union-find forest over the points. A root is only ever linked
+// below a smaller root, so that the root of each set is its smallest point
+// id whatever the order of the unions.
+class PointForest
+{
+public:
+  explicit PointForest(vtkIdType numPts) :
+    Parents(new std::atomic<vtkIdType> [numPts])
+  {
+    std::atomic<vtkIdType> *parents = this->Parents.get();
+    vtkSMPTools::For(0, numPts, [parents](vtkIdType ptId, vtkIdType endPtId)
+    {
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        parents[ptId].store(ptId, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  vtkIdType Find(vtkIdType ptId)
+  {
+    vtkIdType parent = this->Parents[ptId].load(std::memory_order_relaxed);
+    while (parent != ptId)
+    {
+      // Path halving: links only ever move up to an ancestor.
+      const vtkIdType grandParent =
+        this->Parents[parent].load(std::memory_order_relaxed);
+      this->Parents[ptId].compare_exchange_weak(
+        parent, grandParent, std::memory_order_relaxed);
+      ptId = grandParent;
+      parent = this->Parents[ptId].load(std::memory_order_relaxed);
+    }
+    return ptId;
+  }
+
+  void Union(vtkIdType ptId1, vtkIdType ptId2)
+  {
+    for (;;)
+    {
+      ptId1 = this->Find(ptId1);
+      ptId2 = this->Find(ptId2);
+      if (ptId1 == ptId2)
+      {
+        return;
+      }
+      if (ptId1 < ptId2)
+      {
+        std::swap(ptId1, ptId2);
+      }
+      // Fails if another thread linked ptId1 in the meantime.
+      vtkIdType root = ptId1;
+      if (this->Parents[ptId1].compare_exchange_strong(
+            root, ptId2, std::memory_order_relaxed))
+      {
+        return;
+      }
+    }
+  }
+
+private:
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+};
+
+const vtkIdType LABELING_BATCH_SIZE = 4096;
+
+struct RegionLabeling
+{
+  vtkDataSet *Input;
+  PointForest Forest;
+  // The root of the first point of each cell, then its region number. Cells
+  // without points are regions of their own: they are labeled with -1, then
+  // with -2 - their region number until all the cells are numbered.
+  vtkIdType *Labels;
+  // The first cell of the set of each root.
+  std::unique_ptr<std::atomic<vtkIdType>[]> FirstCells;
+  // The region number of each root, then of each point.
+  vtkIdType *PointRegions;
+  // The number of regions starting in each batch of cells, then the number
+  // of the first of them.
+  std::vector<vtkIdType> BatchRegions;
+  std::unique_ptr<std::atomic<vtkIdType>[]> RegionSizes;
+
+  RegionLabeling(vtkDataSet *input, vtkIdType *labels,
+                 vtkIdType *pointRegions) :
+    Input(input),
+    Forest(input->GetNumberOfPoints()),
+    Labels(labels),
+    FirstCells(new std::atomic<vtkIdType> [input->GetNumberOfPoints()]),
+    PointRegions(pointRegions),
+    BatchRegions((input->GetNumberOfCells() - 1) / LABELING_BATCH_SIZE + 1)
+  {
+  }
+
+  bool IsFirstCell(vtkIdType cellId) const
+  {
+    const vtkIdType label = this->Labels[cellId];
+    return label < 0 ||
+      this->FirstCells[label].load(std::memory_order_relaxed) == cellId;
+  }
+};
+
+// Merge the points of each cell.
+struct UniteCellPoints
+{
+  RegionLabeling *Labeling;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  UniteCellPoints(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Labeling->Input->GetCellPoints(cellId, ptIds);
+      const vtkIdType npts = ptIds->GetNumberOfIds();
+      for (vtkIdType i = 1; i < npts; ++i)
+      {
+        this->Labeling->Forest.Union(ptIds->GetId(0), ptIds->GetId(i));
+      }
+    }
+  }
+};
+
+// Label the cells with their root, and find the first cell of each root.
+struct LabelCells
+{
+  RegionLabeling *Labeling;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  LabelCells(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    std::atomic<vtkIdType> *firstCells = this->Labeling->FirstCells.get();
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Labeling->Input->GetCellPoints(cellId, ptIds);
+      if (ptIds->GetNumberOfIds() == 0)
+      {
+        this->Labeling->Labels[cellId] = -1;
+        continue;
+      }
+      const vtkIdType root = this->Labeling->Forest.Find(ptIds->GetId(0));
+      this->Labeling->Labels[cellId] = root;
+      vtkIdType first = firstCells[root].load(std::memory_order_relaxed);
+      while (cellId < first &&
+             !firstCells[root].compare_exchange_weak(
+               first, cellId, std::memory_order_relaxed))
+      {
+      }
+    }
+  }
+};
+
+// Count the regions starting in each batch of cells.
+struct CountRegions
+{
+  RegionLabeling *Labeling;
+
+  CountRegions(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    const vtkIdType numCells = this->Labeling->Input->GetNumberOfCells();
+    for ( ; batch < endBatch; ++batch)
+    {
+      const vtkIdType endCellId =
+        std::min((batch + 1) * LABELING_BATCH_SIZE, numCells);
+      vtkIdType numRegions = 0;
+      for (vtkIdType cellId = batch * LABELING_BATCH_SIZE;
+           cellId < endCellId; ++cellId)
+      {
+        numRegions += this->Labeling->IsFirstCell(cellId);
+      }
+      this->Labeling->BatchRegions[batch] = numRegions;
+    }
+  }
+};
+
+// Number the regions from the offsets of the batches.
+struct NumberRegions
+{
+  RegionLabeling *Labeling;
+
+  NumberRegions(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    const vtkIdType numCells = this->Labeling->Input->GetNumberOfCells();
+    vtkIdType *labels = this->Labeling->Labels;
+    for ( ; batch < endBatch; ++batch)
+    {
+      vtkIdType regionId = this->Labeling->BatchRegions[batch];
+      const vtkIdType endCellId =
+        std::min((batch + 1) * LABELING_BATCH_SIZE, numCells);
+      for (vtkIdType cellId = batch * LABELING_BATCH_SIZE;
+           cellId < endCellId; ++cellId)
+      {
+        if (labels[cellId] < 0)
+        {
+          labels[cellId] = -2 - regionId++;
+        }
+        else if (this->Labeling->IsFirstCell(cellId))
+        {
+          this->Labeling->PointRegions[labels[cellId]] = regionId++;
+        }
+      }
+    }
+  }
+};
+
+// Replace the labels of the cells with their region number, and count the
+// cells of each region.
+struct LabelCellRegions
+{
+  RegionLabeling *Labeling;
+
+  LabelCellRegions(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType *labels = this->Labeling->Labels;
+    std::atomic<vtkIdType> *regionSizes = this->Labeling->RegionSizes.get();
+    // Consecutive cells are mostly in the same region: count them before
+    // updating the shared counters.
+    vtkIdType regionId = -1;
+    vtkIdType count = 0;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType label = labels[cellId];
+      const vtkIdType cellRegionId =
+        label < 0 ? -2 - label : this->Labeling->PointRegions[label];
+      labels[cellId] = cellRegionId;
+      if (cellRegionId != regionId)
+      {
+        if (count > 0)
+        {
+          regionSizes[regionId].fetch_add(count, std::memory_order_relaxed);
+        }
+        regionId = cellRegionId;
+        count = 0;
+      }
+      ++count;
+    }
+    if (count > 0)
+    {
+      regionSizes[regionId].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+};
+
+// Give each point the region number of its root. The roots keep their
+// entry, so that the entries read by the other threads do not change.
+struct LabelPoints
+{
+  RegionLabeling *Labeling;
+
+  LabelPoints(RegionLabeling *labeling) : Labeling(labeling) {}
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const vtkIdType root = this->Labeling->Forest.Find(ptId);
+      if (root != ptId)
+      {
+        this->Labeling->PointRegions[ptId] =
+          this->Labeling->PointRegions[root];
+      }
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectivityLabeling::LabelRegions(vtkDataSet *input,
+                                           vtkIdType *regions,
+                                           vtkIdType *pointRegions,
+                                           vtkIdTypeArray *regionSizes)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  RegionLabeling labeling(input, regions, pointRegions);
+  std::atomic<vtkIdType> *firstCells = labeling.FirstCells.get();
+  vtkSMPTools::Fill(firstCells, firstCells + numPts, numCells);
+  vtkSMPTools::Fill(pointRegions, pointRegions + numPts, vtkIdType(-1));
+
+  UniteCellPoints unite(&labeling);
+  vtkSMPTools::For(0, numCells, unite);
+  LabelCells labelCells(&labeling);
+  vtkSMPTools::For(0, numCells, labelCells);
+
+  // Number the regions in the order of their first cell.
+  const vtkIdType numBatches =
+    static_cast<vtkIdType>(labeling.BatchRegions.size());
+  CountRegions countRegions(&labeling);
+  vtkSMPTools::For(0, numBatches, countRegions);
+  const vtkIdType numLastRegions = labeling.BatchRegions[numBatches-1];
+  vtkSMPTools::ExclusiveScan(labeling.BatchRegions.begin(),
+                             labeling.BatchRegions.end(),
+                             labeling.BatchRegions.begin(), vtkIdType(0));
+  const vtkIdType numRegions =
+    labeling.BatchRegions[numBatches-1] + numLastRegions;
+  NumberRegions numberRegions(&labeling);
+  vtkSMPTools::For(0, numBatches, numberRegions);
+
+  labeling.RegionSizes.reset(new std::atomic<vtkIdType> [numRegions]);
+  std::atomic<vtkIdType> *sizes = labeling.RegionSizes.get();
+  vtkSMPTools::Fill(sizes, sizes + numRegions, vtkIdType(0));
+  LabelCellRegions labelCellRegions(&labeling);
+  vtkSMPTools::For(0, numCells, labelCellRegions);
+  LabelPoints labelPoints(&labeling);
+  vtkSMPTools::For(0, numPts, labelPoints);
+
+  regionSizes->SetNumberOfValues(numRegions);
+  std::copy(sizes, sizes + numRegions, regionSizes->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectivityLabeling::MergeSeededRegions(const unsigned char *seeded,
+                                                 vtkIdType numCells,
+                                                 vtkIdType *regions,
+                                                 vtkIdType numPts,
+                                                 vtkIdType *pointRegions,
+                                                 vtkIdTypeArray *regionSizes)
+{
+  vtkIdType numSeededCells = 0;
+  for (vtkIdType regionId = 0; regionId < regionSizes->GetNumberOfValues();
+       ++regionId)
+  {
+    if (seeded[regionId])
+    {
+      numSeededCells += regionSizes->GetValue(regionId);
+    }
+  }
+  regionSizes->SetNumberOfValues(1);
+  regionSizes->SetValue(0, numSeededCells);
+
+  vtkSMPTools::For(0, numCells,
+    [seeded, regions](vtkIdType cellId, vtkIdType endCellId)
+    {
+      for ( ; cellId < endCellId; ++cellId)
+      {
+        regions[cellId] = seeded[regions[cellId]] ? 0 : -1;
+      }
+    });
+  vtkSMPTools::For(0, numPts,
+    [seeded, pointRegions](vtkIdType ptId, vtkIdType endPtId)
+    {
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        if (pointRegions[ptId] >= 0)
+        {
+          pointRegions[ptId] = seeded[pointRegions[ptId]] ? 0 : -1;
+        }
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityLabeling::MapPoints(vtkIdType numPts,
+                                             const vtkIdType *pointRegions,
+                                             vtkIdType *pointMap,
+                                             vtkIdType *pointScalars)
+{
+  vtkSMPTools::Transform(pointRegions, pointRegions + numPts, pointMap,
+    [](vtkIdType regionId) -> vtkIdType { return regionId >= 0 ? 1 : 0; });
+  vtkSMPTools::ExclusiveScan(pointMap, pointMap + numPts, pointMap,
+                             vtkIdType(0));
+  const vtkIdType numNewPts =
+    pointMap[numPts-1] + (pointRegions[numPts-1] >= 0 ? 1 : 0);
+
+  vtkSMPTools::For(0, numPts,
+    [pointRegions, pointMap, pointScalars](vtkIdType ptId, vtkIdType endPtId)
+    {
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        if (pointRegions[ptId] >= 0)
+        {
+          pointScalars[pointMap[ptId]] = pointRegions[ptId];
+        }
+        else
+        {
+          pointMap[ptId] = -1;
+        }
+      }
+    });
+  return numNewPts;
+}
@@ -0,0 +1,76 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityLabeling.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectivityLabeling
+ * @brief   multi-threaded labeling of connected regions
+ *
+ * vtkConnectivityLabeling labels the regions of cells sharing points with
+ * vtkSMPTools, for vtkConnectivityFilter and vtkPolyDataConnectivityFilter.
+ * The points of each cell are merged into the same set of a lock-free
+ * union-find forest, whose sets are always linked below the set of smaller
+ * root so that the result does not depend on the order in which the threads
+ * merge them. The regions are numbered in the order of their first cell,
+ * as the serial traversal of the filters does.
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ */
+
+#ifndef vtkConnectivityLabeling_h
+#define vtkConnectivityLabeling_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h"
+
+class vtkDataSet;
+class vtkIdTypeArray;
+
+class VTKFILTERSCORE_EXPORT vtkConnectivityLabeling
+{
+public:
+  /**
+   * Label the regions of input, which must support concurrent reads and
+   * have been prepared for them (see vtkDataSet::SupportsConcurrentReads()).
+   * regions receives the region number of each cell, pointRegions the
+   * region number of each point (-1 for the points not used by any cell)
+   * and regionSizes the number of cells of each region.
+   */
+  static void LabelRegions(vtkDataSet *input, vtkIdType *regions,
+                           vtkIdType *pointRegions,
+                           vtkIdTypeArray *regionSizes);
+
+  /**
+   * Merge the regions flagged in seeded into region 0 and unlabel the
+   * other ones (-1), for numCells cells and numPts points. regionSizes is
+   * updated to the single region.
+   */
+  static void MergeSeededRegions(const unsigned char *seeded,
+                                 vtkIdType numCells, vtkIdType *regions,
+                                 vtkIdType numPts, vtkIdType *pointRegions,
+                                 vtkIdTypeArray *regionSizes);
+
+  /**
+   * Number the labeled points of the numPts points in the order of their
+   * ids into pointMap (-1 for the other ones), and store their region number
+   * at their new id in pointScalars. Returns the number of labeled points.
+   */
+  static vtkIdType MapPoints(vtkIdType numPts, const vtkIdType *pointRegions,
+                             vtkIdType *pointMap, vtkIdType *pointScalars);
+
+private:
+  vtkConnectivityLabeling() = delete;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectivityLabeling.h
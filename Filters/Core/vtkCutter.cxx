@@ -38,11 +38,15 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
@@ -52,6 +56,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
@@ -404,7 +411,11 @@ int vtkCutter::RequestData(
            input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
   {
     vtkDebugMacro(<< "Executing Unstructured Grid Cutter");
-    this->UnstructuredGridCutter(input, output);
+    if (!this->ParallelUnstructuredGridCutter(
+          vtkUnstructuredGrid::SafeDownCast(input), output))
+    {
+      this->UnstructuredGridCutter(input, output);
+    }
   }
   else
   {
@@ -1017,6 +1028,494 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// The multi-threaded cutter of unstructured grids processes the cells in
+// batches of consecutive cells, with one pass per cell dimension as the
+// serial code sorting by value. Each batch contours its cells into its own
+// points, cells and attributes, merging its points with a vtkMergePoints.
+// The points of all the batches are then merged on their coordinates,
+// keeping their first use, so that the output is numbered as the serial one.
+const vtkIdType CUTTER_BATCH_SIZE = 4096;
+
+struct CutterBatch
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkCellData> CellData;
+
+  // Where the batch goes in the merged points and in the output cells of
+  // its kind.
+  vtkIdType PointOffset;
+  vtkIdType CellOffset;
+  vtkIdType ConnectivityOffset;
+
+  CutterBatch() : PointOffset(0), CellOffset(0), ConnectivityOffset(0) {}
+};
+
+// Whether the arrays can be read and written from several threads.
+bool HasThreadSafeArrays(vtkFieldData *fd)
+{
+  for (int i = 0; i < fd->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *array = fd->GetAbstractArray(i);
+    if (!array->HasStandardMemoryLayout() || array->GetDataType() == VTK_BIT)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Implicit functions whose evaluation only reads their parameters.
+bool IsThreadSafe(vtkImplicitFunction *function)
+{
+  const char *threadSafeFunctions[] = { "vtkBox", "vtkCone", "vtkCylinder",
+    "vtkPlane", "vtkQuadric", "vtkSphere" };
+  if (function->GetTransform())
+  {
+    return false;
+  }
+  for (const char *className : threadSafeFunctions)
+  {
+    if (strcmp(function->GetClassName(), className) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Contour the cells of one dimension of each batch.
+struct ContourCutterBatches
+{
+  vtkUnstructuredGrid *Grid;
+  vtkDoubleArray *CutScalars;
+  vtkPointData *InPD;
+  vtkCellData *InCD;
+  const double *Values;
+  int NumberOfValues;
+  const unsigned char *CellTypeDimensions;
+  int Dimension;
+  const double *Bounds;
+  int PointsType;
+  CutterBatch *Batches;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkDoubleArray> CellScalars;
+  vtkSMPThreadLocalObject<vtkMergePoints> Locator;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkDoubleArray *cellScalars = this->CellScalars.Local();
+    vtkMergePoints *locator = this->Locator.Local();
+    const double *scalars = this->CutScalars->GetPointer(0);
+    const double *valuesEnd = this->Values + this->NumberOfValues;
+    const vtkIdType numCells = this->Grid->GetNumberOfCells();
+
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      CutterBatch &batch = this->Batches[batchId];
+      std::unique_ptr<vtkContourHelper> helper;
+      const vtkIdType endCellId =
+        std::min((batchId + 1) * CUTTER_BATCH_SIZE, numCells);
+      for (vtkIdType cellId = batchId * CUTTER_BATCH_SIZE; cellId < endCellId;
+           ++cellId)
+      {
+        const int cellType = this->Grid->GetCellType(cellId);
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+            this->CellTypeDimensions[cellType] != this->Dimension)
+        {
+          continue;
+        }
+
+        // Check whether the range of the cell scalars contains a value
+        vtkIdType npts, *pts;
+        this->Grid->GetCellPoints(cellId, npts, pts);
+        double range[2];
+        range[0] = range[1] = scalars[pts[0]];
+        for (vtkIdType i = 1; i < npts; ++i)
+        {
+          range[0] = std::min(range[0], scalars[pts[i]]);
+          range[1] = std::max(range[1], scalars[pts[i]]);
+        }
+        bool needCell = false;
+        for (const double *value = this->Values; value != valuesEnd; ++value)
+        {
+          if (*value >= range[0] && *value <= range[1])
+          {
+            needCell = true;
+            break;
+          }
+        }
+        if (!needCell)
+        {
+          continue;
+        }
+
+        if (!helper)
+        {
+          const vtkIdType estimatedSize = CUTTER_BATCH_SIZE / 4;
+          batch.Points = vtkSmartPointer<vtkPoints>::New();
+          batch.Points->SetDataType(this->PointsType);
+          batch.Points->Allocate(estimatedSize, estimatedSize);
+          batch.PointData = vtkSmartPointer<vtkPointData>::New();
+          batch.PointData->InterpolateAllocate(this->InPD, estimatedSize,
+                                               estimatedSize);
+          batch.CellData = vtkSmartPointer<vtkCellData>::New();
+          batch.CellData->CopyAllocate(this->InCD, estimatedSize,
+                                       estimatedSize);
+          batch.Verts = vtkSmartPointer<vtkCellArray>::New();
+          batch.Lines = vtkSmartPointer<vtkCellArray>::New();
+          batch.Polys = vtkSmartPointer<vtkCellArray>::New();
+          locator->InitPointInsertion(batch.Points, this->Bounds,
+                                      endCellId - batchId * CUTTER_BATCH_SIZE);
+          helper.reset(new vtkContourHelper(locator, batch.Verts, batch.Lines,
+            batch.Polys, this->InPD, this->InCD, batch.PointData,
+            batch.CellData, estimatedSize, true));
+        }
+
+        this->Grid->GetCell(cellId, cell);
+        cellScalars->SetNumberOfTuples(cell->GetNumberOfPoints());
+        this->CutScalars->GetTuples(cell->GetPointIds(), cellScalars);
+        for (const double *value = this->Values; value != valuesEnd; ++value)
+        {
+          helper->Contour(cell, *value, cellScalars, cellId);
+        }
+      }
+      if (helper)
+      {
+        locator->Initialize();
+      }
+    }
+  }
+};
+
+// Evaluate the cut function at the points, on consecutive ranges of points.
+void EvaluateCutFunction(vtkImplicitFunction *function, vtkDataArray *points,
+                         vtkDoubleArray *cutScalars)
+{
+  vtkSMPTools::For(0, points->GetNumberOfTuples(),
+    [function, points, cutScalars](vtkIdType begin, vtkIdType end)
+    {
+      vtkSmartPointer<vtkDataArray> rangePoints;
+      rangePoints.TakeReference(points->NewInstance());
+      rangePoints->SetNumberOfComponents(3);
+      rangePoints->SetVoidArray(points->GetVoidPointer(3 * begin),
+                                3 * (end - begin), 1);
+      vtkNew<vtkDoubleArray> rangeScalars;
+      rangeScalars->SetArray(cutScalars->GetPointer(begin), end - begin, 1);
+      function->FunctionValue(rangePoints, rangeScalars);
+    });
+}
+
+// Copy the cells of the batches, with the merged point ids, and their
+// attributes.
+struct CopyCutterBatchCells
+{
+  const std::vector<CutterBatch> *Batches;
+  int Kind;
+  const std::vector<vtkIdType> *PointIds;
+  vtkIdType *Connectivity;
+  vtkCellData *OutCD;
+  vtkIdType CellDataOffset;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId) const
+  {
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      const CutterBatch &batch = (*this->Batches)[batchId];
+      if (!batch.Points)
+      {
+        continue;
+      }
+      vtkCellArray *cells = this->Kind == 0 ? batch.Verts :
+        (this->Kind == 1 ? batch.Lines : batch.Polys);
+      const vtkIdType *pointIds = this->PointIds->data() + batch.PointOffset;
+      const vtkIdType *conn = cells->GetPointer();
+      const vtkIdType *connEnd = conn + cells->GetNumberOfConnectivityEntries();
+      vtkIdType *outConn = this->Connectivity + batch.ConnectivityOffset;
+      while (conn < connEnd)
+      {
+        vtkIdType npts = *conn++;
+        *outConn++ = npts;
+        for (; npts > 0; --npts)
+        {
+          *outConn++ = pointIds[*conn++];
+        }
+      }
+
+      const vtkIdType numCells = cells->GetNumberOfCells();
+      const vtkIdType cellOffset = this->CellDataOffset + batch.CellOffset;
+      for (int i = 0; i < this->OutCD->GetNumberOfArrays(); ++i)
+      {
+        vtkAbstractArray *outArray = this->OutCD->GetAbstractArray(i);
+        vtkAbstractArray *inArray = batch.CellData->GetAbstractArray(i);
+        for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+        {
+          outArray->SetTuple(cellOffset + cellId, cellId, inArray);
+        }
+      }
+    }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+bool vtkCutter::ParallelUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                               vtkPolyData *output)
+{
+  if ( this->Locator == nullptr )
+  {
+    this->CreateDefaultLocator();
+  }
+  vtkPointData *inputPD = input ? input->GetPointData() : nullptr;
+  vtkCellData *inCD = input ? input->GetCellData() : nullptr;
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 || !input ||
+      this->SortBy != VTK_SORT_BY_VALUE || !this->GenerateTriangles ||
+      input->GetFaces() ||
+      !vtkMergePoints::SafeDownCast(this->Locator) ||
+      !HasThreadSafeArrays(inputPD) || !HasThreadSafeArrays(inCD))
+  {
+    return false;
+  }
+
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const int numContours = this->ContourValues->GetNumberOfContours();
+  const double *contourValues = this->ContourValues->GetValues();
+
+  // set precision for the points in the output
+  int pointsType = input->GetPoints()->GetDataType();
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    pointsType = VTK_FLOAT;
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  // Evaluate the cut function at all the points
+  vtkNew<vtkDoubleArray> cutScalars;
+  cutScalars->SetNumberOfTuples(numPts);
+  vtkDataArray *inPoints = input->GetPoints()->GetData();
+  if (IsThreadSafe(this->CutFunction) &&
+      inPoints->HasStandardMemoryLayout() &&
+      (inPoints->GetDataType() == VTK_FLOAT ||
+       inPoints->GetDataType() == VTK_DOUBLE))
+  {
+    EvaluateCutFunction(this->CutFunction, inPoints, cutScalars);
+  }
+  else
+  {
+    this->CutFunction->FunctionValue(inPoints, cutScalars);
+  }
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  vtkSmartPointer<vtkPointData> inPD = inputPD;
+  if ( this->GenerateCutScalars )
+  {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(inputPD);//copies original attributes
+    inPD->SetScalars(cutScalars);
+  }
+
+  // Contour the cells of each dimension, one after the other. 0d cells
+  // cannot be cut.
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+  double bounds[6];
+  input->GetBounds(bounds);
+  const vtkIdType numBatches =
+    (numCells + CUTTER_BATCH_SIZE - 1) / CUTTER_BATCH_SIZE;
+  std::vector<CutterBatch> batches[3];
+  for (int dimension = 1; dimension <= 3; ++dimension)
+  {
+    std::vector<CutterBatch> &dimensionBatches = batches[dimension - 1];
+    dimensionBatches.resize(numBatches);
+    ContourCutterBatches contour;
+    contour.Grid = input;
+    contour.CutScalars = cutScalars;
+    contour.InPD = inPD;
+    contour.InCD = inCD;
+    contour.Values = contourValues;
+    contour.NumberOfValues = numContours;
+    contour.CellTypeDimensions = cellTypeDimensions;
+    contour.Dimension = dimension;
+    contour.Bounds = bounds;
+    contour.PointsType = pointsType;
+    contour.Batches = dimensionBatches.data();
+    vtkSMPTools::For(0, numBatches, contour);
+
+    this->UpdateProgress(dimension / 4.0);
+    if (this->GetAbortExecute())
+    {
+      return true;
+    }
+  }
+
+  // Cells of dimension n give cells of dimension n-1 only. Any other output
+  // is left to the serial code, which is then the reference.
+  vtkIdType numMergedPts = 0;
+  vtkIdType numOutCells[3] = { 0, 0, 0 };
+  vtkIdType outConnSize[3] = { 0, 0, 0 };
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    for (CutterBatch &batch : batches[kind])
+    {
+      if (!batch.Points)
+      {
+        continue;
+      }
+      vtkCellArray *cells[3] = { batch.Verts, batch.Lines, batch.Polys };
+      for (int otherKind = 0; otherKind < 3; ++otherKind)
+      {
+        if (otherKind != kind && cells[otherKind]->GetNumberOfCells() > 0)
+        {
+          return false;
+        }
+      }
+      batch.PointOffset = numMergedPts;
+      batch.CellOffset = numOutCells[kind];
+      batch.ConnectivityOffset = outConnSize[kind];
+      numMergedPts += batch.Points->GetNumberOfPoints();
+      numOutCells[kind] += cells[kind]->GetNumberOfCells();
+      outConnSize[kind] += cells[kind]->GetNumberOfConnectivityEntries();
+    }
+  }
+
+  // Gather the points of all the batches, and merge the coincident ones.
+  // The merged point keeps the lowest id, that is its first use.
+  vtkNew<vtkPoints> batchPoints;
+  batchPoints->SetDataType(pointsType);
+  batchPoints->SetNumberOfPoints(numMergedPts);
+  const int pointSize = 3 * batchPoints->GetData()->GetDataTypeSize();
+  std::vector<CutterBatch*> allBatches;
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    for (CutterBatch &batch : batches[kind])
+    {
+      if (batch.Points)
+      {
+        allBatches.push_back(&batch);
+      }
+    }
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(allBatches.size()),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
+      {
+        const CutterBatch *batch = allBatches[begin];
+        memcpy(batchPoints->GetData()->GetVoidPointer(3 * batch->PointOffset),
+               batch->Points->GetData()->GetVoidPointer(0),
+               batch->Points->GetNumberOfPoints() * pointSize);
+      }
+    });
+
+  std::vector<vtkIdType> mergeMap(numMergedPts);
+  if (numMergedPts > 0)
+  {
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(batchPoints);
+    vtkNew<vtkStaticPointLocator> mergeLocator;
+    mergeLocator->SetDataSet(cloud);
+    mergeLocator->BuildLocator();
+    mergeLocator->MergePoints(0.0, mergeMap.data());
+  }
+  std::vector<vtkIdType> pointIds(numMergedPts);
+  vtkIdType numNewPts = 0;
+  for (vtkIdType ptId = 0; ptId < numMergedPts; ++ptId)
+  {
+    pointIds[ptId] = mergeMap[ptId] == ptId ? numNewPts++ :
+      pointIds[mergeMap[ptId]];
+  }
+
+  // Copy the merged points and their attributes
+  vtkNew<vtkPoints> newPoints;
+  newPoints->SetDataType(pointsType);
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkPointData *outPD = output->GetPointData();
+  outPD->InterpolateAllocate(inPD, numNewPts);
+  for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+  {
+    outPD->GetAbstractArray(i)->SetNumberOfTuples(numNewPts);
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(allBatches.size()),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for ( ; begin < end; ++begin)
+      {
+        const CutterBatch *batch = allBatches[begin];
+        const vtkIdType numBatchPts = batch->Points->GetNumberOfPoints();
+        for (vtkIdType ptId = 0; ptId < numBatchPts; ++ptId)
+        {
+          const vtkIdType mergedId = batch->PointOffset + ptId;
+          if (mergeMap[mergedId] != mergedId)
+          {
+            continue;
+          }
+          const vtkIdType newId = pointIds[mergedId];
+          memcpy(newPoints->GetData()->GetVoidPointer(3 * newId),
+                 batch->Points->GetData()->GetVoidPointer(3 * ptId), pointSize);
+          for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+          {
+            outPD->GetAbstractArray(i)->SetTuple(
+              newId, ptId, batch->PointData->GetAbstractArray(i));
+          }
+        }
+      }
+    });
+
+  // Copy the cells, verts first, then lines and polys.
+  vtkCellData *outCD = output->GetCellData();
+  const vtkIdType numNewCells = numOutCells[0] + numOutCells[1] +
+    numOutCells[2];
+  outCD->CopyAllocate(inCD, numNewCells);
+  for (int i = 0; i < outCD->GetNumberOfArrays(); ++i)
+  {
+    outCD->GetAbstractArray(i)->SetNumberOfTuples(numNewCells);
+  }
+  vtkSmartPointer<vtkCellArray> newCells[3];
+  vtkIdType cellDataOffset = 0;
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    newCells[kind] = vtkSmartPointer<vtkCellArray>::New();
+    CopyCutterBatchCells copyCells;
+    copyCells.Batches = &batches[kind];
+    copyCells.Kind = kind;
+    copyCells.PointIds = &pointIds;
+    copyCells.Connectivity =
+      newCells[kind]->WritePointer(numOutCells[kind], outConnSize[kind]);
+    copyCells.OutCD = outCD;
+    copyCells.CellDataOffset = cellDataOffset;
+    vtkSMPTools::For(0, numBatches, copyCells);
+    cellDataOffset += numOutCells[kind];
+  }
+
+  output->SetPoints(newPoints);
+  if (numOutCells[0])
+  {
+    output->SetVerts(newCells[0]);
+  }
+  if (numOutCells[1])
+  {
+    output->SetLines(newCells[1]);
+  }
+  if (numOutCells[2])
+  {
+    output->SetPolys(newCells[2]);
+  }
+  output->Squeeze();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
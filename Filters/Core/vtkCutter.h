@@ -38,6 +38,14 @@
  * By default, if an implicit function is set it is used to clip the data
  * set, otherwise the dataset scalars are used to perform the clipping.
  *
+ * Unstructured grids are cut with several threads through vtkSMPTools when
+ * more than one thread is available, the default vtkMergePoints locator is
+ * used, the output is sorted by value, triangles are generated and the grid
+ * has no polyhedron: the cut function is evaluated in parallel, groups of
+ * cells are contoured concurrently, and their points are merged afterwards
+ * on their coordinates, as the locator does. The output is the same as the
+ * one of a serial execution.
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData
 */
@@ -59,6 +67,7 @@ class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
 class vtkRectilinearSynchronizedTemplates;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkCutter : public vtkPolyDataAlgorithm
 {
@@ -231,6 +240,14 @@ protected:
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int FillInputPortInformation(int port, vtkInformation *info) override;
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+
+  /**
+   * Multi-threaded cut of unstructured grids. Return false, leaving the
+   * output untouched, when the input or the settings require the serial
+   * UnstructuredGridCutter().
+   */
+  bool ParallelUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
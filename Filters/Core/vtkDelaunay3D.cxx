@@ -851,7 +851,8 @@ vtkUnstructuredGrid *vtkDelaunay3D::InitPointInsertion(double center[3],
 
   Mesh->SetPoints(points);
   points->Delete();
-  Mesh->BuildLinks();
+  // The links are edited as the points are inserted.
+  Mesh->BuildLinks(Mesh->GetNumberOfPoints());
 
   // Keep track of change in references to points
   this->References = new int [numPtsToInsert+6];
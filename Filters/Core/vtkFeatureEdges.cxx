@@ -15,13 +15,18 @@
 #include "vtkFeatureEdges.h"
 
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkMath.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleStrip.h"
 #include "vtkUnsignedCharArray.h"
@@ -30,8 +35,25 @@
 #include "vtkPointData.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkFeatureEdges);
 
+namespace
+{
+// An edge of a polygon: its end points, the id of the edge in the polygon
+// traversal order (EId), and the polygon (T).
+typedef vtkStaticEdgeLocatorTemplate<vtkIdType, vtkIdType> vtkFeatureEdgeLocator;
+typedef vtkFeatureEdgeLocator::MergeTupleType vtkFeatureEdgeTuple;
+
+// Edge types, in the order of the serial tests, and their scalar values.
+enum { NotExtracted = 0, Boundary, NonManifold, Feature, Manifold };
+const double EdgeTypeScalars[] = { 0.0, 0.0, 0.222222, 0.444444, 0.666667 };
+}
+
 // Construct object with feature angle = 30; all types of edges, except
 // manifold edges, are extracted and colored.
 vtkFeatureEdges::vtkFeatureEdges()
@@ -156,6 +178,12 @@ int vtkFeatureEdges::RequestData(
     newPolys = inPolys;
     Mesh->SetPolys(newPolys);
   }
+
+  if ( this->ExtractEdgesInParallel(input, Mesh, ghosts, output) )
+  {
+    Mesh->Delete();
+    return 1;
+  }
   Mesh->BuildLinks();
 
   // Allocate storage for lines/points (arbitrary allocation sizes)
@@ -380,6 +408,344 @@ int vtkFeatureEdges::RequestData(
   return 1;
 }
 
+bool vtkFeatureEdges::ExtractEdgesInParallel(vtkPolyData *input,
+                                             vtkPolyData *mesh,
+                                             const unsigned char *ghosts,
+                                             vtkPolyData *output)
+{
+  if ( this->Locator == nullptr )
+  {
+    this->CreateDefaultLocator();
+  }
+
+  // The merged points are numbered as vtkMergePoints does when they are
+  // stored with the type of the input points. Ghost levels and cell data
+  // are read at the ids of the polygons, which must be input cells. The
+  // connectivity of the polygons is read directly in the legacy layout.
+  vtkPoints *inPts = input->GetPoints();
+  vtkCellArray *polys = mesh->GetPolys();
+  const vtkIdType numPolys = polys->GetNumberOfCells();
+  const int pointType = inPts->GetDataType();
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 ||
+       !vtkMergePoints::SafeDownCast(this->Locator) ||
+       polys->GetStorageMode() != vtkCellArray::LEGACY_STORAGE ||
+       numPolys > input->GetNumberOfCells() ||
+       (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION &&
+        pointType != VTK_FLOAT) ||
+       (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION &&
+        pointType != VTK_DOUBLE) )
+  {
+    return false;
+  }
+
+  // Where the polygons and their edges start.
+  std::vector<vtkIdType> edgeOffsets(numPolys + 1);
+  vtkIdType *conn = polys->GetPointer();
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numPolys; ++cellId)
+  {
+    edgeOffsets[cellId] = loc - cellId;
+    loc += conn[loc] + 1;
+  }
+  edgeOffsets[numPolys] = loc - numPolys;
+  const vtkIdType numEdges = edgeOffsets[numPolys];
+
+  // Polygon normals, stored as floats like the serial ones, and the edges.
+  std::vector<float> normals(this->FeatureEdges ? 3 * numPolys : 0);
+  std::vector<vtkFeatureEdgeTuple> edges(numEdges);
+  vtkSMPTools::For(0, numPolys, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      vtkIdType *pts = conn + edgeOffsets[cellId] + cellId + 1;
+      const vtkIdType npts = pts[-1];
+      if ( this->FeatureEdges )
+      {
+        double n[3];
+        vtkPolygon::ComputeNormal(inPts, static_cast<int>(npts), pts, n);
+        for (int i = 0; i < 3; ++i)
+        {
+          normals[3 * cellId + i] = static_cast<float>(n[i]);
+        }
+      }
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const vtkIdType edgeId = edgeOffsets[cellId] + i;
+        edges[edgeId] = vtkFeatureEdgeTuple(pts[i], pts[(i + 1) % npts],
+                                            edgeId, cellId);
+      }
+    }
+  });
+  this->UpdateProgress(0.2);
+
+  // Group the copies of each edge.
+  vtkFeatureEdgeLocator locator;
+  vtkIdType numUniqueEdges = 0;
+  const vtkIdType *groups = nullptr;
+  if ( numEdges > 0 )
+  {
+    groups = locator.MergeEdges(numEdges, edges.data(), numUniqueEdges);
+  }
+  this->UpdateProgress(0.4);
+
+  // The serial code finds the polygons sharing an edge with the cell links,
+  // i.e. all the polygons using both end points. They are the polygons having
+  // the edge unless a polygon repeats a point, or has the end points of the
+  // edge as a diagonal.
+  std::atomic<bool> serial(false);
+  vtkSMPTools::For(0, numPolys, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    std::vector<std::pair<vtkIdType, vtkIdType> > sortedPts;
+    for ( ; cellId < endCellId && !serial; ++cellId)
+    {
+      const vtkIdType *pts = conn + edgeOffsets[cellId] + cellId + 1;
+      const vtkIdType npts = pts[-1];
+      if ( npts < 4 )
+      {
+        if ( npts == 1 || (npts > 1 && pts[0] == pts[1]) ||
+             (npts == 3 && (pts[1] == pts[2] || pts[2] == pts[0])) )
+        {
+          serial = true;
+        }
+        continue;
+      }
+      sortedPts.clear();
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        sortedPts.push_back(std::make_pair(pts[i], i));
+      }
+      std::sort(sortedPts.begin(), sortedPts.end());
+      for (vtkIdType i = 0; i + 1 < npts; ++i)
+      {
+        if ( sortedPts[i].first == sortedPts[i + 1].first )
+        {
+          serial = true;
+          break;
+        }
+      }
+      // Look for the edges (v0,v1), v0 < v1, joining two points of the
+      // polygon that are not adjacent in the polygon.
+      for (vtkIdType i = 0; i < npts && !serial; ++i)
+      {
+        const vtkIdType v0 = sortedPts[i].first;
+        const vtkIdType *group = std::lower_bound(groups,
+          groups + numUniqueEdges, v0, [&](vtkIdType offset, vtkIdType v)
+          {
+            return edges[offset].V0 < v;
+          });
+        for ( ; group != groups + numUniqueEdges &&
+                edges[*group].V0 == v0; ++group)
+        {
+          auto other = std::lower_bound(sortedPts.begin() + i + 1,
+            sortedPts.end(), std::make_pair(edges[*group].V1, vtkIdType(0)));
+          if ( other != sortedPts.end() && other->first == edges[*group].V1 )
+          {
+            const vtkIdType distance =
+              std::abs(other->second - sortedPts[i].second);
+            if ( distance != 1 && distance != npts - 1 )
+            {
+              serial = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+  });
+  if ( serial )
+  {
+    return false;
+  }
+
+  // Type of each edge of each polygon, as tested by the serial code with the
+  // polygons sharing the edge.
+  const double cosAngle = this->FeatureEdges ?
+    cos( vtkMath::RadiansFromDegrees( this->FeatureAngle ) ) : 0.0;
+  std::vector<unsigned char> edgeTypes(numEdges);
+  std::vector<vtkIdType> lineIds(numEdges);
+  vtkSMPTools::For(0, numUniqueEdges, [&](vtkIdType group, vtkIdType endGroup)
+  {
+    std::vector<vtkIdType> cells;
+    for ( ; group < endGroup; ++group)
+    {
+      cells.clear();
+      for (vtkIdType i = groups[group]; i < groups[group + 1]; ++i)
+      {
+        cells.push_back(edges[i].T);
+      }
+      std::sort(cells.begin(), cells.end());
+      cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+      const vtkIdType numNei = static_cast<vtkIdType>(cells.size()) - 1;
+
+      for (vtkIdType i = groups[group]; i < groups[group + 1]; ++i)
+      {
+        const vtkIdType cellId = edges[i].T;
+        const vtkIdType nei = cells[0] == cellId ? cells[numNei] : cells[0];
+        unsigned char type = NotExtracted;
+        if ( this->BoundaryEdges && numNei < 1 )
+        {
+          type = Boundary;
+        }
+        else if ( this->NonManifoldEdges && numNei > 1 )
+        {
+          type = cells[0] < cellId ? NotExtracted : NonManifold;
+        }
+        else if ( this->FeatureEdges && numNei == 1 && nei > cellId )
+        {
+          const double neiTuple[3] = { normals[3 * nei],
+            normals[3 * nei + 1], normals[3 * nei + 2] };
+          const double cellTuple[3] = { normals[3 * cellId],
+            normals[3 * cellId + 1], normals[3 * cellId + 2] };
+          type = vtkMath::Dot(neiTuple, cellTuple) <= cosAngle ?
+            Feature : NotExtracted;
+        }
+        else if ( this->ManifoldEdges && numNei == 1 && nei > cellId )
+        {
+          type = Manifold;
+        }
+        if ( ghosts && ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL )
+        {
+          type = NotExtracted;
+        }
+        edgeTypes[edges[i].EId] = type;
+        lineIds[edges[i].EId] = type != NotExtracted;
+      }
+    }
+  });
+  this->UpdateProgress(0.6);
+
+  // Lines are numbered in the order of the polygon edges.
+  vtkIdType numLines = numEdges > 0 ? lineIds[numEdges - 1] : 0;
+  vtkSMPTools::ExclusiveScan(lineIds.begin(), lineIds.end(), lineIds.begin(),
+                             vtkIdType(0));
+  numLines += numEdges > 0 ? lineIds[numEdges - 1] : 0;
+
+  // End points and polygon of each line.
+  std::vector<vtkIdType> lineEnds(2 * numLines);
+  vtkNew<vtkIdList> lineCells;
+  lineCells->SetNumberOfIds(numLines);
+  vtkSMPTools::For(0, numPolys, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *pts = conn + edgeOffsets[cellId] + cellId + 1;
+      const vtkIdType npts = pts[-1];
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const vtkIdType edgeId = edgeOffsets[cellId] + i;
+        if ( edgeTypes[edgeId] != NotExtracted )
+        {
+          const vtkIdType lineId = lineIds[edgeId];
+          lineEnds[2 * lineId] = pts[i];
+          lineEnds[2 * lineId + 1] = pts[(i + 1) % npts];
+          lineCells->SetId(lineId, cellId);
+        }
+      }
+    }
+  });
+
+  // Coincident points are merged as with vtkMergePoints: each group of
+  // coincident points gets the id of its first use, and the data of the
+  // point used first.
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  std::vector<vtkIdType> mergeMap(numPts);
+  vtkNew<vtkStaticPointLocator> pointLocator;
+  pointLocator->SetDataSet(mesh);
+  pointLocator->BuildLocator();
+  pointLocator->MergePoints(0.0, mergeMap.data());
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkNew<vtkIdList> outPtSources;
+  outPtSources->Allocate(numPts/10, numPts);
+  for (vtkIdType i = 0; i < 2 * numLines; ++i)
+  {
+    vtkIdType &newId = pointMap[mergeMap[lineEnds[i]]];
+    if ( newId < 0 )
+    {
+      newId = outPtSources->InsertNextId(lineEnds[i]);
+    }
+  }
+  this->UpdateProgress(0.8);
+
+  // Write the points, lines and edge types.
+  const vtkIdType numNewPts = outPtSources->GetNumberOfIds();
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(pointType);
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkNew<vtkCellArray> newLines;
+  vtkIdType *lines = newLines->WritePointer(numLines, 3 * numLines);
+  vtkFloatArray *newScalars = nullptr;
+  if ( this->Coloring )
+  {
+    newScalars = vtkFloatArray::New();
+    newScalars->SetName("Edge Types");
+    newScalars->SetNumberOfTuples(numLines);
+  }
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      inPts->GetPoint(outPtSources->GetId(ptId), x);
+      newPts->SetPoint(ptId, x);
+    }
+  });
+  vtkSMPTools::For(0, numEdges, [&](vtkIdType edgeId, vtkIdType endEdgeId)
+  {
+    for ( ; edgeId < endEdgeId; ++edgeId)
+    {
+      if ( edgeTypes[edgeId] == NotExtracted )
+      {
+        continue;
+      }
+      const vtkIdType lineId = lineIds[edgeId];
+      lines[3 * lineId] = 2;
+      lines[3 * lineId + 1] = pointMap[mergeMap[lineEnds[2 * lineId]]];
+      lines[3 * lineId + 2] = pointMap[mergeMap[lineEnds[2 * lineId + 1]]];
+      if ( newScalars )
+      {
+        newScalars->SetValue(lineId,
+          static_cast<float>(EdgeTypeScalars[edgeTypes[edgeId]]));
+      }
+    }
+  });
+
+  // Copy the attributes of the points used first and of the polygons.
+  vtkPointData *pd = input->GetPointData(), *outPD = output->GetPointData();
+  vtkCellData *cd = input->GetCellData(), *outCD = output->GetCellData();
+  outPD->CopyAllocate(pd, numPts);
+  outCD->CopyAllocate(cd, input->GetNumberOfCells());
+  vtkNew<vtkIdList> newPtIds;
+  newPtIds->SetNumberOfIds(numNewPts);
+  vtkNew<vtkIdList> newLineIds;
+  newLineIds->SetNumberOfIds(numLines);
+  vtkIdList *newIds[] = { newPtIds, newLineIds };
+  for (vtkIdList *ids : newIds)
+  {
+    vtkSMPTools::For(0, ids->GetNumberOfIds(), [&](vtkIdType id, vtkIdType endId)
+    {
+      for ( ; id < endId; ++id)
+      {
+        ids->SetId(id, id);
+      }
+    });
+  }
+  outPD->CopyData(pd, outPtSources, newPtIds);
+  outCD->CopyData(cd, lineCells, newLineIds);
+
+  vtkDebugMacro(<<"Created " << numLines << " edges in parallel");
+
+  output->SetPoints(newPts);
+  output->SetLines(newLines);
+  if ( this->Coloring )
+  {
+    int idx = outCD->AddArray(newScalars);
+    outCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+  }
+
+  return true;
+}
+
 void vtkFeatureEdges::CreateDefaultLocator()
 {
   if ( this->Locator == nullptr )
@@ -31,6 +31,15 @@
  * instance variable of the mapper to SetScalarModeToUseCellData(). (This
  * is only a problem if there are point data scalars.)
  *
+ * @warning
+ * When more than one thread is available, the edges of the polygons are
+ * gathered with vtkStaticEdgeLocatorTemplate instead of the cell links, the
+ * polygon normals and the edge types are computed with vtkSMPTools, and the
+ * lines are written at offsets given by a parallel scan. The output is the
+ * same as the one of a serial execution. Polygons repeating a point, or
+ * with a diagonal that is the edge of another polygon, custom locators and
+ * changes of point precision are left to the serial code.
+ *
  * @sa
  * vtkExtractEdges
 */
@@ -145,6 +154,14 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
+  /**
+   * Multi-threaded extraction of the edges of the polygons of mesh, called
+   * by RequestData() before the cell links are built. Return false, without
+   * touching the output, when the edges have to be extracted serially.
+   */
+  bool ExtractEdgesInParallel(vtkPolyData *input, vtkPolyData *mesh,
+                              const unsigned char *ghosts, vtkPolyData *output);
+
   double FeatureAngle;
   vtkTypeBool BoundaryEdges;
   vtkTypeBool FeatureEdges;
@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkFloatArray.h"
@@ -22,10 +24,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,9 +37,162 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
+namespace
+{
+// The matrix of a glyph, built with the same operations as the vtkTransform
+// of the serial code so that both give the same glyphs, but without the
+// concatenation objects.
+class GlyphMatrix
+{
+public:
+  GlyphMatrix()
+  {
+    this->Identity();
+  }
+
+  void Identity()
+  {
+    vtkMatrix4x4::Identity(this->PreMatrix);
+    this->Concatenated = false;
+  }
+
+  void Translate(double x, double y, double z)
+  {
+    if (x == 0.0 && y == 0.0 && z == 0.0)
+    {
+      return;
+    }
+    double matrix[16];
+    vtkMatrix4x4::Identity(matrix);
+    matrix[3] = x;
+    matrix[7] = y;
+    matrix[11] = z;
+    this->Concatenate(matrix);
+  }
+
+  void RotateWXYZ(double angle, double x, double y, double z)
+  {
+    if (angle == 0.0 || (x == 0.0 && y == 0.0 && z == 0.0))
+    {
+      return;
+    }
+
+    // make a normalized quaternion, and convert it to a matrix
+    angle = vtkMath::RadiansFromDegrees(angle);
+    double w = cos(0.5*angle);
+    double f = sin(0.5*angle)/sqrt(x*x+y*y+z*z);
+    x *= f;
+    y *= f;
+    z *= f;
+
+    double matrix[16];
+    vtkMatrix4x4::Identity(matrix);
+    double ww = w*w;
+    double wx = w*x;
+    double wy = w*y;
+    double wz = w*z;
+    double xx = x*x;
+    double yy = y*y;
+    double zz = z*z;
+    double xy = x*y;
+    double xz = x*z;
+    double yz = y*z;
+    double s = ww - xx - yy - zz;
+
+    matrix[0] = xx*2 + s;
+    matrix[4] = (xy + wz)*2;
+    matrix[8] = (xz - wy)*2;
+    matrix[1] = (xy - wz)*2;
+    matrix[5] = yy*2 + s;
+    matrix[9] = (yz + wx)*2;
+    matrix[2] = (xz + wy)*2;
+    matrix[6] = (yz - wx)*2;
+    matrix[10] = zz*2 + s;
+    this->Concatenate(matrix);
+  }
+
+  void Scale(double x, double y, double z)
+  {
+    if (x == 1.0 && y == 1.0 && z == 1.0)
+    {
+      return;
+    }
+    double matrix[16];
+    vtkMatrix4x4::Identity(matrix);
+    matrix[0] = x;
+    matrix[5] = y;
+    matrix[10] = z;
+    this->Concatenate(matrix);
+  }
+
+  // The matrix that transforms the points, and the one that transforms the
+  // normals.
+  void GetMatrices(double matrix[16], double normalMatrix[16]) const
+  {
+    vtkMatrix4x4::Identity(matrix);
+    if (this->Concatenated)
+    {
+      vtkMatrix4x4::Multiply4x4(matrix, this->PreMatrix, matrix);
+    }
+    vtkMatrix4x4::Invert(matrix, normalMatrix);
+    vtkMatrix4x4::Transpose(normalMatrix, normalMatrix);
+  }
+
+private:
+  void Concatenate(const double matrix[16])
+  {
+    vtkMatrix4x4::Multiply4x4(this->PreMatrix, matrix, this->PreMatrix);
+    this->Concatenated = true;
+  }
+
+  double PreMatrix[16];
+  bool Concatenated;
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void TransformGlyphPoints(const double matrix[16], const double *in,
+                          vtkIdType numPts, T *out)
+{
+  for (vtkIdType i = 0; i < numPts; ++i, in += 3, out += 3)
+  {
+    T x = static_cast<T>(
+      matrix[0]*in[0]+matrix[1]*in[1]+matrix[2]*in[2]+matrix[3]);
+    T y = static_cast<T>(
+      matrix[4]*in[0]+matrix[5]*in[1]+matrix[6]*in[2]+matrix[7]);
+    T z = static_cast<T>(
+      matrix[8]*in[0]+matrix[9]*in[1]+matrix[10]*in[2]+matrix[11]);
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+  }
+}
+
+//----------------------------------------------------------------------------
+void TransformGlyphNormals(const double matrix[16], const double *in,
+                           vtkIdType numPts, float *out)
+{
+  for (vtkIdType i = 0; i < numPts; ++i, in += 3, out += 3)
+  {
+    float x = static_cast<float>(
+      matrix[0]*in[0] + matrix[1]*in[1] + matrix[2]*in[2]);
+    float y = static_cast<float>(
+      matrix[4]*in[0] + matrix[5]*in[1] + matrix[6]*in[2]);
+    float z = static_cast<float>(
+      matrix[8]*in[0] + matrix[9]*in[1] + matrix[10]*in[2]);
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+    vtkMath::Normalize(out);
+  }
+}
+}
+
 //----------------------------------------------------------------------------
 // Construct object with scaling on, scaling mode is by scalar value,
 // scale factor = 1.0, the range is (0,1), orient geometry is on, and
@@ -400,8 +557,18 @@ bool vtkGlyph3D::Execute(
     newTCoords->SetName("TCoords");
   }
 
+  // Generate all the glyphs at once with several threads when possible.
+  const bool parallel = this->GlyphInParallel(
+    input, source, inSScalars, inVectors, inNormals, inCScalars,
+    inGhostLevels, newPts, newScalars, newVectors, newNormals, newTCoords,
+    pointIds, output);
+
   // Setting up for calls to PolyData::InsertNextCell()
-  if (this->IndexMode != VTK_INDEXING_OFF )
+  if (parallel)
+  {
+    // The cells are already there.
+  }
+  else if (this->IndexMode != VTK_INDEXING_OFF )
   {
     output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
   }
@@ -419,7 +586,7 @@ bool vtkGlyph3D::Execute(
   //
   ptIncr=0;
   cellIncr=0;
-  for (inPtId=0; inPtId < numPts; inPtId++)
+  for (inPtId=0; !parallel && inPtId < numPts; inPtId++)
   {
     scalex = scaley = scalez = 1.0;
     if ( ! (inPtId % 10000) )
@@ -741,6 +908,413 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkGlyph3D::GlyphInParallel(
+  vtkDataSet *input, vtkPolyData *source, vtkDataArray *inSScalars,
+  vtkDataArray *inVectors, vtkDataArray *inNormals, vtkDataArray *inCScalars,
+  const unsigned char *inGhostLevels, vtkPoints *newPts,
+  vtkDataArray *newScalars, vtkDataArray *newVectors,
+  vtkDataArray *newNormals, vtkDataArray *newTCoords,
+  vtkIdTypeArray *pointIds, vtkPolyData *output)
+{
+  vtkPointData *pd = input->GetPointData();
+  vtkPoints *sourcePts = source->GetPoints();
+  vtkDataArray *sourceNormals = source->GetPointData()->GetNormals();
+  vtkDataArray *sourceTCoords = source->GetPointData()->GetTCoords();
+  vtkDataArray *array3D =
+    this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+  const bool haveVectors = newVectors != nullptr;
+
+  // Indexing, arrays that cannot be copied concurrently, and cases where the
+  // serial code reports an error are left to the serial code.
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 ||
+      this->IndexMode != VTK_INDEXING_OFF || !sourcePts ||
+      (haveVectors && array3D->GetNumberOfComponents() > 3) ||
+      (sourceNormals && sourceNormals->GetDataType() != VTK_FLOAT &&
+       sourceNormals->GetDataType() != VTK_DOUBLE) ||
+      (inCScalars && this->ColorMode == VTK_COLOR_BY_SCALAR &&
+       inCScalars->GetDataType() == VTK_BIT) ||
+      !ArrayList::ProcessesAllArrays(pd) ||
+      (pointIds && pd->GetAbstractArray(this->PointIdsName)))
+  {
+    return false;
+  }
+
+  // Number the glyphed points, which gives where each glyph goes.
+  vtkUniformGrid *inputUG = vtkUniformGrid::SafeDownCast(input);
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  std::vector<vtkIdType> glyphIds(numPts);
+  vtkIdType numGlyphs = 0;
+  for (vtkIdType inPtId = 0; inPtId < numPts; ++inPtId)
+  {
+    if ((inGhostLevels &&
+         inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT) ||
+        (inputUG && !inputUG->IsPointVisible(inPtId)) ||
+        !this->IsPointVisible(input, inPtId))
+    {
+      glyphIds[inPtId] = -1;
+    }
+    else
+    {
+      glyphIds[inPtId] = numGlyphs++;
+    }
+  }
+
+  // The source points, normals and texture coordinates in double precision.
+  const vtkIdType numSourcePts = sourcePts->GetNumberOfPoints();
+  const vtkIdType numSourceCells = source->GetNumberOfCells();
+  std::vector<double> sourcePoints(3 * numSourcePts);
+  vtkNew<vtkPoints> transformedSourcePts;
+  if (this->SourceTransform)
+  {
+    transformedSourcePts->SetDataTypeToDouble();
+    this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
+    sourcePts = transformedSourcePts;
+  }
+  for (vtkIdType i = 0; i < numSourcePts; ++i)
+  {
+    sourcePts->GetPoint(i, &sourcePoints[3 * i]);
+  }
+  std::vector<double> sourceNormalValues;
+  if (sourceNormals)
+  {
+    sourceNormalValues.resize(3 * numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      sourceNormals->GetTuple(i, &sourceNormalValues[3 * i]);
+    }
+  }
+  std::vector<double> sourceTCoordValues;
+  int numTCoordComps = 0;
+  if (newTCoords)
+  {
+    numTCoordComps = sourceTCoords->GetNumberOfComponents();
+    sourceTCoordValues.resize(numTCoordComps * numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      sourceTCoords->GetTuple(i, &sourceTCoordValues[numTCoordComps * i]);
+    }
+  }
+
+  // Size the output.
+  const vtkIdType numNewPts = numGlyphs * numSourcePts;
+  newPts->SetNumberOfPoints(numNewPts);
+  void *newPtsPointer = newPts->GetVoidPointer(0);
+  const bool doublePoints = newPts->GetDataType() == VTK_DOUBLE;
+  float *newNormalsPointer = nullptr;
+  if (newNormals)
+  {
+    newNormals->SetNumberOfTuples(numNewPts);
+    newNormalsPointer = static_cast<vtkFloatArray*>(newNormals)->GetPointer(0);
+  }
+  vtkDataArray *newArrays[] = { newScalars, newVectors, newTCoords };
+  for (vtkDataArray *newArray : newArrays)
+  {
+    if (newArray)
+    {
+      newArray->SetNumberOfTuples(numNewPts);
+    }
+  }
+  if (pointIds)
+  {
+    pointIds->SetNumberOfValues(numNewPts);
+  }
+
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, pd, output->GetPointData(), 0.0, false);
+  ArrayList cellArrays;
+  if (this->FillCellData)
+  {
+    cellArrays.AddArrays(numGlyphs * numSourceCells, pd,
+                         output->GetCellData(), 0.0, false);
+  }
+
+  // The cells of each type are copied glyph after glyph, as the serial code
+  // inserts them. When the source mixes several kinds of cells, they are
+  // inserted after the glyphs in the order of the source cells instead, so
+  // that the output cell ids are those of the serial code.
+  vtkCellArray *sourceCells[4] = { source->GetVerts(), source->GetLines(),
+                                   source->GetPolys(), source->GetStrips() };
+  const vtkIdType *sourceConn[4] = { nullptr, nullptr, nullptr, nullptr };
+  vtkIdType sourceConnSize[4] = { 0, 0, 0, 0 };
+  vtkIdType *newConn[4] = { nullptr, nullptr, nullptr, nullptr };
+  int numCellKinds = 0;
+  for (int type = 0; type < 4; ++type)
+  {
+    if (sourceCells[type]->GetNumberOfCells() > 0)
+    {
+      ++numCellKinds;
+    }
+  }
+  for (int type = 0; numCellKinds == 1 && type < 4; ++type)
+  {
+    const vtkIdType numCells = sourceCells[type]->GetNumberOfCells();
+    if (numCells == 0)
+    {
+      continue;
+    }
+    sourceConnSize[type] = sourceCells[type]->GetNumberOfConnectivityEntries();
+    sourceConn[type] = sourceCells[type]->GetPointer();
+    vtkNew<vtkCellArray> cells;
+    newConn[type] = cells->WritePointer(numGlyphs * numCells,
+                                        numGlyphs * sourceConnSize[type]);
+    switch (type)
+    {
+      case 0:
+        output->SetVerts(cells);
+        break;
+      case 1:
+        output->SetLines(cells);
+        break;
+      case 2:
+        output->SetPolys(cells);
+        break;
+      default:
+        output->SetStrips(cells);
+    }
+  }
+
+  // GetPoint() is thread safe once it was called from a single thread.
+  double x[3];
+  input->GetPoint(0, x);
+
+  double den = this->Range[1] - this->Range[0];
+  if (den == 0.0)
+  {
+    den = 1.0;
+  }
+
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end)
+  {
+    GlyphMatrix trans;
+    double matrix[16], normalMatrix[16], v[3], vNew[3], point[3];
+    for (vtkIdType inPtId = begin; inPtId < end; ++inPtId)
+    {
+      const vtkIdType glyphId = glyphIds[inPtId];
+      if (glyphId < 0)
+      {
+        continue;
+      }
+      const vtkIdType ptIncr = glyphId * numSourcePts;
+      const vtkIdType cellIncr = glyphId * numSourceCells;
+      double scalex = 1.0, scaley = 1.0, scalez = 1.0, vMag = 0.0;
+
+      // Get the scalar and vector data
+      if (inSScalars)
+      {
+        const double s = inSScalars->GetComponent(inPtId, 0);
+        if (this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+            this->ScaleMode == VTK_DATA_SCALING_OFF)
+        {
+          scalex = scaley = scalez = s;
+        }
+      }
+      if (haveVectors)
+      {
+        v[0] = 0;
+        v[1] = 0;
+        v[2] = 0;
+        array3D->GetTuple(inPtId, v);
+        vMag = vtkMath::Norm(v);
+        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        {
+          scalex = v[0];
+          scaley = v[1];
+          scalez = v[2];
+        }
+        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+        {
+          scalex = scaley = scalez = vMag;
+        }
+      }
+
+      // Clamp data scale if enabled
+      if (this->Clamping)
+      {
+        scalex = (scalex < this->Range[0] ? this->Range[0] :
+                  (scalex > this->Range[1] ? this->Range[1] : scalex));
+        scalex = (scalex - this->Range[0]) / den;
+        scaley = (scaley < this->Range[0] ? this->Range[0] :
+                  (scaley > this->Range[1] ? this->Range[1] : scaley));
+        scaley = (scaley - this->Range[0]) / den;
+        scalez = (scalez < this->Range[0] ? this->Range[0] :
+                  (scalez > this->Range[1] ? this->Range[1] : scalez));
+        scalez = (scalez - this->Range[0]) / den;
+      }
+
+      // Copy the topology, offset to the points of the glyph
+      for (int type = 0; type < 4; ++type)
+      {
+        const vtkIdType *cell = sourceConn[type];
+        const vtkIdType *cellEnd = cell + sourceConnSize[type];
+        vtkIdType *newCell = newConn[type] + glyphId * sourceConnSize[type];
+        while (cell < cellEnd)
+        {
+          vtkIdType npts = *cell++;
+          *newCell++ = npts;
+          for (; npts > 0; --npts)
+          {
+            *newCell++ = *cell++ + ptIncr;
+          }
+        }
+      }
+
+      // translate Source to Input point
+      trans.Identity();
+      input->GetPoint(inPtId, point);
+      trans.Translate(point[0], point[1], point[2]);
+
+      if (haveVectors)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newVectors->SetTuple(i + ptIncr, v);
+        }
+        if (this->Orient && (vMag > 0.0))
+        {
+          // if there is no y or z component
+          if (v[1] == 0.0 && v[2] == 0.0)
+          {
+            if (v[0] < 0) //just flip x if we need to
+            {
+              trans.RotateWXYZ(180.0, 0, 1, 0);
+            }
+          }
+          else
+          {
+            vNew[0] = (v[0] + vMag) / 2.0;
+            vNew[1] = v[1] / 2.0;
+            vNew[2] = v[2] / 2.0;
+            trans.RotateWXYZ(180.0, vNew[0], vNew[1], vNew[2]);
+          }
+        }
+      }
+
+      if (newTCoords)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newTCoords->SetTuple(i + ptIncr,
+                               &sourceTCoordValues[numTCoordComps * i]);
+        }
+      }
+
+      // Copy scalar value
+      if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newScalars->SetTuple(i + ptIncr, &scalex);
+        }
+      }
+      else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newScalars->SetTuple(i + ptIncr, inPtId, inCScalars);
+        }
+      }
+      if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          newScalars->SetTuple(i + ptIncr, &vMag);
+        }
+      }
+
+      // scale data if appropriate
+      if (this->Scaling)
+      {
+        if (this->ScaleMode == VTK_DATA_SCALING_OFF)
+        {
+          scalex = scaley = scalez = this->ScaleFactor;
+        }
+        else
+        {
+          scalex *= this->ScaleFactor;
+          scaley *= this->ScaleFactor;
+          scalez *= this->ScaleFactor;
+        }
+
+        if (scalex == 0.0)
+        {
+          scalex = 1.0e-10;
+        }
+        if (scaley == 0.0)
+        {
+          scaley = 1.0e-10;
+        }
+        if (scalez == 0.0)
+        {
+          scalez = 1.0e-10;
+        }
+        trans.Scale(scalex, scaley, scalez);
+      }
+
+      // multiply points and normals by resulting matrix
+      trans.GetMatrices(matrix, normalMatrix);
+      if (doublePoints)
+      {
+        TransformGlyphPoints(matrix, sourcePoints.data(), numSourcePts,
+          static_cast<double*>(newPtsPointer) + 3 * ptIncr);
+      }
+      else
+      {
+        TransformGlyphPoints(matrix, sourcePoints.data(), numSourcePts,
+          static_cast<float*>(newPtsPointer) + 3 * ptIncr);
+      }
+      if (newNormals)
+      {
+        TransformGlyphNormals(normalMatrix, sourceNormalValues.data(),
+                              numSourcePts, newNormalsPointer + 3 * ptIncr);
+      }
+
+      // Copy point data from source
+      for (vtkIdType i = 0; i < numSourcePts; ++i)
+      {
+        pointArrays.Copy(inPtId, ptIncr + i);
+      }
+      if (this->FillCellData)
+      {
+        for (vtkIdType i = 0; i < numSourceCells; ++i)
+        {
+          cellArrays.Copy(inPtId, cellIncr + i);
+        }
+      }
+
+      if (pointIds)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
+        {
+          pointIds->SetValue(ptIncr + i, inPtId);
+        }
+      }
+    }
+  });
+
+  if (numCellKinds > 1)
+  {
+    output->Allocate(source, 3 * numGlyphs * numSourceCells,
+                     numGlyphs * numSourceCells);
+    vtkNew<vtkIdList> cellPts;
+    for (vtkIdType glyphId = 0; glyphId < numGlyphs; ++glyphId)
+    {
+      const vtkIdType ptIncr = glyphId * numSourcePts;
+      for (vtkIdType cellId = 0; cellId < numSourceCells; ++cellId)
+      {
+        source->GetCellPoints(cellId, cellPts);
+        for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+          cellPts->SetId(i, cellPts->GetId(i) + ptIncr);
+        }
+        output->InsertNextCell(source->GetCellType(cellId), cellPts);
+      }
+    }
+  }
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
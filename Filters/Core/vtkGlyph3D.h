@@ -73,6 +73,14 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * When a single glyph is used and more than one thread is available, the
+ * glyphs are generated with vtkSMPTools: the glyphed points are numbered
+ * first, which gives the size of the output and where each glyph goes, then
+ * the glyph points, normals, connectivity and attributes are written
+ * concurrently. The output is the same as the one of a serial execution,
+ * except that the output cell types are only built when requested.
+ *
  * @sa
  * vtkTensorGlyph
 */
@@ -100,6 +108,8 @@
 #define VTK_INDEXING_BY_SCALAR 1
 #define VTK_INDEXING_BY_VECTOR 2
 
+class vtkIdTypeArray;
+class vtkPoints;
 class vtkTransform;
 
 class VTKFILTERSCORE_EXPORT vtkGlyph3D : public vtkPolyDataAlgorithm
@@ -344,6 +354,19 @@ protected:
                        vtkDataArray *inVectors);
   //@}
 
+  /**
+   * Multi-threaded generation of the glyphs of a single source, called by
+   * Execute() once the output arrays are created. Return false, without
+   * touching the output, when the glyphs have to be generated serially.
+   */
+  bool GlyphInParallel(vtkDataSet *input, vtkPolyData *source,
+                       vtkDataArray *inSScalars, vtkDataArray *inVectors,
+                       vtkDataArray *inNormals, vtkDataArray *inCScalars,
+                       const unsigned char *inGhostLevels, vtkPoints *newPts,
+                       vtkDataArray *newScalars, vtkDataArray *newVectors,
+                       vtkDataArray *newNormals, vtkDataArray *newTCoords,
+                       vtkIdTypeArray *pointIds, vtkPolyData *output);
+
   vtkPolyData **Source; // Geometry to copy to each point
   vtkTypeBool Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
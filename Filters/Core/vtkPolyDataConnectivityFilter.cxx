@@ -17,6 +17,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkConnectivityLabeling.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -28,6 +29,7 @@
 #include "vtkPolyData.h"
 
 #include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
@@ -58,6 +60,8 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->ParallelLabeling = 0;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -131,11 +135,19 @@ int vtkPolyDataConnectivityFilter::RequestData(
     }
   }
 
-  // Build cell structure
+  // Build cell structure. The parallel labeling does not need the links.
   //
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  const bool parallel = this->ParallelLabeling && !this->InScalars;
+  if ( parallel )
+  {
+    this->Mesh->PrepareForConcurrentReads();
+  }
+  else
+  {
+    this->Mesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -186,7 +198,12 @@ int vtkPolyDataConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( parallel )
+  {
+    this->LabelRegionsInParallel(largestRegionId);
+    this->UpdateProgress (0.9);
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -446,6 +463,94 @@ int vtkPolyDataConnectivityFilter::RequestData(
   return 1;
 }
 
+// Label the regions with several threads, see vtkConnectivityLabeling.
+//
+void vtkPolyDataConnectivityFilter::LabelRegionsInParallel(
+  vtkIdType &largestRegionId)
+{
+  const vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+  const vtkIdType numCells = this->Mesh->GetNumberOfCells();
+  std::vector<vtkIdType> pointRegions(numPts);
+  vtkConnectivityLabeling::LabelRegions(this->Mesh, this->Visited,
+                                        pointRegions.data(),
+                                        this->RegionSizes);
+  this->UpdateProgress (0.5);
+
+  const vtkIdType numRegions = this->RegionSizes->GetNumberOfValues();
+  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+  {
+    vtkIdType maxCellsInRegion = 0;
+    for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+      if ( this->RegionSizes->GetValue(regionId) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(regionId);
+        largestRegionId = regionId;
+      }
+    }
+    this->RegionNumber = numRegions;
+  }
+  else // regions have been seeded, everything considered in same region
+  {
+    std::vector<unsigned char> seeded(numRegions, 0);
+    vtkIdType i;
+    if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
+    {
+      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
+      {
+        const vtkIdType pt = this->Seeds->GetId(i);
+        if ( pt >= 0 && pt < numPts && pointRegions[pt] >= 0 )
+        {
+          seeded[pointRegions[pt]] = 1;
+        }
+      }
+    }
+    else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
+    {
+      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
+      {
+        const vtkIdType cellId = this->Seeds->GetId(i);
+        if ( cellId >= 0 && cellId < numCells )
+        {
+          seeded[this->Visited[cellId]] = 1;
+        }
+      }
+    }
+    else
+    {//loop over points, find closest one
+      vtkPoints *inPts = this->Mesh->GetPoints();
+      double minDist2, dist2, x[3];
+      vtkIdType minId = 0;
+      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {
+        inPts->GetPoint(i,x);
+        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
+        if ( dist2 < minDist2 )
+        {
+          minId = i;
+          minDist2 = dist2;
+        }
+      }
+      if ( pointRegions[minId] >= 0 )
+      {
+        seeded[pointRegions[minId]] = 1;
+      }
+    }
+    vtkConnectivityLabeling::MergeSeededRegions(seeded.data(), numCells,
+                                                this->Visited, numPts,
+                                                pointRegions.data(),
+                                                this->RegionSizes);
+    this->RegionNumber = 0;
+  }
+
+  // Keep the points of the labeled cells, in the order of the input.
+  this->PointNumber = vtkConnectivityLabeling::MapPoints(numPts,
+    pointRegions.data(), this->PointMap,
+    vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->GetPointer(0));
+}
+
 // Mark current cell as visited and assign region number.  Note:
 // traversal occurs across shared vertices.
 //
@@ -659,4 +764,6 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
 }
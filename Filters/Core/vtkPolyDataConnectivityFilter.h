@@ -43,6 +43,12 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * When ParallelLabeling is on, the regions are labeled with several threads
+ * by merging the points of each cell into a union-find forest. The region
+ * numbers and the extracted cells are the same as with the serial
+ * traversal, but the output points are ordered by input id instead of
+ * traversal order. ScalarConnectivity always uses the serial traversal.
+ *
  * @sa
  * vtkConnectivityFilter
 */
@@ -222,6 +228,17 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the labeling of the regions with several threads (see the
+   * class documentation). Scalar connectivity is always handled serially.
+   * The default is off.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter() override;
@@ -246,6 +263,7 @@ protected:
   double ScalarRange[2];
 
   void TraverseAndMark();
+  void LabelRegionsInParallel(vtkIdType &largestRegionId);
 
   // used to support algorithm execution
   vtkDataArray *CellScalars;
@@ -266,6 +284,7 @@ protected:
 
   vtkTypeBool MarkVisitedPointIds;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelLabeling;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) = delete;
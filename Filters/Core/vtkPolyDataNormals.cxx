@@ -26,11 +26,338 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkStaticCellLinksTemplate.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+//----------------------------------------------------------------------------
+// Helper classes to support efficient computing, and threaded execution.
+// Each of them produces exactly the same result as a serial traversal of the
+// cells or points, whatever the number of threads.
+namespace {
+
+// Compute the normal of each polygon.
+struct ComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+
+  ComputePolyNormals(vtkPolyData *mesh, float *polyNormals) :
+    Mesh(mesh), PolyNormals(polyNormals)
+  {
+    this->Points = this->Mesh->GetPoints();
+  }
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    float *polyNormal = this->PolyNormals + 3*cellId;
+
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      *polyNormal++ = static_cast<float>(n[0]);
+      *polyNormal++ = static_cast<float>(n[1]);
+      *polyNormal++ = static_cast<float>(n[2]);
+    }
+  }
+};
+
+// Position of a cell in the list of cells using a point. The links of
+// vtkPolyData are built by traversing the cells in order, so these lists are
+// sorted.
+inline vtkIdType GetLocalCellIndex(const vtkIdType *cells,
+                                   unsigned short ncells, vtkIdType cellId)
+{
+  return std::lower_bound(cells, cells + ncells, cellId) - cells;
+}
+
+// Split the mesh at each point, part one: around each point, label the cells
+// of each region bounded by feature edges, boundaries or non-manifold edges.
+// The labels are stored for each (point, cell) pair, in the order of the
+// cell links. Regions are labeled from 0; the points with N regions need N-1
+// duplicates.
+struct MarkRegions
+{
+  vtkPolyData *Mesh;
+  const float *PolyNormals;
+  double CosAngle;
+  const vtkIdType *Offsets;
+  int *Regions;
+  vtkIdType *NumDuplicates;
+
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  MarkRegions(vtkPolyData *mesh, const float *polyNormals, double cosAngle,
+              const vtkIdType *offsets, int *regions,
+              vtkIdType *numDuplicates) :
+    Mesh(mesh), PolyNormals(polyNormals), CosAngle(cosAngle),
+    Offsets(offsets), Regions(regions), NumDuplicates(numDuplicates)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  // Walk around the point ptId from one cell to its edge neighbor, starting
+  // from the edge (ptId, nei) of the cell cellId, while the neighbors are not
+  // separated by a feature edge.
+  void GrowRegion(vtkIdType ptId, const vtkIdType *cells, unsigned short ncells,
+                  int *visited, int region, vtkIdType cellId, vtkIdType nei,
+                  vtkIdList *cellIds)
+  {
+    vtkIdType numPts, *pts, spot, neiCellId, neiIdx;
+    while ( cellId >= 0 ) //while we can grow this region
+    {
+      this->Mesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+      if ( cellIds->GetNumberOfIds() == 1 &&
+           (neiIdx=GetLocalCellIndex(cells,ncells,
+             (neiCellId=cellIds->GetId(0)))) < ncells &&
+           visited[neiIdx] < 0 )
+      {
+        const float *thisNormal = this->PolyNormals + 3*cellId;
+        const float *neiNormal = this->PolyNormals + 3*neiCellId;
+        const double dot =
+          static_cast<double>(thisNormal[0]) * neiNormal[0] +
+          static_cast<double>(thisNormal[1]) * neiNormal[1] +
+          static_cast<double>(thisNormal[2]) * neiNormal[2];
+
+        if ( dot > this->CosAngle )
+        {
+          //visit and arrange to visit next edge neighbor
+          visited[neiIdx] = region;
+          cellId = neiCellId;
+          this->Mesh->GetCellPoints(cellId,numPts,pts);
+
+          for (spot=0; spot < numPts; spot++)
+          {
+            if ( pts[spot] == ptId )
+            {
+              break;
+            }
+          }
+
+          if (spot == 0)
+          {
+            nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+          }
+          else if (spot == (numPts-1))
+          {
+            nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+          }
+          else
+          {
+            nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+          }
+        }//if not separated by edge angle
+        else
+        {
+          cellId = -1; //separated by edge angle
+        }
+      }//if can move to edge neighbor
+      else
+      {
+        cellId = -1;//separated by previous visit, boundary, or non-manifold
+      }
+    }//while visit wave is propagating
+  }
+
+  // Start moving around the "cycle" of points using the point. Label each
+  // subregion of cells connected to this point that are connected (and not
+  // separated by a feature edge) with a given region number.
+  int MarkPoint(vtkIdType ptId, vtkIdList *cellIds)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    this->Mesh->GetPointCells(ptId,ncells,cells);
+    int *visited = this->Regions + this->Offsets[ptId];
+    if ( ncells <= 1 )
+    {
+      std::fill_n(visited, ncells, 0);
+      return 1; //point does not need to be further disconnected
+    }
+
+    // Start by initializing the cells as unvisited
+    std::fill_n(visited, ncells, -1);
+
+    vtkIdType numPts, *pts, spot, neiPt[2];
+    int numRegions = 0;
+    for (unsigned short j=0; j<ncells; j++) //for all cells connected to point
+    {
+      // A degenerate cell using the point several times is listed several
+      // times; only its first entry is labeled.
+      const vtkIdType cellIdx = GetLocalCellIndex(cells,ncells,cells[j]);
+      if ( visited[cellIdx] < 0 ) //for all unvisited cells
+      {
+        visited[cellIdx] = numRegions;
+        //okay, mark all the cells connected to this seed cell and using ptId
+        this->Mesh->GetCellPoints(cells[j],numPts,pts);
+
+        //find the two edges
+        for (spot=0; spot < numPts; spot++)
+        {
+          if ( pts[spot] == ptId )
+          {
+            break;
+          }
+        }
+
+        if ( spot == 0 )
+        {
+          neiPt[0] = pts[spot+1];
+          neiPt[1] = pts[numPts-1];
+        }
+        else if ( spot == (numPts-1) )
+        {
+          neiPt[0] = pts[spot-1];
+          neiPt[1] = pts[0];
+        }
+        else
+        {
+          neiPt[0] = pts[spot+1];
+          neiPt[1] = pts[spot-1];
+        }
+
+        for (int i=0; i<2; i++) //for each of the two edges of the seed cell
+        {
+          this->GrowRegion(ptId, cells, ncells, visited, numRegions, cells[j],
+                           neiPt[i], cellIds);
+        }
+        numRegions++;
+      }//if cell is unvisited
+    }//for all cells connected to point ptId
+
+    return numRegions;
+  }
+
+  void operator() (vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->NumDuplicates[ptId] = this->MarkPoint(ptId, cellIds) - 1;
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Split the mesh at each point, part two: in the cells that are not in the
+// first region around one of their points, replace the point with the
+// duplicate created for the region. Unless the storage of the cells is
+// shareable, pts is a copy that is stored back into the cells.
+struct ReplaceSplitPoints
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *Offsets;
+  const int *Regions;
+  const vtkIdType *FirstDuplicates;
+  bool StorageShareable;
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType numPts, *pts, *cells;
+    unsigned short ncells;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->NewMesh->GetCellPoints(cellId,numPts,pts);
+      bool replaced = false;
+      for (vtkIdType i=0; i < numPts; i++)
+      {
+        const vtkIdType ptId = pts[i];
+        this->OldMesh->GetPointCells(ptId,ncells,cells);
+        const vtkIdType cellIdx = GetLocalCellIndex(cells,ncells,cellId);
+        const int region = cellIdx < ncells ?
+          this->Regions[this->Offsets[ptId] + cellIdx] : 0;
+        if ( region > 0 )
+        {
+          pts[i] = this->FirstDuplicates[ptId] + region - 1; // direct write!
+          replaced = true;
+        }
+      }
+      if ( replaced && !this->StorageShareable )
+      {
+        this->NewMesh->ReplaceCell(cellId,static_cast<int>(numPts),pts);
+      }
+    }
+  }
+};
+
+// Map each output point to the input point it comes from.
+struct MapSplitPoints
+{
+  const vtkIdType *NumDuplicates;
+  const vtkIdType *FirstDuplicates;
+  vtkIdType *Map;
+
+  void operator() (vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Map[ptId] = ptId;
+      std::fill_n(this->Map + this->FirstDuplicates[ptId],
+                  this->NumDuplicates[ptId], ptId);
+    }
+  }
+};
+
+// Average the normals of the polygons using each point. The cells are
+// gathered in increasing id order so that the sums are computed in the same
+// order as a serial traversal of the polygons.
+struct AveragePointNormals
+{
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+  const float *PolyNormals;
+  float *Normals;
+  double FlipDirection;
+
+  void operator() (vtkIdType ptId, vtkIdType endPtId)
+  {
+    float *n = this->Normals + 3*ptId;
+    for ( ; ptId < endPtId; ++ptId, n += 3 )
+    {
+      const vtkIdType ncells = this->Links->GetNumberOfCells(ptId);
+      const vtkIdType *cells = this->Links->GetCells(ptId);
+      n[0] = n[1] = n[2] = 0.0f;
+      // The links list the cells in increasing id order.
+      for (vtkIdType i = 0; i < ncells; ++i)
+      {
+        const float *polyNormal = this->PolyNormals + 3*cells[i];
+        n[0] += polyNormal[0];
+        n[1] += polyNormal[1];
+        n[2] += polyNormal[2];
+      }
+
+      const double length = sqrt(n[0] * n[0] +
+                                 n[1] * n[1] +
+                                 n[2] * n[2]) * this->FlipDirection;
+      if (length != 0.0)
+      {
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+      }
+    }
+  }
+};
+
+} //anonymous namespace
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -49,7 +376,6 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->Wave = nullptr;
   this->Wave2 = nullptr;
   this->CellIds = nullptr;
-  this->Map = nullptr;
   this->OldMesh = nullptr;
   this->NewMesh = nullptr;
   this->Visited = nullptr;
@@ -190,7 +516,7 @@ int vtkPolyDataNormals::RequestData(
 
   // The visited array keeps track of which polygons have been visited.
   //
-  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+  if ( this->Consistency || this->AutoOrientNormals )
   {
     this->Visited = new int[numPolys];
     memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys*sizeof(int));
@@ -342,23 +668,24 @@ int vtkPolyDataNormals::RequestData(
   //
   this->PolyNormals = vtkFloatArray::New();
   this->PolyNormals->SetNumberOfComponents(3);
-  this->PolyNormals->Allocate(3*numPolys);
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
+  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  // The polygons are processed by several threads in chunks of at least
+  // 1000 cells, with progress and abort checks between the chunks.
+  ComputePolyNormals computePolyNormals(this->NewMesh, fPolyNormals);
+  const vtkIdType chunkSize = std::max<vtkIdType>(1000, numPolys / 20);
+  for (cellId=0; cellId < numPolys; cellId += chunkSize)
   {
-    if ((cellId % 1000) == 0)
+    this->UpdateProgress(0.333 + 0.333 * cellId / numPolys);
+    if (this->GetAbortExecute())
     {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      std::fill(fPolyNormals + 3 * cellId, fPolyNormals + 3 * numPolys, 0.0f);
+      break;
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
+    vtkSMPTools::For(cellId, std::min(cellId + chunkSize, numPolys),
+                     computePolyNormals);
   }
 
   // Split mesh if sharp features
@@ -369,22 +696,51 @@ int vtkPolyDataNormals::RequestData(
     // connectivity.
     //
       this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
-    //  Splitting will create new points.  We have to create index array
-    // to map new points into old points.
+    //  Splitting will create new points. The points are split independently
+    // of each other, and the duplicates of a point are numbered after those
+    // of the points with a lower id.
     //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
+    std::vector<vtkIdType> offsets(numPts + 1);
+    for (ptId=0; ptId < numPts; ptId++)
     {
-      this->Map->SetId(i,i);
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      offsets[ptId] = ncells;
     }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    offsets[numPts] = 0;
+    vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(),
+                               offsets.begin(), vtkIdType(0));
+
+    std::vector<int> regions(offsets[numPts]);
+    std::vector<vtkIdType> numDuplicates(numPts + 1, 0);
+    MarkRegions markRegions(this->OldMesh, fPolyNormals, this->CosAngle,
+                            offsets.data(), regions.data(),
+                            numDuplicates.data());
+    vtkSMPTools::For(0, numPts, markRegions);
+
+    std::vector<vtkIdType> firstDuplicates(numPts + 1);
+    vtkSMPTools::ExclusiveScan(numDuplicates.begin(), numDuplicates.end(),
+                               firstDuplicates.begin(), numPts);
+    numNewPts = firstDuplicates[numPts];
+
+    ReplaceSplitPoints replace = { this->OldMesh, this->NewMesh,
+      offsets.data(), regions.data(), firstDuplicates.data(),
+      newPolys->IsStorageShareable() };
+    if ( replace.StorageShareable )
     {
-      this->MarkAndSplit(ptId);
-    }//for all input points
+      vtkSMPTools::For(0, numPolys, replace);
+    }
+    else
+    {
+      // The cells are changed through ReplaceCell(), one at a time.
+      replace(0, numPolys);
+    }
 
-    numNewPts = this->Map->GetNumberOfIds();
+    std::vector<vtkIdType> map(numNewPts);
+    MapSplitPoints mapPoints = { numDuplicates.data(), firstDuplicates.data(),
+      map.data() };
+    vtkSMPTools::For(0, numPts, mapPoints);
 
     vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
 
@@ -420,11 +776,10 @@ int vtkPolyDataNormals::RequestData(
     newPts->SetNumberOfPoints(numNewPts);
     for (ptId=0; ptId < numNewPts; ptId++)
     {
-      oldId = this->Map->GetId(ptId);
+      oldId = map[ptId];
       newPts->SetPoint(ptId,inPts->GetPoint(oldId));
       outPD->CopyData(pd,oldId,ptId);
     }
-    this->Map->Delete();
   } //splitting
 
   else //no splitting, so no new points
@@ -434,9 +789,10 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
   }
 
-  if ( this->Consistency || this->Splitting )
+  if ( this->Visited )
   {
     delete [] this->Visited;
+    this->Visited = nullptr;
     this->CellIds->Delete();
   }
 
@@ -455,36 +811,22 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
   float *fNormals = newNormals->WritePointer(0, 3 * numNewPts);
-  std::fill_n(fNormals, 3 * numNewPts, 0);
-
-  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
   if (this->ComputePointNormals)
   {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
-         ++cellId)
-    {
-      for (vtkIdType i = 0; i < npts; ++i)
-      {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
-    }
-
-    for (vtkIdType i = 0; i < numNewPts; ++i)
-    {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-      {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-      }
-    }
+    vtkNew<vtkPolyData> mesh;
+    mesh->SetPoints(this->Splitting ? newPts : inPts);
+    mesh->SetPolys(newPolys);
+    vtkStaticCellLinksTemplate<vtkIdType> links;
+    links.BuildLinks(mesh);
+
+    AveragePointNormals average = { &links, fPolyNormals, fNormals,
+      flipDirection };
+    vtkSMPTools::For(0, numNewPts, average);
+  }
+  else
+  {
+    std::fill_n(fNormals, 3 * numNewPts, 0);
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -538,6 +880,7 @@ void vtkPolyDataNormals::TraverseAndOrder ()
   vtkIdType *pts, *neiPts, npts, numNeiPts;
   vtkIdType neighbor;
   vtkIdList *tmpWave;
+  vtkNew<vtkIdList> cellPts;
 
   // propagate wave until nothing left in wave
   while ( (numIds=this->Wave->GetNumberOfIds()) > 0 )
@@ -546,7 +889,11 @@ void vtkPolyDataNormals::TraverseAndOrder ()
     {
       cellId = this->Wave->GetId(i);
 
-      this->NewMesh->GetCellPoints(cellId, npts, pts);
+      // With the split cell storage, the points of a cell are only valid
+      // until the points of its neighbors are read: keep a copy of them.
+      this->NewMesh->GetCellPoints(cellId, cellPts);
+      npts = cellPts->GetNumberOfIds();
+      pts = cellPts->GetPointer(0);
 
       for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0)) //for each edge neighbor
       {
@@ -595,165 +942,6 @@ void vtkPolyDataNormals::TraverseAndOrder ()
   } //while wave still propagating
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-  {
-    return; //point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-  {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-      {
-        if ( pts[spot] == ptId )
-        {
-          break;
-        }
-      }
-
-      if ( spot == 0 )
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-      }
-      else if ( spot == (numPts-1) )
-      {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-      }
-      else
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-      }
-
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
-        {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
-            {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
-              {
-                if ( pts[spot] == ptId )
-                {
-                  break;
-                }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-              }
-              else if (spot == (numPts-1))
-              {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-              }
-
-            }//if not separated by edge angle
-            else
-            {
-              cellId = -1; //separated by edge angle
-            }
-          }//if can move to edge neighbor
-          else
-          {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-          }
-        }//while visit wave is propagating
-      }//for each of the two edges of the starting cell
-      numRegions++;
-    }//if cell is unvisited
-  }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-  {
-    return; //a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
-
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-      {
-        if ( pts[i] == ptId )
-        {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-        }
-      }//replace ptId with split point
-    }//if not in first regions and requiring splitting
-  }//for all cells connected to ptId
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
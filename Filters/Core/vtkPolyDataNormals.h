@@ -39,6 +39,11 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * The polygon normals, the splitting and the averaging of the point normals
+ * are multi-threaded with vtkSMPTools. The output does not depend on the
+ * number of threads; it is identical to a serial execution. The traversal
+ * which makes the orientation of the polygons consistent is serial.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
@@ -195,7 +200,6 @@ private:
   vtkIdList *Wave;
   vtkIdList *Wave2;
   vtkIdList *CellIds;
-  vtkIdList *Map;
   vtkPolyData *OldMesh;
   vtkPolyData *NewMesh;
   int *Visited;
@@ -206,11 +210,6 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) = delete;
   void operator=(const vtkPolyDataNormals&) = delete;
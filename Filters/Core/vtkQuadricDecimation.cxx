@@ -53,10 +53,290 @@
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+//----------------------------------------------------------------------------
+// Edge costs and target points of the parallel decimation, which replace
+// the priority queue and the TargetPoints array. Each round computes the
+// costs of the modified edges, finds the cheapest edge around the modified
+// points, and collapses the edges cheaper than all the edges around their
+// end points. Ties on costs are broken by edge id so that the collapses do
+// not depend on the number of threads.
+struct vtkQuadricDecimation::ParallelEdgeData
+{
+  enum EdgeStates
+  {
+    REMOVED = 0,
+    CURRENT = 1,
+    MODIFIED = 2
+  };
+
+  enum Collapses
+  {
+    NO_COLLAPSE = 0,
+    GOOD_PLACEMENT = 1,
+    POOR_PLACEMENT = 2
+  };
+
+  std::vector<double> Costs;
+  std::vector<unsigned char> States;
+  std::vector<double> TargetPoints;
+  int TupleSize;
+  std::vector<vtkIdType> ModifiedEdges;
+
+  // Cheapest edge around each point, -1 if none can be collapsed
+  std::vector<vtkIdType> CheapestEdges;
+  std::vector<unsigned char> PointStates;
+  std::vector<vtkIdType> ModifiedPoints;
+
+  ParallelEdgeData(vtkIdType numEdges, int tupleSize, vtkIdType numPts) :
+    Costs(numEdges, VTK_DOUBLE_MAX), States(numEdges, MODIFIED),
+    TargetPoints(numEdges * tupleSize), TupleSize(tupleSize),
+    ModifiedEdges(numEdges), CheapestEdges(numPts, -1),
+    PointStates(numPts, MODIFIED), ModifiedPoints(numPts)
+  {
+    for (vtkIdType edgeId = 0; edgeId < numEdges; edgeId++)
+    {
+      this->ModifiedEdges[edgeId] = edgeId;
+    }
+    for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+      this->ModifiedPoints[ptId] = ptId;
+    }
+  }
+
+  void Modify(vtkIdType edgeId)
+  {
+    if (edgeId >= static_cast<vtkIdType>(this->States.size()))
+    {
+      this->Costs.resize(edgeId + 1, VTK_DOUBLE_MAX);
+      this->States.resize(edgeId + 1, REMOVED);
+      this->TargetPoints.resize((edgeId + 1) * this->TupleSize);
+    }
+    if (this->States[edgeId] != MODIFIED)
+    {
+      this->States[edgeId] = MODIFIED;
+      this->ModifiedEdges.push_back(edgeId);
+    }
+  }
+
+  void ModifyPoint(vtkIdType ptId)
+  {
+    if (this->PointStates[ptId] != MODIFIED)
+    {
+      this->PointStates[ptId] = MODIFIED;
+      this->ModifiedPoints.push_back(ptId);
+    }
+  }
+
+  // The cheapest edges of a point and of its neighbors change when the
+  // edges around the point are collapsed, removed or get a new cost.
+  void ModifyNeighborhood(vtkPolyData *mesh, vtkIdType ptId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    this->ModifyPoint(ptId);
+    mesh->GetPointCells(ptId, ncells, cells);
+    for (unsigned short i = 0; i < ncells; i++)
+    {
+      mesh->GetCellPoints(cells[i], npts, pts);
+      for (vtkIdType j = 0; j < npts; j++)
+      {
+        this->ModifyPoint(pts[j]);
+      }
+    }
+  }
+
+  double *GetTargetPoint(vtkIdType edgeId)
+  {
+    return this->TargetPoints.data() + edgeId * this->TupleSize;
+  }
+
+  bool IsCandidate(vtkIdType edgeId) const
+  {
+    return this->States[edgeId] != REMOVED &&
+      this->Costs[edgeId] < VTK_DOUBLE_MAX;
+  }
+
+  bool IsCheaper(vtkIdType edgeId, vtkIdType otherId) const
+  {
+    return otherId < 0 || this->Costs[edgeId] < this->Costs[otherId] ||
+      (this->Costs[edgeId] == this->Costs[otherId] && edgeId < otherId);
+  }
+
+  // Compute the cost and target point of the modified edges, with thread
+  // local copies of the temporary matrices of the cost computation.
+  struct ComputeCosts
+  {
+    vtkQuadricDecimation *Self;
+    ParallelEdgeData *Edges;
+    int Size;
+    vtkSMPThreadLocal<std::vector<double> > Quad;
+    vtkSMPThreadLocal<std::vector<double> > B;
+    vtkSMPThreadLocal<std::vector<double> > Data;
+    vtkSMPThreadLocal<std::vector<double*> > A;
+
+    ComputeCosts(vtkQuadricDecimation *self, ParallelEdgeData *edges) :
+      Self(self), Edges(edges), Size(edges->TupleSize)
+    {
+    }
+
+    void Initialize()
+    {
+      this->Quad.Local().resize(11 + 4 * this->Self->NumberOfComponents +
+                                this->Self->VolumePreservation);
+      this->B.Local().resize(this->Size);
+      std::vector<double>& data = this->Data.Local();
+      std::vector<double*>& a = this->A.Local();
+      data.resize(this->Size * this->Size);
+      a.resize(this->Size);
+      for (int i = 0; i < this->Size; i++)
+      {
+        a[i] = data.data() + i * this->Size;
+      }
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double *quad = this->Quad.Local().data();
+      double *b = this->B.Local().data();
+      double **a = this->A.Local().data();
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        const vtkIdType edgeId = this->Edges->ModifiedEdges[i];
+        if (this->Edges->States[edgeId] != MODIFIED)
+        {
+          continue;
+        }
+        double *x = this->Edges->GetTargetPoint(edgeId);
+        if (this->Self->AttributeErrorMetric)
+        {
+          this->Edges->Costs[edgeId] =
+            this->Self->ComputeCost2(edgeId, x, quad, a, b);
+        }
+        else
+        {
+          this->Edges->Costs[edgeId] =
+            this->Self->ComputeCost(edgeId, x, quad);
+        }
+        this->Edges->States[edgeId] = CURRENT;
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+  // Find the cheapest edge around the modified points.
+  struct FindCheapestEdges
+  {
+    vtkQuadricDecimation *Self;
+    ParallelEdgeData *Edges;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      unsigned short ncells;
+      vtkIdType *cells, npts, *pts;
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        const vtkIdType ptId = this->Edges->ModifiedPoints[i];
+        vtkIdType cheapest = -1;
+        this->Self->Mesh->GetPointCells(ptId, ncells, cells);
+        for (unsigned short k = 0; k < ncells; k++)
+        {
+          this->Self->Mesh->GetCellPoints(cells[k], npts, pts);
+          for (vtkIdType j = 0; j < npts; j++)
+          {
+            vtkIdType edgeId;
+            if (pts[j] != ptId &&
+                (edgeId = this->Self->Edges->IsEdge(ptId, pts[j])) >= 0 &&
+                this->Edges->IsCandidate(edgeId) &&
+                this->Edges->IsCheaper(edgeId, cheapest))
+            {
+              cheapest = edgeId;
+            }
+          }
+        }
+        this->Edges->CheapestEdges[ptId] = cheapest;
+        this->Edges->PointStates[ptId] = CURRENT;
+      }
+    }
+  };
+
+  // Select the edges which are the cheapest around both their end points
+  // and cheaper than the cheapest edges of all the neighbor points. Two
+  // selected edges have no adjacent end points, so their collapses modify
+  // distinct triangles and edges, and can be checked independently. The
+  // collapse of an edge is stored at its first end point.
+  struct SelectCollapses
+  {
+    vtkQuadricDecimation *Self;
+    ParallelEdgeData *Edges;
+    unsigned char *Collapses;
+
+    bool IsCheaperAround(vtkIdType edgeId, vtkIdType ptId)
+    {
+      unsigned short ncells;
+      vtkIdType *cells, npts, *pts;
+      this->Self->Mesh->GetPointCells(ptId, ncells, cells);
+      for (unsigned short i = 0; i < ncells; i++)
+      {
+        this->Self->Mesh->GetCellPoints(cells[i], npts, pts);
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          const vtkIdType cheapest = this->Edges->CheapestEdges[pts[j]];
+          if (cheapest != edgeId &&
+              !this->Edges->IsCheaper(edgeId, cheapest))
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+        this->Collapses[ptId] = NO_COLLAPSE;
+        const vtkIdType edgeId = this->Edges->CheapestEdges[ptId];
+        if (edgeId < 0 || this->Self->EndPoint1List->GetId(edgeId) != ptId)
+        {
+          continue;
+        }
+        const vtkIdType pt1Id = this->Self->EndPoint2List->GetId(edgeId);
+        if (this->Edges->CheapestEdges[pt1Id] == edgeId &&
+            this->IsCheaperAround(edgeId, ptId) &&
+            this->IsCheaperAround(edgeId, pt1Id))
+        {
+          this->Collapses[ptId] = this->Self->IsGoodPlacement(
+            ptId, pt1Id, this->Edges->GetTargetPoint(edgeId)) ?
+            GOOD_PLACEMENT : POOR_PLACEMENT;
+        }
+      }
+    }
+  };
+
+  // Order the selected collapses by increasing cost.
+  struct CompareCosts
+  {
+    const ParallelEdgeData *Edges;
+
+    bool operator()(vtkIdType edgeId, vtkIdType otherId) const
+    {
+      return this->Edges->IsCheaper(edgeId, otherId);
+    }
+  };
+};
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -68,6 +348,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->ErrorQuadrics = nullptr;
   this->VolumeConstraints = nullptr;
   this->TargetPoints = vtkDoubleArray::New();
+  this->ParallelEdges = nullptr;
 
   this->TargetReduction = 0.9;
   this->NumberOfEdgeCollapses = 0;
@@ -75,6 +356,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
 
   this->AttributeErrorMetric = 0;
   this->VolumePreservation = 0;
+  this->ParallelDecimation = 0;
   this->ScalarsAttribute = 1;
   this->VectorsAttribute = 1;
   this->NormalsAttribute = 1;
@@ -227,6 +509,11 @@ int vtkQuadricDecimation::RequestData(
   this->Mesh->SetPoints(points);
   points->Delete();
   polys->DeepCopy(input->GetPolys());
+  if (this->ParallelDecimation)
+  {
+    // the cells are read by several threads
+    polys->SetStorageModeToLegacy();
+  }
   this->Mesh->SetPolys(polys);
   polys->Delete();
   if (this->AttributeErrorMetric)
@@ -253,7 +540,10 @@ int vtkQuadricDecimation::RequestData(
 
   vtkDebugMacro(<<"Computing Edges");
   this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
-  this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
+  if (!this->ParallelDecimation)
+  {
+    this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
+  }
   for (i = 0; i <  this->Mesh->GetNumberOfCells(); i++)
   {
     this->Mesh->GetCellPoints(i, npts, pts);
@@ -299,75 +589,84 @@ int vtkQuadricDecimation::RequestData(
   this->AddBoundaryConstraints();
   this->UpdateProgress(0.15);
 
-  vtkDebugMacro(<<"Computing Costs");
-  // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
+  if (this->ParallelDecimation)
   {
-    if (this->AttributeErrorMetric)
-    {
-      cost = this->ComputeCost2(i, x);
-    }
-    else
-    {
-      cost = this->ComputeCost(i, x);
-    }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
+    numDeletedTris = this->DecimateInParallel(numTris);
+    vtkDebugMacro(<<"Number Of Edge Collapses: "
+                  << this->NumberOfEdgeCollapses);
   }
-  this->UpdateProgress(0.20);
-
-  // Okay collapse edges until desired reduction is reached
-  this->ActualReduction = 0.0;
-  this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0,cost);
-
-  int abort = 0;
-  while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
-         this->ActualReduction < this->TargetReduction )
+  else
   {
-    if ( ! (this->NumberOfEdgeCollapses % 10000) )
+    vtkDebugMacro(<<"Computing Costs");
+    // Compute the cost of and target point for collapsing each edge.
+    for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
     {
-      vtkDebugMacro(<<"Collapsing edge#" << this->NumberOfEdgeCollapses);
-      this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
-      abort = this->GetAbortExecute();
+      if (this->AttributeErrorMetric)
+      {
+        cost = this->ComputeCost2(i, x);
+      }
+      else
+      {
+        cost = this->ComputeCost(i, x);
+      }
+      this->EdgeCosts->Insert(cost, i);
+      this->TargetPoints->InsertTuple(i, x);
     }
+    this->UpdateProgress(0.20);
 
-    endPtIds[0] = this->EndPoint1List->GetId(edgeId);
-    endPtIds[1] = this->EndPoint2List->GetId(edgeId);
-    this->TargetPoints->GetTuple(edgeId, x);
+    // Okay collapse edges until desired reduction is reached
+    this->ActualReduction = 0.0;
+    this->NumberOfEdgeCollapses = 0;
+    edgeId = this->EdgeCosts->Pop(0,cost);
 
-    // check for a poorly placed point
-    if ( !this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+    int abort = 0;
+    while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
+           this->ActualReduction < this->TargetReduction )
     {
-      vtkDebugMacro(<<"Poor placement detected " << edgeId << " " <<  cost);
-      // return the point to the queue but with the max cost so that
-      // when it is recomputed it will be reconsidered
-      this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+      if ( ! (this->NumberOfEdgeCollapses % 10000) )
+      {
+        vtkDebugMacro(<<"Collapsing edge#" << this->NumberOfEdgeCollapses);
+        this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
+        abort = this->GetAbortExecute();
+      }
 
-      edgeId = this->EdgeCosts->Pop(0, cost);
-      continue;
-    }
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      this->TargetPoints->GetTuple(edgeId, x);
 
-    this->NumberOfEdgeCollapses++;
+      // check for a poorly placed point
+      if ( !this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+      {
+        vtkDebugMacro(<<"Poor placement detected " << edgeId << " " <<  cost);
+        // return the point to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
 
-    // Set the new coordinates of point0.
-    this->SetPointAttributeArray(endPtIds[0], x);
-    vtkDebugMacro(<<"Cost: " << cost << " Edge: "
-                  << endPtIds[0] << " " << endPtIds[1]);
+        edgeId = this->EdgeCosts->Pop(0, cost);
+        continue;
+      }
 
-    // Merge the quadrics of the two points.
-    this->AddQuadric(endPtIds[1], endPtIds[0]);
+      this->NumberOfEdgeCollapses++;
 
-    this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+      // Set the new coordinates of point0.
+      this->SetPointAttributeArray(endPtIds[0], x);
+      vtkDebugMacro(<<"Cost: " << cost << " Edge: "
+                    << endPtIds[0] << " " << endPtIds[1]);
 
-    // Update the output triangles.
-    numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
-    this->ActualReduction = (double) numDeletedTris / numTris;
-    edgeId = this->EdgeCosts->Pop(0, cost);
-  }
+      // Merge the quadrics of the two points.
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
 
-  vtkDebugMacro(<<"Number Of Edge Collapses: "
-                << this->NumberOfEdgeCollapses << " Cost: " << cost);
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+
+      // Update the output triangles.
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+      this->ActualReduction = (double) numDeletedTris / numTris;
+      edgeId = this->EdgeCosts->Pop(0, cost);
+    }
+
+    vtkDebugMacro(<<"Number Of Edge Collapses: "
+                  << this->NumberOfEdgeCollapses << " Cost: " << cost);
+  }
 
   // clean up working data
   for (i = 0; i < numPts; i++)
@@ -420,6 +719,103 @@ int vtkQuadricDecimation::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricDecimation::DecimateInParallel(vtkIdType numTris)
+{
+  const vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+  vtkIdType numDeletedTris = 0;
+  vtkIdType edgeId, endPtIds[2];
+
+  // All the edges and points are modified before the first round.
+  ParallelEdgeData edges(this->Edges->GetNumberOfEdges(),
+                         3 + this->NumberOfComponents +
+                         this->VolumePreservation, numPts);
+  this->ParallelEdges = &edges;
+
+  std::vector<unsigned char> collapses(numPts);
+  std::vector<vtkIdType> selectedEdges;
+
+  this->ActualReduction = 0.0;
+  this->NumberOfEdgeCollapses = 0;
+
+  int abort = 0;
+  while (!abort && this->ActualReduction < this->TargetReduction)
+  {
+    // an edge removed and added again in the previous round is listed twice
+    vtkSMPTools::Sort(edges.ModifiedEdges.begin(), edges.ModifiedEdges.end());
+    edges.ModifiedEdges.erase(std::unique(edges.ModifiedEdges.begin(),
+                                          edges.ModifiedEdges.end()),
+                              edges.ModifiedEdges.end());
+    ParallelEdgeData::ComputeCosts computeCosts(this, &edges);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(edges.ModifiedEdges.size()),
+                     computeCosts);
+    edges.ModifiedEdges.clear();
+
+    ParallelEdgeData::FindCheapestEdges findCheapestEdges = { this, &edges };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(edges.ModifiedPoints.size()),
+                     findCheapestEdges);
+    edges.ModifiedPoints.clear();
+
+    ParallelEdgeData::SelectCollapses selectCollapses =
+      { this, &edges, collapses.data() };
+    vtkSMPTools::For(0, numPts, selectCollapses);
+
+    selectedEdges.clear();
+    for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+      if (collapses[ptId] != ParallelEdgeData::NO_COLLAPSE)
+      {
+        selectedEdges.push_back(edges.CheapestEdges[ptId]);
+      }
+    }
+    if (selectedEdges.empty())
+    {
+      break;
+    }
+    ParallelEdgeData::CompareCosts compareCosts = { &edges };
+    vtkSMPTools::Sort(selectedEdges.begin(), selectedEdges.end(),
+                      compareCosts);
+
+    // The selected collapses are independent, so they are performed as in
+    // the serial decimation, cheapest first, until the desired reduction is
+    // reached. The costs of the modified edges are updated in the next round.
+    for (vtkIdType i = 0; i < static_cast<vtkIdType>(selectedEdges.size()) &&
+           this->ActualReduction < this->TargetReduction; i++)
+    {
+      edgeId = selectedEdges[i];
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      if (collapses[endPtIds[0]] == ParallelEdgeData::POOR_PLACEMENT)
+      {
+        // it is reconsidered when its cost is recomputed
+        edges.Costs[edgeId] = VTK_DOUBLE_MAX;
+        edges.ModifyPoint(endPtIds[0]);
+        edges.ModifyPoint(endPtIds[1]);
+        continue;
+      }
+
+      edges.States[edgeId] = ParallelEdgeData::REMOVED;
+      edges.ModifyNeighborhood(this->Mesh, endPtIds[0]);
+      edges.ModifyNeighborhood(this->Mesh, endPtIds[1]);
+
+      this->NumberOfEdgeCollapses++;
+      this->SetPointAttributeArray(endPtIds[0], edges.GetTargetPoint(edgeId));
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+      this->ActualReduction = (double) numDeletedTris / numTris;
+    }
+
+    vtkDebugMacro(<<"Collapsed " << this->NumberOfEdgeCollapses
+                  << " edges in rounds");
+    this->UpdateProgress(0.15 + 0.85*this->NumberOfEdgeCollapses/numPts);
+    abort = this->GetAbortExecute();
+  }
+
+  this->ParallelEdges = nullptr;
+  return numDeletedTris;
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
 {
@@ -742,7 +1138,6 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 {
   vtkIdList *changedEdges = vtkIdList::New();
   vtkIdType i, edgeId, edge[2];
-  double cost;
 
   // Find all edges with exactly either of these 2 endpoints.
   this->FindAffectedEdges(pt0Id, pt1Id, changedEdges);
@@ -758,7 +1153,15 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 
     // Remove all affected edges from the priority queue.
     // This does not include collapsed edge.
-    this->EdgeCosts->DeleteId(changedEdges->GetId(i));
+    if (this->ParallelEdges)
+    {
+      this->ParallelEdges->States[changedEdges->GetId(i)] =
+        ParallelEdgeData::REMOVED;
+    }
+    else
+    {
+      this->EdgeCosts->DeleteId(changedEdges->GetId(i));
+    }
 
     // Determine the new set of edges
     if (edge[0] == pt1Id)
@@ -770,16 +1173,7 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->EndPoint1List->InsertId(edgeId, edge[1]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
         // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
-        {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-        }
-        else
-        {
-          cost = this->ComputeCost(edgeId, this->TempX);
-        }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
+        this->UpdateEdgeCost(edgeId);
       }
     }
     else if (edge[1] == pt1Id)
@@ -791,38 +1185,50 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->EndPoint1List->InsertId(edgeId, edge[0]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
         // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
-        {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-        }
-        else
-        {
-          cost = this->ComputeCost(edgeId, this->TempX);
-        }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
+        this->UpdateEdgeCost(edgeId);
       }
     }
     else
     { // This edge already has one point as the merged point.
-      if (this->AttributeErrorMetric)
-      {
-        cost = this->ComputeCost2(changedEdges->GetId(i), this->TempX);
-      }
-      else
-      {
-        cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
-      }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
-      this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
+      this->UpdateEdgeCost(changedEdges->GetId(i));
     }
   }
 
   changedEdges->Delete();
 }
 
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::UpdateEdgeCost(vtkIdType edgeId)
+{
+  if (this->ParallelEdges)
+  {
+    // The cost is computed at the beginning of the next round.
+    this->ParallelEdges->Modify(edgeId);
+    return;
+  }
+
+  double cost;
+  if (this->AttributeErrorMetric)
+  {
+    cost = this->ComputeCost2(edgeId, this->TempX);
+  }
+  else
+  {
+    cost = this->ComputeCost(edgeId, this->TempX);
+  }
+  this->EdgeCosts->Insert(cost, edgeId);
+  this->TargetPoints->InsertTuple(edgeId, this->TempX);
+}
+
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost(edgeId, x, this->TempQuad);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x,
+                                         double *quad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -839,20 +1245,20 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    quad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -906,7 +1312,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = quad;
   for (i = 0; i < 4; i++)
   {
     cost += (*index++)*newPoint[i]*newPoint[i];
@@ -922,6 +1328,14 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost2(edgeId, x, this->TempQuad, this->TempA,
+                            this->TempB);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x,
+                                          double *quad, double **A, double *b)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dense matrix was not extracted into a separate function and
@@ -937,29 +1351,29 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    quad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
   // copy the temp quad into TempA
   // converting from the sparse matrix format into a dense
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
-    this->TempB[i] = -this->TempQuad[11+4*(i-3)+3];
+    A[0][i] = A[i][0] = quad[11+4*(i-3)];
+    A[1][i] = A[i][1] = quad[11+4*(i-3)+1];
+    A[2][i] = A[i][2] = quad[11+4*(i-3)+2];
+    b[i] = -quad[11+4*(i-3)+3];
   }
 
 
@@ -970,11 +1384,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -985,45 +1399,45 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
     // Add constraint to b
-    this->TempB[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
-    this->TempB[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
+    b[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
+    b[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
   }
 
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    x[i] = this->TempB[i];
+    x[i] = b[i];
   }
 
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
-  solveOk = vtkMath::SolveLinearSystem(this->TempA, x, 3 + this->NumberOfComponents + this->VolumePreservation);
+  solveOk = vtkMath::SolveLinearSystem(A, x, 3 + this->NumberOfComponents + this->VolumePreservation);
 
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
+    A[0][i] = A[i][0] = quad[11+4*(i-3)];
+    A[1][i] = A[i][1] = quad[11+4*(i-3)+1];
+    A[2][i] = A[i][2] = quad[11+4*(i-3)+2];
   }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
@@ -1032,11 +1446,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -1047,15 +1461,15 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
   }
@@ -1088,7 +1502,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j)
       {
-        temp2[i] += this->TempA[i][j]*v[j];
+        temp2[i] += A[i][j]*v[j];
       }
     }
 
@@ -1106,13 +1520,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j)
         {
-          temp[i] += this->TempA[i][j]*pt1[j];
+          temp[i] += A[i][j]*pt1[j];
         }
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
       {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = b[i] - temp[i];
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1146,18 +1560,18 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3+this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost += this->TempA[i][i]*x[i]*x[i];
+    cost += A[i][i]*x[i]*x[i];
     for (j = i+1; j < 3+this->NumberOfComponents + this->VolumePreservation; j++)
     {
-      cost += 2.0*this->TempA[i][j]*x[i]*x[j];
+      cost += 2.0*A[i][j]*x[i]*x[j];
     }
   }
   for (i = 0; i < 3+this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost -=  2.0 * this->TempB[i]*x[i];
+    cost -=  2.0 * b[i]*x[i];
   }
 
-  cost += this->TempQuad[9];
+  cost += quad[9];
 
   return cost;
 }
@@ -1438,6 +1852,8 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
      << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: "
     << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Parallel Decimation: "
+     << (this->ParallelDecimation ? "On\n" : "Off\n");
   os << indent << "Scalars Attribute: "
      << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: "
@@ -48,6 +48,15 @@
  * Attributes" is also a good take on the subject especially as it pertains
  * to the error metric applied to attributes.
  *
+ * When ParallelDecimation is on, the edges are collapsed in rounds instead of
+ * one at a time from a global priority queue. In each round the costs of the
+ * modified edges are computed with several threads, and every edge cheaper
+ * than all the edges around its end points is collapsed, so that the
+ * collapses of a round never share a triangle. The same quadric error
+ * measure (with the same attribute weights) drives the decimation, but the
+ * order of the collapses differs from the serial decimation, and so does the
+ * output. It does not depend on the number of threads.
+ *
  * @par Thanks:
  * Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
  * contributing this class.
@@ -148,6 +157,17 @@ public:
   vtkGetMacro(TensorsWeight, double);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the decimation in rounds of independent edge collapses (see
+   * the class documentation). The costs and the placement checks of each
+   * round are computed with several threads. The default is off.
+   */
+  vtkSetMacro(ParallelDecimation, vtkTypeBool);
+  vtkGetMacro(ParallelDecimation, vtkTypeBool);
+  vtkBooleanMacro(ParallelDecimation, vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -198,6 +218,31 @@ protected:
   double ComputeCost2(vtkIdType edgeId, double *x);
   //@}
 
+  //@{
+  /**
+   * Same as above, with caller provided temporary storage so that the costs
+   * of several edges can be computed concurrently. quad holds
+   * 11 + 4 * NumberOfComponents values, b and each row of A
+   * 3 + NumberOfComponents + VolumePreservation values.
+   */
+  double ComputeCost(vtkIdType edgeId, double *x, double *quad);
+  double ComputeCost2(vtkIdType edgeId, double *x, double *quad,
+                      double **A, double *b);
+  //@}
+
+  /**
+   * Compute the cost and target point of this edge and put it in the
+   * priority queue, or mark it for the next round of the parallel
+   * decimation.
+   */
+  void UpdateEdgeCost(vtkIdType edgeId);
+
+  /**
+   * Collapse edges in rounds of independent collapses until the desired
+   * reduction is reached; return the number of triangles deleted.
+   */
+  vtkIdType DecimateInParallel(vtkIdType numTris);
+
   /**
    * Find all edges that will have an endpoint change ids because of an edge
    * collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
@@ -234,6 +279,7 @@ protected:
   double ActualReduction;
   vtkTypeBool   AttributeErrorMetric;
   vtkTypeBool   VolumePreservation;
+  vtkTypeBool   ParallelDecimation;
 
   vtkTypeBool ScalarsAttribute;
   vtkTypeBool VectorsAttribute;
@@ -278,6 +324,11 @@ protected:
   double **TempA;
   double *TempData;
 
+  // Edge costs, states and target points of the parallel decimation, null
+  // otherwise
+  struct ParallelEdgeData;
+  ParallelEdgeData *ParallelEdges;
+
 private:
   vtkQuadricDecimation(const vtkQuadricDecimation&) = delete;
   void operator=(const vtkQuadricDecimation&) = delete;
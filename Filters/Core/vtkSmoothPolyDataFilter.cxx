@@ -25,10 +25,14 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -129,6 +133,7 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelSmoothing = 0;
 
   this->SmoothPoints = nullptr;
 
@@ -178,15 +183,126 @@ template<typename T> struct vtkSPDF_InternalParams
   T factor;
   T conv;
   vtkIdType numPts;
-  vtkMeshVertexPtr vertexPtr;
+  const vtkIdType *offsets; // the neighbors of point i are
+  const vtkIdType *neighbors; // neighbors[offsets[i]..offsets[i+1]-1]
   vtkPolyData *source;
   vtkSmoothPoints *SmoothPoints;
   double *w;
   vtkCellLocator *cellLocator;
+  bool parallel;
 };
 
+// Move the points of a range toward the mean position of their neighbors,
+// reading the positions of the previous iteration in Current and writing
+// the new ones in Next. Points without neighbors are not written.
+template<typename T> struct vtkSPDF_JacobiIteration
+{
+  const vtkSPDF_InternalParams<T>& Params;
+  const T *Current;
+  T *Next;
+  vtkSMPThreadLocal<T> MaxDist;
+
+  vtkSPDF_JacobiIteration(const vtkSPDF_InternalParams<T>& params,
+                          const T *current, T *next)
+    : Params(params), Current(current), Next(next)
+  {
+  }
+
+  void Initialize()
+  {
+    this->MaxDist.Local() = 0.0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType *offsets = this->Params.offsets;
+    const vtkIdType *neighbors = this->Params.neighbors;
+    T& maxDist = this->MaxDist.Local();
+    T dist, deltaX[3];
+
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType npts = offsets[i + 1] - offsets[i];
+      if (npts > 0)
+      {
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+        const vtkIdType *edgeIdPtr = neighbors + offsets[i];
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          for (unsigned short k = 0; k < 3; ++k)
+          {
+            deltaX[k] += this->Current[3 * edgeIdPtr[j] + k];
+          }
+        }
+
+        for (unsigned short k = 0; k < 3; ++k)
+        {
+          const T x = this->Current[3 * i + k];
+          this->Next[3 * i + k] = x + this->Params.factor * (deltaX[k] / npts - x);
+        }
+
+        if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+        {
+          maxDist = dist;
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Multi-threaded Jacobi iterations over two buffers of points.
+template<typename T> void vtkSPDF_MovePointsInParallel(vtkSPDF_InternalParams<T>& params)
+{
+  T* newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
+  std::vector<T> buffer(newPtsCoords, newPtsCoords + 3 * params.numPts);
+  T* current = newPtsCoords;
+  T* next = buffer.data();
+
+  int iterationNumber = 0;
+  for (T maxDist = std::numeric_limits<T>::max();
+       maxDist > params.conv && iterationNumber < params.numberOfIterations;
+       ++iterationNumber)
+  {
+    if (iterationNumber && !(iterationNumber % 5))
+    {
+      params.spdf->UpdateProgress(0.5 + 0.5*iterationNumber / params.numberOfIterations);
+      if (params.spdf->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    vtkSPDF_JacobiIteration<T> iteration(params, current, next);
+    vtkSMPTools::For(0, params.numPts, iteration);
+    maxDist = 0.0;
+    for (typename vtkSMPThreadLocal<T>::iterator itr = iteration.MaxDist.begin();
+         itr != iteration.MaxDist.end(); ++itr)
+    {
+      maxDist = std::max(maxDist, *itr);
+    }
+    std::swap(current, next);
+  }
+
+  if (current != newPtsCoords)
+  {
+    std::copy(current, current + 3 * params.numPts, newPtsCoords);
+  }
+
+  vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
+}
+
 template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
 {
+  if (params.parallel && !params.source)
+  {
+    vtkSPDF_MovePointsInParallel(params);
+    return;
+  }
+
   int iterationNumber = 0;
   for (T maxDist = std::numeric_limits<T>::max();
        maxDist > params.conv && iterationNumber < params.numberOfIterations;
@@ -204,8 +320,8 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     maxDist = 0.0;
     T* newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
     T* start = newPtsCoords;
-    vtkMeshVertexPtr vertsPtr = params.vertexPtr;
-    vtkIdType npts, *edgeIdPtr;
+    const vtkIdType *edgeIdPtr = params.neighbors;
+    vtkIdType npts;
     T dist, deltaX[3];
     double dist2, xNew[3], closestPt[3];
 
@@ -213,11 +329,9 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     // position of its connected neighbors using the relaxation factor.
     for (vtkIdType i = 0; i < params.numPts; ++i)
     {
-      if (vertsPtr->type != VTK_FIXED_VERTEX && vertsPtr->edges != nullptr &&
-         (npts = vertsPtr->edges->GetNumberOfIds()) > 0)
+      if ((npts = params.offsets[i + 1] - params.offsets[i]) > 0)
       {
         deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-        edgeIdPtr = vertsPtr->edges->GetPointer(0);
         // Compute the mean (cumulated) direction vector
         for (vtkIdType j = 0; j < npts; ++j)
         {
@@ -272,7 +386,6 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
       {
         newPtsCoords += 3;
       }
-      ++vertsPtr;
     }//for all points
   }//for not converged or within iteration count
 
@@ -629,6 +742,31 @@ int vtkSmoothPolyDataFilter::RequestData(
                 << numBEdges << " boundary edge vertices\n\t"
                 << numFixed << " fixed vertices\n\t");
 
+  // Gather the neighbors of the points that can move in compressed rows
+  // (fixed points get empty rows), and release the lists.
+  std::vector<vtkIdType> offsets(numPts + 1, 0);
+  for (i=0; i<numPts; i++)
+  {
+    offsets[i+1] = offsets[i];
+    if ( Verts[i].type != VTK_FIXED_VERTEX && Verts[i].edges != nullptr )
+    {
+      offsets[i+1] += Verts[i].edges->GetNumberOfIds();
+    }
+  }
+  std::vector<vtkIdType> neighbors(offsets[numPts]);
+  for (i=0; i<numPts; i++)
+  {
+    if ( Verts[i].edges != nullptr )
+    {
+      std::copy(Verts[i].edges->GetPointer(0),
+                Verts[i].edges->GetPointer(0) + (offsets[i+1] - offsets[i]),
+                neighbors.begin() + offsets[i]);
+      Verts[i].edges->Delete();
+      Verts[i].edges = nullptr;
+    }
+  }
+  delete [] Verts;
+
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
   // We've setup the topology...now perform Laplacian smoothing
@@ -683,8 +821,9 @@ int vtkSmoothPolyDataFilter::RequestData(
   {
     vtkSPDF_InternalParams<double> params = { this, this->NumberOfIterations, newPts,
                                               this->RelaxationFactor, conv, numPts,
-                                              Verts, source, this->SmoothPoints,
-                                              w, cellLocator };
+                                              offsets.data(), neighbors.data(),
+                                              source, this->SmoothPoints, w, cellLocator,
+                                              this->ParallelSmoothing != 0 };
 
     vtkSPDF_MovePoints(params);
   }
@@ -692,8 +831,10 @@ int vtkSmoothPolyDataFilter::RequestData(
   {
     vtkSPDF_InternalParams<float> params = { this, this->NumberOfIterations, newPts,
                                              static_cast<float>(this->RelaxationFactor),
-                                             static_cast<float>(conv), numPts, Verts,
-                                             source, this->SmoothPoints, w, cellLocator };
+                                             static_cast<float>(conv), numPts,
+                                             offsets.data(), neighbors.data(),
+                                             source, this->SmoothPoints, w, cellLocator,
+                                             this->ParallelSmoothing != 0 };
 
     vtkSPDF_MovePoints(params);
   }
@@ -753,17 +894,6 @@ int vtkSmoothPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr )
-    {
-      Verts[i].edges->Delete();
-      Verts[i].edges = nullptr;
-    }
-  }
-  delete [] Verts;
-
   return 1;
 }
 
@@ -805,4 +935,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
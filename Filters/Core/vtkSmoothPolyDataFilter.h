@@ -77,6 +77,14 @@
  * second input: the Source. If defined, the input mesh is constrained to
  * lie on the surface defined by the Source ivar.
  *
+ * Each iteration normally moves the vertices one after the other, each
+ * vertex using the already moved positions of the vertices before it. When
+ * ParallelSmoothing is on (and no Source is defined), each iteration moves
+ * all the vertices from the positions of the previous iteration instead
+ * (a Jacobi rather than a Gauss-Seidel iteration), with several threads.
+ * The result differs slightly from the serial smoothing, but it does not
+ * depend on the number of threads.
+ *
  *
  * @warning
  * The Laplacian operation reduces high frequency information in the geometry
@@ -215,6 +223,17 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the multi-threaded Jacobi iterations (see the class
+   * documentation). They are not used for constrained smoothing, when a
+   * Source is defined. The default is off.
+   */
+  vtkSetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkGetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkBooleanMacro(ParallelSmoothing,vtkTypeBool);
+  //@}
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() override {}
@@ -232,6 +251,7 @@ protected:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelSmoothing;
 
   vtkSmoothPoints *SmoothPoints;
 private:
@@ -14,21 +14,244 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Multi-threaded extraction of the cells of unstructured grids. The cells
+// are processed in batches of consecutive cells: a first pass tells which
+// cells are kept and counts the output of each batch, then prefix sums over
+// the batches give where each batch writes its points and cells. Like the
+// serial code, the points are numbered in the order of their first use.
+const vtkIdType THRESHOLD_BATCH_SIZE = 4096;
+
+struct ThresholdBatch
+{
+  vtkIdType NumberOfCells; // kept cells
+  vtkIdType ConnectivitySize; // entries of the output cell array
+  vtkIdType NumberOfPoints; // points used for the first time
+  vtkIdType CellOffset;
+  vtkIdType ConnectivityOffset;
+  vtkIdType PointOffset;
+};
+
+struct ThresholdExtraction
+{
+  vtkUnstructuredGrid *Input;
+  std::vector<unsigned char> KeepCells;
+  std::vector<ThresholdBatch> Batches;
+  // The index in the output connectivity of the first use of each point.
+  std::atomic<vtkIdType> *FirstUses;
+  vtkIdType *PointMap;
+
+  // Call visitor(ptId, index) for the points of the kept cells of a batch,
+  // where index is the position of the point in the output connectivity.
+  template <typename Visitor>
+  void VisitPointUses(vtkIdType batch, Visitor &visitor)
+  {
+    vtkIdType index = this->Batches[batch].ConnectivityOffset;
+    const vtkIdType endCellId = std::min(
+      (batch + 1) * THRESHOLD_BATCH_SIZE, this->Input->GetNumberOfCells());
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId = batch * THRESHOLD_BATCH_SIZE; cellId < endCellId;
+         ++cellId)
+    {
+      if (this->KeepCells[cellId])
+      {
+        this->Input->GetCellPoints(cellId, npts, pts);
+        ++index; // number of points of the cell
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          visitor(pts[i], index++);
+        }
+      }
+    }
+  }
+};
+
+// Find the first use of each point.
+struct FindFirstUses
+{
+  ThresholdExtraction *Extraction;
+
+  FindFirstUses(ThresholdExtraction *extraction) : Extraction(extraction) {}
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    std::atomic<vtkIdType> *firstUses = this->Extraction->FirstUses;
+    auto visitor = [firstUses](vtkIdType ptId, vtkIdType index)
+    {
+      vtkIdType current = firstUses[ptId].load(std::memory_order_relaxed);
+      while (index < current &&
+             !firstUses[ptId].compare_exchange_weak(
+               current, index, std::memory_order_relaxed))
+      {
+      }
+    };
+    for ( ; batch < endBatch; ++batch)
+    {
+      this->Extraction->VisitPointUses(batch, visitor);
+    }
+  }
+};
+
+// Count the points used for the first time in each batch.
+struct CountNewPoints
+{
+  ThresholdExtraction *Extraction;
+
+  CountNewPoints(ThresholdExtraction *extraction) : Extraction(extraction) {}
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    const std::atomic<vtkIdType> *firstUses = this->Extraction->FirstUses;
+    for ( ; batch < endBatch; ++batch)
+    {
+      vtkIdType numNewPts = 0;
+      auto visitor = [firstUses, &numNewPts](vtkIdType ptId, vtkIdType index)
+      {
+        if (firstUses[ptId].load(std::memory_order_relaxed) == index)
+        {
+          ++numNewPts;
+        }
+      };
+      this->Extraction->VisitPointUses(batch, visitor);
+      this->Extraction->Batches[batch].NumberOfPoints = numNewPts;
+    }
+  }
+};
+
+// Number the points and copy them, with their attributes, to the output.
+struct CopyNewPoints
+{
+  ThresholdExtraction *Extraction;
+  vtkPoints *InPts;
+  vtkPoints *OutPts;
+  ArrayList Arrays;
+
+  CopyNewPoints(ThresholdExtraction *extraction, vtkPoints *inPts,
+                vtkPointData *inPD, vtkIdType numNewPts, vtkPoints *outPts,
+                vtkPointData *outPD) :
+    Extraction(extraction), InPts(inPts), OutPts(outPts)
+  {
+    this->Arrays.AddArrays(numNewPts, inPD, outPD, 0.0, false);
+  }
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    const std::atomic<vtkIdType> *firstUses = this->Extraction->FirstUses;
+    vtkIdType *pointMap = this->Extraction->PointMap;
+    for ( ; batch < endBatch; ++batch)
+    {
+      vtkIdType newPtId = this->Extraction->Batches[batch].PointOffset;
+      auto visitor = [&](vtkIdType ptId, vtkIdType index)
+      {
+        if (firstUses[ptId].load(std::memory_order_relaxed) == index)
+        {
+          double x[3];
+          this->InPts->GetPoint(ptId, x);
+          this->OutPts->SetPoint(newPtId, x);
+          this->Arrays.Copy(ptId, newPtId);
+          pointMap[ptId] = newPtId++;
+        }
+      };
+      this->Extraction->VisitPointUses(batch, visitor);
+    }
+  }
+};
+
+// Write the kept cells, with their attributes.
+struct GenerateCells
+{
+  ThresholdExtraction *Extraction;
+  vtkIdType *Connectivity;
+  vtkIdType *Locations;
+  unsigned char *Types;
+  ArrayList Arrays;
+
+  GenerateCells(ThresholdExtraction *extraction, vtkIdType *connectivity,
+                vtkIdType *locations, unsigned char *types,
+                vtkCellData *inCD, vtkIdType numNewCells,
+                vtkCellData *outCD) :
+    Extraction(extraction), Connectivity(connectivity),
+    Locations(locations), Types(types)
+  {
+    this->Arrays.AddArrays(numNewCells, inCD, outCD, 0.0, false);
+  }
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkUnstructuredGrid *input = this->Extraction->Input;
+    const vtkIdType *pointMap = this->Extraction->PointMap;
+    vtkIdType npts, *pts;
+    for ( ; batch < endBatch; ++batch)
+    {
+      const ThresholdBatch &thresholdBatch = this->Extraction->Batches[batch];
+      vtkIdType newCellId = thresholdBatch.CellOffset;
+      vtkIdType location = thresholdBatch.ConnectivityOffset;
+      const vtkIdType endCellId = std::min(
+        (batch + 1) * THRESHOLD_BATCH_SIZE, input->GetNumberOfCells());
+      for (vtkIdType cellId = batch * THRESHOLD_BATCH_SIZE;
+           cellId < endCellId; ++cellId)
+      {
+        if (!this->Extraction->KeepCells[cellId])
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, npts, pts);
+        this->Types[newCellId] = static_cast<unsigned char>(
+          input->GetCellType(cellId));
+        this->Locations[newCellId] = location;
+        vtkIdType *cell = this->Connectivity + location;
+        *cell++ = npts;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          cell[i] = pointMap[pts[i]];
+        }
+        this->Arrays.Copy(cellId, newCellId++);
+        location += npts + 1;
+      }
+    }
+  }
+};
+
+// The parallel extraction handles grids without polyhedra, and attributes
+// which vtkArrayList can copy.
+bool CanThresholdInParallel(vtkUnstructuredGrid *input)
+{
+  return vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+    input->GetNumberOfCells() > 0 && !input->GetFaces() &&
+    ArrayList::ProcessesAllArrays(input->GetPointData()) &&
+    ArrayList::ProcessesAllArrays(input->GetCellData());
+}
+
+} // end anonymous namespace
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -133,12 +356,9 @@ int vtkThreshold::RequestData(
   }
 
   outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
   outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
 
   numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
 
   newPoints = vtkPoints::New();
 
@@ -164,6 +384,23 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  // Unstructured grids are processed with several threads when possible.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (grid && CanThresholdInParallel(grid))
+  {
+    this->ParallelThreshold(grid, inScalars, usePointScalars, newPoints,
+                            output);
+    newPoints->Delete();
+    return 1;
+  }
+
+  outPD->CopyAllocate(pd);
+  outCD->CopyAllocate(cd);
+  output->Allocate(input->GetNumberOfCells());
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -175,10 +412,6 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
   {
@@ -186,41 +419,8 @@ int vtkThreshold::RequestData(
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
-      }
-      else
-      {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
-
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
+    keepCell = this->EvaluateCellScalars(
+      inScalars, usePointScalars, cellId, cellPts);
 
     if (  numCellPts > 0 && keepCell)
     {
@@ -268,6 +468,155 @@ int vtkThreshold::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkThreshold::ParallelThreshold(vtkUnstructuredGrid *input,
+                                     vtkDataArray *inScalars,
+                                     bool usePointScalars,
+                                     vtkPoints *newPoints,
+                                     vtkUnstructuredGrid *output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numBatches =
+    (numCells + THRESHOLD_BATCH_SIZE - 1) / THRESHOLD_BATCH_SIZE;
+
+  ThresholdExtraction extraction;
+  extraction.Input = input;
+  extraction.KeepCells.resize(numCells);
+  extraction.Batches.resize(numBatches);
+
+  // Tell which cells are kept, and count the output of each batch.
+  vtkSMPThreadLocalObject<vtkIdList> cellPtsLocal;
+  auto classify = [&](vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = cellPtsLocal.Local();
+    for ( ; batch < endBatch; ++batch)
+    {
+      ThresholdBatch &thresholdBatch = extraction.Batches[batch];
+      thresholdBatch.NumberOfCells = 0;
+      thresholdBatch.ConnectivitySize = 0;
+      const vtkIdType endCellId =
+        std::min((batch + 1) * THRESHOLD_BATCH_SIZE, numCells);
+      for (vtkIdType cellId = batch * THRESHOLD_BATCH_SIZE;
+           cellId < endCellId; ++cellId)
+      {
+        input->GetCellPoints(cellId, cellPts);
+        const vtkIdType numCellPts = cellPts->GetNumberOfIds();
+        const bool keepCell = numCellPts > 0 && this->EvaluateCellScalars(
+          inScalars, usePointScalars, cellId, cellPts);
+        extraction.KeepCells[cellId] = keepCell;
+        if (keepCell)
+        {
+          thresholdBatch.NumberOfCells++;
+          thresholdBatch.ConnectivitySize += numCellPts + 1;
+        }
+      }
+    }
+  };
+  vtkSMPTools::For(0, numBatches, classify);
+
+  vtkIdType numNewCells = 0;
+  vtkIdType connectivitySize = 0;
+  for (ThresholdBatch &batch : extraction.Batches)
+  {
+    batch.CellOffset = numNewCells;
+    batch.ConnectivityOffset = connectivitySize;
+    numNewCells += batch.NumberOfCells;
+    connectivitySize += batch.ConnectivitySize;
+  }
+  this->UpdateProgress(0.5);
+
+  // Number the points in the order of their first use.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUses(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(firstUses.get(), firstUses.get() + numPts, VTK_ID_MAX);
+  extraction.FirstUses = firstUses.get();
+  FindFirstUses findFirstUses(&extraction);
+  vtkSMPTools::For(0, numBatches, findFirstUses);
+  CountNewPoints countPoints(&extraction);
+  vtkSMPTools::For(0, numBatches, countPoints);
+  vtkIdType numNewPts = 0;
+  for (ThresholdBatch &batch : extraction.Batches)
+  {
+    batch.PointOffset = numNewPts;
+    numNewPts += batch.NumberOfPoints;
+  }
+
+  std::vector<vtkIdType> pointMap(numPts);
+  extraction.PointMap = pointMap.data();
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyAllocate(input->GetPointData(), numNewPts);
+  newPoints->SetNumberOfPoints(numNewPts);
+  CopyNewPoints copyPoints(&extraction, input->GetPoints(),
+                           input->GetPointData(), numNewPts, newPoints, outPD);
+  vtkSMPTools::For(0, numBatches, copyPoints);
+  firstUses.reset();
+
+  // Generate the cells.
+  vtkNew<vtkCellArray> newCells;
+  vtkIdType *connectivity =
+    newCells->WritePointer(numNewCells, connectivitySize);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numNewCells);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numNewCells);
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numNewCells);
+  GenerateCells generateCells(&extraction, connectivity,
+                              locations->GetPointer(0), types->GetPointer(0),
+                              input->GetCellData(), numNewCells, outCD);
+  vtkSMPTools::For(0, numBatches, generateCells);
+
+  vtkDebugMacro(<< "Extracted " << numNewCells << " number of cells.");
+
+  output->SetPoints(newPoints);
+  output->SetCells(types, locations, newCells, nullptr, nullptr);
+  output->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+int vtkThreshold::EvaluateCellScalars(vtkDataArray *scalars,
+                                      bool usePointScalars, vtkIdType cellId,
+                                      vtkIdList *cellPts)
+{
+  int keepCell;
+  const int numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+
+  if ( usePointScalars )
+  {
+    if (this->AllScalars)
+    {
+      keepCell = 1;
+      for (int i=0; keepCell && (i < numCellPts); i++)
+      {
+        keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+      }
+    }
+    else
+    {
+      if(!this->UseContinuousCellRange)
+      {
+        keepCell = 0;
+        for (int i=0; (!keepCell) && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+        }
+      }
+      else
+      {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+      }
+    }
+  }
+  else //use cell scalars
+  {
+    keepCell = this->EvaluateComponents( scalars, cellId );
+  }
+
+  // Invert the keep flag if the Invert option is enabled.
+  return this->Invert ? (1 - keepCell) : keepCell;
+}
+
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
 {
   int c(0);
@@ -30,6 +30,12 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * Unstructured grids without polyhedra are processed with several threads
+ * through vtkSMPTools, when more than one thread is available: the cells
+ * are classified in parallel, prefix sums give where each group of cells
+ * writes its output, and the points, cells and their attributes are copied
+ * concurrently. The output is identical to the one of a serial execution.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -51,6 +57,8 @@
 
 class vtkDataArray;
 class vtkIdList;
+class vtkPoints;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
@@ -221,6 +229,20 @@ protected:
   int Between(double s) {return ( s >= this->LowerThreshold ?
                                ( s <= this->UpperThreshold ? 1 : 0 ) : 0 );};
 
+  /**
+   * Return whether the scalars of a cell satisfy the threshold criterion,
+   * with the Invert option applied. Thread safe.
+   */
+  int EvaluateCellScalars(vtkDataArray *scalars, bool usePointScalars,
+                          vtkIdType cellId, vtkIdList *cellPts);
+
+  /**
+   * Multi-threaded extraction of the cells of unstructured grids.
+   */
+  void ParallelThreshold(vtkUnstructuredGrid *input, vtkDataArray *inScalars,
+                         bool usePointScalars, vtkPoints *newPoints,
+                         vtkUnstructuredGrid *output);
+
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
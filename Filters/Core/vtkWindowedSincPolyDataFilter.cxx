@@ -24,9 +24,13 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
 //-----------------------------------------------------------------------------
@@ -64,6 +68,158 @@ typedef struct _vtkMeshVertex
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
 
+namespace
+{
+// One iteration of the windowed sinc interpolation over a range of points.
+// Each iteration only reads the points of the previous iterations, and each
+// point only writes its own coordinates, so the points are smoothed
+// independently. The neighbors of point i are
+// Neighbors[Offsets[i]..Offsets[i+1]-1].
+struct vtkWindowedSincIteration
+{
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  const vtkIdType *Neighbors;
+  const double *C;
+  int IterationNumber;
+  float *Zero;
+  float *One;
+  float *Two;
+  float *Three;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    if (this->IterationNumber == 1)
+    {
+      this->First(begin, end);
+    }
+    else
+    {
+      this->Next(begin, end);
+    }
+  }
+
+  static void SetPoint(float *points, vtkIdType i, const double x[3])
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      points[3 * i + k] = static_cast<float>(x[k]);
+    }
+  }
+
+  void First(vtkIdType begin, vtkIdType end)
+  {
+    double x[3], y[3], deltaX[3];
+    const double zerovector[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      const float *x0 = this->Zero + 3 * i;
+      if (npts > 0)
+      {
+        // point is allowed to move
+        std::copy(x0, x0 + 3, x); //use current points
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative of the laplacian
+        const vtkIdType *nei = this->Neighbors + this->Offsets[i];
+        for (vtkIdType j = 0; j < npts; j++) //for all connected points
+        {
+          std::copy(this->Zero + 3 * nei[j], this->Zero + 3 * nei[j] + 3, y);
+          for (int k = 0; k < 3; k++)
+          {
+            deltaX[k] += (x[k] - y[k]) / npts;
+          }
+        }
+        // newPts[one] = newPts[zero] - 0.5 newPts[one]
+        for (int k = 0; k < 3; k++)
+        {
+          deltaX[k] = x[k] - 0.5*deltaX[k];
+        }
+        SetPoint(this->One, i, deltaX);
+
+        // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
+        for (int k = 0; k < 3; k++)
+        {
+          deltaX[k] = this->C[0]*x[k] + this->C[1]*deltaX[k];
+        }
+        if (this->Verts[i].type == VTK_FIXED_VERTEX)
+        {
+          std::copy(x0, x0 + 3, this->Three + 3 * i);
+        }
+        else
+        {
+          SetPoint(this->Three, i, deltaX);
+        }
+      }//if can move point
+      else
+      {
+        // point is not allowed to move, just use the old point...
+        // (zero out the Laplacian)
+        SetPoint(this->One, i, zerovector);
+        std::copy(x0, x0 + 3, this->Three + 3 * i);
+      }
+    }//for all points
+  }
+
+  void Next(vtkIdType begin, vtkIdType end)
+  {
+    double y[3], deltaX[3], xNew[3];
+    double p_x0[3], p_x1[3], p_x3[3];
+    const double zerovector[3] = { 0.0, 0.0, 0.0 };
+    const double c = this->C[this->IterationNumber];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts > 0)
+      {
+        // point is allowed to move
+        std::copy(this->Zero + 3 * i, this->Zero + 3 * i + 3, p_x0);
+        std::copy(this->One + 3 * i, this->One + 3 * i + 3, p_x1);
+
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative laplacian of x1
+        const vtkIdType *nei = this->Neighbors + this->Offsets[i];
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          std::copy(this->One + 3 * nei[j], this->One + 3 * nei[j] + 3, y);
+          for (int k = 0; k < 3; k++)
+          {
+            deltaX[k] += (p_x1[k] - y[k]) / npts;
+          }
+        }//for all connected points
+
+        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+        for (int k = 0; k < 3; k++)
+        {
+          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+        }
+        SetPoint(this->Two, i, deltaX);
+
+        // smooth the vertex (x3 = x3 + cj x2)
+        std::copy(this->Three + 3 * i, this->Three + 3 * i + 3, p_x3);
+        for (int k = 0; k < 3; k++)
+        {
+          xNew[k] = p_x3[k] + c * deltaX[k];
+        }
+        if (this->Verts[i].type != VTK_FIXED_VERTEX)
+        {
+          SetPoint(this->Three, i, xNew);
+        }
+      }//if can move point
+      else
+      {
+        // point is not allowed to move (zero out the Laplacian). Its
+        // newPts[one] was zeroed as newPts[two] (or newPts[one] in the first
+        // iteration) by the previous iteration, and is read by the neighbors.
+        SetPoint(this->Two, i, zerovector);
+      }
+    }//for all points
+  }
+};
+}
+
 //-----------------------------------------------------------------------------
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -85,7 +241,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkIdType npts = 0;
   vtkIdType *pts = nullptr;
   vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
   double x1[3], x2[3], x3[3], l1[3], l2[3];
   double CosFeatureAngle; //Cosine of angle between adjacent polys
   double CosEdgeAngle; // Cosine of angle between adjacent edges
@@ -99,7 +254,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
   int zero, one, two, three;
 
@@ -445,6 +600,27 @@ int vtkWindowedSincPolyDataFilter::RequestData(
                 << numBEdges << " boundary edge vertices\n\t"
                 << numFixed << " fixed vertices\n\t");
 
+  // Gather the neighbors of the points in compressed rows, and release the
+  // lists.
+  std::vector<vtkIdType> offsets(numPts + 1, 0);
+  for (i=0; i<numPts; i++)
+  {
+    offsets[i+1] = offsets[i] +
+      (Verts[i].edges != nullptr ? Verts[i].edges->GetNumberOfIds() : 0);
+  }
+  std::vector<vtkIdType> neighbors(offsets[numPts]);
+  for (i=0; i<numPts; i++)
+  {
+    if ( Verts[i].edges != nullptr )
+    {
+      std::copy(Verts[i].edges->GetPointer(0),
+                Verts[i].edges->GetPointer(0) + Verts[i].edges->GetNumberOfIds(),
+                neighbors.begin() + offsets[i]);
+      Verts[i].edges->Delete();
+      Verts[i].edges = nullptr;
+    }
+  }
+
   // Perform Windowed Sinc function interpolation
   //
   vtkDebugMacro(<<"Beginning smoothing iterations...");
@@ -506,9 +682,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;
-
   // Calculate the weights and the Chebychev coefficients c.
   //
 
@@ -594,53 +767,12 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   }
 
   // first iteration
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
+  vtkWindowedSincIteration iteration = { Verts, offsets.data(),
+    neighbors.data(), c, 1, nullptr, nullptr, nullptr, nullptr };
+  iteration.Zero = vtkFloatArray::SafeDownCast(newPts[zero]->GetData())->GetPointer(0);
+  iteration.One = vtkFloatArray::SafeDownCast(newPts[one]->GetData())->GetPointer(0);
+  iteration.Three = vtkFloatArray::SafeDownCast(newPts[three]->GetData())->GetPointer(0);
+  vtkSMPTools::For(0, numPts, iteration);
 
   // for the rest of the iterations
   for ( iterationNumber=2;
@@ -656,53 +788,11 @@ int vtkWindowedSincPolyDataFilter::RequestData(
       }
     }
 
-    for (i=0; i<numPts; i++)
-    {
-      if ( Verts[i].edges != nullptr &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-        {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-          {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-          }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-        }
-        newPts[two]->SetPoint(i, deltaX);
-
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
-        {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-        }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-        {
-          newPts[three]->SetPoint(i,xNew);
-        }
-      }//if can move point
-      else
-      {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-      }
-    }//for all points
+    iteration.IterationNumber = iterationNumber;
+    iteration.Zero = vtkFloatArray::SafeDownCast(newPts[zero]->GetData())->GetPointer(0);
+    iteration.One = vtkFloatArray::SafeDownCast(newPts[one]->GetData())->GetPointer(0);
+    iteration.Two = vtkFloatArray::SafeDownCast(newPts[two]->GetData())->GetPointer(0);
+    vtkSMPTools::For(0, numPts, iteration);
 
     // update the pointers. three is always three. all other pointers
     // shift by one and wrap.
@@ -799,14 +889,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     inMesh->Delete();
   }
 
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr )
-    {
-      Verts[i].edges->Delete();
-    }
-  }
   delete [] Verts;
 
   return 1;
@@ -0,0 +1,192 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestModifiedBSPTreeSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded construction of vtkModifiedBSPTree gives the
+// same tree as a serial one, and that the batched IntersectWithLine() finds
+// the cells that the intersection of one line at a time finds.
+
+#include <vtkAppendFilter.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkIdListCollection.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkModifiedBSPTree.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vector>
+
+namespace
+{
+// Random segments crossing the bounding box of the dataset.
+void ConstructLines(vtkDataSet *input, vtkPoints *p1s, vtkPoints *p2s)
+{
+  double bounds[6];
+  input->GetBounds(bounds);
+  vtkMath::RandomSeed(17);
+  for (int i = 0; i < 2000; ++i)
+  {
+    double x[2][3];
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        x[j][k] = vtkMath::Random(bounds[2 * k] - 0.2, bounds[2 * k + 1] + 0.2);
+      }
+    }
+    p1s->InsertNextPoint(x[0]);
+    p2s->InsertNextPoint(x[1]);
+  }
+}
+
+vtkSmartPointer<vtkModifiedBSPTree> BuildTree(vtkDataSet *input,
+                                              int cellsPerNode)
+{
+  vtkSmartPointer<vtkModifiedBSPTree> tree =
+    vtkSmartPointer<vtkModifiedBSPTree>::New();
+  tree->SetDataSet(input);
+  tree->SetNumberOfCellsPerNode(cellsPerNode);
+  tree->LazyEvaluationOff();
+  tree->BuildLocator();
+  return tree;
+}
+
+// The boxes and cells of the leaves, and the batched intersections.
+std::vector<double> Results(vtkModifiedBSPTree *tree, vtkPoints *p1s,
+                            vtkPoints *p2s)
+{
+  std::vector<double> results(1, tree->GetLevel());
+  vtkNew<vtkPolyData> boxes;
+  tree->GenerateRepresentation(-1, boxes);
+  for (vtkIdType ptId = 0; ptId < boxes->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    boxes->GetPoint(ptId, x);
+    results.insert(results.end(), x, x + 3);
+  }
+  vtkIdListCollection *leaves = tree->GetLeafNodeCellInformation();
+  for (int i = 0; i < leaves->GetNumberOfItems(); ++i)
+  {
+    vtkIdList *cellIds = leaves->GetItem(i);
+    results.push_back(static_cast<double>(cellIds->GetNumberOfIds()));
+    results.insert(results.end(), cellIds->GetPointer(0),
+                   cellIds->GetPointer(0) + cellIds->GetNumberOfIds());
+  }
+  leaves->Delete();
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkPoints> points;
+  tree->IntersectWithLine(p1s, p2s, 0.001, cellIds, points);
+  for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    results.push_back(static_cast<double>(cellIds->GetId(i)));
+    results.insert(results.end(), x, x + 3);
+  }
+  return results;
+}
+}
+
+int TestModifiedBSPTreeSMP(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(80);
+  sphere->SetPhiResolution(60);
+  sphere->Update();
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(25, 20, 15);
+  image->SetSpacing(0.1, 0.12, 0.07);
+  vtkNew<vtkAppendFilter> grid;
+  grid->AddInputData(image);
+  grid->Update();
+  vtkDataSet *inputs[] = { sphere->GetOutput(), image, grid->GetOutput() };
+
+  for (vtkDataSet *input : inputs)
+  {
+    vtkNew<vtkPoints> p1s;
+    vtkNew<vtkPoints> p2s;
+    ConstructLines(input, p1s, p2s);
+    for (int cellsPerNode : { 4, 32 })
+    {
+      std::vector<double> reference;
+      auto computeReference = [&]()
+      {
+        vtkSmartPointer<vtkModifiedBSPTree> tree =
+          BuildTree(input, cellsPerNode);
+        reference = Results(tree, p1s, p2s);
+
+        // The batched intersections are the ones of one line at a time.
+        vtkNew<vtkIdList> cellIds;
+        tree->IntersectWithLine(p1s, p2s, 0.001, cellIds, nullptr);
+        vtkNew<vtkGenericCell> cell;
+        vtkIdType numHits = 0;
+        for (vtkIdType i = 0; i < p1s->GetNumberOfPoints(); ++i)
+        {
+          double p1[3], p2[3], t, x[3], pcoords[3];
+          int subId;
+          vtkIdType cellId = -1;
+          p1s->GetPoint(i, p1);
+          p2s->GetPoint(i, p2);
+          if (!tree->IntersectWithLine(p1, p2, 0.001, t, x, pcoords, subId,
+                                       cellId, cell))
+          {
+            cellId = -1;
+          }
+          if (cellId != cellIds->GetId(i))
+          {
+            std::cerr << "Error: line " << i << " intersects cell "
+                      << cellIds->GetId(i) << " instead of " << cellId
+                      << std::endl;
+            return false;
+          }
+          numHits += cellId >= 0;
+        }
+        if (numHits == 0 || tree->GetLevel() < 2)
+        {
+          std::cerr << "Error: no intersection with " << input->GetClassName()
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkModifiedBSPTree> tree =
+          BuildTree(input, cellsPerNode);
+        if (Results(tree, p1s, p2s) != reference)
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different tree of " << input->GetClassName()
+                    << " with " << cellsPerNode << " cells per node"
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
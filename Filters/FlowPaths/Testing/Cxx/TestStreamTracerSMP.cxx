@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel integration of vtkStreamTracer gives exactly the
+// same streamlines as the serial integration, with both kinds of velocity
+// field interpolators.
+
+#include <vtkAppendFilter.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkImageData.h>
+#include <vtkImageGradient.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPointSource.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkRungeKutta45.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamTracer.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> Trace(vtkDataSet *input, vtkPolyData *seeds,
+                                   int options, bool parallel)
+{
+  vtkNew<vtkStreamTracer> tracer;
+  tracer->SetInputData(input);
+  tracer->SetSourceData(seeds);
+  tracer->SetMaximumPropagation(30.0);
+  tracer->SetIntegrationDirectionToBoth();
+  if (options & 1)
+  {
+    tracer->SetInterpolatorTypeToCellLocator();
+  }
+  if (options & 2)
+  {
+    vtkNew<vtkRungeKutta45> integrator;
+    tracer->SetIntegrator(integrator);
+  }
+  tracer->SetParallelIntegration(parallel);
+  tracer->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(tracer->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  vtkCellArray *lines1 = output1->GetLines();
+  vtkCellArray *lines2 = output2->GetLines();
+  const vtkIdType size = lines1->GetNumberOfConnectivityEntries();
+  return SameArrays(output1->GetPoints()->GetData(),
+                    output2->GetPoints()->GetData()) &&
+    lines1->GetNumberOfCells() == lines2->GetNumberOfCells() &&
+    size == lines2->GetNumberOfConnectivityEntries() &&
+    std::memcmp(lines1->GetPointer(), lines2->GetPointer(),
+                size * sizeof(vtkIdType)) == 0 &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestStreamTracerSMP(int, char *[])
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-10, 10, -10, 10, -10, 10);
+  vtkNew<vtkImageGradient> gradient;
+  gradient->SetDimensionality(3);
+  gradient->SetInputConnection(source->GetOutputPort());
+  gradient->Update();
+  vtkImageData *image = vtkImageData::SafeDownCast(gradient->GetOutput());
+  image->GetPointData()->SetActiveVectors("RTDataGradient");
+
+  vtkNew<vtkAppendFilter> toGrid;
+  toGrid->SetInputData(image);
+  toGrid->Update();
+  vtkDataSet *inputs[] = { image, toGrid->GetOutput() };
+
+  vtkNew<vtkPointSource> seedSource;
+  seedSource->SetNumberOfPoints(150);
+  seedSource->SetRadius(8.0);
+  seedSource->Update();
+  vtkPolyData *seeds = seedSource->GetOutput();
+
+  for (vtkDataSet *input : inputs)
+  {
+    for (int options = 0; options < 4; ++options)
+    {
+      vtkSmartPointer<vtkPolyData> reference =
+        Trace(input, seeds, options, false);
+      if (reference->GetNumberOfLines() < 100)
+      {
+        std::cerr << "Error: missing streamlines for a "
+                  << input->GetClassName() << " with options " << options
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      auto testBackend = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output =
+          Trace(input, seeds, options, true);
+        if (!SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives "
+                    << "different streamlines for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::ForEachBackend(testBackend))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -18,10 +18,15 @@
 #include "vtkPolyData.h"
 #include "vtkGenericCell.h"
 #include "vtkIdListCollection.h"
+#include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <stack>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <functional>
 
 #include "vtkAppendPolyData.h"
@@ -76,7 +81,7 @@ public:
 
 typedef cell_extents *cell_extents_List;
 
-static int global_list_count = 0;
+static std::atomic<int> global_list_count(0);
 
 class Sorted_cell_extents_Lists
 {
@@ -104,34 +109,45 @@ public:
   }
 };
 
-extern "C" int __compareMin(const void *pA, const void *B )
+// Mins are sorted by increasing min, Maxs by decreasing max. Ties are
+// broken on the cell ID so that the order does not depend on the sort
+static bool __compareMin(const cell_extents &tA, const cell_extents &tB)
 {
-  const cell_extents *tA = static_cast<const cell_extents *>(pA);
-  const cell_extents *tB = static_cast<const cell_extents *>(B);
-  if ( tA->min == tB->min )
+  if ( tA.min == tB.min )
   {
-    return 0;
-  }
-  else
-  {
-    return tA->min < tB->min ? -1 : 1 ;
+    return tA.cell_ID < tB.cell_ID;
   }
+  return tA.min < tB.min;
 }
 
-extern "C" int __compareMax(const void *pA, const void *B )
+static bool __compareMax(const cell_extents &tA, const cell_extents &tB)
 {
-  const cell_extents *tA = static_cast<const cell_extents *>(pA);
-  const cell_extents *tB = static_cast<const cell_extents *>(B);
-  if ( tA->max == tB->max )
+  if ( tA.max == tB.max )
   {
-    return 0;
-  }
-  else
-  {
-    return tA->max > tB->max ? -1 : 1;
+    return tA.cell_ID < tB.cell_ID;
   }
+  return tA.max > tB.max;
 }
 
+// The state of a subdivision made by one task of the parallel build : the
+// node statistics of its subtree and, when it is deferred, the children it
+// leaves to be subdivided later (together with their sorted lists)
+class BSPSubdivision
+{
+public:
+  struct Pending
+  {
+    BSPNode                   *node;
+    Sorted_cell_extents_Lists *lists;
+    vtkIdType                  nCells;
+    int                        depth;
+  };
+  //
+  bool                 Deferred = false;
+  std::vector<Pending> children;
+  int                  npn = 0, nln = 0, tot_depth = 0, MaxDepth = 0;
+};
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
@@ -197,7 +213,7 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
 
   // create the root node
   this->mRoot = new BSPNode();
-  this->mRoot->mAxis = rand() % 3;
+  this->mRoot->mAxis = 0;
   this->mRoot->depth = 0;
   //
   if (numCells==0)
@@ -209,22 +225,23 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
   //
   // sort the cells into 6 lists using structure for subdividing tests
   Sorted_cell_extents_Lists *lists = new Sorted_cell_extents_Lists(numCells);
-  for (int i=0; i<3; i++)
-  { // loop over each axis
-    for (vtkIdType j=0; j<numCells; j++)
-    { // loop over each cell
-      lists->Mins[i][j].min   = CellBounds[j][i*2];   // i=0 xmin, i=1 ymin, i=2 zmin
-      lists->Mins[i][j].max   = CellBounds[j][i*2+1]; // i=0 xmax, i=1 ymax, i=2 zmax
-      lists->Mins[i][j].cell_ID = j;
-      //
-      lists->Maxs[i][j].min   = CellBounds[j][i*2];
-      lists->Maxs[i][j].max   = CellBounds[j][i*2+1];
-      lists->Maxs[i][j].cell_ID = j;
+  // the 6 lists are filled and sorted independently : one task each
+  vtkSMPTools::For(0, 6, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType l=begin; l<end; l++)
+    {
+      int i = static_cast<int>(l/2); // the axis
+      cell_extents_List list = (l%2) ? lists->Maxs[i] : lists->Mins[i];
+      for (vtkIdType j=0; j<numCells; j++)
+      { // loop over each cell
+        list[j].min     = CellBounds[j][i*2];   // i=0 xmin, i=1 ymin, i=2 zmin
+        list[j].max     = CellBounds[j][i*2+1]; // i=0 xmax, i=1 ymax, i=2 zmax
+        list[j].cell_ID = j;
+      }
+      // Sort
+      std::sort(list, list+numCells, (l%2) ? __compareMax : __compareMin);
     }
-    // Sort
-    qsort( lists->Mins[i], numCells, sizeof(cell_extents), __compareMin) ;
-    qsort( lists->Maxs[i], numCells, sizeof(cell_extents), __compareMax) ;
-  }
+  });
   //
   // call the recursive subdivision routine
   //
@@ -232,8 +249,15 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
   //
   if (numCells>0)
   {
-    Subdivide(this->mRoot, lists, this->DataSet, numCells, 0,
-              this->MaxLevel, this->NumberOfCellsPerNode, this->Level);
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() > 1)
+    {
+      this->SubdivideInParallel(lists, numCells);
+    }
+    else
+    {
+      Subdivide(this->mRoot, lists, this->DataSet, numCells, 0,
+                this->MaxLevel, this->NumberOfCellsPerNode, this->Level);
+    }
   }
   delete lists;
   // Child nodes are responsible for freeing the temporary sorted lists
@@ -259,8 +283,13 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
                                    int depth,
                                    int maxlevel,
                                    vtkIdType maxCells,
-                                   int &MaxDepth)
+                                   int &MaxDepth,
+                                   BSPSubdivision *subdivision)
 {
+  // the node statistics go to the subdivision when there is one
+  int &npn       = subdivision ? subdivision->npn : this->npn;
+  int &nln       = subdivision ? subdivision->nln : this->nln;
+  int &tot_depth = subdivision ? subdivision->tot_depth : this->tot_depth;
   //
   // We've got lists sorted on the axes, so we can easily get BBox
   node->setMin( lists->Mins[0][0].min,
@@ -324,7 +353,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
       {
         node->mChild[i]    = new BSPNode();
         node->mChild[i]->depth = node->depth+1;
-        node->mChild[i]->mAxis = rand() % 3;
+        node->mChild[i]->mAxis = (node->mAxis+1) % 3;
       }
       Daxis = node->mAxis;
       Sorted_cell_extents_Lists *left  = new Sorted_cell_extents_Lists(nCells);
@@ -457,6 +486,28 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
                 delete mid;
                 delete right;
               }
+              else if (subdivision && subdivision->Deferred)
+              {
+                //
+                // The children are subdivided later, the lists go with them
+                subdivision->children.push_back(
+                  {node->mChild[0], left, Cmin_l[0], depth+1});
+                if (Cmin_m[0])
+                {
+                  subdivision->children.push_back(
+                    {node->mChild[1], mid, Cmin_m[0], depth+1});
+                }
+                else
+                {
+                  delete node->mChild[1]; node->mChild[1] = nullptr;
+                  delete mid;
+                }
+                subdivision->children.push_back(
+                  {node->mChild[2], right, Cmin_r[0], depth+1});
+                //
+                npn += 1; // Parent node
+                return;
+              }
               else
               {
                 //
@@ -467,7 +518,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
                 // NB: it is possible for a node to be empty now, so check and delete if necessary
                 if (Cmin_l[0])
                 {
-                  Subdivide(node->mChild[0], left, dataset, Cmin_l[0], depth+1, maxlevel, maxCells, MaxDepth);
+                  Subdivide(node->mChild[0], left, dataset, Cmin_l[0], depth+1, maxlevel, maxCells, MaxDepth, subdivision);
                 }
                 else
                 {
@@ -477,7 +528,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
 
                 if (Cmin_m[0])
                 {
-                  Subdivide(node->mChild[1], mid,  dataset, Cmin_m[0], depth+1, maxlevel, maxCells, MaxDepth);
+                  Subdivide(node->mChild[1], mid,  dataset, Cmin_m[0], depth+1, maxlevel, maxCells, MaxDepth, subdivision);
                 }
                 else
                 {
@@ -487,7 +538,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
 
                 if (Cmin_r[0])
                 {
-                  Subdivide(node->mChild[2], right,dataset, Cmin_r[0], depth+1, maxlevel, maxCells, MaxDepth);
+                  Subdivide(node->mChild[2], right,dataset, Cmin_r[0], depth+1, maxlevel, maxCells, MaxDepth, subdivision);
                 }
                 else
                 {
@@ -525,6 +576,70 @@ void vtkModifiedBSPTree::Subdivide(BSPNode *node,
   }
   // Thank buggery that's all over.
 }
+//---------------------------------------------------------------------------
+// Subdivide the nodes of the top levels one level at a time, each node of a
+// level in a task of its own, until there are enough nodes to keep all the
+// threads busy. Then subdivide the subtrees of these nodes concurrently.
+// Every node is divided exactly as in the serial recursion.
+void vtkModifiedBSPTree::SubdivideInParallel(Sorted_cell_extents_Lists *lists,
+                                             vtkIdType nCells)
+{
+  const size_t minimumNodes =
+    4 * static_cast<size_t>(vtkSMPTools::GetEstimatedNumberOfThreads());
+  std::vector<BSPSubdivision::Pending> level(1, {this->mRoot, lists, nCells, 0});
+  std::vector<BSPSubdivision> subdivisions;
+  //
+  // the statistics of the tasks are added in order, after each step
+  auto merge = [this](const std::vector<BSPSubdivision> &done)
+  {
+    for (const BSPSubdivision &subdivision : done)
+    {
+      this->npn       += subdivision.npn;
+      this->nln       += subdivision.nln;
+      this->tot_depth += subdivision.tot_depth;
+      this->Level      = std::max(this->Level, subdivision.MaxDepth);
+    }
+  };
+  auto subdivide = [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType n=begin; n<end; n++)
+    {
+      BSPSubdivision::Pending &pending = level[n];
+      BSPSubdivision &subdivision = subdivisions[n];
+      this->Subdivide(pending.node, pending.lists, this->DataSet,
+        pending.nCells, pending.depth, this->MaxLevel,
+        this->NumberOfCellsPerNode, subdivision.MaxDepth, &subdivision);
+      // the lists of the root belong to BuildLocatorInternal
+      if (pending.lists != lists)
+      {
+        delete pending.lists;
+      }
+    }
+  };
+  //
+  while (!level.empty() && level.size() < minimumNodes)
+  {
+    subdivisions.assign(level.size(), BSPSubdivision());
+    for (BSPSubdivision &subdivision : subdivisions)
+    {
+      subdivision.Deferred = true;
+    }
+    vtkSMPTools::For(0, static_cast<vtkIdType>(level.size()), 1, subdivide);
+    merge(subdivisions);
+    //
+    std::vector<BSPSubdivision::Pending> next;
+    for (const BSPSubdivision &subdivision : subdivisions)
+    {
+      next.insert(next.end(),
+        subdivision.children.begin(), subdivision.children.end());
+    }
+    level.swap(next);
+  }
+  //
+  subdivisions.assign(level.size(), BSPSubdivision());
+  vtkSMPTools::For(0, static_cast<vtkIdType>(level.size()), 1, subdivide);
+  merge(subdivisions);
+}
 
 //////////////////////////////////////////////////////////////////////////////
 // Generate representation for viewing structure
@@ -673,14 +788,72 @@ int vtkModifiedBSPTree::IntersectWithLine(const double p1[3],
 //---------------------------------------------------------------------------
 int vtkModifiedBSPTree::IntersectWithLine(const double p1[3], const double p2[3], double tol,
                                           double &t, double x[3], double pcoords[3], int &subId, vtkIdType &cellId)
+{
+  this->BuildLocatorIfNeeded();
+  return this->IntersectWithLineInternal(p1, p2, tol, t, x, pcoords, subId, cellId, nullptr);
+}
+//---------------------------------------------------------------------------
+void vtkModifiedBSPTree::IntersectWithLine(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                                           vtkIdList *cellIds, vtkPoints *points)
+{
+  vtkIdType numLines = p1s->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numLines);
+  if (points)
+  {
+    points->SetNumberOfPoints(numLines);
+  }
+  if (numLines < 1)
+  {
+    return;
+  }
+  //
+  this->BuildLocatorIfNeeded();
+  //
+  vtkSMPThreadLocalObject<vtkGenericCell> cells;
+  auto intersect = [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = cells.Local();
+    double p1[3], p2[3], t, x[3], pcoords[3];
+    int subId;
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      p1s->GetPoint(i, p1);
+      p2s->GetPoint(i, p2);
+      vtkIdType cellId = -1;
+      if (!this->DataSet || this->DataSet->GetNumberOfCells() < 1 ||
+          !this->IntersectWithLineInternal(p1, p2, tol, t, x, pcoords, subId, cellId, cell))
+      {
+        cellId = -1;
+        x[0] = p1[0]; x[1] = p1[1]; x[2] = p1[2];
+      }
+      cellIds->SetId(i, cellId);
+      if (points)
+      {
+        points->SetPoint(i, x);
+      }
+    }
+  };
+  //
+  if (this->DataSet && this->DataSet->SupportsConcurrentReads())
+  {
+    this->DataSet->PrepareForConcurrentReads();
+    vtkSMPTools::For(0, numLines, intersect);
+  }
+  else
+  {
+    intersect(0, numLines);
+  }
+}
+//---------------------------------------------------------------------------
+int vtkModifiedBSPTree::IntersectWithLineInternal(const double p1[3], const double p2[3], double tol,
+                                                  double &t, double x[3], double pcoords[3], int &subId, vtkIdType &cellId,
+                                                  vtkGenericCell *cell)
 {
   //
   BSPNode  *node, *Near, *Mid, *Far;
   double    ctmin, ctmax, tmin, tmax, _tmin, _tmax, tDist;
   double    ray_vec[3] = { p2[0]-p1[0], p2[1]-p1[1], p2[2]-p1[2] };
   //
-  this->BuildLocatorIfNeeded();
-  //
   // Does ray pass through root BBox
   tmin = 0; tmax = 1;
   if (!this->mRoot->RayMinMaxT(p1, ray_vec, tmin, tmax))
@@ -776,7 +949,17 @@ int vtkModifiedBSPTree::IntersectWithLine(const double p1[3], const double p2[3]
       ctmin = _tmin; ctmax = _tmax;
       if (BSPNode::RayMinMaxT(CellBounds[cell_ID], p1, ray_vec, ctmin, ctmax))
       {
-        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId))
+        int cellHit;
+        if (cell)
+        {
+          this->DataSet->GetCell(cell_ID, cell);
+          cellHit = cell->IntersectWithLine(const_cast<double*>(p1), const_cast<double*>(p2), tol, t_hit, ipt, pcoords, subId);
+        }
+        else
+        {
+          cellHit = this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId);
+        }
+        if (cellHit)
         {
           if (t_hit<closest_intersection)
           {
@@ -95,6 +95,12 @@
  * segments the lists and passes them down to the new child nodes whilst
  * maintaining sorted order. This makes for an efficient subdivision strategy.
  *
+ * When several threads are available, the 6 lists are sorted concurrently,
+ * the nodes of each of the top levels are subdivided concurrently with
+ * vtkSMPTools, and then the deeper subtrees are built concurrently. The
+ * search for a split plane starts on the axis following the split axis of
+ * the parent node, so the tree does not depend on the number of threads.
+ *
  * NB. The following reference has been sent to me
  *   @Article{formella-1995-ray,
  *     author =     "Arno Formella and Christian Gill",
@@ -149,6 +155,7 @@
 
 class Sorted_cell_extents_Lists;
 class BSPNode;
+class BSPSubdivision;
 class vtkGenericCell;
 class vtkIdList;
 class vtkIdListCollection;
@@ -218,6 +225,17 @@ class VTKFILTERSFLOWPATHS_EXPORT vtkModifiedBSPTree : public vtkAbstractCellLoca
     const double p1[3], const double p2[3], const double tol,
     vtkPoints *points, vtkIdList *cellIds);
 
+  /**
+   * Intersect a batch of line segments with the data set, several segments
+   * at a time with vtkSMPTools. Segment i goes from point i of p1s to point
+   * i of p2s. For each segment, cellIds receives the id of the first cell
+   * that it intersects, or -1, and points (unless nullptr) the intersection
+   * point, or the start of the segment when there is none. The cells are
+   * tested with one vtkGenericCell per thread, not IntersectCellInternal.
+   */
+  void IntersectWithLine(vtkPoints *p1s, vtkPoints *p2s, double tol,
+    vtkIdList *cellIds, vtkPoints *points);
+
   /**
    * Test a point to find if it is inside a cell. Returns the cellId if inside
    * or -1 if not.
@@ -245,8 +263,15 @@ class VTKFILTERSFLOWPATHS_EXPORT vtkModifiedBSPTree : public vtkAbstractCellLoca
 
   //
   // The main subdivision routine
+  // When subdivision is not nullptr, the node statistics are kept in it
+  // rather than in this object, and if it is deferred the children of the
+  // node are handed to it instead of being subdivided
   void Subdivide(BSPNode *node, Sorted_cell_extents_Lists *lists, vtkDataSet *dataSet,
-    vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells, int &MaxDepth);
+    vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells, int &MaxDepth,
+    BSPSubdivision *subdivision = nullptr);
+  //
+  // Subdivide the root node with vtkSMPTools
+  void SubdivideInParallel(Sorted_cell_extents_Lists *lists, vtkIdType nCells);
 
   // We provide a function which does the cell/ray test so that
   // it can be overridden by subclasses to perform special treatment
@@ -255,6 +280,13 @@ class VTKFILTERSFLOWPATHS_EXPORT vtkModifiedBSPTree : public vtkAbstractCellLoca
   virtual int IntersectCellInternal(vtkIdType cell_ID, const double p1[3], const double p2[3],
     const double tol, double &t, double ipt[3], double pcoords[3], int &subId);
 
+  // The search for the first intersection of a line. The cells are tested
+  // with IntersectCellInternal when cell is nullptr, and with cell otherwise,
+  // which several threads can do at once
+  int IntersectWithLineInternal(const double p1[3], const double p2[3], double tol,
+    double &t, double x[3], double pcoords[3], int &subId, vtkIdType &cellId,
+    vtkGenericCell *cell);
+
   void BuildLocatorIfNeeded();
   void ForceBuildLocator();
   void BuildLocatorInternal();
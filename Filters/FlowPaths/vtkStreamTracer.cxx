@@ -33,6 +33,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInterpolatedVelocityField.h"
 #include "vtkAbstractInterpolatedVelocityField.h"
 #include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkCompositeInterpolatedVelocityField.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkNew.h"
@@ -45,8 +46,11 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer)
@@ -89,6 +93,62 @@ namespace
     }
   }
 
+  // Number of seeds integrated together by a thread, in parallel mode.
+  const vtkIdType STREAM_TRACER_BATCH_SIZE = 32;
+
+  // Build the structures that a dataset creates lazily when its cells are
+  // located (bounds, cell links, point locator), so that the threads of the
+  // parallel mode only read them.
+  void PrepareDataSetForThreads(vtkDataSet* ds)
+  {
+    double bounds[6];
+    ds->GetBounds(bounds);
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+    if (ps && ps->GetNumberOfPoints() > 0 && ps->GetNumberOfCells() > 0)
+    {
+      vtkNew<vtkIdList> cellIds;
+      ps->GetPointCells(0, cellIds);
+
+      std::vector<double> weights(std::max(ps->GetMaxCellSize(), 1));
+      double center[3], pcoords[3];
+      int subId;
+      ps->GetCenter(center);
+      ps->FindCell(center, nullptr, -1, 0.0, subId, pcoords, weights.data());
+    }
+  }
+
+  // Create a velocity field interpolator for a thread of the parallel mode,
+  // with the same parameters, datasets and vectors as func.
+  vtkAbstractInterpolatedVelocityField* NewVelocityField(
+    vtkAbstractInterpolatedVelocityField* func,
+    const std::vector<vtkDataSet*>& dataSets, int vecType, const char* vecName)
+  {
+    vtkAbstractInterpolatedVelocityField* copy = func->NewInstance();
+    copy->CopyParameters(func);
+    vtkCompositeInterpolatedVelocityField* composite =
+      vtkCompositeInterpolatedVelocityField::SafeDownCast(copy);
+    for (vtkDataSet* ds : dataSets)
+    {
+      composite->AddDataSet(ds);
+    }
+    copy->SelectVectors(vecType, vecName);
+    return copy;
+  }
+
+  // Append the tuples of the arrays of source to the arrays of target, which
+  // have the same layout.
+  void AppendAttributes(vtkDataSetAttributes* target,
+                        vtkDataSetAttributes* source)
+  {
+    for (int i = 0; i < target->GetNumberOfArrays(); ++i)
+    {
+      vtkAbstractArray* targetArray = target->GetAbstractArray(i);
+      vtkAbstractArray* sourceArray = source->GetAbstractArray(i);
+      targetArray->InsertTuples(targetArray->GetNumberOfTuples(),
+                                sourceArray->GetNumberOfTuples(), 0,
+                                sourceArray);
+    }
+  }
 }
 
 vtkStreamTracer::vtkStreamTracer()
@@ -128,6 +188,8 @@ vtkStreamTracer::vtkStreamTracer()
   this->HasMatchingPointAttributes = true;
 
   this->SurfaceStreamlines = false;
+
+  this->ParallelIntegration = false;
 }
 
 vtkStreamTracer::~vtkStreamTracer()
@@ -512,12 +574,18 @@ int vtkStreamTracer::RequestData(
       double propagation = 0;
       vtkIdType numSteps = 0;
       double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecType,vecName,
-                      propagation, numSteps, integrationTime);
+      if (!this->IntegrateInParallel(input0->GetPointData(), output,
+                                     seeds, seedIds,
+                                     integrationDirections, func,
+                                     maxCellSize, vecType, vecName))
+      {
+        this->Integrate(input0->GetPointData(), output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecType,vecName,
+                        propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -664,6 +732,28 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
                                 double& inPropagation,
                                 vtkIdType& inNumSteps,
                                 double &inIntegrationTime)
+{
+  this->Integrate(input0Data, output, seedSource, seedIds,
+                  integrationDirections, lastPoint, func, maxCellSize,
+                  vecType, vecName, inPropagation, inNumSteps,
+                  inIntegrationTime, false, this->LastUsedStepSize);
+}
+
+void vtkStreamTracer::Integrate(vtkPointData *input0Data,
+                                vtkPolyData* output,
+                                vtkDataArray* seedSource,
+                                vtkIdList* seedIds,
+                                vtkIntArray* integrationDirections,
+                                double lastPoint[3],
+                                vtkAbstractInterpolatedVelocityField* func,
+                                int maxCellSize,
+                                int vecType,
+                                const char *vecName,
+                                double& inPropagation,
+                                vtkIdType& inNumSteps,
+                                double &inIntegrationTime,
+                                bool batch,
+                                double& lastUsedStepSize)
 {
   vtkIdType numLines = seedIds->GetNumberOfIds();
   double propagation = inPropagation;
@@ -792,7 +882,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!batch)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -938,9 +1031,12 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
       if ( numSteps++ % 1000 == 1 )
       {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (!batch)
+        {
+          progress =
+            ( currentLine + propagation / this->MaximumPropagation ) / numLines;
+          this->UpdateProgress(progress);
+        }
 
         if (this->GetAbortExecute())
         {
@@ -973,7 +1069,7 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      lastUsedStepSize = stepSize.Interval;
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1177,7 +1273,7 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     {
       // Assign geometry and attributes
       output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
+      if (this->GenerateNormalsInIntegrate && !batch)
       {
         this->GenerateNormals(output, nullptr, vecName);
       }
@@ -1215,6 +1311,194 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   output->Squeeze();
 }
 
+bool vtkStreamTracer::IntegrateInParallel(vtkPointData *input0Data,
+                                          vtkPolyData* output,
+                                          vtkDataArray* seedSource,
+                                          vtkIdList* seedIds,
+                                          vtkIntArray* integrationDirections,
+                                          vtkAbstractInterpolatedVelocityField* func,
+                                          int maxCellSize,
+                                          int vecType,
+                                          const char *vecName)
+{
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+
+  // The custom callbacks see the points of all the previous streamlines, and
+  // the point data of the blocks has to be checked point by point when the
+  // arrays do not match: keep these cases serial.
+  if (!this->ParallelIntegration ||
+      vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 ||
+      numLines <= 1 || this->GetIntegrator() == nullptr ||
+      !vtkCompositeInterpolatedVelocityField::SafeDownCast(func) ||
+      !this->CustomTerminationCallback.empty() ||
+      !this->HasMatchingPointAttributes ||
+      (this->SurfaceStreamlines &&
+       !vtkInterpolatedVelocityField::SafeDownCast(func)))
+  {
+    return false;
+  }
+
+  std::vector<vtkDataSet*> dataSets;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (ds)
+    {
+      PrepareDataSetForThreads(ds);
+      dataSets.push_back(ds);
+    }
+  }
+
+  // Integrate the batches of seeds. Each thread has its own interpolator,
+  // which keeps its cell locators from one batch to the next.
+  vtkIdType numBatches =
+    (numLines + STREAM_TRACER_BATCH_SIZE - 1) / STREAM_TRACER_BATCH_SIZE;
+  std::vector<vtkSmartPointer<vtkPolyData> > batchOutputs(numBatches);
+  std::vector<double> batchStepSizes(numBatches, vtkMath::Nan());
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    localFuncs;
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField>& localFunc =
+      localFuncs.Local();
+    if (!localFunc)
+    {
+      localFunc.TakeReference(
+        NewVelocityField(func, dataSets, vecType, vecName));
+    }
+    for (vtkIdType batch = begin; batch < end; ++batch)
+    {
+      if (this->GetAbortExecute())
+      {
+        return;
+      }
+      vtkIdType firstLine = batch * STREAM_TRACER_BATCH_SIZE;
+      vtkIdType batchSize =
+        std::min(STREAM_TRACER_BATCH_SIZE, numLines - firstLine);
+      vtkNew<vtkIdList> batchSeedIds;
+      batchSeedIds->SetNumberOfIds(batchSize);
+      vtkNew<vtkIntArray> batchDirections;
+      batchDirections->SetNumberOfValues(batchSize);
+      for (vtkIdType i = 0; i < batchSize; ++i)
+      {
+        batchSeedIds->SetId(i, seedIds->GetId(firstLine + i));
+        batchDirections->SetValue(
+          i, integrationDirections->GetValue(firstLine + i));
+      }
+
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      batchOutputs[batch] = vtkSmartPointer<vtkPolyData>::New();
+      this->Integrate(input0Data, batchOutputs[batch], seedSource,
+                      batchSeedIds, batchDirections, lastPoint, localFunc,
+                      maxCellSize, vecType, vecName, propagation, numSteps,
+                      integrationTime, true, batchStepSizes[batch]);
+    }
+  });
+
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
+
+  for (vtkIdType batch = numBatches; batch--;)
+  {
+    if (!vtkMath::IsNan(batchStepSizes[batch]))
+    {
+      this->LastUsedStepSize = batchStepSizes[batch];
+      break;
+    }
+  }
+
+  // Concatenate the streamlines in seed order. The point data of all the
+  // batches has the same layout as the point data of a serial output.
+  vtkIdType numPts = 0;
+  vtkIdType numCells = 0;
+  vtkIdType linesSize = 0;
+  for (const auto& batchOutput : batchOutputs)
+  {
+    numPts += batchOutput->GetNumberOfPoints();
+    numCells += batchOutput->GetNumberOfLines();
+    linesSize += batchOutput->GetLines()->GetNumberOfConnectivityEntries();
+  }
+
+  vtkPointData* outputPD = output->GetPointData();
+  outputPD->DeepCopy(batchOutputs[0]->GetPointData());
+  for (int i = 0; i < outputPD->GetNumberOfArrays(); ++i)
+  {
+    outputPD->GetAbstractArray(i)->Resize(numPts);
+  }
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->Allocate(numPts);
+  vtkNew<vtkCellArray> outputLines;
+  vtkIdType* lines = outputLines->WritePointer(numCells, linesSize);
+  vtkNew<vtkIntArray> retVals;
+  retVals->SetName("ReasonForTermination");
+  retVals->Allocate(numCells);
+  vtkNew<vtkIntArray> sids;
+  sids->SetName("SeedIds");
+  sids->Allocate(numCells);
+
+  vtkIdType offset = 0;
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    vtkPolyData* batchOutput = batchOutputs[batch];
+    vtkIdType batchNumPts = batchOutput->GetNumberOfPoints();
+    if (batchNumPts == 0)
+    {
+      continue;
+    }
+    outputPoints->GetData()->InsertTuples(
+      offset, batchNumPts, 0, batchOutput->GetPoints()->GetData());
+    if (batch > 0)
+    {
+      AppendAttributes(outputPD, batchOutput->GetPointData());
+    }
+
+    vtkCellArray* batchLines = batchOutput->GetLines();
+    const vtkIdType* batchCell = batchLines->GetPointer();
+    for (vtkIdType cellId = 0; cellId < batchLines->GetNumberOfCells(); ++cellId)
+    {
+      vtkIdType npts = *batchCell++;
+      *lines++ = npts;
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        *lines++ = offset + *batchCell++;
+      }
+    }
+    if (batchLines->GetNumberOfCells() > 0)
+    {
+      vtkCellData* batchCD = batchOutput->GetCellData();
+      retVals->InsertTuples(retVals->GetNumberOfTuples(),
+                            batchLines->GetNumberOfCells(), 0,
+                            batchCD->GetArray("ReasonForTermination"));
+      sids->InsertTuples(sids->GetNumberOfTuples(),
+                         batchLines->GetNumberOfCells(), 0,
+                         batchCD->GetArray("SeedIds"));
+    }
+    offset += batchNumPts;
+  }
+
+  output->SetPoints(outputPoints);
+  if (numPts > 1)
+  {
+    output->SetLines(outputLines);
+    if (this->GenerateNormalsInIntegrate)
+    {
+      this->GenerateNormals(output, nullptr, vecName);
+    }
+    output->GetCellData()->AddArray(retVals);
+    output->GetCellData()->AddArray(sids);
+  }
+  output->Squeeze();
+
+  return true;
+}
+
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal,
                                       const char *vecName)
 {
@@ -1437,6 +1721,8 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: "
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Parallel integration: "
+     << (this->ParallelIntegration ? " On" : " Off") << endl;
 }
 
 vtkExecutive* vtkStreamTracer::CreateDefaultExecutive()
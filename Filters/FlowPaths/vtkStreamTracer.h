@@ -69,6 +69,15 @@
  * a source object, traces will be generated from each point in the source
  * that is inside the dataset.
  *
+ * When ParallelIntegration is on, the seeds are integrated with vtkSMPTools.
+ * They are split in batches, which are distributed over the threads. Each
+ * thread works with its own copy of the velocity field interpolator, and so
+ * with its own cell locators. The streamlines are then concatenated in seed
+ * order, so the output is the same as in serial mode for a single dataset.
+ * For a composite dataset, the block in which a point on the boundary between
+ * two blocks is located may depend on the previous seed integrated by the
+ * thread.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
@@ -294,6 +303,18 @@ public:
   vtkBooleanMacro(SurfaceStreamlines, bool);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the integration of the seeds with several threads (see the
+   * class documentation). Custom termination callbacks, AMR inputs and inputs
+   * whose blocks do not have the same point data arrays are always handled
+   * in serial mode. The default is off.
+   */
+  vtkSetMacro(ParallelIntegration, bool);
+  vtkGetMacro(ParallelIntegration, bool);
+  vtkBooleanMacro(ParallelIntegration, bool);
+  //@}
+
   enum
   {
     FORWARD,
@@ -412,6 +433,43 @@ protected:
                  double& propagation,
                  vtkIdType& numSteps,
                  double& integrationTime);
+
+  /**
+   * Implementation of Integrate(). When batch is true, the seeds are a batch
+   * of a threaded integration: the progress is not reported, the normals are
+   * not generated, and the last step size is stored in lastUsedStepSize
+   * instead of LastUsedStepSize.
+   */
+  void Integrate(vtkPointData *inputData,
+                 vtkPolyData* output,
+                 vtkDataArray* seedSource,
+                 vtkIdList* seedIds,
+                 vtkIntArray* integrationDirections,
+                 double lastPoint[3],
+                 vtkAbstractInterpolatedVelocityField* func,
+                 int maxCellSize,
+                 int vecType,
+                 const char *vecFieldName,
+                 double& propagation,
+                 vtkIdType& numSteps,
+                 double& integrationTime,
+                 bool batch,
+                 double& lastUsedStepSize);
+
+  /**
+   * Integrate the seeds with several threads when ParallelIntegration is on
+   * and the input allows it. Returns false when the seeds must be integrated
+   * in serial mode.
+   */
+  bool IntegrateInParallel(vtkPointData *inputData,
+                           vtkPolyData* output,
+                           vtkDataArray* seedSource,
+                           vtkIdList* seedIds,
+                           vtkIntArray* integrationDirections,
+                           vtkAbstractInterpolatedVelocityField* func,
+                           int maxCellSize,
+                           int vecType,
+                           const char *vecFieldName);
   double SimpleIntegrate(double seed[3],
                          double lastPoint[3],
                          double stepSize,
@@ -468,6 +526,9 @@ protected:
   // Compute streamlines only on surface.
   bool SurfaceStreamlines;
 
+  // Integrate the seeds with several threads.
+  bool ParallelIntegration;
+
   vtkAbstractInterpolatedVelocityField * InterpolatorPrototype;
 
   vtkCompositeDataSet* InputData;
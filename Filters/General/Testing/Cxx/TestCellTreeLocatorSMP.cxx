@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellTreeLocatorSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded construction of vtkCellTreeLocator gives the
+// same tree as a serial one, and that FindCells() locates the points as
+// FindCell() does.
+
+#include <vtkAppendFilter.h>
+#include <vtkCellArray.h>
+#include <vtkCellTreeLocator.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vector>
+
+namespace
+{
+// Random points around the dataset, and in the cells of a bounding box
+// smaller than the dataset.
+vtkSmartPointer<vtkPoints> ConstructPoints(vtkDataSet *input)
+{
+  double bounds[6];
+  input->GetBounds(bounds);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkMath::RandomSeed(31);
+  for (int i = 0; i < 20000; ++i)
+  {
+    points->InsertNextPoint(
+      vtkMath::Random(bounds[0] - 0.1, bounds[1] + 0.1),
+      vtkMath::Random(bounds[2] - 0.1, bounds[3] + 0.1),
+      vtkMath::Random(bounds[4] - 0.1, bounds[5] + 0.1));
+  }
+  return points;
+}
+
+// Ids of the cells containing the points, and of the cells within a box,
+// whose order depends on the tree.
+std::vector<vtkIdType> LocateCells(vtkDataSet *input, vtkPoints *points,
+                                   int cellsPerNode)
+{
+  vtkNew<vtkCellTreeLocator> locator;
+  locator->SetDataSet(input);
+  locator->SetNumberOfCellsPerNode(cellsPerNode);
+  locator->BuildLocator();
+
+  vtkNew<vtkIdList> cellIds;
+  locator->FindCells(points, cellIds);
+  std::vector<vtkIdType> ids(cellIds->GetPointer(0),
+                             cellIds->GetPointer(0) + cellIds->GetNumberOfIds());
+
+  double bounds[6];
+  input->GetBounds(bounds);
+  for (int i = 0; i < 3; ++i)
+  {
+    bounds[2 * i + 1] = 0.5 * (bounds[2 * i] + bounds[2 * i + 1]);
+  }
+  locator->FindCellsWithinBounds(bounds, cellIds);
+  ids.insert(ids.end(), cellIds->GetPointer(0),
+             cellIds->GetPointer(0) + cellIds->GetNumberOfIds());
+  return ids;
+}
+}
+
+int TestCellTreeLocatorSMP(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(80);
+  sphere->SetPhiResolution(60);
+  sphere->Update();
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(30, 25, 20);
+  image->SetSpacing(0.1, 0.12, 0.07);
+  vtkNew<vtkAppendFilter> grid;
+  grid->AddInputData(image);
+  grid->Update();
+  vtkDataSet *inputs[] = { sphere->GetOutput(), image, grid->GetOutput() };
+
+  for (vtkDataSet *input : inputs)
+  {
+    vtkSmartPointer<vtkPoints> points = ConstructPoints(input);
+    for (int cellsPerNode : { 1, 8, 32 })
+    {
+      std::vector<vtkIdType> reference;
+      auto computeReference = [&]()
+      {
+        reference = LocateCells(input, points, cellsPerNode);
+
+        // The cells found for each point are the ones of FindCell().
+        vtkNew<vtkCellTreeLocator> locator;
+        locator->SetDataSet(input);
+        locator->SetNumberOfCellsPerNode(cellsPerNode);
+        locator->BuildLocator();
+        vtkNew<vtkGenericCell> cell;
+        std::vector<double> weights(input->GetMaxCellSize());
+        vtkIdType numFound = 0;
+        for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+        {
+          double x[3], pcoords[3];
+          points->GetPoint(ptId, x);
+          const vtkIdType cellId =
+            locator->FindCell(x, 0.0, cell, pcoords, weights.data());
+          if (cellId != reference[ptId])
+          {
+            std::cerr << "Error: point " << ptId << " found in cell "
+                      << reference[ptId] << " instead of " << cellId
+                      << std::endl;
+            return false;
+          }
+          numFound += cellId >= 0;
+        }
+        if (numFound == 0)
+        {
+          std::cerr << "Error: no point found in " << input->GetClassName()
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        if (LocateCells(input, points, cellsPerNode) != reference)
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "cells in " << input->GetClassName() << " with "
+                    << cellsPerNode << " cells per node" << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCurvaturesSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkCurvatures gives the same curvatures as
+// a serial execution, for all the curvature types.
+
+#include <vtkCellArray.h>
+#include <vtkCurvatures.h>
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// A bumpy sphere of triangles, and a bumpy plane of quads with holes and a
+// fan of triangles sharing a non-manifold edge.
+vtkSmartPointer<vtkPolyData> ConstructSphere()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(sphere->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    const double scale = 1.0 + 0.1 * std::sin(5.0 * ptId);
+    points->SetPoint(ptId, scale * x[0], scale * x[1], scale * x[2]);
+  }
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> ConstructPlane()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(20, 15);
+  plane->Update();
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->DeepCopy(plane->GetOutput());
+  input->GetPointData()->Initialize();
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    x[2] = 0.3 * std::fabs(x[0]) + 0.05 * std::sin(3.0 * ptId);
+    points->SetPoint(ptId, x);
+  }
+
+  vtkNew<vtkCellArray> polys;
+  vtkIdType npts, *pts;
+  vtkIdType cellId = 0;
+  vtkCellArray *quads = input->GetPolys();
+  for (quads->InitTraversal(); quads->GetNextCell(npts, pts); ++cellId)
+  {
+    if (cellId % 17 != 5)
+    {
+      polys->InsertNextCell(npts, pts);
+    }
+  }
+  const vtkIdType p0 = points->InsertNextPoint(1.0, 0.0, 0.0);
+  const vtkIdType p1 = points->InsertNextPoint(1.0, 1.0, 0.0);
+  for (int i = 0; i < 4; ++i)
+  {
+    const vtkIdType triangle[3] = { p0, p1, points->InsertNextPoint(
+      1.0 + std::cos(1.3 * i), 0.5, std::sin(1.3 * i)) };
+    polys->InsertNextCell(3, triangle);
+  }
+  input->SetPolys(polys);
+  return input;
+}
+
+// Whether the output keeps its links: each point lists the cells using it.
+bool HasLinks(vtkPolyData *output)
+{
+  vtkIdType numLinks = 0;
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    output->GetPointCells(ptId, ncells, cells);
+    for (unsigned short i = 0; i < ncells; ++i)
+    {
+      if (!output->IsPointUsedByCell(ptId, cells[i]))
+      {
+        return false;
+      }
+    }
+    numLinks += ncells;
+  }
+  vtkCellArray *polys = output->GetPolys();
+  return numLinks == polys->GetNumberOfConnectivityEntries() -
+                     polys->GetNumberOfCells();
+}
+
+// Return nullptr if checkLinks is set and the output does not keep its
+// links.
+vtkSmartPointer<vtkPolyData> ComputeCurvatures(vtkPolyData *input,
+                                               int options, bool checkLinks)
+{
+  vtkNew<vtkCurvatures> curvatures;
+  curvatures->SetInputData(input);
+  curvatures->SetCurvatureType(options & 3);
+  curvatures->SetInvertMeanCurvature((options >> 2) & 1);
+  curvatures->Update();
+  if (checkLinks && !HasLinks(curvatures->GetOutput()))
+  {
+    return nullptr;
+  }
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(curvatures->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  vtkPointData *pointData1 = output1->GetPointData();
+  vtkPointData *pointData2 = output2->GetPointData();
+  if (pointData1->GetNumberOfArrays() != pointData2->GetNumberOfArrays() ||
+      !SameArrays(pointData1->GetScalars(), pointData2->GetScalars()))
+  {
+    return false;
+  }
+  for (int i = 0; i < pointData1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = pointData1->GetArray(i);
+    if (!SameArrays(array1, pointData2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestCurvaturesSMP(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> inputs[] = { ConstructSphere(),
+                                            ConstructPlane() };
+
+  for (vtkPolyData *input : inputs)
+  {
+    for (int options = 0; options < 8; ++options)
+    {
+      vtkSmartPointer<vtkPolyData> reference;
+      auto computeReference = [&]()
+      {
+        // The serial Gauss curvature does not build the links.
+        reference = ComputeCurvatures(input, options,
+                                      (options & 3) != VTK_CURVATURE_GAUSS);
+        if (!reference)
+        {
+          std::cerr << "Error: the output has no links with options "
+                    << options << std::endl;
+          return false;
+        }
+        // The principal curvatures may be undefined everywhere.
+        vtkDataArray *curvatures = reference->GetPointData()->GetArray(
+          (options & 3) == VTK_CURVATURE_MEAN ?
+          "Mean_Curvature" : "Gauss_Curvature");
+        if (!curvatures ||
+            curvatures->GetRange()[0] == curvatures->GetRange()[1])
+        {
+          std::cerr << "Error: constant curvatures with options " << options
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkPolyData> output =
+          ComputeCurvatures(input, options, true);
+        if (!output)
+        {
+          std::cerr << "Error: the " << backend << " output has no links "
+                    << "with options " << options << std::endl;
+          return false;
+        }
+        if (!SameOutputs(reference, output))
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "curvatures with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGradientFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkGradientFilter gives exactly the same
+// output as a serial execution for all the dataset types, and that the
+// gradients of the coordinates are the identity on image data and
+// rectilinear grids.
+
+#include <vtkAppendFilter.h>
+#include <vtkCellArray.h>
+#include <vtkCellCenters.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDoubleArray.h>
+#include <vtkGradientFilter.h>
+#include <vtkImageData.h>
+#include <vtkImageDataToPointSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStructuredGrid.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Add the coordinates of the points and of the cell centers as vectors.
+void AddCoordinates(vtkDataSet *dataSet)
+{
+  vtkNew<vtkDoubleArray> pointCoordinates;
+  pointCoordinates->SetName("Coordinates");
+  pointCoordinates->SetNumberOfComponents(3);
+  pointCoordinates->SetNumberOfTuples(dataSet->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    pointCoordinates->SetTuple3(ptId, x[0], 0.5 * x[1] + x[2], x[2] - x[0]);
+  }
+  dataSet->GetPointData()->AddArray(pointCoordinates);
+
+  vtkNew<vtkCellCenters> centers;
+  centers->SetInputData(dataSet);
+  centers->Update();
+  vtkNew<vtkDoubleArray> cellCoordinates;
+  cellCoordinates->SetName("Coordinates");
+  cellCoordinates->SetNumberOfComponents(3);
+  cellCoordinates->SetNumberOfTuples(dataSet->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    double x[3];
+    centers->GetOutput()->GetPoint(cellId, x);
+    cellCoordinates->SetTuple3(cellId, x[0], 0.5 * x[1] + x[2], x[2] - x[0]);
+  }
+  dataSet->GetCellData()->AddArray(cellCoordinates);
+}
+
+vtkSmartPointer<vtkImageData> ConstructImage()
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-8, 8, -8, 8, -6, 6);
+  source->Update();
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->ShallowCopy(source->GetOutput());
+  image->SetSpacing(0.5, 1.0, 2.0);
+  image->SetOrigin(1.0, -2.0, 0.5);
+  AddCoordinates(image);
+  return image;
+}
+
+vtkSmartPointer<vtkRectilinearGrid> ConstructRectilinearGrid(
+  vtkImageData *image)
+{
+  vtkSmartPointer<vtkRectilinearGrid> grid =
+    vtkSmartPointer<vtkRectilinearGrid>::New();
+  int dims[3];
+  image->GetDimensions(dims);
+  grid->SetDimensions(dims);
+  vtkNew<vtkDoubleArray> coordinates[3];
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int i = 0; i < dims[axis]; ++i)
+    {
+      // Irregular but increasing coordinates.
+      coordinates[axis]->InsertNextValue(i + 0.3 * std::sin(1.0 * i));
+    }
+  }
+  grid->SetXCoordinates(coordinates[0]);
+  grid->SetYCoordinates(coordinates[1]);
+  grid->SetZCoordinates(coordinates[2]);
+  grid->GetPointData()->AddArray(image->GetPointData()->GetArray("RTData"));
+  AddCoordinates(grid);
+  return grid;
+}
+
+vtkSmartPointer<vtkPolyData> ConstructPolyData()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->ShallowCopy(sphere->GetOutput());
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("RTData");
+  for (vtkIdType ptId = 0; ptId < polyData->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    polyData->GetPoint(ptId, x);
+    values->InsertNextValue(x[0] * x[1] + std::cos(3.0 * x[2]));
+  }
+  polyData->GetPointData()->AddArray(values);
+  AddCoordinates(polyData);
+  return polyData;
+}
+
+vtkSmartPointer<vtkDataSet> ComputeGradients(vtkDataSet *input, int options)
+{
+  vtkNew<vtkGradientFilter> gradients;
+  gradients->SetInputData(input);
+  const int association = options & 1 ?
+    vtkDataObject::FIELD_ASSOCIATION_CELLS :
+    vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  if (options & 2)
+  {
+    gradients->SetInputScalars(association, "Coordinates");
+    gradients->ComputeDivergenceOn();
+    gradients->ComputeVorticityOn();
+    gradients->ComputeQCriterionOn();
+  }
+  else
+  {
+    gradients->SetInputScalars(association,
+      association == vtkDataObject::FIELD_ASSOCIATION_CELLS ? "Coordinates" :
+      "RTData");
+  }
+  gradients->SetFasterApproximation((options >> 2) & 1);
+  gradients->SetContributingCellOption((options >> 3) % 3);
+  gradients->Update();
+
+  vtkSmartPointer<vtkDataSet> output;
+  output.TakeReference(gradients->GetOutput()->NewInstance());
+  output->DeepCopy(gradients->GetOutput());
+  return output;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The gradients of the coordinates, and the quantities derived from them.
+bool CheckCoordinateGradients(vtkDataSet *output, int options)
+{
+  vtkDataSetAttributes *attributes = options & 1 ?
+    static_cast<vtkDataSetAttributes*>(output->GetCellData()) :
+    static_cast<vtkDataSetAttributes*>(output->GetPointData());
+  const double expected[9] = { 1.0, 0.0, 0.0, 0.0, 0.5, 1.0, -1.0, 0.0, 1.0 };
+  vtkDataArray *gradients = attributes->GetArray("Gradients");
+  vtkDataArray *divergence = attributes->GetArray("Divergence");
+  vtkDataArray *vorticity = attributes->GetArray("Vorticity");
+  for (vtkIdType i = 0; i < gradients->GetNumberOfTuples(); ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+    {
+      if (std::fabs(gradients->GetComponent(i, j) - expected[j]) > 1e-4)
+      {
+        std::cerr << "Error: wrong gradient " << gradients->GetComponent(i, j)
+                  << " instead of " << expected[j] << std::endl;
+        return false;
+      }
+    }
+    if (std::fabs(divergence->GetComponent(i, 0) - 2.5) > 1e-4 ||
+        std::fabs(vorticity->GetComponent(i, 0) + 1.0) > 1e-4 ||
+        std::fabs(vorticity->GetComponent(i, 1) - 1.0) > 1e-4 ||
+        std::fabs(vorticity->GetComponent(i, 2)) > 1e-4)
+    {
+      std::cerr << "Error: wrong divergence or vorticity" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestGradientFilterSMP(int, char *[])
+{
+  vtkSmartPointer<vtkImageData> image = ConstructImage();
+  vtkSmartPointer<vtkRectilinearGrid> rectilinear =
+    ConstructRectilinearGrid(image);
+  vtkNew<vtkImageDataToPointSet> toStructured;
+  toStructured->SetInputData(image);
+  toStructured->Update();
+  vtkNew<vtkAppendFilter> toUnstructured;
+  toUnstructured->SetInputData(image);
+  toUnstructured->Update();
+  vtkSmartPointer<vtkPolyData> polyData = ConstructPolyData();
+
+  // The cells in the split storage are read with several threads too.
+  vtkNew<vtkUnstructuredGrid> splitUnstructured;
+  splitUnstructured->DeepCopy(toUnstructured->GetOutput());
+  splitUnstructured->GetCells()->SetStorageMode(
+    vtkCellArray::SPLIT_STORAGE_32BIT);
+  vtkNew<vtkPolyData> splitPolyData;
+  splitPolyData->DeepCopy(polyData);
+  splitPolyData->GetPolys()->SetStorageMode(
+    vtkCellArray::SPLIT_STORAGE_32BIT);
+
+  vtkDataSet *inputs[] = { image, rectilinear, toStructured->GetOutput(),
+    toUnstructured->GetOutput(), polyData, splitUnstructured, splitPolyData };
+
+  for (vtkDataSet *input : inputs)
+  {
+    for (int options = 0; options < 24; ++options)
+    {
+      vtkSmartPointer<vtkDataSet> reference;
+      auto computeReference = [&]()
+      {
+        reference = ComputeGradients(input, options);
+        const bool regular = input == image || input == rectilinear;
+        if ((options & 2) && regular &&
+            !CheckCoordinateGradients(reference, options))
+        {
+          std::cerr << "Error: for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkDataSet> output = ComputeGradients(input, options);
+        if (!SameAttributes(reference->GetPointData(),
+                            output->GetPointData()) ||
+            !SameAttributes(reference->GetCellData(), output->GetCellData()))
+        {
+          std::cerr << "Error: the " << backend << " backend gives different "
+                    << "gradients for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBBTreeSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded construction of vtkOBBTree gives the same
+// boxes as a serial one, and that the batched IntersectWithLine() finds the
+// cells that the intersection of one line at a time finds.
+
+#include <vtkAppendFilter.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkOBBTree.h>
+#include <vtkPlaneSource.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Random segments crossing the bounding box of the dataset.
+void ConstructLines(vtkDataSet *input, vtkPoints *p1s, vtkPoints *p2s)
+{
+  double bounds[6];
+  input->GetBounds(bounds);
+  vtkMath::RandomSeed(17);
+  for (int i = 0; i < 2000; ++i)
+  {
+    double x[2][3];
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        x[j][k] = vtkMath::Random(bounds[2 * k] - 0.2, bounds[2 * k + 1] + 0.2);
+      }
+    }
+    p1s->InsertNextPoint(x[0]);
+    p2s->InsertNextPoint(x[1]);
+  }
+}
+
+vtkSmartPointer<vtkOBBTree> BuildTree(vtkDataSet *input, int maxLevel)
+{
+  vtkSmartPointer<vtkOBBTree> tree = vtkSmartPointer<vtkOBBTree>::New();
+  tree->SetDataSet(input);
+  tree->SetMaxLevel(maxLevel);
+  tree->SetNumberOfCellsPerNode(4);
+  tree->BuildLocator();
+  return tree;
+}
+
+// The corners of the boxes of every level, and the batched intersections.
+std::vector<double> Results(vtkOBBTree *tree, vtkPoints *p1s, vtkPoints *p2s)
+{
+  std::vector<double> results(1, tree->GetLevel());
+  for (int level = 0; level <= tree->GetLevel(); ++level)
+  {
+    vtkNew<vtkPolyData> boxes;
+    tree->GenerateRepresentation(level, boxes);
+    for (vtkIdType ptId = 0; ptId < boxes->GetNumberOfPoints(); ++ptId)
+    {
+      double x[3];
+      boxes->GetPoint(ptId, x);
+      results.insert(results.end(), x, x + 3);
+    }
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkPoints> points;
+  tree->IntersectWithLine(p1s, p2s, 0.001, cellIds, points);
+  for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    results.push_back(static_cast<double>(cellIds->GetId(i)));
+    results.insert(results.end(), x, x + 3);
+  }
+  return results;
+}
+}
+
+int TestOBBTreeSMP(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+  // The boxes are fitted to the surface cells, so the unstructured grid is
+  // a bumpy plane of quads.
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(50, 40);
+  plane->Update();
+  vtkNew<vtkAppendFilter> grid;
+  grid->AddInputData(plane->GetOutput());
+  grid->Update();
+  vtkPoints *points = grid->GetOutput()->GetPoints();
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    points->GetPoint(ptId, x);
+    points->SetPoint(ptId, x[0], x[1],
+                     0.3 * std::fabs(x[0]) + 0.05 * std::sin(3.0 * ptId));
+  }
+  vtkDataSet *inputs[] = { sphere->GetOutput(), grid->GetOutput() };
+
+  for (vtkDataSet *input : inputs)
+  {
+    vtkNew<vtkPoints> p1s;
+    vtkNew<vtkPoints> p2s;
+    ConstructLines(input, p1s, p2s);
+    for (int maxLevel : { 3, 12 })
+    {
+      std::vector<double> reference;
+      auto computeReference = [&]()
+      {
+        vtkSmartPointer<vtkOBBTree> tree = BuildTree(input, maxLevel);
+        reference = Results(tree, p1s, p2s);
+
+        // The batched intersections are the ones of one line at a time.
+        vtkNew<vtkIdList> cellIds;
+        tree->IntersectWithLine(p1s, p2s, 0.001, cellIds, nullptr);
+        vtkNew<vtkGenericCell> cell;
+        vtkIdType numHits = 0;
+        for (vtkIdType i = 0; i < p1s->GetNumberOfPoints(); ++i)
+        {
+          double p1[3], p2[3], t, x[3], pcoords[3];
+          int subId;
+          vtkIdType cellId = -1;
+          p1s->GetPoint(i, p1);
+          p2s->GetPoint(i, p2);
+          tree->IntersectWithLine(p1, p2, 0.001, t, x, pcoords, subId, cellId,
+                                  cell);
+          if (cellId != cellIds->GetId(i))
+          {
+            std::cerr << "Error: line " << i << " intersects cell "
+                      << cellIds->GetId(i) << " instead of " << cellId
+                      << std::endl;
+            return false;
+          }
+          numHits += cellId >= 0;
+        }
+        if (numHits == 0 || tree->GetLevel() < 2)
+        {
+          std::cerr << "Error: no intersection with " << input->GetClassName()
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkOBBTree> tree = BuildTree(input, maxLevel);
+        if (Results(tree, p1s, p2s) != reference)
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different tree of " << input->GetClassName()
+                    << " with " << maxLevel << " levels" << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded vtkTableBasedClipDataSet gives exactly the
+// same output as a serial execution, for images, structured grids and
+// unstructured grids, including one with split cell storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkImageDataToPointSet.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+#include <vtkTableBasedClipDataSet.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+// The wavelet, with a cell attribute.
+vtkSmartPointer<vtkImageData> ConstructImage(int zMin, int zMax)
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-10, 10, -10, 10, zMin, zMax);
+  source->Update();
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->ShallowCopy(source->GetOutput());
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->SetNumberOfComponents(2);
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    cellValues->InsertNextTuple2(cellId, cellId % 7);
+  }
+  image->GetCellData()->AddArray(cellValues);
+  return image;
+}
+
+// Split the cells of the wavelet into cells of all the types handled by the
+// clipping tables.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid(vtkImageData *image)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->SetPoint(ptId, image->GetPoint(ptId));
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+
+  vtkNew<vtkIdList> ids;
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  grid->Allocate(image->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, ids);
+    const vtkIdType *v = ids->GetPointer(0);
+    const vtkIdType c[8] = { v[0], v[1], v[3], v[2], v[4], v[5], v[7], v[6] };
+    switch (cellId % 7)
+    {
+      case 0:
+        grid->InsertNextCell(VTK_VOXEL, ids);
+        break;
+      case 1:
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+        break;
+      case 2:
+      {
+        const vtkIdType wedge1[6] = { c[0], c[1], c[3], c[4], c[5], c[7] };
+        const vtkIdType wedge2[6] = { c[1], c[2], c[3], c[5], c[6], c[7] };
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+        break;
+      }
+      case 3:
+      {
+        const vtkIdType pyramid[5] = { c[0], c[1], c[2], c[3], c[6] };
+        const vtkIdType tetra1[4] = { c[0], c[6], c[7], c[3] };
+        const vtkIdType tetra2[4] = { c[0], c[5], c[6], c[1] };
+        const vtkIdType tetra3[4] = { c[0], c[4], c[5], c[6] };
+        const vtkIdType tetra4[4] = { c[0], c[7], c[6], c[4] };
+        grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+        grid->InsertNextCell(VTK_TETRA, 4, tetra1);
+        grid->InsertNextCell(VTK_TETRA, 4, tetra2);
+        grid->InsertNextCell(VTK_TETRA, 4, tetra3);
+        grid->InsertNextCell(VTK_TETRA, 4, tetra4);
+        break;
+      }
+      case 4:
+        grid->InsertNextCell(VTK_QUAD, 4, c);
+        grid->InsertNextCell(VTK_PIXEL, 4, v + 4);
+        break;
+      case 5:
+        grid->InsertNextCell(VTK_TRIANGLE, 3, c);
+        grid->InsertNextCell(VTK_LINE, 2, c + 5);
+        break;
+      default:
+        grid->InsertNextCell(VTK_VERTEX, 1, c + 6);
+    }
+    while (cellValues->GetNumberOfTuples() < grid->GetNumberOfCells())
+    {
+      cellValues->InsertNextValue(static_cast<int>(cellId));
+    }
+  }
+  grid->GetCellData()->AddArray(cellValues);
+  return grid;
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkUnstructuredGrid *output1, vtkUnstructuredGrid *output2)
+{
+  return output1->GetNumberOfCells() == output2->GetNumberOfCells() &&
+    SameArrays(output1->GetPoints()->GetData(),
+               output2->GetPoints()->GetData()) &&
+    SameArrays(output1->GetCells()->GetData(),
+               output2->GetCells()->GetData()) &&
+    SameArrays(output1->GetCellTypesArray(), output2->GetCellTypesArray()) &&
+    SameArrays(output1->GetCellLocationsArray(),
+               output2->GetCellLocationsArray()) &&
+    SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+
+// Clip the input, and return the output followed by the clipped output.
+void Clip(vtkDataSet *input, int options,
+          vtkSmartPointer<vtkUnstructuredGrid> outputs[2])
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.5, 0.25, 0.125);
+  plane->SetNormal(1.0, 2.0, 3.0);
+
+  vtkNew<vtkTableBasedClipDataSet> clip;
+  clip->SetInputData(input);
+  if (options & 1)
+  {
+    clip->SetClipFunction(plane);
+    clip->SetGenerateClipScalars((options >> 2) & 1);
+  }
+  else
+  {
+    clip->SetValue(150.0);
+  }
+  clip->SetInsideOut((options >> 1) & 1);
+  clip->GenerateClippedOutputOn();
+  clip->Update();
+
+  outputs[0] = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  outputs[0]->DeepCopy(clip->GetOutput());
+  outputs[1] = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  outputs[1]->DeepCopy(clip->GetClippedOutput());
+}
+}
+
+int TestTableBasedClipDataSetSMP(int, char *[])
+{
+  vtkSmartPointer<vtkImageData> image = ConstructImage(-10, 10);
+  vtkSmartPointer<vtkImageData> slice = ConstructImage(0, 0);
+  vtkNew<vtkImageDataToPointSet> toPointSet;
+  toPointSet->SetInputData(image);
+  toPointSet->Update();
+  vtkSmartPointer<vtkStructuredGrid> structured = toPointSet->GetOutput();
+  vtkSmartPointer<vtkUnstructuredGrid> unstructured = ConstructGrid(image);
+  vtkNew<vtkUnstructuredGrid> splitUnstructured;
+  splitUnstructured->DeepCopy(unstructured);
+  splitUnstructured->GetCells()->SetStorageMode(
+    vtkCellArray::SPLIT_STORAGE_32BIT);
+  vtkDataSet *inputs[] = { image, slice, structured, unstructured,
+                           splitUnstructured };
+
+  for (vtkDataSet *input : inputs)
+  {
+    for (int options = 0; options < 8; ++options)
+    {
+      vtkSmartPointer<vtkUnstructuredGrid> references[2];
+      auto computeReference = [&]()
+      {
+        Clip(input, options, references);
+        if (references[0]->GetNumberOfCells() == 0 ||
+            references[1]->GetNumberOfCells() == 0)
+        {
+          std::cerr << "Error: nothing was clipped from a "
+                    << input->GetClassName() << " with options " << options
+                    << std::endl;
+          return false;
+        }
+        return true;
+      };
+      auto compare = [&](const char *backend)
+      {
+        vtkSmartPointer<vtkUnstructuredGrid> outputs[2];
+        Clip(input, options, outputs);
+        if (!SameOutputs(references[0], outputs[0]) ||
+            !SameOutputs(references[1], outputs[1]))
+        {
+          std::cerr << "Error: the " << backend << " backend gives a "
+                    << "different result for a " << input->GetClassName()
+                    << " with options " << options << std::endl;
+          return false;
+        }
+        return true;
+      };
+      if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
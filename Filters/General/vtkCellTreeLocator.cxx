@@ -29,6 +29,10 @@
 #include "vtkPolyData.h"
 #include "vtkBoundingBox.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 vtkStandardNewMacro(vtkCellTreeLocator);
 
@@ -279,16 +283,29 @@ class vtkCellTreeBuilder
 
     // -------------------------------------------------------------------------
 
-    void Split( unsigned int index, float min[3], float max[3] )
+    // A node holding at least m_leafsize cells, waiting to be split, with
+    // the bounds of its cells.
+    struct PendingNode
     {
-      unsigned int start = this->m_nodes[index].Start();
-      unsigned int size  = this->m_nodes[index].Size();
+      unsigned int Index;
+      float Min[3];
+      float Max[3];
+    };
 
-      if( size < this->m_leafsize )
-      {
-        return;
-      }
+    // Where a node is split, and the bounds of the cells of its children.
+    struct NodeSplit
+    {
+      unsigned int Dim;
+      unsigned int Mid;
+      float LMin[3], LMax[3], RMin[3], RMax[3];
+    };
 
+    // Partition the cells of a node between its two children. Only the
+    // cells of the node are moved, so that the nodes of a level of the tree
+    // are split concurrently.
+    void Split( unsigned int start, unsigned int size,
+      const float min[3], const float max[3], NodeSplit& split )
+    {
       PerCell* begin = &(this->m_pc[start]);
       PerCell* end   = &(this->m_pc[0])+start + size;
       PerCell* mid = begin;
@@ -388,22 +405,43 @@ class vtkCellTreeBuilder
         std::nth_element( begin, mid, end, CenterOrder( dim ) );
       }
 
-      float lmin[3], lmax[3], rmin[3], rmax[3];
+      FindMinMax( begin, mid, split.LMin, split.LMax );
+      FindMinMax( mid,   end, split.RMin, split.RMax );
 
-      FindMinMax( begin, mid, lmin, lmax );
-      FindMinMax( mid,   end, rmin, rmax );
+      split.Dim = dim;
+      split.Mid = mid - &(this->m_pc[0]);
+    }
 
-      float clip[2] = { lmax[dim], rmin[dim]};
+    // Add the children of a split node, and queue those holding enough
+    // cells to be split in turn.
+    void AddChildren( const PendingNode& node, const NodeSplit& split,
+      std::vector<PendingNode>& pending )
+    {
+      const unsigned int start = this->m_nodes[node.Index].Start();
+      const unsigned int end = start + this->m_nodes[node.Index].Size();
+      float clip[2] = { split.LMax[split.Dim], split.RMin[split.Dim] };
 
       vtkCellTreeLocator::vtkCellTreeNode child[2];
-      child[0].MakeLeaf( begin - &(this->m_pc[0]), mid-begin );
-      child[1].MakeLeaf( mid   - &(this->m_pc[0]), end-mid );
+      child[0].MakeLeaf( start, split.Mid-start );
+      child[1].MakeLeaf( split.Mid, end-split.Mid );
 
-      this->m_nodes[index].MakeNode( (int)m_nodes.size(), dim, clip );
+      const unsigned int left = static_cast<unsigned int>(this->m_nodes.size());
+      this->m_nodes[node.Index].MakeNode( left, split.Dim, clip );
       this->m_nodes.insert( m_nodes.end(), child, child+2 );
 
-      Split( this->m_nodes[index].GetLeftChildIndex(), lmin, lmax );
-      Split( this->m_nodes[index].GetRightChildIndex(), rmin, rmax );
+      const float* bounds[2][2] =
+        { { split.LMin, split.LMax }, { split.RMin, split.RMax } };
+      for( unsigned int i=0; i<2; ++i )
+      {
+        if( child[i].Size() >= this->m_leafsize && child[i].Size() > 1 )
+        {
+          PendingNode pendingChild;
+          pendingChild.Index = left+i;
+          std::copy( bounds[i][0], bounds[i][0]+3, pendingChild.Min );
+          std::copy( bounds[i][1], bounds[i][1]+3, pendingChild.Max );
+          pending.push_back( pendingChild );
+        }
+      }
     }
 
   public:
@@ -417,7 +455,6 @@ class vtkCellTreeBuilder
     void Build( vtkCellTreeLocator *ctl, vtkCellTreeLocator::vtkCellTree& ct, vtkDataSet* ds )
     {
       const vtkIdType size = ds->GetNumberOfCells();
-      double cellBounds[6];
       this->m_pc.resize(size);
 
       float min[3] =
@@ -434,36 +471,42 @@ class vtkCellTreeBuilder
         -std::numeric_limits<float>::max(),
         };
 
-      for( vtkIdType i=0; i<size; ++i )
+      // The bounds of the cells are computed concurrently when the dataset
+      // can be shared by several threads.
+      auto computeBounds = [&](vtkIdType i, vtkIdType end)
       {
-        this->m_pc[i].Ind = i;
-
-        double *boundsPtr = cellBounds;
-        if (ctl->CellBounds)
-        {
-          boundsPtr = ctl->CellBounds[i];
-        }
-        else
-        {
-          ds->GetCellBounds(i, boundsPtr);
-        }
-
-        for( int d=0; d<3; ++d )
+        double cellBounds[6];
+        for( ; i<end; ++i )
         {
-          this->m_pc[i].Min[d] = boundsPtr[2*d+0];
-          this->m_pc[i].Max[d] = boundsPtr[2*d+1];
+          this->m_pc[i].Ind = i;
 
-          if( this->m_pc[i].Min[d] < min[d] )
+          double *boundsPtr = cellBounds;
+          if (ctl->CellBounds)
+          {
+            boundsPtr = ctl->CellBounds[i];
+          }
+          else
           {
-            min[d] = this->m_pc[i].Min[d];
+            ds->GetCellBounds(i, boundsPtr);
           }
 
-          if( this->m_pc[i].Max[d] > max[d] )  /// This can be m_pc[i].max[d] instead of min
+          for( int d=0; d<3; ++d )
           {
-            max[d] = this->m_pc[i].Max[d];
+            this->m_pc[i].Min[d] = boundsPtr[2*d+0];
+            this->m_pc[i].Max[d] = boundsPtr[2*d+1];
           }
         }
+      };
+      if ( ds->SupportsConcurrentReads() )
+      {
+        ds->PrepareForConcurrentReads();
+        vtkSMPTools::For(0, size, computeBounds);
+      }
+      else
+      {
+        computeBounds(0, size);
       }
+      FindMinMax( &(this->m_pc[0]), &(this->m_pc[0]) + size, min, max );
 
       ct.DataBBox[0] = min[0];
       ct.DataBBox[1] = max[0];
@@ -476,7 +519,42 @@ class vtkCellTreeBuilder
       root.MakeLeaf( 0, size );
       this->m_nodes.push_back( root );
 
-      Split( 0, min, max );
+      // Split the tree one level at a time, the nodes of a level being split
+      // concurrently. The nodes are renumbered below in an order that only
+      // depends on the shape of the tree, which is the same as with a
+      // recursive depth-first splitting.
+      std::vector<PendingNode> level, nextLevel;
+      if( size >= this->m_leafsize && size > 1 )
+      {
+        PendingNode pendingRoot;
+        pendingRoot.Index = 0;
+        std::copy( min, min+3, pendingRoot.Min );
+        std::copy( max, max+3, pendingRoot.Max );
+        level.push_back( pendingRoot );
+      }
+      std::vector<NodeSplit> splits;
+      while( !level.empty() )
+      {
+        splits.resize( level.size() );
+        vtkSMPTools::For(0, static_cast<vtkIdType>(level.size()),
+          [&](vtkIdType i, vtkIdType end)
+          {
+            for( ; i<end; ++i )
+            {
+              const vtkCellTreeLocator::vtkCellTreeNode& node =
+                this->m_nodes[level[i].Index];
+              this->Split( node.Start(), node.Size(), level[i].Min,
+                level[i].Max, splits[i] );
+            }
+          });
+
+        nextLevel.clear();
+        for( size_t i=0; i<level.size(); ++i )
+        {
+          this->AddChildren( level[i], splits[i], nextLevel );
+        }
+        level.swap( nextLevel );
+      }
 
       ct.Nodes.resize( this->m_nodes.size() );
       ct.Nodes[0] = this->m_nodes[0];
@@ -640,6 +718,51 @@ vtkIdType vtkCellTreeLocator::FindCell( double pos[3], double , vtkGenericCell *
   return -1;
 }
 
+//----------------------------------------------------------------------------
+void vtkCellTreeLocator::FindCells(vtkPoints *points, vtkIdList *cellIds)
+{
+  this->BuildLocatorIfNeeded();
+
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numPts);
+  vtkIdType *ids = cellIds->GetPointer(0);
+  if( this->Tree == nullptr )
+  {
+    std::fill_n( ids, numPts, -1 );
+    return;
+  }
+  if( numPts == 0 )
+  {
+    return;
+  }
+
+  // Each thread evaluates the cells with its own generic cell and weights.
+  const int maxCellSize = std::max(this->DataSet->GetMaxCellSize(), 1);
+  vtkSMPThreadLocalObject<vtkGenericCell> threadCell;
+  vtkSMPThreadLocal<std::vector<double> > threadWeights;
+  auto findCells = [&](vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkGenericCell *cell = threadCell.Local();
+    std::vector<double>& weights = threadWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pcoords[3];
+    for( ; ptId<endPtId; ++ptId )
+    {
+      points->GetPoint(ptId, x);
+      ids[ptId] = this->FindCell(x, 0.0, cell, pcoords, weights.data());
+    }
+  };
+  if( this->DataSet->SupportsConcurrentReads() )
+  {
+    this->DataSet->PrepareForConcurrentReads();
+    vtkSMPTools::For(0, numPts, findCells);
+  }
+  else
+  {
+    findCells(0, numPts);
+  }
+}
+
 //----------------------------------------------------------------------------
 
 namespace
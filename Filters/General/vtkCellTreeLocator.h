@@ -28,6 +28,12 @@
  * Some methods in building and traversing the cell tree in this class were derived
  * avtCellLocatorBIH class in the VisIT Visualization Tool
  *
+ * The bounds of the cells are computed with vtkSMPTools, and the tree is
+ * split one level at a time, the nodes of a level being split concurrently.
+ * The tree does not depend on the number of threads. The cells of datasets
+ * that cannot be read by several threads, such as polydata or unstructured
+ * grids with split cell storage, are processed serially.
+ *
  *
  *
  * @sa
@@ -44,6 +50,8 @@
 class vtkCellPointTraversal;
 class vtkIdTypeArray;
 class vtkCellArray;
+class vtkIdList;
+class vtkPoints;
 
 class VTKFILTERSGENERAL_EXPORT vtkCellTreeLocator : public vtkAbstractCellLocator
 {
@@ -67,6 +75,14 @@ class VTKFILTERSGENERAL_EXPORT vtkCellTreeLocator : public vtkAbstractCellLocato
     vtkIdType FindCell(double pos[3], double vtkNotUsed, vtkGenericCell *cell,  double pcoords[3],
                        double* weights ) override;
 
+    /**
+     * Find the cell containing each of the given points, as FindCell() does,
+     * and store its id, or -1 when the point is outside of the cells, in
+     * cellIds. The points are located concurrently with vtkSMPTools, each
+     * thread evaluating the cells with its own vtkGenericCell.
+     */
+    void FindCells(vtkPoints *points, vtkIdList *cellIds);
+
     /**
      * Return intersection point (if any) AND the cell which was intersected by
      * the finite line. The cell is returned as a cell id and as a generic cell.
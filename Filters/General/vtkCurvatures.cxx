@@ -27,8 +27,12 @@
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkCurvatures);
 
 //-------------------------------------------------------//
@@ -388,6 +392,264 @@ void vtkCurvatures::GetMinimumCurvature(vtkPolyData *input,vtkPolyData *output)
   }
 }
 
+//-------------------------------------------------------
+bool vtkCurvatures::ComputeCurvaturesInParallel(vtkPolyData *output)
+{
+  // Only meshes made of polygons with at least three points, the serial
+  // code reading three points per facet, are processed here. Their
+  // connectivity is read directly in the legacy layout.
+  vtkCellArray *polys = output->GetPolys();
+  const vtkIdType numPolys = polys->GetNumberOfCells();
+  const vtkIdType numPts = output->GetNumberOfPoints();
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 ||
+       this->CurvatureType < VTK_CURVATURE_GAUSS ||
+       this->CurvatureType > VTK_CURVATURE_MINIMUM ||
+       numPolys == 0 || numPts == 0 ||
+       output->GetNumberOfCells() != numPolys ||
+       polys->GetStorageMode() != vtkCellArray::LEGACY_STORAGE )
+  {
+    return false;
+  }
+
+  // Where the polygons and their edges start.
+  std::vector<vtkIdType> edgeOffsets(numPolys + 1);
+  const vtkIdType *conn = polys->GetPointer();
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numPolys; ++cellId)
+  {
+    if ( conn[loc] < 3 )
+    {
+      return false;
+    }
+    edgeOffsets[cellId] = loc - cellId;
+    loc += conn[loc] + 1;
+  }
+  edgeOffsets[numPolys] = loc - numPolys;
+  const vtkIdType numEdges = edgeOffsets[numPolys];
+
+  vtkDebugMacro("Start vtkCurvatures::ComputeCurvaturesInParallel");
+
+  // The cells using each point, shared by all the curvatures and kept by
+  // the output.
+  output->BuildLinks();
+
+  // First pass over the facets: the area and the angles of each facet for
+  // the Gauss curvature, and the weighted dihedral angle of each edge having
+  // a single neighbour of larger id for the mean curvature.
+  const bool gauss = this->CurvatureType != VTK_CURVATURE_MEAN;
+  const bool mean = this->CurvatureType != VTK_CURVATURE_GAUSS;
+  std::vector<double> facetAngles(gauss ? 4 * numPolys : 0);
+  std::vector<double> edgeCurvatures(mean ? numEdges : 0);
+  std::vector<char> curvedEdges(mean ? numEdges : 0);
+  vtkSMPTools::For(0, numPolys, [&](vtkIdType cellId, vtkIdType endCellId)
+  {
+    double v0[3], v1[3], v2[3], e0[3], e1[3], e2[3];
+    double n_f[3], n_n[3], t[3], ore[3], end[3], oth[3], e[3];
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *pts = conn + edgeOffsets[cellId] + cellId + 1;
+      const int nv = static_cast<int>(pts[-1]);
+      if ( gauss )
+      {
+        output->GetPoint(pts[0],v0);
+        output->GetPoint(pts[1],v1);
+        output->GetPoint(pts[2],v2);
+        e0[0] = v1[0] - v0[0]; e0[1] = v1[1] - v0[1]; e0[2] = v1[2] - v0[2];
+        e1[0] = v2[0] - v1[0]; e1[1] = v2[1] - v1[1]; e1[2] = v2[2] - v1[2];
+        e2[0] = v0[0] - v2[0]; e2[1] = v0[1] - v2[1]; e2[2] = v0[2] - v2[2];
+        vtkMath::Normalize(e0); vtkMath::Normalize(e1); vtkMath::Normalize(e2);
+        double ac1 = vtkMath::Dot(e1,e2);
+        double ac2 = vtkMath::Dot(e2,e0);
+        double ac3 = vtkMath::Dot(e0,e1);
+        double *facet = facetAngles.data() + 4 * cellId;
+        facet[0] = vtkTriangle::TriangleArea(v0,v1,v2);
+        facet[1] = acos(-CLAMP_MACRO(ac1));
+        facet[2] = acos(-CLAMP_MACRO(ac2));
+        facet[3] = acos(-CLAMP_MACRO(ac3));
+      }
+      if ( !mean )
+      {
+        continue;
+      }
+      for (int v = 0; v < nv; v++)
+      {
+        const vtkIdType v_l = pts[v];
+        const vtkIdType v_r = pts[(v+1) % nv];
+        const vtkIdType v_o = pts[(v+2) % nv];
+
+        // Count the neighbours as GetCellEdgeNeighbors() does.
+        vtkIdType numCells_l, numCells_r, *cells_l, *cells_r;
+        output->GetPointCells(v_l, numCells_l, cells_l);
+        output->GetPointCells(v_r, numCells_r, cells_r);
+        vtkIdType *cells_rEnd = cells_r + numCells_r;
+        vtkIdType numNeighbours = 0, n = -1;
+        for (vtkIdType i = 0; i < numCells_l; ++i)
+        {
+          if ( cells_l[i] != cellId &&
+               std::find(cells_r, cells_rEnd, cells_l[i]) != cells_rEnd )
+          {
+            ++numNeighbours;
+            n = cells_l[i];
+          }
+        }
+        const vtkIdType edgeId = edgeOffsets[cellId] + v;
+        if ( numNeighbours != 1 || n <= cellId )
+        {
+          continue;
+        }
+
+        output->GetPoint(v_l,ore);
+        output->GetPoint(v_r,end);
+        output->GetPoint(v_o,oth);
+        vtkTriangle::ComputeNormal(ore,end,oth,n_f);
+        e[0] = end[0] - ore[0]; e[1] = end[1] - ore[1]; e[2] = end[2] - ore[2];
+        double length = double(vtkMath::Normalize(e));
+        double Af = double(vtkTriangle::TriangleArea(ore,end,oth));
+        const vtkIdType *ptsN = conn + edgeOffsets[n] + n + 1;
+        output->GetPoint(ptsN[0],v0);
+        output->GetPoint(ptsN[1],v1);
+        output->GetPoint(ptsN[2],v2);
+        Af += double(vtkTriangle::TriangleArea(v0,v1,v2));
+        vtkTriangle::ComputeNormal(v0,v1,v2,n_n);
+        double cs = double(vtkMath::Dot(n_f,n_n));
+        vtkMath::Cross(n_f,n_n,t);
+        double sn = double(vtkMath::Dot(t,e));
+        double Hf = 0.0;
+        if (sn!=0.0 || cs!=0.0)
+        {
+          Hf = length*atan2(sn,cs);
+        }
+        if (Af!=0.0)
+        {
+          (Hf /= Af) *=3.0;
+        }
+        edgeCurvatures[edgeId] = Hf;
+        curvedEdges[edgeId] = 1;
+      }
+    }
+  });
+
+  vtkDoubleArray *gaussCurvature = nullptr;
+  vtkDoubleArray *meanCurvature = nullptr;
+  vtkDoubleArray *principalCurvature = nullptr;
+  if ( gauss )
+  {
+    gaussCurvature = vtkDoubleArray::New();
+    gaussCurvature->SetName("Gauss_Curvature");
+    gaussCurvature->SetNumberOfTuples(numPts);
+  }
+  if ( mean )
+  {
+    meanCurvature = vtkDoubleArray::New();
+    meanCurvature->SetName("Mean_Curvature");
+    meanCurvature->SetNumberOfTuples(numPts);
+  }
+  if ( gauss && mean )
+  {
+    principalCurvature = vtkDoubleArray::New();
+    principalCurvature->SetName(
+      this->CurvatureType == VTK_CURVATURE_MAXIMUM ?
+      "Maximum_Curvature" : "Minimum_Curvature");
+    principalCurvature->SetNumberOfTuples(numPts);
+  }
+
+  // Second pass over the points. The links list the cells in increasing
+  // order, so that the contributions are summed in the order of the serial
+  // passes over the facets.
+  const double pi2 = 2.0*vtkMath::Pi();
+  const double sign = this->CurvatureType == VTK_CURVATURE_MINIMUM ? -1.0 : 1.0;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      double K = pi2, dA = 0.0, H = 0.0;
+      int numNeighbours = 0;
+      vtkIdType numCells, *cells;
+      output->GetPointCells(ptId, numCells, cells);
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        const vtkIdType cellId = cells[i];
+        if ( i > 0 && cells[i-1] == cellId )
+        {
+          continue; // the point is repeated in the facet
+        }
+        const vtkIdType *pts = conn + edgeOffsets[cellId] + cellId + 1;
+        const int nv = static_cast<int>(pts[-1]);
+        if ( gauss )
+        {
+          const double *facet = facetAngles.data() + 4 * cellId;
+          for (int j = 0; j < 3; ++j)
+          {
+            if ( pts[j] == ptId )
+            {
+              dA += facet[0];
+              K -= facet[1 + (j+1) % 3];
+            }
+          }
+        }
+        if ( mean )
+        {
+          for (int v = 0; v < nv; v++)
+          {
+            const vtkIdType edgeId = edgeOffsets[cellId] + v;
+            if ( !curvedEdges[edgeId] )
+            {
+              continue;
+            }
+            if ( pts[v] == ptId )
+            {
+              H += edgeCurvatures[edgeId];
+              ++numNeighbours;
+            }
+            if ( pts[(v+1) % nv] == ptId )
+            {
+              H += edgeCurvatures[edgeId];
+              ++numNeighbours;
+            }
+          }
+        }
+      }
+
+      double k = 0.0, h = 0.0;
+      if ( gauss )
+      {
+        k = dA > 0.0 ? 3.0*K/dA : 0.0;
+        gaussCurvature->SetValue(ptId, k);
+      }
+      if ( mean )
+      {
+        if ( numNeighbours > 0 )
+        {
+          const double Hf = 0.5*H/numNeighbours;
+          h = this->InvertMeanCurvature ? -Hf : Hf;
+        }
+        meanCurvature->SetValue(ptId, h);
+      }
+      if ( principalCurvature )
+      {
+        // Undefined principal curvatures are set to 0.
+        const double tmp = h*h - k;
+        principalCurvature->SetValue(ptId, tmp >= 0 ? h + sign*sqrt(tmp) : 0);
+      }
+    }
+  });
+
+  vtkDataArray *curvatures[3] =
+    { gaussCurvature, meanCurvature, principalCurvature };
+  for (vtkDataArray *curvature : curvatures)
+  {
+    if ( curvature )
+    {
+      output->GetPointData()->AddArray(curvature);
+      output->GetPointData()->SetActiveScalars(curvature->GetName());
+      curvature->Delete();
+    }
+  }
+
+  vtkDebugMacro("Set Values of Curvatures: Done");
+  return true;
+}
+
 //-------------------------------------------------------
 int vtkCurvatures::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -419,7 +681,11 @@ int vtkCurvatures::RequestData(
   //    Set Curvatures as PointData Scalars                //
   //-------------------------------------------------------//
 
-  if ( this->CurvatureType == VTK_CURVATURE_GAUSS )
+  if ( this->ComputeCurvaturesInParallel(output) )
+  {
+    return 1;
+  }
+  else if ( this->CurvatureType == VTK_CURVATURE_GAUSS )
   {
     this->GetGaussCurvature(output);
   }
@@ -51,6 +51,17 @@
  * of opposite senses then the flag InvertMeanCurvature can be set and the
  * Curvature reported by the Mean calculation will be inverted.
  *
+ * When more than one thread is available, the links from the points to the
+ * cells are built once on the output, shared by all the curvatures, and kept
+ * by the output so that the neighbourhood of each point can be reused
+ * downstream through vtkPolyData::GetPointCells() and GetCellEdgeNeighbors()
+ * without calling BuildLinks() again. The facet angles and the edge terms
+ * are then computed with vtkSMPTools, and the Gauss, mean and principal
+ * curvatures of each point are summed in a single pass over the points, in
+ * the same order as the serial code.
+ * Meshes with vertices, lines, strips or facets with less than three points
+ * are processed serially.
+ *
  * @par Thanks:
  * Philip Batchelor philipp.batchelor@kcl.ac.uk for creating and contributing
  * the class and Andrew Maclean a.maclean@acfr.usyd.edu.au for cleanups and
@@ -139,6 +150,13 @@ protected:
    */
   void GetMinimumCurvature(vtkPolyData *input, vtkPolyData *output);
 
+  /**
+   * Multi-threaded computation of the curvatures of output, which must be
+   * made of polygons only. Return false, without touching the output, when
+   * the curvatures have to be computed serially.
+   */
+  bool ComputeCurvaturesInParallel(vtkPolyData *output);
+
 
   // Vars
   int CurvatureType;
@@ -20,11 +20,14 @@
 
 #include "vtkGradientFilter.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -35,11 +38,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -59,7 +67,7 @@ namespace
 // with the vorticity/curl of that vector
 //-----------------------------------------------------------------------------
   template<class data_type>
-  void ComputeVorticityFromGradient(data_type* gradients, data_type* vorticity)
+  void ComputeVorticityFromGradient(const data_type* gradients, data_type* vorticity)
   {
     vorticity[0] = gradients[7] - gradients[5];
     vorticity[1] = gradients[2] - gradients[6];
@@ -67,13 +75,13 @@ namespace
   }
 
   template<class data_type>
-  void ComputeDivergenceFromGradient(data_type* gradients, data_type* divergence)
+  void ComputeDivergenceFromGradient(const data_type* gradients, data_type* divergence)
   {
     divergence[0] = gradients[0]+gradients[4]+gradients[8];
   }
 
   template<class data_type>
-  void ComputeQCriterionFromGradient(data_type* gradients, data_type* qCriterion)
+  void ComputeQCriterionFromGradient(const data_type* gradients, data_type* qCriterion)
   {
     // see http://public.kitware.com/pipermail/paraview/2015-May/034233.html for
     // paper citation and formula on Q-criterion.
@@ -91,7 +99,7 @@ namespace
 
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
-    double parametricCoord[3]);
+    double parametricCoord[3], std::vector<double> &weights);
 
   template<class data_type>
   void ComputeCellGradientsUG(
@@ -120,25 +128,6 @@ namespace
     return false;
   }
 
-  // generic way to get the coordinate for either a cell (using
-  // the parametric center) or a point
-  void GetGridEntityCoordinate(vtkDataSet* grid, int fieldAssociation,
-                               vtkIdType index, double coords[3])
-  {
-    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-    {
-      grid->GetPoint(index, coords);
-    }
-    else
-    {
-      vtkCell* cell = grid->GetCell(index);
-      double pcoords[3];
-      int subId = cell->GetParametricCenter(pcoords);
-      std::vector<double> weights(cell->GetNumberOfPoints()+1);
-      cell->EvaluateLocation(subId, pcoords, coords, &weights[0]);
-    }
-  }
-
   template<class data_type>
   void Fill(vtkDataArray* array, data_type vtkNotUsed(data), int replacementValueOption)
   {
@@ -849,125 +838,263 @@ int vtkGradientFilter::GetOutputArrayType(vtkDataArray* array)
 
 namespace {
 //-----------------------------------------------------------------------------
+  // Fetch the values of all the components of the array at the points of a
+  // cell, interleaved as expected by vtkCell::Derivatives().
+  template<class ArrayT>
+  void GetCellValues(vtkDataArrayAccessor<ArrayT> &array, vtkCell *cell,
+                     int numberOfInputComponents, std::vector<double> &values)
+  {
+    const int numberOfCellPoints = cell->GetNumberOfPoints();
+    values.resize(numberOfCellPoints*numberOfInputComponents);
+    double *value = values.data();
+    for (int i = 0; i < numberOfCellPoints; i++)
+    {
+      const vtkIdType pointId = cell->GetPointId(i);
+      for (int inputComponent = 0; inputComponent < numberOfInputComponents;
+           inputComponent++)
+      {
+        *value++ = static_cast<double>(array.Get(pointId, inputComponent));
+      }
+    }
+  }
+
   template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence, int highestCellDimension, int contributingCellOption)
+  void ComputeQuantitiesFromGradient(const std::vector<data_type> &g,
+    vtkIdType index, int numberOfInputComponents, data_type *gradients,
+    data_type* vorticity, data_type* qCriterion, data_type* divergence)
   {
-    vtkNew<vtkIdList> currentPoint;
-    currentPoint->SetNumberOfIds(1);
-    vtkNew<vtkIdList> cellsOnPoint;
+    const data_type *gradient = g.data();
+    if(vorticity)
+    {
+      ComputeVorticityFromGradient(gradient, vorticity+3*index);
+    }
+    if(qCriterion)
+    {
+      ComputeQCriterionFromGradient(gradient, qCriterion+index);
+    }
+    if(divergence)
+    {
+      ComputeDivergenceFromGradient(gradient, divergence+index);
+    }
+    if(gradients)
+    {
+      std::copy(g.begin(), g.end(),
+                gradients+index*3*numberOfInputComponents);
+    }
+  }
 
-    vtkIdType numpts = structure->GetNumberOfPoints();
+  // The gradient, vorticity, Q-criterion and divergence of unstructured data
+  // are computed in a single pass over its points or cells. Unstructured
+  // grids without polyhedra and polydata are processed with several threads,
+  // their point to cells links being given by a vtkStaticCellLinks. The other
+  // datasets are processed serially.
+  template<class data_type>
+  struct GradientsUG
+  {
+    vtkDataSet *Structure;
+    int NumberOfInputComponents;
+    data_type *Gradients;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    int HighestCellDimension;
+    int ContributingCellOption;
+    vtkStaticCellLinks *Links;
+
+    bool IsThreadSafe() const
+    {
+      vtkUnstructuredGrid *grid =
+        vtkUnstructuredGrid::SafeDownCast(this->Structure);
+      return this->Structure->SupportsConcurrentReads() &&
+        !(grid && grid->GetFaces());
+    }
+
+    template<class Functor>
+    void Execute(vtkIdType n, Functor &functor)
+    {
+      if (this->IsThreadSafe())
+      {
+        vtkSMPTools::For(0, n, functor);
+      }
+      else
+      {
+        functor(0, n);
+      }
+    }
+  };
 
-    int numberOfOutputComponents = 3*numberOfInputComponents;
-    std::vector<data_type> g(numberOfOutputComponents);
+  // Gradients at the points, averaging the derivatives of the cells using
+  // each point.
+  template<class ArrayT, class data_type>
+  struct PointGradientsUG
+  {
+    const GradientsUG<data_type> &Parameters;
+    ArrayT *Array;
 
-    // if we are doing patches for contributing cell dimensions we want to keep track of
-    // the maximum expected dimension so we can exit out of the check loop quicker
-    const int maxCellDimension = structure->IsA("vtkPolyData") ? 2 : 3;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocalObject<vtkIdList> CurrentPoint;
+    vtkSMPThreadLocalObject<vtkIdList> CellsOnPoint;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
 
-    for (vtkIdType point = 0; point < numpts; point++)
+    PointGradientsUG(const GradientsUG<data_type> &parameters, ArrayT *array)
+      : Parameters(parameters), Array(array)
     {
-      currentPoint->SetId(0, point);
-      double pointcoords[3];
-      structure->GetPoint(point, pointcoords);
-      // Get all cells touching this point.
-      structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
-      vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
+    }
 
-      for(int i=0;i<numberOfOutputComponents;i++)
+    // Get the cells using a point, in increasing order.
+    void GetCellsOnPoint(vtkIdType point, vtkIdList *cellsOnPoint)
+    {
+      vtkStaticCellLinks *links = this->Parameters.Links;
+      if (links)
       {
-        g[i] = 0;
+        const vtkIdType numCells = links->GetNcells(point);
+        const vtkIdType *cells = links->GetCells(point);
+        cellsOnPoint->SetNumberOfIds(numCells);
+        std::copy(cells, cells + numCells, cellsOnPoint->GetPointer(0));
       }
+      else
+      {
+        vtkIdList *currentPoint = this->CurrentPoint.Local();
+        currentPoint->SetNumberOfIds(1);
+        currentPoint->SetId(0, point);
+        this->Parameters.Structure->GetCellNeighbors(-1, currentPoint,
+                                                     cellsOnPoint);
+      }
+    }
 
-      if (contributingCellOption == vtkGradientFilter::Patch)
+    void operator()(vtkIdType point, vtkIdType endPoint)
+    {
+      const GradientsUG<data_type> &p = this->Parameters;
+      vtkDataSet *structure = p.Structure;
+      vtkGenericCell *cell = this->Cell.Local();
+      vtkIdList *cellsOnPoint = this->CellsOnPoint.Local();
+      std::vector<double> &values = this->Values.Local();
+      std::vector<double> &weights = this->Weights.Local();
+      vtkDataArrayAccessor<ArrayT> array(this->Array);
+
+      const int numberOfOutputComponents = 3*p.NumberOfInputComponents;
+      std::vector<data_type> g(numberOfOutputComponents);
+      std::vector<double> derivative(numberOfOutputComponents);
+
+      // if we are doing patches for contributing cell dimensions we want to keep track of
+      // the maximum expected dimension so we can exit out of the check loop quicker
+      const int maxCellDimension = structure->IsA("vtkPolyData") ? 2 : 3;
+
+      for ( ; point < endPoint; point++)
       {
-        highestCellDimension = 0;
-        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        double pointcoords[3];
+        structure->GetPoint(point, pointcoords);
+        // Get all cells touching this point.
+        this->GetCellsOnPoint(point, cellsOnPoint);
+        vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
+
+        std::fill(g.begin(), g.end(), 0);
+
+        int highestCellDimension = p.HighestCellDimension;
+        if (p.ContributingCellOption == vtkGradientFilter::Patch)
         {
-          int cellDimension = structure->GetCell(cellsOnPoint->GetId(neighbor))->GetCellDimension();
-          if (cellDimension > highestCellDimension)
+          highestCellDimension = 0;
+          for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
           {
-            highestCellDimension = cellDimension;
-            if (highestCellDimension == maxCellDimension)
+            structure->GetCell(cellsOnPoint->GetId(neighbor), cell);
+            int cellDimension = cell->GetCellDimension();
+            if (cellDimension > highestCellDimension)
             {
-              break;
+              highestCellDimension = cellDimension;
+              if (highestCellDimension == maxCellDimension)
+              {
+                break;
+              }
             }
           }
         }
-      }
-      vtkIdType numValidCellNeighbors = 0;
+        vtkIdType numValidCellNeighbors = 0;
 
-      // Iterate on all cells and find all points connected to current point
-      // by an edge.
-      for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
-      {
-        vtkCell *cell = structure->GetCell(cellsOnPoint->GetId(neighbor));
-        if (cell->GetCellDimension() >= highestCellDimension)
+        // Iterate on all cells and find all points connected to current point
+        // by an edge.
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
         {
-          int subId;
-          double parametricCoord[3];
-          if(GetCellParametricData(point, pointcoords, cell,
-                                   subId, parametricCoord))
+          structure->GetCell(cellsOnPoint->GetId(neighbor), cell);
+          if (cell->GetCellDimension() >= highestCellDimension)
           {
-            numValidCellNeighbors++;
-            for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
+            int subId;
+            double parametricCoord[3];
+            if(GetCellParametricData(point, pointcoords, cell,
+                                     subId, parametricCoord, weights))
             {
-              int numberOfCellPoints = cell->GetNumberOfPoints();
-              std::vector<double> values(numberOfCellPoints);
-              // Get values of Array at cell points.
-              for (int i = 0; i < numberOfCellPoints; i++)
+              numValidCellNeighbors++;
+              // Get derivative of cell at point, for all the components.
+              GetCellValues(array, cell, p.NumberOfInputComponents, values);
+              cell->Derivatives(subId, parametricCoord, values.data(),
+                                p.NumberOfInputComponents, derivative.data());
+              for (int i = 0; i < numberOfOutputComponents; i++)
               {
-                values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
+                g[i] += static_cast<data_type>(derivative[i]);
               }
+            } // if(GetCellParametricData())
+          } // if(cell->GetCellDimension () >= highestCellDimension
+        } // iterating over neighbors
 
-              double derivative[3];
-              // Get derivative of cell at point.
-              cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
-
-              g[inputComponent*3] += static_cast<data_type>(derivative[0]);
-              g[inputComponent*3+1] += static_cast<data_type>(derivative[1]);
-              g[inputComponent*3+2] += static_cast<data_type>(derivative[2]);
-            } // iterating over Components
-          } // if(GetCellParametricData())
-        } // if(cell->GetCellDimension () >= highestCellDimension
-      } // iterating over neighbors
-
-      if (numValidCellNeighbors > 0)
-      {
-        for(int i=0;i<3*numberOfInputComponents;i++)
-        {
-          g[i] /= numValidCellNeighbors;
-        }
-
-        if(vorticity)
-        {
-          ComputeVorticityFromGradient(&g[0], vorticity+3*point);
-        }
-        if(qCriterion)
-        {
-          ComputeQCriterionFromGradient(&g[0], qCriterion+point);
-        }
-        if(divergence)
-        {
-          ComputeDivergenceFromGradient(&g[0], divergence+point);
-        }
-        if(gradients)
+        if (numValidCellNeighbors > 0)
         {
           for(int i=0;i<numberOfOutputComponents;i++)
           {
-            gradients[point*numberOfOutputComponents+i] = g[i];
+            g[i] /= numValidCellNeighbors;
           }
+          ComputeQuantitiesFromGradient(g, point, p.NumberOfInputComponents,
+            p.Gradients, p.Vorticity, p.QCriterion, p.Divergence);
         }
-      }
-    }  // iterating over points in grid
+      }  // iterating over points in grid
+    }
+  };
+
+  template<class data_type>
+  struct PointGradientsUGWorker
+  {
+    GradientsUG<data_type> &Parameters;
+
+    template<class ArrayT>
+    void operator()(ArrayT *array)
+    {
+      PointGradientsUG<ArrayT, data_type> functor(this->Parameters, array);
+      this->Parameters.Execute(
+        this->Parameters.Structure->GetNumberOfPoints(), functor);
+    }
+  };
+
+  template<class data_type>
+  void ComputePointGradientsUG(
+    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence, int highestCellDimension, int contributingCellOption)
+  {
+    GradientsUG<data_type> parameters = { structure, numberOfInputComponents,
+      gradients, vorticity, qCriterion, divergence, highestCellDimension,
+      contributingCellOption, nullptr };
+    vtkNew<vtkStaticCellLinks> links;
+    if (parameters.IsThreadSafe())
+    {
+      // Build the links, and the cells of polydata, before the threads use
+      // them.
+      links->BuildLinks(structure);
+      parameters.Links = links;
+      structure->PrepareForConcurrentReads();
+    }
+
+    PointGradientsUGWorker<data_type> worker = { parameters };
+    typedef vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>
+      Dispatcher;
+    if (!Dispatcher::Execute(array, worker))
+    {
+      worker(array);
+    }
   }
 
 //-----------------------------------------------------------------------------
   int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
-                            vtkCell *cell, int &subId, double parametricCoord[3])
+                            vtkCell *cell, int &subId, double parametricCoord[3],
+                            std::vector<double> &weights)
   {
     // Watch out for degenerate cells.  They make the derivative calculation
     // fail.
@@ -987,75 +1114,171 @@ namespace {
     }
 
     double dummy;
-    int numpoints = cell->GetNumberOfPoints();
-    std::vector<double> values(numpoints);
+    weights.resize(cell->GetNumberOfPoints());
     // Get parametric position of point.
     cell->EvaluatePosition(pointCoord, nullptr, subId, parametricCoord,
-                           dummy, &values[0]/*Really another dummy.*/);
+                           dummy, weights.data());
 
     return 1;
   }
 
 //-----------------------------------------------------------------------------
+  // Gradients at the parametric centers of the cells.
+  template<class ArrayT, class data_type>
+  struct CellGradientsUG
+  {
+    const GradientsUG<data_type> &Parameters;
+    ArrayT *Array;
+
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+
+    CellGradientsUG(const GradientsUG<data_type> &parameters, ArrayT *array)
+      : Parameters(parameters), Array(array)
+    {
+    }
+
+    void operator()(vtkIdType cellid, vtkIdType endCellId)
+    {
+      const GradientsUG<data_type> &p = this->Parameters;
+      vtkGenericCell *cell = this->Cell.Local();
+      std::vector<double> &values = this->Values.Local();
+      vtkDataArrayAccessor<ArrayT> array(this->Array);
+
+      const int numberOfOutputComponents = 3*p.NumberOfInputComponents;
+      std::vector<data_type> cellGradients(numberOfOutputComponents);
+      std::vector<double> derivative(numberOfOutputComponents);
+      for ( ; cellid < endCellId; cellid++)
+      {
+        p.Structure->GetCell(cellid, cell);
+        double cellCenter[3];
+        int subId = cell->GetParametricCenter(cellCenter);
+
+        GetCellValues(array, cell, p.NumberOfInputComponents, values);
+        cell->Derivatives(subId, cellCenter, values.data(),
+                          p.NumberOfInputComponents, derivative.data());
+        for (int i = 0; i < numberOfOutputComponents; i++)
+        {
+          cellGradients[i] = static_cast<data_type>(derivative[i]);
+        }
+        ComputeQuantitiesFromGradient(cellGradients, cellid,
+          p.NumberOfInputComponents, p.Gradients, p.Vorticity, p.QCriterion,
+          p.Divergence);
+      }
+    }
+  };
+
+  template<class data_type>
+  struct CellGradientsUGWorker
+  {
+    GradientsUG<data_type> &Parameters;
+
+    template<class ArrayT>
+    void operator()(ArrayT *array)
+    {
+      CellGradientsUG<ArrayT, data_type> functor(this->Parameters, array);
+      this->Parameters.Execute(
+        this->Parameters.Structure->GetNumberOfCells(), functor);
+    }
+  };
+
   template<class data_type>
     void ComputeCellGradientsUG(
       vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
       int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
       data_type* divergence)
   {
-    vtkIdType numcells = structure->GetNumberOfCells();
-    std::vector<double> values(8);
-    std::vector<data_type> cellGradients(3*numberOfInputComponents);
-    for (vtkIdType cellid = 0; cellid < numcells; cellid++)
-    {
-      vtkCell *cell = structure->GetCell(cellid);
-      int subId;
-      double cellCenter[3];
-      subId = cell->GetParametricCenter(cellCenter);
-
-      int numpoints = cell->GetNumberOfPoints();
-      if(static_cast<size_t>(numpoints) > values.size())
-      {
-        values.resize(numpoints);
-      }
-      double derivative[3];
-      for(int inputComponent=0;inputComponent<numberOfInputComponents;
-          inputComponent++)
+    GradientsUG<data_type> parameters = { structure, numberOfInputComponents,
+      gradients, vorticity, qCriterion, divergence, 0, vtkGradientFilter::All,
+      nullptr };
+    if (parameters.IsThreadSafe())
+    {
+      // Build the cells of polydata before the threads use them.
+      structure->PrepareForConcurrentReads();
+    }
+
+    CellGradientsUGWorker<data_type> worker = { parameters };
+    typedef vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>
+      Dispatcher;
+    if (!Dispatcher::Execute(array, worker))
+    {
+      worker(array);
+    }
+  }
+
+//-----------------------------------------------------------------------------
+  // Coordinates of the points, or of the cell centers, of a structured
+  // dataset given their index. They are computed directly from the extent
+  // of image data and from the coordinates of rectilinear grids, without
+  // evaluating the cells.
+  class GridEntityCoordinates
+  {
+  public:
+    GridEntityCoordinates(vtkDataSet *grid, int fieldAssociation,
+                          const int dims[3])
+      : Grid(grid), Image(vtkImageData::SafeDownCast(grid)),
+        Rectilinear(vtkRectilinearGrid::SafeDownCast(grid)),
+        Cells(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+    {
+      std::copy(dims, dims + 3, this->Dims);
+    }
+
+    void Get(vtkIdType index, vtkGenericCell *cell, double coords[3]) const
+    {
+      if (this->Image || this->Rectilinear)
       {
-        for (int i = 0; i < numpoints; i++)
+        int ijk[3];
+        ijk[0] = static_cast<int>(index % this->Dims[0]);
+        ijk[1] = static_cast<int>((index / this->Dims[0]) % this->Dims[1]);
+        ijk[2] = static_cast<int>(index / (this->Dims[0]*this->Dims[1]));
+        if (this->Image)
         {
-          values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
+          const double *origin = this->Image->GetOrigin();
+          const double *spacing = this->Image->GetSpacing();
+          const int *extent = this->Image->GetExtent();
+          const double shift = this->Cells ? 0.5 : 0.0;
+          for (int i = 0; i < 3; i++)
+          {
+            coords[i] = origin[i] + (ijk[i]+extent[i*2]+shift) * spacing[i];
+          }
         }
-
-        cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
-        cellGradients[inputComponent*3] =
-          static_cast<data_type>(derivative[0]);
-        cellGradients[inputComponent*3+1] =
-          static_cast<data_type>(derivative[1]);
-        cellGradients[inputComponent*3+2] =
-          static_cast<data_type>(derivative[2]);
-      }
-      if(gradients)
-      {
-        for(int i=0;i<3*numberOfInputComponents;i++)
+        else
         {
-          gradients[cellid*3*numberOfInputComponents+i] = cellGradients[i];
+          vtkDataArray *axes[3] = { this->Rectilinear->GetXCoordinates(),
+            this->Rectilinear->GetYCoordinates(),
+            this->Rectilinear->GetZCoordinates() };
+          for (int i = 0; i < 3; i++)
+          {
+            coords[i] = axes[i]->GetComponent(ijk[i], 0);
+            if (this->Cells && axes[i]->GetNumberOfTuples() > 1)
+            {
+              coords[i] =
+                0.5 * (coords[i] + axes[i]->GetComponent(ijk[i]+1, 0));
+            }
+          }
         }
       }
-      if(vorticity)
-      {
-        ComputeVorticityFromGradient(&cellGradients[0], vorticity+3*cellid);
-      }
-      if(qCriterion)
+      else if (!this->Cells)
       {
-        ComputeQCriterionFromGradient(&cellGradients[0], qCriterion+cellid);
+        this->Grid->GetPoint(index, coords);
       }
-      if(divergence)
+      else
       {
-        ComputeDivergenceFromGradient(&cellGradients[0], divergence+cellid);
+        this->Grid->GetCell(index, cell);
+        double pcoords[3];
+        double weights[VTK_CELL_SIZE];
+        int subId = cell->GetParametricCenter(pcoords);
+        cell->EvaluateLocation(subId, pcoords, coords, weights);
       }
     }
-  }
+
+  private:
+    vtkDataSet *Grid;
+    vtkImageData *Image;
+    vtkRectilinearGrid *Rectilinear;
+    bool Cells;
+    vtkIdType Dims[3];
+  };
 
 //-----------------------------------------------------------------------------
   template<class Grid, class data_type>
@@ -1064,23 +1287,6 @@ namespace {
                           data_type* vorticity, data_type* qCriterion,
                           data_type* divergence)
   {
-    int idx, idx2, inputComponent;
-    double xp[3], xm[3], factor;
-    xp[0] = xp[1] = xp[2] = xm[0] = xm[1] = xm[2] = factor = 0;
-    double xxi, yxi, zxi, xeta, yeta, zeta, xzeta, yzeta, zzeta;
-    yxi = zxi = xeta = yeta = zeta = xzeta = yzeta = zzeta = 0;
-    double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-    xix = xiy = xiz = etax = etay = etaz = zetax = zetay = zetaz = 0;
-    // for finite differencing -- the values on the "plus" side and
-    // "minus" side of the point to be computed at
-    std::vector<double> plusvalues(numberOfInputComponents);
-    std::vector<double> minusvalues(numberOfInputComponents);
-
-    std::vector<double> dValuesdXi(numberOfInputComponents);
-    std::vector<double> dValuesdEta(numberOfInputComponents);
-    std::vector<double> dValuesdZeta(numberOfInputComponents);
-    std::vector<data_type> localGradients(numberOfInputComponents*3);
-
     int dims[3];
     output->GetDimensions(dims);
     if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
@@ -1091,13 +1297,45 @@ namespace {
         dims[i]--;
       }
     }
-    int ijsize = dims[0]*dims[1];
+    const vtkIdType ijsize = static_cast<vtkIdType>(dims[0])*dims[1];
+    GridEntityCoordinates coordinates(output, fieldAssociation, dims);
+    if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+    {
+      // Cache the ghost arrays, that the blanking of structured grids reads,
+      // before the threads use them.
+      output->PrepareForConcurrentReads();
+    }
+    vtkSMPThreadLocalObject<vtkGenericCell> threadCell;
 
-    for (int k=0; k<dims[2]; k++)
+    // The rows of the grid are processed concurrently.
+    const vtkIdType numRows = std::max(dims[1], 0) *
+      static_cast<vtkIdType>(std::max(dims[2], 0));
+    vtkSMPTools::For(0, numRows, [&](vtkIdType row, vtkIdType endRow)
     {
-      for (int j=0; j<dims[1]; j++)
+      vtkGenericCell *cell = threadCell.Local();
+      vtkIdType idx, idx2;
+      int inputComponent;
+      double xp[3], xm[3], factor;
+      xp[0] = xp[1] = xp[2] = xm[0] = xm[1] = xm[2] = factor = 0;
+      double xxi, yxi, zxi, xeta, yeta, zeta, xzeta, yzeta, zzeta;
+      yxi = zxi = xeta = yeta = zeta = xzeta = yzeta = zzeta = 0;
+      double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
+      xix = xiy = xiz = etax = etay = etaz = zetax = zetay = zetaz = 0;
+      // for finite differencing -- the values on the "plus" side and
+      // "minus" side of the point to be computed at
+      std::vector<double> plusvalues(numberOfInputComponents);
+      std::vector<double> minusvalues(numberOfInputComponents);
+
+      std::vector<double> dValuesdXi(numberOfInputComponents);
+      std::vector<double> dValuesdEta(numberOfInputComponents);
+      std::vector<double> dValuesdZeta(numberOfInputComponents);
+      std::vector<data_type> localGradients(numberOfInputComponents*3);
+
+      for ( ; row < endRow; row++)
       {
-        for (int i=0; i<dims[0]; i++)
+        const vtkIdType j = row % dims[1];
+        const vtkIdType k = row / dims[1];
+        for (vtkIdType i=0; i<dims[0]; i++)
         {
           //  Xi derivatives.
           if ( dims[0] == 1 ) // 2D in this direction
@@ -1119,8 +1357,8 @@ namespace {
             factor = 1.0;
             idx = (i+1) + j*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1133,8 +1371,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i-1 + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1147,8 +1385,8 @@ namespace {
             factor = 0.5;
             idx = (i+1) + j*dims[0] + k*ijsize;
             idx2 = (i-1) + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1186,8 +1424,8 @@ namespace {
             factor = 1.0;
             idx = i + (j+1)*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1200,8 +1438,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1214,8 +1452,8 @@ namespace {
             factor = 0.5;
             idx = i + (j+1)*dims[0] + k*ijsize;
             idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1253,8 +1491,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + (k+1)*ijsize;
             idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1267,8 +1505,8 @@ namespace {
             factor = 1.0;
             idx = i + j*dims[0] + k*ijsize;
             idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1281,8 +1519,8 @@ namespace {
             factor = 0.5;
             idx = i + j*dims[0] + (k+1)*ijsize;
             idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
+            coordinates.Get(idx, cell, xp);
+            coordinates.Get(idx2, cell, xm);
             for(inputComponent=0;inputComponent<numberOfInputComponents;
                 inputComponent++)
             {
@@ -1344,28 +1582,12 @@ namespace {
               zetaz*dValuesdZeta[inputComponent]);
           }
 
-          if(gradients)
-          {
-            for(int ii=0;ii<3*numberOfInputComponents;ii++)
-            {
-              gradients[idx*numberOfInputComponents*3+ii] = localGradients[ii];
-            }
-          }
-          if(vorticity)
-          {
-            ComputeVorticityFromGradient(&localGradients[0], vorticity+3*idx);
-          }
-          if(qCriterion)
-          {
-            ComputeQCriterionFromGradient(&localGradients[0], qCriterion+idx);
-          }
-          if(divergence)
-          {
-            ComputeDivergenceFromGradient(&localGradients[0], divergence+idx);
-          }
+          ComputeQuantitiesFromGradient(localGradients, idx,
+            numberOfInputComponents, gradients, vorticity, qCriterion,
+            divergence);
         }
       }
-    }
+    });
   }
 
 } // end anonymous namespace
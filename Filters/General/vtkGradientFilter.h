@@ -39,6 +39,11 @@
  * the entire data set. For Patch or DataSetMax it is possible that some values
  * will not be computed. The ReplacementValueOption specifies what to use
  * for these values.
+ *
+ * The gradients of image data, rectilinear grids, structured grids,
+ * unstructured grids and polydata are computed with several threads through
+ * vtkSMPTools, the derived quantities being computed in the same pass. The
+ * other datasets are processed serially.
 */
 
 #ifndef vtkGradientFilter_h
@@ -23,11 +23,29 @@
 #include "vtkPlane.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkOBBTree);
 
+namespace
+{
+// The scratch space and statistics of the thread building some nodes.
+struct OBBTreeScratch
+{
+  std::vector<int> InsertedPoints;
+  int OBBCount = 0;
+  vtkSmartPointer<vtkPoints> PointsList;
+  int Level = 0;
+};
+}
+
 #define vtkCELLTRIANGLES(CELLPTIDS, TYPE, IDX, PTID0, PTID1, PTID2) \
         { switch( TYPE ) \
   { \
@@ -265,6 +283,15 @@ void vtkOBBTree::ComputeOBB(vtkDataSet *input, double corner[3], double max[3],
 // a sorted list of relative "sizes" of axes for comparison purposes.
 void vtkOBBTree::ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
                             double mid[3], double min[3], double size[3])
+{
+  this->ComputeOBB(cells, corner, max, mid, min, size,
+                   this->InsertedPoints, this->OBBCount, this->PointsList);
+}
+
+void vtkOBBTree::ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
+                            double mid[3], double min[3], double size[3],
+                            int *insertedPoints, int &obbCount,
+                            vtkPoints *pointsList)
 {
   vtkIdType numCells, i, j, cellId, ptId, pId, qId, rId;
   int k, type;
@@ -275,8 +302,8 @@ void vtkOBBTree::ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
   double tMin[3], tMax[3], closest[3], t;
   double dp0[3], dp1[3], tri_mass, tot_mass, c[3];
 
-  this->OBBCount++;
-  this->PointsList->Reset();
+  obbCount++;
+  pointsList->Reset();
   //
   // Compute mean & moments
   //
@@ -351,10 +378,11 @@ void vtkOBBTree::ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
     //
     for ( j=0; j < numPts; j++ )
     {
-      if ( this->InsertedPoints[ptIds[j]] != this->OBBCount )
+      if ( insertedPoints[ptIds[j]] != obbCount )
       {
-        this->InsertedPoints[ptIds[j]] = this->OBBCount;
-        this->PointsList->InsertNextPoint(this->DataSet->GetPoint(ptIds[j]));
+        insertedPoints[ptIds[j]] = obbCount;
+        this->DataSet->GetPoint(ptIds[j], p);
+        pointsList->InsertNextPoint(p);
       }
     }//for all points of this cell
   } // end foreach cell
@@ -402,10 +430,10 @@ void vtkOBBTree::ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
     tMin[0] = tMin[1] = tMin[2] = VTK_DOUBLE_MAX;
     tMax[0] = tMax[1] = tMax[2] = -VTK_DOUBLE_MAX;
 
-    numPts = this->PointsList->GetNumberOfPoints();
+    numPts = pointsList->GetNumberOfPoints();
     for (ptId=0; ptId < numPts; ptId++ )
     {
-      this->PointsList->GetPoint(ptId, p);
+      pointsList->GetPoint(ptId, p);
       for (i=0; i < 3; i++)
       {
         vtkLine::DistanceToLine(p, mean, a[i], t, closest);
@@ -974,6 +1002,57 @@ int vtkOBBTree::IntersectWithLine(const double a0[3], const double a1[3], double
   }
 }
 
+void vtkOBBTree::IntersectWithLine(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                                   vtkIdList *cellIds, vtkPoints *points)
+{
+  vtkIdType numLines = p1s->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numLines);
+  if ( points )
+  {
+    points->SetNumberOfPoints(numLines);
+  }
+  if ( numLines == 0 )
+  {
+    return;
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> localCell;
+  auto intersect = [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = localCell.Local();
+    double a0[3], a1[3], t, x[3], pcoords[3];
+    int subId;
+    for ( vtkIdType i = begin; i < end; i++ )
+    {
+      p1s->GetPoint(i, a0);
+      p2s->GetPoint(i, a1);
+      vtkIdType cellId = -1;
+      if ( !this->Tree ||
+           !this->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId,
+                                    cellId, cell) )
+      {
+        cellId = -1;
+        x[0] = a0[0]; x[1] = a0[1]; x[2] = a0[2];
+      }
+      cellIds->SetId(i, cellId);
+      if ( points )
+      {
+        points->SetPoint(i, x);
+      }
+    }
+  };
+
+  if ( this->DataSet && this->DataSet->SupportsConcurrentReads() )
+  {
+    this->DataSet->PrepareForConcurrentReads();
+    vtkSMPTools::For(0, numLines, intersect);
+  }
+  else
+  {
+    intersect(0, numLines);
+  }
+}
+
 void vtkOBBNode::DebugPrintTree( int level, double *leaf_vol,
                                  int *minCells, int *maxCells )
 {
@@ -1085,7 +1164,19 @@ void vtkOBBTree::BuildLocator()
   }
   this->Tree = new vtkOBBNode;
   this->Level = 0;
-  this->BuildTree(cellList,this->Tree,0);
+  // Only polygonal data and unstructured grids are supported by ComputeOBB.
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+       (vtkPolyData::SafeDownCast(this->DataSet) ||
+        vtkUnstructuredGrid::SafeDownCast(this->DataSet)) &&
+       this->DataSet->SupportsConcurrentReads() )
+  {
+    this->DataSet->PrepareForConcurrentReads();
+    this->BuildTreeInParallel(cellList);
+  }
+  else
+  {
+    this->BuildTree(cellList,this->Tree,0);
+  }
 
   vtkDebugMacro(<<"# Cells: " << numCells << ", Deepest tree level: " <<
                 this->Level <<", Created: " << this->OBBCount << " OBB nodes");
@@ -1112,6 +1203,15 @@ void vtkOBBTree::BuildLocator()
 // NOTE: for better memory usage this recursive method
 // frees its first argument
 void vtkOBBTree::BuildTree(vtkIdList *cells, vtkOBBNode *OBBptr, int level)
+{
+  this->BuildTree(cells, OBBptr, level, this->InsertedPoints, this->OBBCount,
+                  this->PointsList, this->Level, nullptr);
+}
+
+void vtkOBBTree::BuildTree(vtkIdList *cells, vtkOBBNode *OBBptr, int level,
+                           int *insertedPoints, int &obbCount,
+                           vtkPoints *pointsList, int &maxLevel,
+                           vtkIdList **kidCells)
 {
   vtkIdType i, j, numCells=cells->GetNumberOfIds();
   vtkIdType cellId;
@@ -1119,15 +1219,20 @@ void vtkOBBTree::BuildTree(vtkIdList *cells, vtkOBBNode *OBBptr, int level)
   vtkIdList *cellPts = vtkIdList::New();
   double size[3];
 
-  if ( level > this->Level )
+  if ( kidCells )
+  {
+    kidCells[0] = kidCells[1] = nullptr;
+  }
+  if ( level > maxLevel )
   {
-    this->Level = level;
+    maxLevel = level;
   }
   //
   // Now compute the OBB
   //
   this->ComputeOBB(cells, OBBptr->Corner, OBBptr->Axes[0],
-                   OBBptr->Axes[1], OBBptr->Axes[2], size);
+                   OBBptr->Axes[1], OBBptr->Axes[2], size,
+                   insertedPoints, obbCount, pointsList);
 
   //
   // Check whether to continue recursing; if so, create two children and
@@ -1253,8 +1358,18 @@ void vtkOBBTree::BuildTree(vtkIdList *cells, vtkOBBNode *OBBptr, int level)
       RHnode->Parent = OBBptr;
 
       cells->Delete(); cells = nullptr; //don't need to keep anymore
-      this->BuildTree(LHlist, LHnode, level+1);
-      this->BuildTree(RHlist, RHnode, level+1);
+      if ( kidCells )
+      {
+        kidCells[0] = LHlist;
+        kidCells[1] = RHlist;
+      }
+      else
+      {
+        this->BuildTree(LHlist, LHnode, level+1, insertedPoints, obbCount,
+                        pointsList, maxLevel, nullptr);
+        this->BuildTree(RHlist, RHnode, level+1, insertedPoints, obbCount,
+                        pointsList, maxLevel, nullptr);
+      }
     }
     else
     {
@@ -1276,6 +1391,90 @@ void vtkOBBTree::BuildTree(vtkIdList *cells, vtkOBBNode *OBBptr, int level)
   cellPts->Delete();
 }
 
+// The cells of the nodes of a level are disjoint lists, and each node only
+// depends on its own cells, so the nodes can be built in any order. The
+// top levels, which have few nodes, are built one level at a time. Once
+// there are enough nodes to keep the threads busy, their subtrees are
+// built with the serial recursion.
+void vtkOBBTree::BuildTreeInParallel(vtkIdList *cells)
+{
+  const int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  const vtkIdType numPts = this->DataSet->GetNumberOfPoints();
+
+  struct PendingNode
+  {
+    vtkIdList *Cells;
+    vtkOBBNode *Node;
+  };
+
+  vtkSMPThreadLocal<OBBTreeScratch> localScratch;
+  auto getScratch = [&]() -> OBBTreeScratch&
+  {
+    OBBTreeScratch &scratch = localScratch.Local();
+    if ( !scratch.PointsList )
+    {
+      scratch.InsertedPoints.assign(numPts, 0);
+      scratch.PointsList = vtkSmartPointer<vtkPoints>::New();
+    }
+    return scratch;
+  };
+
+  std::vector<PendingNode> nodes(1, PendingNode{cells, this->Tree});
+  std::vector<PendingNode> kids;
+  std::vector<vtkIdList*> kidCells;
+  int level = 0;
+
+  while ( !nodes.empty() &&
+          nodes.size() < static_cast<size_t>(4 * numThreads) )
+  {
+    kidCells.assign(2 * nodes.size(), nullptr);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(nodes.size()), 1,
+      [&](vtkIdType begin, vtkIdType end)
+      {
+        OBBTreeScratch &scratch = getScratch();
+        for ( vtkIdType i = begin; i < end; i++ )
+        {
+          this->BuildTree(nodes[i].Cells, nodes[i].Node, level,
+                          scratch.InsertedPoints.data(), scratch.OBBCount,
+                          scratch.PointsList, scratch.Level, &kidCells[2*i]);
+        }
+      });
+
+    kids.clear();
+    for ( size_t i = 0; i < nodes.size(); i++ )
+    {
+      if ( kidCells[2*i] )
+      {
+        kids.push_back(PendingNode{kidCells[2*i], nodes[i].Node->Kids[0]});
+        kids.push_back(PendingNode{kidCells[2*i+1], nodes[i].Node->Kids[1]});
+      }
+    }
+    nodes.swap(kids);
+    level++;
+  }
+
+  vtkSMPTools::For(0, static_cast<vtkIdType>(nodes.size()), 1,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      OBBTreeScratch &scratch = getScratch();
+      for ( vtkIdType i = begin; i < end; i++ )
+      {
+        this->BuildTree(nodes[i].Cells, nodes[i].Node, level,
+                        scratch.InsertedPoints.data(), scratch.OBBCount,
+                        scratch.PointsList, scratch.Level, nullptr);
+      }
+    });
+
+  for ( OBBTreeScratch &scratch : localScratch )
+  {
+    this->OBBCount += scratch.OBBCount;
+    if ( scratch.Level > this->Level )
+    {
+      this->Level = scratch.Level;
+    }
+  }
+}
+
 // Create polygonal representation for OBB tree at specified level. If
 // level < 0, then the leaf OBB nodes will be gathered. The aspect ratio (ar)
 // and line diameter (d) are used to control the building of the
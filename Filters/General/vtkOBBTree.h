@@ -33,6 +33,13 @@
  * A good reference for OBB-trees is Gottschalk & Manocha in Proceedings of
  * Siggraph `96.
  *
+ * When several threads are available and the cells of the dataset can be
+ * read concurrently, the nodes of each of the top levels of the tree are
+ * built concurrently with vtkSMPTools, and then the deeper subtrees are
+ * built concurrently. Each thread gathers the points of its nodes in its
+ * own scratch space, of the size of the point array. The tree is the same
+ * as the one built by a single thread.
+ *
  * @warning
  * Since this algorithms works from a list of cells, the OBB tree will only
  * bound the "geometry" attached to the cells if the convex hull of the
@@ -120,6 +127,17 @@ public:
                         double& t, double x[3], double pcoords[3],
                         int &subId, vtkIdType &cellId, vtkGenericCell *cell) override;
 
+  /**
+   * Intersect a batch of line segments with the data set, several segments
+   * at a time with vtkSMPTools. Segment i goes from point i of p1s to point
+   * i of p2s. For each segment, cellIds receives the id of the first cell
+   * that it intersects, or -1, and points (unless nullptr) the intersection
+   * point, or the start of the segment when there is none. The tree must
+   * have been built beforehand.
+   */
+  void IntersectWithLine(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                         vtkIdList *cellIds, vtkPoints *points);
+
   /**
    * Compute an OBB from the list of points given. Return the corner point
    * and the three axes defining the orientation of the OBB. Also return
@@ -203,8 +221,25 @@ protected:
   void ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
                        double mid[3], double min[3], double size[3]);
 
+  // Same as above, gathering the points of the cells in pointsList.
+  // insertedPoints holds, for each point, the obbCount of the last OBB
+  // that gathered it; obbCount is incremented for this OBB.
+  void ComputeOBB(vtkIdList *cells, double corner[3], double max[3],
+                  double mid[3], double min[3], double size[3],
+                  int *insertedPoints, int &obbCount, vtkPoints *pointsList);
+
   vtkOBBNode *Tree;
   void BuildTree(vtkIdList *cells, vtkOBBNode *parent, int level);
+
+  // Same as above, with the scratch space and statistics of one thread.
+  // When kidCells is not nullptr, the cell lists of the two children are
+  // returned in it (nullptr for a leaf) instead of building the children.
+  void BuildTree(vtkIdList *cells, vtkOBBNode *parent, int level,
+                 int *insertedPoints, int &obbCount, vtkPoints *pointsList,
+                 int &maxLevel, vtkIdList **kidCells);
+
+  // Build the tree with vtkSMPTools. Same tree as BuildTree(cells, Tree, 0).
+  void BuildTreeInParallel(vtkIdList *cells);
   vtkPoints *PointsList;
   int *InsertedPoints;
   int OBBCount;
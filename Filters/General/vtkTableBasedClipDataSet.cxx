@@ -57,9 +57,21 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkIdTypeArray.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkNew.h"
+
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
 
 #include "vtkTableBasedClipCases.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -1580,6 +1592,835 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // ============================================================================
 
 
+// ============================================================================
+// ================ Multi-threaded table based clipping (begin) ===============
+// ============================================================================
+
+namespace
+{
+
+// The multi-threaded clipper processes the cells in batches of consecutive
+// cells. Each batch keeps its own lists of shapes, of points on edges and of
+// centroid points, exactly as vtkTableBasedClipperVolumeFromVolume does for
+// the whole dataset. The batches are merged afterwards, the points on edges
+// being merged with vtkStaticEdgeLocatorTemplate. Everything is numbered in
+// the same order as in the serial code, so the output is the same.
+const vtkIdType TABLE_BASED_CLIPPER_BATCH_SIZE = 1024;
+
+// The shapes, in the order of their lists in ConstructDataSet().
+const int TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES = 8;
+const int TableBasedClipperShapeSizes[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ] =
+  { 4, 5, 6, 8, 4, 3, 2, 1 };
+const unsigned char
+  TableBasedClipperShapeTypes[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ] =
+  { VTK_TETRA, VTK_PYRAMID, VTK_WEDGE, VTK_HEXAHEDRON,
+    VTK_QUAD, VTK_TRIANGLE, VTK_LINE, VTK_VERTEX };
+
+typedef MergeTuple< vtkIdType, double > TableBasedClipperEdgeTuple;
+
+// The clipping tables of a cell type.
+struct TableBasedClipperCellTables
+{
+  const int           * StartShapes;
+  const int           * NumShapes;
+  const unsigned char * Shapes;
+  const int          ( * VerticesFromEdges )[2];
+
+  void Set( const int * start, const int * num, const unsigned char * shapes,
+            const int ( * verticesFromEdges )[2] )
+  {
+    this->StartShapes       = start;
+    this->NumShapes         = num;
+    this->Shapes            = shapes;
+    this->VerticesFromEdges = verticesFromEdges;
+  }
+};
+
+// Get the tables of the cell types clipped by ClipUnstructuredGridData().
+// Return false for the other types.
+bool GetTableBasedClipperCellTables( int cellType,
+                                     TableBasedClipperCellTables & tables )
+{
+  using namespace vtkTableBasedClipperClipTables;
+  using namespace vtkTableBasedClipperTriangulationTables;
+  switch ( cellType )
+  {
+    case VTK_TETRA:
+      tables.Set( StartClipShapesTet, NumClipShapesTet, ClipShapesTet,
+                  TetVerticesFromEdges );
+      return true;
+
+    case VTK_PYRAMID:
+      tables.Set( StartClipShapesPyr, NumClipShapesPyr, ClipShapesPyr,
+                  PyramidVerticesFromEdges );
+      return true;
+
+    case VTK_WEDGE:
+      tables.Set( StartClipShapesWdg, NumClipShapesWdg, ClipShapesWdg,
+                  WedgeVerticesFromEdges );
+      return true;
+
+    case VTK_HEXAHEDRON:
+      tables.Set( StartClipShapesHex, NumClipShapesHex, ClipShapesHex,
+                  HexVerticesFromEdges );
+      return true;
+
+    case VTK_VOXEL:
+      tables.Set( StartClipShapesVox, NumClipShapesVox, ClipShapesVox,
+                  VoxVerticesFromEdges );
+      return true;
+
+    case VTK_TRIANGLE:
+      tables.Set( StartClipShapesTri, NumClipShapesTri, ClipShapesTri,
+                  TriVerticesFromEdges );
+      return true;
+
+    case VTK_QUAD:
+      tables.Set( StartClipShapesQua, NumClipShapesQua, ClipShapesQua,
+                  QuadVerticesFromEdges );
+      return true;
+
+    case VTK_PIXEL:
+      tables.Set( StartClipShapesPix, NumClipShapesPix, ClipShapesPix,
+                  PixelVerticesFromEdges );
+      return true;
+
+    case VTK_LINE:
+      tables.Set( StartClipShapesLin, NumClipShapesLin, ClipShapesLin,
+                  LineVerticesFromEdges );
+      return true;
+
+    case VTK_VERTEX:
+      tables.Set( StartClipShapesVtx, NumClipShapesVtx, ClipShapesVtx,
+                  nullptr );
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// The cells of an unstructured grid.
+struct TableBasedClipperUnstructuredCells
+{
+  vtkUnstructuredGrid * Grid;
+
+  int GetCell( vtkIdType cellId, vtkIdType pts[8],
+               TableBasedClipperCellTables & tables ) const
+  {
+    vtkIdType   npts = 0;
+    vtkIdType * cellPts = nullptr;
+    this->Grid->GetCellPoints( cellId, npts, cellPts );
+    GetTableBasedClipperCellTables( this->Grid->GetCellType( cellId ), tables );
+    std::copy( cellPts, cellPts + npts, pts );
+    return static_cast< int >( npts );
+  }
+};
+
+// The cells of a structured or rectilinear grid: hexahedra, or quads when
+// the grid is 2D.
+struct TableBasedClipperStructuredCells
+{
+  int         CellDims[3];
+  vtkIdType   CyStride;
+  vtkIdType   CzStride;
+  vtkIdType   PyStride;
+  vtkIdType   PzStride;
+  int         NumberOfCellPoints;
+  const int * ShiftLUT[3];
+  TableBasedClipperCellTables Tables;
+
+  TableBasedClipperStructuredCells( const int dims[3] )
+  {
+    static const int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+    static const int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+    static const int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+    const bool isTwoDim = ( dims[0] <= 1 || dims[1] <= 1 || dims[2] <= 1 );
+    this->ShiftLUT[0] = shiftLUTx;
+    this->ShiftLUT[1] = shiftLUTy;
+    this->ShiftLUT[2] = shiftLUTz;
+    if ( dims[0] <= 1 )
+    {
+      this->ShiftLUT[0] = shiftLUTy;
+      this->ShiftLUT[1] = shiftLUTz;
+      this->ShiftLUT[2] = shiftLUTx;
+    }
+    else if ( dims[1] <= 1 )
+    {
+      this->ShiftLUT[1] = shiftLUTz;
+      this->ShiftLUT[2] = shiftLUTy;
+    }
+
+    for ( int i = 0; i < 3; i ++ )
+    {
+      this->CellDims[i] = dims[i] - 1;
+    }
+    this->CyStride = ( this->CellDims[0] ? this->CellDims[0] : 1 );
+    this->CzStride = this->CyStride * ( this->CellDims[1] ? this->CellDims[1] : 1 );
+    this->PyStride = dims[0];
+    this->PzStride = static_cast< vtkIdType >( dims[0] ) * dims[1];
+
+    // As in the serial code, the edges of the quads are found with the table
+    // of the hexahedra.
+    using namespace vtkTableBasedClipperClipTables;
+    if ( isTwoDim )
+    {
+      this->NumberOfCellPoints = 4;
+      this->Tables.Set( StartClipShapesQua, NumClipShapesQua, ClipShapesQua,
+        vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges );
+    }
+    else
+    {
+      this->NumberOfCellPoints = 8;
+      this->Tables.Set( StartClipShapesHex, NumClipShapesHex, ClipShapesHex,
+        vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges );
+    }
+  }
+
+  int GetCell( vtkIdType cellId, vtkIdType pts[8],
+               TableBasedClipperCellTables & tables ) const
+  {
+    const vtkIdType theCellI =
+      ( this->CellDims[0] > 0 ? cellId % this->CellDims[0] : 0 );
+    const vtkIdType theCellJ =
+      ( this->CellDims[1] > 0 ? ( cellId / this->CyStride ) % this->CellDims[1] : 0 );
+    const vtkIdType theCellK =
+      ( this->CellDims[2] > 0 ? ( cellId / this->CzStride ) : 0 );
+    for ( int j = 0; j < this->NumberOfCellPoints; j ++ )
+    {
+      pts[j] = ( theCellI + this->ShiftLUT[0][j] ) +
+               ( theCellJ + this->ShiftLUT[1][j] ) * this->PyStride +
+               ( theCellK + this->ShiftLUT[2][j] ) * this->PzStride;
+    }
+    tables = this->Tables;
+    return this->NumberOfCellPoints;
+  }
+};
+
+// The coordinates of the points of a point set.
+struct TableBasedClipperPointSetCoordinates
+{
+  vtkPoints * Points;
+
+  void GetPoint( vtkIdType ptId, double x[3] ) const
+  {
+    this->Points->GetPoint( ptId, x );
+  }
+};
+
+// The coordinates of the points of a rectilinear grid.
+struct TableBasedClipperRectilinearCoordinates
+{
+  int            Dims[3];
+  vtkDataArray * Coordinates[3];
+
+  void GetPoint( vtkIdType ptId, double x[3] ) const
+  {
+    x[0] = this->Coordinates[0]->GetComponent( ptId % this->Dims[0], 0 );
+    x[1] = this->Coordinates[1]->GetComponent(
+             ( ptId / this->Dims[0] ) % this->Dims[1], 0 );
+    x[2] = this->Coordinates[2]->GetComponent(
+             ptId / ( static_cast< vtkIdType >( this->Dims[0] ) * this->Dims[1] ),
+             0 );
+  }
+};
+
+// The output of a batch of cells. The shapes and the centroid points refer
+// to the input points by their ids, to the points on edges by the number of
+// input points plus their index in Edges, and to the centroid points by -1
+// minus their index in the centroid list, as in the serial code.
+struct TableBasedClipperBatch
+{
+  // For each shape: the input cell id, then the point references.
+  std::vector< vtkIdType > Shapes[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ];
+  // One entry for each use of a point on an edge.
+  std::vector< TableBasedClipperEdgeTuple > Edges;
+  // For each centroid point: the number of points, then 8 point references.
+  std::vector< vtkIdType > Centroids;
+
+  // Where the output of the batch goes.
+  vtkIdType EdgeOffset;
+  vtkIdType CentroidOffset;
+  vtkIdType CellOffsets[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ];
+  vtkIdType ConnectivityOffsets[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ];
+  vtkIdType NumberOfNewPoints[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ];
+  vtkIdType PointOffsets[ TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES ];
+
+  // Call visitor( ptId, index ) for the uses of input points by the shapes
+  // of a type, where index is the position of the point in the output
+  // connectivity.
+  template < typename Visitor >
+  void VisitPointUses( int shape, vtkIdType numPts, Visitor & visitor ) const
+  {
+    const std::vector< vtkIdType > & list = this->Shapes[ shape ];
+    const size_t entrySize = TableBasedClipperShapeSizes[ shape ] + 1;
+    const vtkIdType offset = this->ConnectivityOffsets[ shape ];
+    for ( size_t i = 0; i < list.size(); i ++ )
+    {
+      if ( i % entrySize != 0 && list[i] >= 0 && list[i] < numPts )
+      {
+        visitor( list[i], offset + static_cast< vtkIdType >( i ) );
+      }
+    }
+  }
+};
+
+// Clip the cells of the batches, following the same steps as the serial
+// code.
+template < typename TCells >
+struct TableBasedClipperClipCells
+{
+  const TCells           & Cells;
+  vtkDataArray           * ClipArray;
+  double                   IsoValue;
+  bool                     InsideOut;
+  vtkIdType                NumberOfPoints;
+  vtkIdType                NumberOfCells;
+  TableBasedClipperBatch * Batches;
+
+  TableBasedClipperClipCells( const TCells & cells, vtkDataArray * clipArray,
+    double isoValue, bool insideOut, vtkIdType numPts, vtkIdType numCells,
+    TableBasedClipperBatch * batches ) : Cells( cells ), ClipArray( clipArray ),
+    IsoValue( isoValue ), InsideOut( insideOut ), NumberOfPoints( numPts ),
+    NumberOfCells( numCells ), Batches( batches )
+  {
+  }
+
+  void operator()( vtkIdType batchId, vtkIdType endBatchId ) const
+  {
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      const vtkIdType endCellId = std::min(
+        ( batchId + 1 ) * TABLE_BASED_CLIPPER_BATCH_SIZE, this->NumberOfCells );
+      for ( vtkIdType cellId = batchId * TABLE_BASED_CLIPPER_BATCH_SIZE;
+            cellId < endCellId; cellId ++ )
+      {
+        this->ClipCell( cellId, this->Batches[ batchId ] );
+      }
+    }
+  }
+
+  vtkIdType AddEdgePoint( TableBasedClipperBatch & batch, vtkIdType p1,
+                          vtkIdType p2, double percent ) const
+  {
+    // Same convention as vtkTableBasedClipperEdgeHashTable::AddPoint().
+    if ( p2 < p1 )
+    {
+      std::swap( p1, p2 );
+      percent = 1.0 - percent;
+    }
+    const vtkIdType edgeIndex = static_cast< vtkIdType >( batch.Edges.size() );
+    batch.Edges.push_back(
+      TableBasedClipperEdgeTuple( p1, p2, edgeIndex, percent ) );
+    return this->NumberOfPoints + edgeIndex;
+  }
+
+  void ClipCell( vtkIdType cellId, TableBasedClipperBatch & batch ) const
+  {
+    vtkIdType pntIndxs[8];
+    TableBasedClipperCellTables tables;
+    const int numbPnts = this->Cells.GetCell( cellId, pntIndxs, tables );
+
+    int    caseIndx = 0;
+    double grdDiffs[8];
+    for ( int j = numbPnts - 1; j >= 0; j -- )
+    {
+      grdDiffs[j] = this->ClipArray->GetComponent( pntIndxs[j], 0 ) -
+                    this->IsoValue;
+      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+      caseIndx  <<= (  1 - ( !j )  );
+    }
+
+    const unsigned char * thisCase =
+      tables.Shapes + tables.StartShapes[ caseIndx ];
+    const int nOutputs = tables.NumShapes[ caseIndx ];
+    vtkIdType intrpIds[4] = { 0, 0, 0, 0 };
+    for ( int j = 0; j < nOutputs; j ++ )
+    {
+      int nCellPts = 0;
+      int theColor = -1;
+      int intrpIdx = -1;
+      int theShape = -1; // index of the shape list
+      switch ( *thisCase ++ )
+      {
+        case ST_TET:
+          nCellPts = 4;
+          theShape = 0;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_PYR:
+          nCellPts = 5;
+          theShape = 1;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_WDG:
+          nCellPts = 6;
+          theShape = 2;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_HEX:
+          nCellPts = 8;
+          theShape = 3;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_QUA:
+          nCellPts = 4;
+          theShape = 4;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_TRI:
+          nCellPts = 3;
+          theShape = 5;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_LIN:
+          nCellPts = 2;
+          theShape = 6;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_VTX:
+          nCellPts = 1;
+          theShape = 7;
+          theColor = *thisCase ++;
+          break;
+
+        case ST_PNT:
+          intrpIdx = *thisCase ++;
+          theColor = *thisCase ++;
+          nCellPts = *thisCase ++;
+          break;
+      }
+
+      if ( ( !this->InsideOut && theColor == COLOR0 ) ||
+           (  this->InsideOut && theColor == COLOR1 ) )
+      {
+        // We don't want this one; it's the wrong side.
+        thisCase += nCellPts;
+        continue;
+      }
+
+      vtkIdType shapeIds[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      for ( int p = 0; p < nCellPts; p ++ )
+      {
+        const unsigned char pntIndex = *thisCase ++;
+        if ( pntIndex <= P7 )
+        {
+          shapeIds[p] = pntIndxs[ pntIndex ];
+        }
+        else if ( pntIndex >= EA && pntIndex <= EL )
+        {
+          int pt1Index = tables.VerticesFromEdges[ pntIndex - EA ][0];
+          int pt2Index = tables.VerticesFromEdges[ pntIndex - EA ][1];
+          if ( pt2Index < pt1Index )
+          {
+            std::swap( pt1Index, pt2Index );
+          }
+          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+          shapeIds[p] = this->AddEdgePoint( batch, pntIndxs[ pt1Index ],
+                                            pntIndxs[ pt2Index ], p1Weight );
+        }
+        else if ( pntIndex >= N0 && pntIndex <= N3 )
+        {
+          shapeIds[p] = intrpIds[ pntIndex - N0 ];
+        }
+      }
+
+      if ( intrpIdx >= 0 )
+      {
+        intrpIds[ intrpIdx ] =
+          -1 - static_cast< vtkIdType >( batch.Centroids.size() / 9 );
+        batch.Centroids.push_back( nCellPts );
+        batch.Centroids.insert( batch.Centroids.end(), shapeIds, shapeIds + 8 );
+      }
+      else if ( theShape >= 0 )
+      {
+        std::vector< vtkIdType > & list = batch.Shapes[ theShape ];
+        list.push_back( cellId );
+        list.insert( list.end(), shapeIds, shapeIds + nCellPts );
+      }
+    }
+  }
+};
+
+// Turn the point references of a batch into output point ids.
+struct TableBasedClipperPointIds
+{
+  vtkIdType         NumberOfPoints;
+  const vtkIdType * PointMap;
+  vtkIdType         NumberOfUsedPoints;
+  const vtkIdType * EdgeIds;
+  vtkIdType         CentroidStart;
+
+  vtkIdType operator()( const TableBasedClipperBatch & batch,
+                        vtkIdType ref ) const
+  {
+    if ( ref < 0 )
+    {
+      return this->CentroidStart + batch.CentroidOffset - 1 - ref;
+    }
+    if ( ref >= this->NumberOfPoints )
+    {
+      return this->NumberOfUsedPoints +
+        this->EdgeIds[ batch.EdgeOffset + ref - this->NumberOfPoints ];
+    }
+    return this->PointMap[ ref ];
+  }
+};
+
+// Prepare the output arrays so that their tuples can be set by several
+// threads at once.
+void AllocateTableBasedClipperAttributes( vtkDataSetAttributes * inAttributes,
+  vtkDataSetAttributes * outAttributes, vtkIdType numTuples )
+{
+  outAttributes->CopyAllocate( inAttributes, numTuples );
+  for ( int i = 0; i < outAttributes->GetNumberOfArrays(); i ++ )
+  {
+    outAttributes->GetAbstractArray( i )->SetNumberOfTuples( numTuples );
+  }
+}
+
+// Tell whether the tuples of the arrays can be set by several threads at
+// once, which is the case for the data arrays but for bit arrays.
+bool HasOnlyThreadSafeArrays( vtkDataSetAttributes * attributes )
+{
+  for ( int i = 0; i < attributes->GetNumberOfArrays(); i ++ )
+  {
+    vtkDataArray * array =
+      vtkArrayDownCast< vtkDataArray >( attributes->GetAbstractArray( i ) );
+    if ( !array || array->GetDataType() == VTK_BIT )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Clip the cells with several threads, and build the output like
+// vtkTableBasedClipperVolumeFromVolume::ConstructDataSet().
+template < typename TCells, typename TCoordinates >
+void ClipCellsInParallel( const TCells & cells,
+  const TCoordinates & coordinates, vtkDataSet * input,
+  vtkDataArray * clipArray, double isoValue, bool insideOut, int pointsType,
+  vtkUnstructuredGrid * output )
+{
+  const int       numShapes  = TABLE_BASED_CLIPPER_NUMBER_OF_SHAPES;
+  const vtkIdType numPts     = input->GetNumberOfPoints();
+  const vtkIdType numCells   = input->GetNumberOfCells();
+  const vtkIdType numBatches =
+    ( numCells - 1 ) / TABLE_BASED_CLIPPER_BATCH_SIZE + 1;
+  std::vector< TableBasedClipperBatch > batches( numBatches );
+
+  TableBasedClipperClipCells< TCells > clipCells( cells, clipArray, isoValue,
+    insideOut, numPts, numCells, batches.data() );
+  vtkSMPTools::For( 0, numBatches, clipCells );
+
+  // Offsets of the output of the batches. The shapes are ordered by type
+  // first, then by batch.
+  vtkIdType numEdgeUses  = 0;
+  vtkIdType numCentroids = 0;
+  for ( TableBasedClipperBatch & batch : batches )
+  {
+    batch.EdgeOffset     = numEdgeUses;
+    batch.CentroidOffset = numCentroids;
+    numEdgeUses  += static_cast< vtkIdType >( batch.Edges.size() );
+    numCentroids += static_cast< vtkIdType >( batch.Centroids.size() / 9 );
+  }
+  vtkIdType numOutCells = 0;
+  vtkIdType connSize    = 0;
+  for ( int shape = 0; shape < numShapes; shape ++ )
+  {
+    for ( TableBasedClipperBatch & batch : batches )
+    {
+      const vtkIdType listSize =
+        static_cast< vtkIdType >( batch.Shapes[ shape ].size() );
+      batch.CellOffsets[ shape ]         = numOutCells;
+      batch.ConnectivityOffsets[ shape ] = connSize;
+      numOutCells += listSize / ( TableBasedClipperShapeSizes[ shape ] + 1 );
+      connSize    += listSize;
+    }
+  }
+
+  // Merge the points on edges. As with the hash table of the serial code,
+  // each edge keeps the percent of its first use, and the edges are numbered
+  // in the order of their first use.
+  std::vector< TableBasedClipperEdgeTuple > edgeUses( numEdgeUses );
+  vtkSMPTools::For( 0, numBatches,
+    [&]( vtkIdType batchId, vtkIdType endBatchId )
+    {
+      for ( ; batchId < endBatchId; batchId ++ )
+      {
+        const TableBasedClipperBatch & batch = batches[ batchId ];
+        TableBasedClipperEdgeTuple * edgeUse = &edgeUses[ batch.EdgeOffset ];
+        for ( const TableBasedClipperEdgeTuple & edge : batch.Edges )
+        {
+          *edgeUse = edge;
+          edgeUse->EId += batch.EdgeOffset;
+          edgeUse ++;
+        }
+      }
+    } );
+
+  std::vector< vtkIdType > edgeIds( numEdgeUses );
+  std::vector< TableBasedClipperEdgeTuple > edges;
+  if ( numEdgeUses > 0 )
+  {
+    vtkStaticEdgeLocatorTemplate< vtkIdType, double > locator;
+    vtkIdType numEdges = 0;
+    const vtkIdType * groups =
+      locator.MergeEdges( numEdgeUses, edgeUses.data(), numEdges );
+
+    // Find the first use of each edge, and number these uses.
+    std::vector< vtkIdType > firstUses( numEdges );
+    std::vector< vtkIdType > isFirstUse( numEdgeUses, 0 );
+    vtkSMPTools::For( 0, numEdges,
+      [&]( vtkIdType edgeId, vtkIdType endEdgeId )
+      {
+        for ( ; edgeId < endEdgeId; edgeId ++ )
+        {
+          vtkIdType first = groups[ edgeId ];
+          for ( vtkIdType i = first + 1; i < groups[ edgeId + 1 ]; i ++ )
+          {
+            if ( edgeUses[i].EId < edgeUses[ first ].EId )
+            {
+              first = i;
+            }
+          }
+          firstUses[ edgeId ] = first;
+          isFirstUse[ edgeUses[ first ].EId ] = 1;
+        }
+      } );
+    std::vector< vtkIdType > newEdgeIds( numEdgeUses );
+    vtkSMPTools::ExclusiveScan( isFirstUse.begin(), isFirstUse.end(),
+                                newEdgeIds.begin(), vtkIdType( 0 ) );
+
+    edges.resize( numEdges );
+    vtkSMPTools::For( 0, numEdges,
+      [&]( vtkIdType edgeId, vtkIdType endEdgeId )
+      {
+        for ( ; edgeId < endEdgeId; edgeId ++ )
+        {
+          const TableBasedClipperEdgeTuple & first =
+            edgeUses[ firstUses[ edgeId ] ];
+          const vtkIdType newEdgeId = newEdgeIds[ first.EId ];
+          edges[ newEdgeId ] = first;
+          for ( vtkIdType i = groups[ edgeId ]; i < groups[ edgeId + 1 ]; i ++ )
+          {
+            edgeIds[ edgeUses[i].EId ] = newEdgeId;
+          }
+        }
+      } );
+  }
+  edgeUses.clear();
+  const vtkIdType numEdges = static_cast< vtkIdType >( edges.size() );
+
+  // Number the input points used by the shapes in the order of their first
+  // use, with the index of this use in the output connectivity.
+  const vtkIdType numUnits = numShapes * numBatches;
+  std::unique_ptr< std::atomic< vtkIdType >[] > firstUses(
+    new std::atomic< vtkIdType >[ numPts ] );
+  std::atomic< vtkIdType > * uses = firstUses.get();
+  vtkSMPTools::Fill( uses, uses + numPts, VTK_ID_MAX );
+  vtkSMPTools::For( 0, numUnits,
+    [&]( vtkIdType unit, vtkIdType endUnit )
+    {
+      auto visitor = [uses]( vtkIdType ptId, vtkIdType index )
+      {
+        vtkIdType current = uses[ ptId ].load( std::memory_order_relaxed );
+        while ( index < current &&
+                !uses[ ptId ].compare_exchange_weak(
+                  current, index, std::memory_order_relaxed ) )
+        {
+        }
+      };
+      for ( ; unit < endUnit; unit ++ )
+      {
+        batches[ unit % numBatches ].VisitPointUses(
+          static_cast< int >( unit / numBatches ), numPts, visitor );
+      }
+    } );
+  vtkSMPTools::For( 0, numUnits,
+    [&]( vtkIdType unit, vtkIdType endUnit )
+    {
+      for ( ; unit < endUnit; unit ++ )
+      {
+        TableBasedClipperBatch & batch = batches[ unit % numBatches ];
+        const int shape = static_cast< int >( unit / numBatches );
+        vtkIdType numNewPts = 0;
+        auto visitor = [uses, &numNewPts]( vtkIdType ptId, vtkIdType index )
+        {
+          if ( uses[ ptId ].load( std::memory_order_relaxed ) == index )
+          {
+            numNewPts ++;
+          }
+        };
+        batch.VisitPointUses( shape, numPts, visitor );
+        batch.NumberOfNewPoints[ shape ] = numNewPts;
+      }
+    } );
+  vtkIdType numUsed = 0;
+  for ( int shape = 0; shape < numShapes; shape ++ )
+  {
+    for ( TableBasedClipperBatch & batch : batches )
+    {
+      batch.PointOffsets[ shape ] = numUsed;
+      numUsed += batch.NumberOfNewPoints[ shape ];
+    }
+  }
+
+  // Set up the output points and their point data: the used input points,
+  // then the points on edges, then the centroid points.
+  const vtkIdType centroidStart = numUsed + numEdges;
+  const vtkIdType nOutPts       = centroidStart + numCentroids;
+  vtkNew< vtkPoints > outPts;
+  outPts->SetDataType( pointsType );
+  outPts->SetNumberOfPoints( nOutPts );
+  vtkPointData * inPD  = input->GetPointData();
+  vtkPointData * outPD = output->GetPointData();
+  AllocateTableBasedClipperAttributes( inPD, outPD, nOutPts );
+
+  std::vector< vtkIdType > pointMap( numPts );
+  vtkSMPTools::For( 0, numUnits,
+    [&]( vtkIdType unit, vtkIdType endUnit )
+    {
+      for ( ; unit < endUnit; unit ++ )
+      {
+        const TableBasedClipperBatch & batch = batches[ unit % numBatches ];
+        const int shape = static_cast< int >( unit / numBatches );
+        vtkIdType newPtId = batch.PointOffsets[ shape ];
+        auto visitor = [&]( vtkIdType ptId, vtkIdType index )
+        {
+          if ( uses[ ptId ].load( std::memory_order_relaxed ) == index )
+          {
+            double x[3];
+            coordinates.GetPoint( ptId, x );
+            outPts->SetPoint( newPtId, x );
+            outPD->CopyData( inPD, ptId, newPtId );
+            pointMap[ ptId ] = newPtId ++;
+          }
+        };
+        batch.VisitPointUses( shape, numPts, visitor );
+      }
+    } );
+  firstUses.reset();
+
+  vtkSMPTools::For( 0, numEdges,
+    [&]( vtkIdType edgeId, vtkIdType endEdgeId )
+    {
+      for ( ; edgeId < endEdgeId; edgeId ++ )
+      {
+        const TableBasedClipperEdgeTuple & edge = edges[ edgeId ];
+        const vtkIdType ptIdx = numUsed + edgeId;
+        double pt1[3], pt2[3], pt[3];
+        coordinates.GetPoint( edge.V0, pt1 );
+        coordinates.GetPoint( edge.V1, pt2 );
+        double p  = edge.T;
+        double bp = 1.0 - p;
+        pt[0] = pt1[0] * p + pt2[0] * bp;
+        pt[1] = pt1[1] * p + pt2[1] * bp;
+        pt[2] = pt1[2] * p + pt2[2] * bp;
+        outPts->SetPoint( ptIdx, pt );
+        outPD->InterpolateEdge( inPD, ptIdx, edge.V0, edge.V1, bp );
+      }
+    } );
+
+  // A centroid point may depend on the previous ones of the same cell, so
+  // the centroid points of a batch are computed in order.
+  TableBasedClipperPointIds pointIds =
+    { numPts, pointMap.data(), numUsed, edgeIds.data(), centroidStart };
+  vtkSMPThreadLocalObject< vtkIdList > idLists;
+  vtkSMPTools::For( 0, numBatches,
+    [&]( vtkIdType batchId, vtkIdType endBatchId )
+    {
+      vtkIdList * idList = idLists.Local();
+      for ( ; batchId < endBatchId; batchId ++ )
+      {
+        const TableBasedClipperBatch & batch = batches[ batchId ];
+        vtkIdType ptIdx = centroidStart + batch.CentroidOffset;
+        for ( size_t c = 0; c < batch.Centroids.size(); c += 9, ptIdx ++ )
+        {
+          const int nPts = static_cast< int >( batch.Centroids[c] );
+          idList->SetNumberOfIds( nPts );
+          double pts[8][3];
+          double weights[8];
+          double pt[3] = { 0.0, 0.0, 0.0 };
+          double weight_factor = 1.0 / nPts;
+          for ( int k = 0; k < nPts; k ++ )
+          {
+            weights[k] = 1.0 * weight_factor;
+            const vtkIdType id = pointIds( batch, batch.Centroids[ c + 1 + k ] );
+            idList->SetId( k, id );
+            outPts->GetPoint( id, pts[k] );
+            pt[0] += pts[k][0];
+            pt[1] += pts[k][1];
+            pt[2] += pts[k][2];
+          }
+          pt[0] *= weight_factor;
+          pt[1] *= weight_factor;
+          pt[2] *= weight_factor;
+
+          outPts->SetPoint( ptIdx, pt );
+          outPD->InterpolatePoint( outPD, ptIdx, idList, weights );
+        }
+      }
+    } );
+  output->SetPoints( outPts );
+
+  // Now set up the shapes and the cell data.
+  vtkCellData * inCD  = input->GetCellData();
+  vtkCellData * outCD = output->GetCellData();
+  AllocateTableBasedClipperAttributes( inCD, outCD, numOutCells );
+  vtkNew< vtkCellArray > cellArray;
+  vtkIdType * nl = cellArray->WritePointer( numOutCells, connSize );
+  vtkNew< vtkUnsignedCharArray > cellTypes;
+  cellTypes->SetNumberOfValues( numOutCells );
+  unsigned char * ct = cellTypes->GetPointer( 0 );
+  vtkNew< vtkIdTypeArray > cellLocations;
+  cellLocations->SetNumberOfValues( numOutCells );
+  vtkIdType * cl = cellLocations->GetPointer( 0 );
+  vtkSMPTools::For( 0, numUnits,
+    [&]( vtkIdType unit, vtkIdType endUnit )
+    {
+      for ( ; unit < endUnit; unit ++ )
+      {
+        const TableBasedClipperBatch & batch = batches[ unit % numBatches ];
+        const int shape = static_cast< int >( unit / numBatches );
+        const int shapeSize = TableBasedClipperShapeSizes[ shape ];
+        const std::vector< vtkIdType > & list = batch.Shapes[ shape ];
+        vtkIdType cellId = batch.CellOffsets[ shape ];
+        vtkIdType index  = batch.ConnectivityOffsets[ shape ];
+        for ( size_t i = 0; i < list.size(); i += shapeSize + 1, cellId ++ )
+        {
+          outCD->CopyData( inCD, list[i], cellId );
+          ct[ cellId ] = TableBasedClipperShapeTypes[ shape ];
+          cl[ cellId ] = index;
+          nl[ index ++ ] = shapeSize;
+          for ( int l = 1; l <= shapeSize; l ++ )
+          {
+            nl[ index ++ ] = pointIds( batch, list[ i + l ] );
+          }
+        }
+      }
+    } );
+
+  output->SetCells( cellTypes, cellLocations, cellArray );
+}
+
+}
+// ============================================================================
+// ================= Multi-threaded table based clipping (end) ================
+// ============================================================================
+
+
 //-----------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
 // set to 0.0; and generate clip scalars turned off.
@@ -2342,6 +3183,11 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
 void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
+  if ( this->ClipInParallel( inputGrd, clipAray, isoValue, outputUG ) )
+  {
+    return;
+  }
+
   vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
 
   int   i, j;
@@ -2687,6 +3533,11 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
 void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
+  if ( this->ClipInParallel( inputGrd, clipAray, isoValue, outputUG ) )
+  {
+    return;
+  }
+
   vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
 
   int   i, j;
@@ -2989,6 +3840,11 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
+  if ( this->ClipInParallel( inputGrd, clipAray, isoValue, outputUG ) )
+  {
+    return;
+  }
+
   vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
 
   vtkIdType   i, j;
@@ -3391,6 +4247,81 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   unstruct = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkTableBasedClipDataSet::ClipInParallel( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  // The original node numbers are only handled by the serial code.
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 ||
+       inputGrd->GetNumberOfCells() == 0 ||
+       vtkArrayDownCast< vtkIntArray >
+         (  inputGrd->GetPointData()->GetArray( "avtOriginalNodeNumbers" )  ) ||
+       !HasOnlyThreadSafeArrays( inputGrd->GetPointData() ) ||
+       !HasOnlyThreadSafeArrays( inputGrd->GetCellData() ) )
+  {
+    return false;
+  }
+
+  // Same precision for the output points as in ConstructDataSet().
+  vtkPointSet * pointSet  = vtkPointSet::SafeDownCast( inputGrd );
+  int           pntsType  = VTK_FLOAT;
+  if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    pntsType = VTK_DOUBLE;
+  }
+  else if ( this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION &&
+            pointSet )
+  {
+    pntsType = pointSet->GetPoints()->GetDataType();
+  }
+
+  const bool insideOut = ( this->InsideOut != 0 );
+  if ( vtkUnstructuredGrid * unstruct =
+         vtkUnstructuredGrid::SafeDownCast( inputGrd ) )
+  {
+    // The cells which can not be clipped with the tables are left to the
+    // serial code.
+    TableBasedClipperCellTables tables;
+    for ( vtkIdType i = 0; i < unstruct->GetNumberOfCells(); i ++ )
+    {
+      if (  !GetTableBasedClipperCellTables( unstruct->GetCellType( i ), tables )  )
+      {
+        return false;
+      }
+    }
+    TableBasedClipperUnstructuredCells cells = { unstruct };
+    TableBasedClipperPointSetCoordinates coordinates = { unstruct->GetPoints() };
+    ClipCellsInParallel( cells, coordinates, unstruct, clipAray, isoValue,
+                         insideOut, pntsType, outputUG );
+  }
+  else if ( vtkStructuredGrid * strcGrid =
+              vtkStructuredGrid::SafeDownCast( inputGrd ) )
+  {
+    TableBasedClipperStructuredCells cells( strcGrid->GetDimensions() );
+    TableBasedClipperPointSetCoordinates coordinates = { strcGrid->GetPoints() };
+    ClipCellsInParallel( cells, coordinates, strcGrid, clipAray, isoValue,
+                         insideOut, pntsType, outputUG );
+  }
+  else if ( vtkRectilinearGrid * rectGrid =
+              vtkRectilinearGrid::SafeDownCast( inputGrd ) )
+  {
+    TableBasedClipperStructuredCells cells( rectGrid->GetDimensions() );
+    TableBasedClipperRectilinearCoordinates coordinates;
+    rectGrid->GetDimensions( coordinates.Dims );
+    coordinates.Coordinates[0] = rectGrid->GetXCoordinates();
+    coordinates.Coordinates[1] = rectGrid->GetYCoordinates();
+    coordinates.Coordinates[2] = rectGrid->GetZCoordinates();
+    ClipCellsInParallel( cells, coordinates, rectGrid, clipAray, isoValue,
+                         insideOut, pntsType, outputUG );
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 {
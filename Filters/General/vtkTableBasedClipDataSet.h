@@ -70,6 +70,11 @@
  *  advantages are gained by adopting the unique clipping and triangulation tables
  *  proposed by VisIt.
  *
+ *  Unstructured grids made of the cells handled by the clipping tables,
+ *  structured grids, rectilinear grids and images are clipped with several
+ *  threads (see vtkSMPTools) when more than one is available. The output is
+ *  the same as with a single thread.
+ *
  * @warning
  *  vtkTableBasedClipDataSet makes use of a hash table (that is provided by class
  *  maintained by internal class vtkTableBasedClipperDataSetFromVolume) to achieve
@@ -287,6 +292,17 @@ protected:
   void ClipUnstructuredGridData( vtkDataSet * inputGrd, vtkDataArray * clipAray,
                                  double isoValue, vtkUnstructuredGrid * outputUG );
 
+  /**
+   * This function clips a vtkUnstructuredGrid, a vtkStructuredGrid or a
+   * vtkRectilinearGrid with several threads, giving the same output as the
+   * three functions above. It returns false, without doing anything, when
+   * only one thread is available or when the input can not be clipped this
+   * way (e.g., an unstructured grid with cells not handled by the clipping
+   * tables); the serial code is then used.
+   */
+  bool ClipInParallel( vtkDataSet * inputGrd, vtkDataArray * clipAray,
+                       double isoValue, vtkUnstructuredGrid * outputUG );
+
 
   /**
    * Register a callback function with the InternalProgressObserver.
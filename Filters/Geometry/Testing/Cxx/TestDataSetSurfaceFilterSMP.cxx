@@ -0,0 +1,297 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the multi-threaded extraction of the surface of an unstructured
+// grid gives exactly the same output as the serial code, for cells in the
+// legacy and split storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTestUtilities.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace
+{
+const int Resolution = 12;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Resolution * (j + Resolution * k);
+}
+
+// Build a block of cubes split into cells of all the supported types, with
+// a few more 2D, 1D and 0D cells, and some hidden points.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        points->InsertNextPoint(i, j + 0.1 * i, k);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->Allocate();
+
+  for (int k = 0; k < Resolution - 1; ++k)
+  {
+    for (int j = 0; j < Resolution - 1; ++j)
+    {
+      for (int i = 0; i < Resolution - 1; ++i)
+      {
+        const vtkIdType c[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + 2 * j + 3 * k) % 5)
+        {
+          case 0:
+          case 1:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+            break;
+          case 2:
+          {
+            const vtkIdType voxel[8] =
+              { c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+            break;
+          }
+          case 3:
+          {
+            const vtkIdType wedge1[6] = { c[0], c[1], c[3], c[4], c[5], c[7] };
+            const vtkIdType wedge2[6] = { c[1], c[2], c[3], c[5], c[6], c[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+            break;
+          }
+          default:
+          {
+            const vtkIdType pyramid[5] = { c[0], c[1], c[2], c[3], c[6] };
+            const vtkIdType tetra1[4] = { c[0], c[6], c[7], c[3] };
+            const vtkIdType tetra2[4] = { c[0], c[5], c[6], c[1] };
+            const vtkIdType tetra3[4] = { c[0], c[4], c[5], c[6] };
+            const vtkIdType tetra4[4] = { c[0], c[7], c[6], c[4] };
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+            grid->InsertNextCell(VTK_TETRA, 4, tetra1);
+            grid->InsertNextCell(VTK_TETRA, 4, tetra2);
+            grid->InsertNextCell(VTK_TETRA, 4, tetra3);
+            grid->InsertNextCell(VTK_TETRA, 4, tetra4);
+          }
+        }
+      }
+    }
+
+    // Prisms, lower dimensional cells and duplicated cells in between.
+    const vtkIdType r = Resolution;
+    const vtkIdType base = PointId(0, 0, k);
+    const vtkIdType pentagon[10] = {
+      base, base + 1, base + r + 2, base + 2 * r + 1, base + r,
+      base + r * r, base + r * r + 1, base + r * r + r + 2,
+      base + r * r + 2 * r + 1, base + r * r + r };
+    grid->InsertNextCell(VTK_PENTAGONAL_PRISM, 10, pentagon);
+    const vtkIdType hexagon[12] = {
+      base + 3, base + 4, base + r + 5, base + 2 * r + 4, base + 2 * r + 3,
+      base + r + 2, base + r * r + 3, base + r * r + 4,
+      base + r * r + r + 5, base + r * r + 2 * r + 4,
+      base + r * r + 2 * r + 3, base + r * r + r + 2 };
+    grid->InsertNextCell(VTK_HEXAGONAL_PRISM, 12, hexagon);
+    grid->InsertNextCell(VTK_HEXAGONAL_PRISM, 12, hexagon);
+
+    const vtkIdType quad[4] = { base, base + r, base + r + 1, base + 1 };
+    grid->InsertNextCell(VTK_QUAD, 4, quad);
+    grid->InsertNextCell(VTK_PIXEL, 4, quad);
+    grid->InsertNextCell(VTK_TRIANGLE, 3, quad);
+    grid->InsertNextCell(VTK_POLYGON, 5, pentagon);
+    grid->InsertNextCell(VTK_TRIANGLE_STRIP, 6, hexagon);
+    grid->InsertNextCell(VTK_TRIANGLE_STRIP, 2, hexagon);
+    grid->InsertNextCell(VTK_LINE, 2, quad + 1);
+    grid->InsertNextCell(VTK_POLY_LINE, 4, hexagon + 6);
+    grid->InsertNextCell(VTK_VERTEX, 1, pentagon + 7);
+    grid->InsertNextCell(VTK_POLY_VERTEX, 3, quad);
+  }
+
+  // Attributes, and ghost points on a side of the block.
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+  {
+    pointScalars->InsertNextValue(0.5 * ptId);
+    unsigned char ghost = 0;
+    if (ptId % Resolution == Resolution - 1)
+    {
+      ghost = vtkDataSetAttributes::DUPLICATEPOINT;
+    }
+    else if (ptId % 97 == 0)
+    {
+      ghost = vtkDataSetAttributes::HIDDENPOINT;
+    }
+    ghosts->InsertNextValue(ghost);
+  }
+  grid->GetPointData()->SetScalars(pointScalars);
+  grid->GetPointData()->AddArray(ghosts);
+
+  vtkNew<vtkIntArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->SetNumberOfComponents(2);
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    cellValues->InsertNextTuple2(cellId, -cellId);
+  }
+  grid->GetCellData()->AddArray(cellValues);
+  return grid;
+}
+
+vtkSmartPointer<vtkPolyData> ExtractSurface(vtkUnstructuredGrid *input)
+{
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  surface->Update();
+
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->DeepCopy(surface->GetOutput());
+  return output;
+}
+
+bool SameCellArrays(vtkCellArray *cells1, vtkCellArray *cells2)
+{
+  const vtkIdType size = cells1->GetNumberOfConnectivityEntries();
+  return cells1->GetNumberOfCells() == cells2->GetNumberOfCells() &&
+    size == cells2->GetNumberOfConnectivityEntries() &&
+    (size == 0 ||
+     std::memcmp(cells1->GetPointer(), cells2->GetPointer(),
+                 size * sizeof(vtkIdType)) == 0);
+}
+
+bool SameArrays(vtkDataArray *array1, vtkDataArray *array2)
+{
+  if (!array1 || !array2 ||
+      array1->GetDataType() != array2->GetDataType() ||
+      array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+      array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const vtkIdType size =
+    array1->GetNumberOfTuples() * array1->GetNumberOfComponents();
+  return size == 0 ||
+    std::memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0),
+                size * array1->GetDataTypeSize()) == 0;
+}
+
+bool SameAttributes(vtkDataSetAttributes *attributes1,
+                    vtkDataSetAttributes *attributes2)
+{
+  if (attributes1->GetNumberOfArrays() != attributes2->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < attributes1->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array1 = attributes1->GetArray(i);
+    if (!SameArrays(array1, attributes2->GetArray(array1->GetName())))
+    {
+      std::cerr << "Error: different " << array1->GetName() << " arrays"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *output1, vtkPolyData *output2)
+{
+  if (!SameArrays(output1->GetPoints()->GetData(),
+                  output2->GetPoints()->GetData()))
+  {
+    std::cerr << "Error: different points" << std::endl;
+    return false;
+  }
+  if (!SameCellArrays(output1->GetVerts(), output2->GetVerts()) ||
+      !SameCellArrays(output1->GetLines(), output2->GetLines()) ||
+      !SameCellArrays(output1->GetPolys(), output2->GetPolys()) ||
+      output2->GetNumberOfStrips() != 0)
+  {
+    std::cerr << "Error: different cells" << std::endl;
+    return false;
+  }
+  return SameAttributes(output1->GetPointData(), output2->GetPointData()) &&
+    SameAttributes(output1->GetCellData(), output2->GetCellData());
+}
+}
+
+int TestDataSetSurfaceFilterSMP(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> input = ConstructGrid();
+  vtkNew<vtkUnstructuredGrid> splitInput;
+  splitInput->DeepCopy(input);
+  splitInput->GetCells()->SetStorageMode(vtkCellArray::SPLIT_STORAGE_32BIT);
+
+  // The sequential backend runs the serial code.
+  vtkSmartPointer<vtkPolyData> reference;
+  auto computeReference = [&]()
+  {
+    reference = ExtractSurface(input);
+    if (reference->GetNumberOfPolys() == 0 ||
+        reference->GetNumberOfLines() == 0 ||
+        reference->GetNumberOfVerts() == 0)
+    {
+      std::cerr << "Error: missing cells in the surface" << std::endl;
+      return false;
+    }
+    return true;
+  };
+  auto compare = [&](const char *backend)
+  {
+    vtkSmartPointer<vtkPolyData> output = ExtractSurface(input);
+    vtkSmartPointer<vtkPolyData> splitOutput = ExtractSurface(splitInput);
+    if (!SameOutputs(reference, output) ||
+        !SameOutputs(reference, splitOutput))
+    {
+      std::cerr << "Error: the " << backend << " backend gives a different "
+                << "surface" << std::endl;
+      return false;
+    }
+    return true;
+  };
+  if (!vtkSMPTestUtilities::CompareBackends(computeReference, compare))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
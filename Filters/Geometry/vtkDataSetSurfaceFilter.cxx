@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkDataSetSurfaceFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -32,6 +33,7 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -49,8 +51,11 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 static inline int sizeofFastQuad(int numPts)
 {
@@ -101,6 +106,795 @@ protected:
   MapType Map;
 };
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Multi-threaded extraction of the surface of unstructured grids made of
+// linear cells. The output is identical to the one of the serial code: the
+// faces of the 3D cells are hashed with the rules of InsertQuadInHash(),
+// InsertTriInHash() and InsertPolygonInHash(), in the same order, and the
+// points are numbered by first use.
+//
+// The cells are split in chunks of consecutive cells, and the points in
+// partitions of consecutive point ids. The faces of a chunk are sorted by
+// the partition of their smallest point id (the bin of the serial hash), so
+// that each partition can be hashed independently. The work is then split
+// in units, ordered like the output of the serial code: the vertices, lines
+// and 2D cells of each chunk, followed by the visible faces of each
+// partition.
+
+// How cells are processed.
+enum CellCategory
+{
+  SURFACE_VERTS = 0, // vertices, copied to the output
+  SURFACE_LINES = 1, // lines, copied to the output
+  SURFACE_POLYS = 2, // 2D cells, copied to the output
+  SURFACE_SOLID = 3, // 3D cells, whose faces are hashed
+  SURFACE_UNSUPPORTED = 4
+};
+
+int GetCellCategory(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+      return SURFACE_VERTS;
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+      return SURFACE_LINES;
+    case VTK_PIXEL:
+    case VTK_QUAD:
+    case VTK_TRIANGLE:
+    case VTK_POLYGON:
+    case VTK_TRIANGLE_STRIP:
+      return SURFACE_POLYS;
+    case VTK_TETRA:
+    case VTK_VOXEL:
+    case VTK_HEXAHEDRON:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      return SURFACE_SOLID;
+    default:
+      return SURFACE_UNSUPPORTED;
+  }
+}
+
+// The faces of the 3D cells, in the order in which
+// vtkDataSetSurfaceFilter::UnstructuredGridExecute() inserts them in the
+// hash. The kind of a face selects the insertion method.
+enum FaceKind
+{
+  TRI_FACE,
+  QUAD_FACE,
+  POLYGON_FACE
+};
+
+struct CellFace
+{
+  int Kind;
+  int NumberOfPoints;
+  int Points[6];
+};
+
+struct CellFaces
+{
+  int NumberOfFaces;
+  CellFace Faces[8];
+};
+
+const CellFaces TetraFaces = { 4, {
+  { TRI_FACE, 3, { 0, 1, 3 } },
+  { TRI_FACE, 3, { 0, 2, 1 } },
+  { TRI_FACE, 3, { 0, 3, 2 } },
+  { TRI_FACE, 3, { 1, 2, 3 } } } };
+
+const CellFaces VoxelFaces = { 6, {
+  { QUAD_FACE, 4, { 0, 1, 5, 4 } },
+  { QUAD_FACE, 4, { 0, 2, 3, 1 } },
+  { QUAD_FACE, 4, { 0, 4, 6, 2 } },
+  { QUAD_FACE, 4, { 1, 3, 7, 5 } },
+  { QUAD_FACE, 4, { 2, 6, 7, 3 } },
+  { QUAD_FACE, 4, { 4, 5, 7, 6 } } } };
+
+const CellFaces HexahedronFaces = { 6, {
+  { QUAD_FACE, 4, { 0, 1, 5, 4 } },
+  { QUAD_FACE, 4, { 0, 3, 2, 1 } },
+  { QUAD_FACE, 4, { 0, 4, 7, 3 } },
+  { QUAD_FACE, 4, { 1, 2, 6, 5 } },
+  { QUAD_FACE, 4, { 2, 3, 7, 6 } },
+  { QUAD_FACE, 4, { 4, 5, 6, 7 } } } };
+
+const CellFaces WedgeFaces = { 5, {
+  { QUAD_FACE, 4, { 0, 2, 5, 3 } },
+  { QUAD_FACE, 4, { 1, 0, 3, 4 } },
+  { QUAD_FACE, 4, { 2, 1, 4, 5 } },
+  { TRI_FACE, 3, { 0, 1, 2 } },
+  { TRI_FACE, 3, { 3, 5, 4 } } } };
+
+const CellFaces PyramidFaces = { 5, {
+  { QUAD_FACE, 4, { 3, 2, 1, 0 } },
+  { TRI_FACE, 3, { 0, 1, 4 } },
+  { TRI_FACE, 3, { 1, 2, 4 } },
+  { TRI_FACE, 3, { 2, 3, 4 } },
+  { TRI_FACE, 3, { 3, 0, 4 } } } };
+
+const CellFaces PentagonalPrismFaces = { 7, {
+  { QUAD_FACE, 4, { 0, 1, 6, 5 } },
+  { QUAD_FACE, 4, { 1, 2, 7, 6 } },
+  { QUAD_FACE, 4, { 2, 3, 8, 7 } },
+  { QUAD_FACE, 4, { 3, 4, 9, 8 } },
+  { QUAD_FACE, 4, { 4, 0, 5, 9 } },
+  { POLYGON_FACE, 5, { 0, 1, 2, 3, 4 } },
+  { POLYGON_FACE, 5, { 5, 6, 7, 8, 9 } } } };
+
+const CellFaces HexagonalPrismFaces = { 8, {
+  { QUAD_FACE, 4, { 0, 1, 7, 6 } },
+  { QUAD_FACE, 4, { 1, 2, 8, 7 } },
+  { QUAD_FACE, 4, { 2, 3, 9, 8 } },
+  { QUAD_FACE, 4, { 3, 4, 10, 9 } },
+  { QUAD_FACE, 4, { 4, 5, 11, 10 } },
+  { QUAD_FACE, 4, { 5, 0, 6, 11 } },
+  { POLYGON_FACE, 6, { 0, 1, 2, 3, 4, 5 } },
+  { POLYGON_FACE, 6, { 6, 7, 8, 9, 10, 11 } } } };
+
+const CellFaces* GetCellFaces(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      return &TetraFaces;
+    case VTK_VOXEL:
+      return &VoxelFaces;
+    case VTK_HEXAHEDRON:
+      return &HexahedronFaces;
+    case VTK_WEDGE:
+      return &WedgeFaces;
+    case VTK_PYRAMID:
+      return &PyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      return &PentagonalPrismFaces;
+    case VTK_HEXAGONAL_PRISM:
+      return &HexagonalPrismFaces;
+    default:
+      return nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Get the point ids of a face, reordered like the insertion methods of the
+// hash do. The first id is the bin of the face.
+void GetFacePoints(const CellFace &face, const vtkIdType *cellPts,
+                   vtkIdType *ids)
+{
+  const int numPts = face.NumberOfPoints;
+  for (int i = 0; i < numPts; ++i)
+  {
+    ids[i] = cellPts[face.Points[i]];
+  }
+
+  if (face.Kind == QUAD_FACE)
+  {
+    const vtkIdType a = ids[0], b = ids[1], c = ids[2], d = ids[3];
+    if (b < a && b < c && b < d)
+    {
+      ids[0] = b; ids[1] = c; ids[2] = d; ids[3] = a;
+    }
+    else if (c < a && c < b && c < d)
+    {
+      ids[0] = c; ids[1] = d; ids[2] = a; ids[3] = b;
+    }
+    else if (d < a && d < b && d < c)
+    {
+      ids[0] = d; ids[1] = a; ids[2] = b; ids[3] = c;
+    }
+  }
+  else if (face.Kind == TRI_FACE)
+  {
+    const vtkIdType a = ids[0], b = ids[1], c = ids[2];
+    if (b < a && b < c)
+    {
+      ids[0] = b; ids[1] = c; ids[2] = a;
+    }
+    else if (c < a && c < b)
+    {
+      ids[0] = c; ids[1] = a; ids[2] = b;
+    }
+  }
+  else
+  {
+    int offset = 0;
+    for (int i = 0; i < numPts; ++i)
+    {
+      if (ids[i] < ids[offset])
+      {
+        offset = i;
+      }
+    }
+    std::rotate(ids, ids + offset, ids + numPts);
+  }
+}
+
+//----------------------------------------------------------------------------
+// A face of the hash of a partition.
+struct HashedFace
+{
+  vtkIdType Points[6];
+  vtkIdType SourceId; // -1 when the face is shared by several cells
+  vtkIdType Next; // next face in the bin, or -1
+  int NumberOfPoints;
+};
+
+// Tell whether an inserted face matches a face of the hash, with the rules
+// of the insertion methods of vtkDataSetSurfaceFilter.
+bool MatchFace(int kind, const vtkIdType *ids, int numPts,
+               const HashedFace &face)
+{
+  const vtkIdType *pts = face.Points;
+  if (kind == QUAD_FACE)
+  {
+    return face.NumberOfPoints == 4 && ids[2] == pts[2] &&
+      ((ids[1] == pts[1] && ids[3] == pts[3]) ||
+       (ids[1] == pts[3] && ids[3] == pts[1]));
+  }
+  if (kind == TRI_FACE)
+  {
+    return face.NumberOfPoints == 3 &&
+      ((ids[1] == pts[1] && ids[2] == pts[2]) ||
+       (ids[1] == pts[2] && ids[2] == pts[1]));
+  }
+  if (face.NumberOfPoints != numPts || ids[0] != pts[0])
+  {
+    return false;
+  }
+  if (numPts > 1 && ids[1] == pts[1])
+  {
+    for (int i = 2; i < numPts; ++i)
+    {
+      if (ids[i] != pts[i])
+      {
+        return false;
+      }
+    }
+  }
+  else
+  {
+    for (int i = 1; i < numPts; ++i)
+    {
+      if (ids[numPts - i] != pts[i])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// A face of a chunk: the cell and the index of the face in the cell.
+struct FaceReference
+{
+  vtkIdType CellId;
+  int Face;
+};
+
+// A unit of work. The offsets are exclusive prefix sums over the units.
+struct SurfaceUnit
+{
+  vtkIdType NumberOfUses; // point uses, which define the point numbering
+  vtkIdType NumberOfCells; // output cells
+  vtkIdType ConnectivitySize; // entries of the output cell array
+  vtkIdType NumberOfPoints; // points used for the first time
+  vtkIdType UseOffset;
+  vtkIdType CellOffset;
+  vtkIdType ConnectivityOffset;
+  vtkIdType PointOffset;
+};
+
+//----------------------------------------------------------------------------
+// State shared by the passes of the parallel extraction.
+struct SurfaceExtraction
+{
+  vtkUnstructuredGrid *Input;
+  const unsigned char *Ghosts;
+  vtkIdType NumberOfChunks;
+  vtkIdType NumberOfPartitions;
+  vtkIdType PartitionSize;
+
+  // Chunk units first (for each category, for each chunk), then the face
+  // units (one per partition).
+  std::vector<SurfaceUnit> Units;
+  // Faces of each chunk, per partition: [chunk * NumberOfPartitions + p]
+  std::vector<std::vector<FaceReference> > ChunkFaces;
+  // Hashed faces of each partition, and the faces visible in order.
+  std::vector<std::vector<HashedFace> > PartitionFaces;
+  std::vector<std::vector<vtkIdType> > VisibleFaces;
+
+  std::atomic<vtkIdType> *FirstUses;
+  vtkIdType *PointMap;
+
+  vtkIdType GetChunkBegin(vtkIdType chunk) const
+  {
+    return chunk * this->Input->GetNumberOfCells() / this->NumberOfChunks;
+  }
+
+  // Tell whether a face of the hash is not extracted because of the ghost
+  // points. Like the serial code, its points are still used.
+  bool IsHidden(const HashedFace &face) const
+  {
+    if (!this->Ghosts)
+    {
+      return false;
+    }
+    bool allGhosts = true;
+    bool oneHidden = false;
+    for (int i = 0; i < face.NumberOfPoints; ++i)
+    {
+      unsigned char val = this->Ghosts[face.Points[i]];
+      if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+      {
+        allGhosts = false;
+      }
+      if (val & vtkDataSetAttributes::HIDDENPOINT)
+      {
+        oneHidden = true;
+      }
+    }
+    return allGhosts || oneHidden;
+  }
+
+  // Call visitor(ptId) for the point uses of a unit, in order.
+  template <typename Visitor>
+  void VisitPointUses(vtkIdType unit, Visitor &visitor)
+  {
+    const vtkIdType numChunkUnits = 3 * this->NumberOfChunks;
+    if (unit >= numChunkUnits)
+    {
+      const vtkIdType partition = unit - numChunkUnits;
+      const std::vector<HashedFace> &faces = this->PartitionFaces[partition];
+      for (vtkIdType faceId : this->VisibleFaces[partition])
+      {
+        const HashedFace &face = faces[faceId];
+        for (int i = 0; i < face.NumberOfPoints; ++i)
+        {
+          visitor(face.Points[i]);
+        }
+      }
+      return;
+    }
+
+    const int category = static_cast<int>(unit / this->NumberOfChunks);
+    const vtkIdType chunk = unit % this->NumberOfChunks;
+    const vtkIdType endCellId = this->GetChunkBegin(chunk + 1);
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId = this->GetChunkBegin(chunk); cellId < endCellId;
+         ++cellId)
+    {
+      const int cellType = this->Input->GetCellType(cellId);
+      if (GetCellCategory(cellType) != category)
+      {
+        continue;
+      }
+      this->Input->GetCellPoints(cellId, npts, pts);
+      if (cellType == VTK_PIXEL)
+      {
+        visitor(pts[0]);
+        visitor(pts[1]);
+        visitor(pts[3]);
+        visitor(pts[2]);
+      }
+      else if (cellType != VTK_TRIANGLE_STRIP || npts > 1)
+      {
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          visitor(pts[i]);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the output of the chunks, and sort their faces by partition.
+struct CountChunkCells
+{
+  SurfaceExtraction *Surface;
+
+  CountChunkCells(SurfaceExtraction *surface) : Surface(surface) {}
+
+  void operator()(vtkIdType chunk, vtkIdType endChunk)
+  {
+    SurfaceExtraction *surface = this->Surface;
+    vtkUnstructuredGrid *input = surface->Input;
+    const vtkIdType numChunks = surface->NumberOfChunks;
+    const vtkIdType numPartitions = surface->NumberOfPartitions;
+    vtkIdType npts, *pts, ids[6];
+    for ( ; chunk < endChunk; ++chunk)
+    {
+      SurfaceUnit *units[3];
+      for (int category = 0; category < 3; ++category)
+      {
+        units[category] = &surface->Units[category * numChunks + chunk];
+        units[category]->NumberOfUses = 0;
+        units[category]->NumberOfCells = 0;
+        units[category]->ConnectivitySize = 0;
+      }
+      std::vector<FaceReference> *faces =
+        &surface->ChunkFaces[chunk * numPartitions];
+
+      const vtkIdType endCellId = surface->GetChunkBegin(chunk + 1);
+      for (vtkIdType cellId = surface->GetChunkBegin(chunk);
+           cellId < endCellId; ++cellId)
+      {
+        const int cellType = input->GetCellType(cellId);
+        const int category = GetCellCategory(cellType);
+        input->GetCellPoints(cellId, npts, pts);
+        if (category == SURFACE_SOLID)
+        {
+          const CellFaces *cellFaces = GetCellFaces(cellType);
+          for (int face = 0; face < cellFaces->NumberOfFaces; ++face)
+          {
+            GetFacePoints(cellFaces->Faces[face], pts, ids);
+            faces[ids[0] / surface->PartitionSize].push_back(
+              FaceReference{ cellId, face });
+          }
+        }
+        else if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          if (npts > 1)
+          {
+            units[category]->NumberOfUses += npts;
+            units[category]->NumberOfCells += npts - 2;
+            units[category]->ConnectivitySize += 4 * (npts - 2);
+          }
+        }
+        else
+        {
+          units[category]->NumberOfUses += npts;
+          units[category]->NumberOfCells++;
+          units[category]->ConnectivitySize += npts + 1;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Hash the faces of each partition, in the order of the serial code, and
+// collect the visible faces in the order of the bins.
+struct HashPartitionFaces
+{
+  SurfaceExtraction *Surface;
+
+  HashPartitionFaces(SurfaceExtraction *surface) : Surface(surface) {}
+
+  void operator()(vtkIdType partition, vtkIdType endPartition)
+  {
+    SurfaceExtraction *surface = this->Surface;
+    vtkUnstructuredGrid *input = surface->Input;
+    const vtkIdType numPartitions = surface->NumberOfPartitions;
+    std::vector<vtkIdType> bins;
+    vtkIdType npts, *pts, ids[6];
+    for ( ; partition < endPartition; ++partition)
+    {
+      const vtkIdType firstPtId = partition * surface->PartitionSize;
+      bins.assign(surface->PartitionSize, -1);
+      std::vector<HashedFace> &faces = surface->PartitionFaces[partition];
+
+      for (vtkIdType chunk = 0; chunk < surface->NumberOfChunks; ++chunk)
+      {
+        for (const FaceReference &ref :
+               surface->ChunkFaces[chunk * numPartitions + partition])
+        {
+          input->GetCellPoints(ref.CellId, npts, pts);
+          const CellFace &cellFace = GetCellFaces(
+            input->GetCellType(ref.CellId))->Faces[ref.Face];
+          GetFacePoints(cellFace, pts, ids);
+
+          // Look for the face in its bin, then append it if not found.
+          vtkIdType *next = &bins[ids[0] - firstPtId];
+          bool found = false;
+          while (*next != -1)
+          {
+            HashedFace &face = faces[*next];
+            if (MatchFace(cellFace.Kind, ids, cellFace.NumberOfPoints, face))
+            {
+              face.SourceId = -1;
+              found = true;
+              break;
+            }
+            next = &face.Next;
+          }
+          if (!found)
+          {
+            *next = static_cast<vtkIdType>(faces.size());
+            HashedFace face;
+            std::copy(ids, ids + cellFace.NumberOfPoints, face.Points);
+            face.SourceId = ref.CellId;
+            face.Next = -1;
+            face.NumberOfPoints = cellFace.NumberOfPoints;
+            faces.push_back(face);
+          }
+        }
+      }
+
+      // Faces are visible when not shared by several cells.
+      SurfaceUnit &unit = surface->Units[3 * surface->NumberOfChunks +
+                                         partition];
+      unit.NumberOfUses = 0;
+      unit.NumberOfCells = 0;
+      unit.ConnectivitySize = 0;
+      std::vector<vtkIdType> &visible = surface->VisibleFaces[partition];
+      for (vtkIdType faceId : bins)
+      {
+        for ( ; faceId != -1; faceId = faces[faceId].Next)
+        {
+          const HashedFace &face = faces[faceId];
+          if (face.SourceId != -1)
+          {
+            visible.push_back(faceId);
+            unit.NumberOfUses += face.NumberOfPoints;
+            if (!surface->IsHidden(face))
+            {
+              unit.NumberOfCells++;
+              unit.ConnectivitySize += face.NumberOfPoints + 1;
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the first use of each point.
+struct FindFirstUses
+{
+  SurfaceExtraction *Surface;
+
+  FindFirstUses(SurfaceExtraction *surface) : Surface(surface) {}
+
+  void operator()(vtkIdType unit, vtkIdType endUnit)
+  {
+    std::atomic<vtkIdType> *firstUses = this->Surface->FirstUses;
+    for ( ; unit < endUnit; ++unit)
+    {
+      vtkIdType use = this->Surface->Units[unit].UseOffset;
+      auto visitor = [firstUses, &use](vtkIdType ptId)
+      {
+        vtkIdType current = firstUses[ptId].load(std::memory_order_relaxed);
+        while (use < current &&
+               !firstUses[ptId].compare_exchange_weak(
+                 current, use, std::memory_order_relaxed))
+        {
+        }
+        ++use;
+      };
+      this->Surface->VisitPointUses(unit, visitor);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the points used for the first time in each unit.
+struct CountNewPoints
+{
+  SurfaceExtraction *Surface;
+
+  CountNewPoints(SurfaceExtraction *surface) : Surface(surface) {}
+
+  void operator()(vtkIdType unit, vtkIdType endUnit)
+  {
+    const std::atomic<vtkIdType> *firstUses = this->Surface->FirstUses;
+    for ( ; unit < endUnit; ++unit)
+    {
+      SurfaceUnit &surfaceUnit = this->Surface->Units[unit];
+      vtkIdType use = surfaceUnit.UseOffset;
+      vtkIdType numNewPts = 0;
+      auto visitor = [firstUses, &use, &numNewPts](vtkIdType ptId)
+      {
+        if (firstUses[ptId].load(std::memory_order_relaxed) == use++)
+        {
+          ++numNewPts;
+        }
+      };
+      this->Surface->VisitPointUses(unit, visitor);
+      surfaceUnit.NumberOfPoints = numNewPts;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Number the points and copy them, with their attributes, to the output.
+struct CopyNewPoints
+{
+  SurfaceExtraction *Surface;
+  vtkPoints *InPts;
+  vtkPoints *OutPts;
+  vtkIdTypeArray *OriginalPointIds;
+  ArrayList Arrays;
+
+  CopyNewPoints(SurfaceExtraction *surface, vtkPoints *inPts,
+                vtkPointData *inPD, vtkIdType numNewPts, vtkPoints *outPts,
+                vtkPointData *outPD, vtkIdTypeArray *originalPointIds) :
+    Surface(surface), InPts(inPts), OutPts(outPts),
+    OriginalPointIds(originalPointIds)
+  {
+    this->Arrays.AddArrays(numNewPts, inPD, outPD, 0.0, false);
+  }
+
+  void operator()(vtkIdType unit, vtkIdType endUnit)
+  {
+    const std::atomic<vtkIdType> *firstUses = this->Surface->FirstUses;
+    vtkIdType *pointMap = this->Surface->PointMap;
+    for ( ; unit < endUnit; ++unit)
+    {
+      const SurfaceUnit &surfaceUnit = this->Surface->Units[unit];
+      vtkIdType use = surfaceUnit.UseOffset;
+      vtkIdType newPtId = surfaceUnit.PointOffset;
+      auto visitor = [&](vtkIdType ptId)
+      {
+        if (firstUses[ptId].load(std::memory_order_relaxed) == use++)
+        {
+          double x[3];
+          this->InPts->GetPoint(ptId, x);
+          this->OutPts->SetPoint(newPtId, x);
+          this->Arrays.Copy(ptId, newPtId);
+          if (this->OriginalPointIds)
+          {
+            this->OriginalPointIds->SetValue(newPtId, ptId);
+          }
+          pointMap[ptId] = newPtId++;
+        }
+      };
+      this->Surface->VisitPointUses(unit, visitor);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Write the output cells, with their attributes.
+struct GenerateSurfaceCells
+{
+  SurfaceExtraction *Surface;
+  vtkIdType *Connectivity[3];
+  vtkIdTypeArray *OriginalCellIds;
+  ArrayList Arrays;
+
+  GenerateSurfaceCells(SurfaceExtraction *surface,
+                       vtkIdType *connectivity[3], vtkCellData *inCD,
+                       vtkIdType numNewCells, vtkCellData *outCD,
+                       vtkIdTypeArray *originalCellIds) :
+    Surface(surface), OriginalCellIds(originalCellIds)
+  {
+    std::copy(connectivity, connectivity + 3, this->Connectivity);
+    this->Arrays.AddArrays(numNewCells, inCD, outCD, 0.0, false);
+  }
+
+  void AddCell(vtkIdType *&cell, vtkIdType &newCellId, vtkIdType npts,
+               const vtkIdType *pts, vtkIdType sourceId)
+  {
+    const vtkIdType *pointMap = this->Surface->PointMap;
+    *cell++ = npts;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      *cell++ = pointMap[pts[i]];
+    }
+    this->Arrays.Copy(sourceId, newCellId);
+    if (this->OriginalCellIds)
+    {
+      this->OriginalCellIds->SetValue(newCellId, sourceId);
+    }
+    ++newCellId;
+  }
+
+  void operator()(vtkIdType unit, vtkIdType endUnit)
+  {
+    SurfaceExtraction *surface = this->Surface;
+    vtkUnstructuredGrid *input = surface->Input;
+    const vtkIdType numChunkUnits = 3 * surface->NumberOfChunks;
+    vtkIdType npts, *pts, ids[4];
+    for ( ; unit < endUnit; ++unit)
+    {
+      const SurfaceUnit &surfaceUnit = surface->Units[unit];
+      vtkIdType newCellId = surfaceUnit.CellOffset;
+      if (unit >= numChunkUnits)
+      {
+        vtkIdType *cell = this->Connectivity[SURFACE_POLYS] +
+          surfaceUnit.ConnectivityOffset;
+        const vtkIdType partition = unit - numChunkUnits;
+        const std::vector<HashedFace> &faces =
+          surface->PartitionFaces[partition];
+        for (vtkIdType faceId : surface->VisibleFaces[partition])
+        {
+          const HashedFace &face = faces[faceId];
+          if (!surface->IsHidden(face))
+          {
+            this->AddCell(cell, newCellId, face.NumberOfPoints, face.Points,
+                          face.SourceId);
+          }
+        }
+        continue;
+      }
+
+      const int category =
+        static_cast<int>(unit / surface->NumberOfChunks);
+      const vtkIdType chunk = unit % surface->NumberOfChunks;
+      vtkIdType *cell =
+        this->Connectivity[category] + surfaceUnit.ConnectivityOffset;
+      const vtkIdType endCellId = surface->GetChunkBegin(chunk + 1);
+      for (vtkIdType cellId = surface->GetChunkBegin(chunk);
+           cellId < endCellId; ++cellId)
+      {
+        const int cellType = input->GetCellType(cellId);
+        if (GetCellCategory(cellType) != category)
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, npts, pts);
+        if (cellType == VTK_PIXEL)
+        {
+          ids[0] = pts[0];
+          ids[1] = pts[1];
+          ids[2] = pts[3];
+          ids[3] = pts[2];
+          this->AddCell(cell, newCellId, 4, ids, cellId);
+        }
+        else if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          // Change strips to triangles, like the serial code.
+          int toggle = 0;
+          if (npts > 1)
+          {
+            ids[0] = pts[0];
+            ids[1] = pts[1];
+            for (vtkIdType i = 2; i < npts; ++i)
+            {
+              ids[2] = pts[i];
+              this->AddCell(cell, newCellId, 3, ids, cellId);
+              ids[toggle] = ids[2];
+              toggle = !toggle;
+            }
+          }
+        }
+        else
+        {
+          this->AddCell(cell, newCellId, npts, pts, cellId);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The parallel extraction handles the linear cells which the serial code
+// processes without vtkGenericCell, and attributes which vtkArrayList can
+// copy.
+bool CanExtractSurfaceInParallel(vtkUnstructuredGrid *input)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() < 2 || numCells < 1 ||
+      input->GetNumberOfPoints() < 1 ||
+      !ArrayList::ProcessesAllArrays(input->GetPointData()) ||
+      !ArrayList::ProcessesAllArrays(input->GetCellData()))
+  {
+    return false;
+  }
+  const unsigned char *types = input->GetCellTypesArray()->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (GetCellCategory(types[cellId]) == SURFACE_UNSUPPORTED)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anonymous namespace
+
 vtkObjectFactoryNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -1518,6 +2312,13 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     }
   }
 
+  // Grids of linear cells are processed with several threads when possible.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (!handleSubdivision && grid && CanExtractSurfaceInParallel(grid))
+  {
+    return this->ParallelUnstructuredGridExecute(grid, output);
+  }
+
   vtkSmartPointer<vtkUnstructuredGrid> tempInput;
   if (handleSubdivision)
   {
@@ -2246,6 +3047,158 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkDataSetSurfaceFilter::ParallelUnstructuredGridExecute(
+  vtkUnstructuredGrid *input, vtkPolyData *output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  SurfaceExtraction surface;
+  surface.Input = input;
+  vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+  surface.Ghosts = ghosts ? ghosts->GetPointer(0) : nullptr;
+  surface.NumberOfChunks = std::min(numCells, 8 * numThreads);
+  surface.NumberOfPartitions = std::min(numPts, 8 * numThreads);
+  surface.PartitionSize = (numPts + surface.NumberOfPartitions - 1) /
+    surface.NumberOfPartitions;
+  const vtkIdType numUnits =
+    3 * surface.NumberOfChunks + surface.NumberOfPartitions;
+  surface.Units.resize(numUnits);
+  surface.ChunkFaces.resize(surface.NumberOfChunks *
+                            surface.NumberOfPartitions);
+  surface.PartitionFaces.resize(surface.NumberOfPartitions);
+  surface.VisibleFaces.resize(surface.NumberOfPartitions);
+
+  // Sort the faces of the 3D cells by partition, then hash them.
+  CountChunkCells countCells(&surface);
+  vtkSMPTools::For(0, surface.NumberOfChunks, 1, countCells);
+  this->UpdateProgress(0.25);
+  HashPartitionFaces hashFaces(&surface);
+  vtkSMPTools::For(0, surface.NumberOfPartitions, 1, hashFaces);
+  std::vector<std::vector<FaceReference> >().swap(surface.ChunkFaces);
+  this->UpdateProgress(0.5);
+
+  // Offsets of the units. Each category of cells goes to its own cell array,
+  // the faces go after the 2D cells.
+  vtkIdType numUses = 0;
+  vtkIdType numNewCells = 0;
+  vtkIdType numCategoryCells[3] = { 0, 0, 0 };
+  vtkIdType connectivitySizes[3] = { 0, 0, 0 };
+  for (vtkIdType unitId = 0; unitId < numUnits; ++unitId)
+  {
+    SurfaceUnit &unit = surface.Units[unitId];
+    const int category = unitId < 3 * surface.NumberOfChunks ?
+      static_cast<int>(unitId / surface.NumberOfChunks) : SURFACE_POLYS;
+    unit.UseOffset = numUses;
+    unit.CellOffset = numNewCells;
+    unit.ConnectivityOffset = connectivitySizes[category];
+    numUses += unit.NumberOfUses;
+    numNewCells += unit.NumberOfCells;
+    numCategoryCells[category] += unit.NumberOfCells;
+    connectivitySizes[category] += unit.ConnectivitySize;
+  }
+
+  // Number the points by first use, like the serial code.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUses(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(firstUses.get(), firstUses.get() + numPts, VTK_ID_MAX);
+  surface.FirstUses = firstUses.get();
+  FindFirstUses findFirstUses(&surface);
+  vtkSMPTools::For(0, numUnits, 1, findFirstUses);
+  CountNewPoints countPoints(&surface);
+  vtkSMPTools::For(0, numUnits, 1, countPoints);
+  vtkIdType numNewPts = 0;
+  for (SurfaceUnit &unit : surface.Units)
+  {
+    unit.PointOffset = numNewPts;
+    numNewPts += unit.NumberOfPoints;
+  }
+
+  std::vector<vtkIdType> pointMap(numPts);
+  surface.PointMap = pointMap.data();
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataType(input->GetPoints()->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  if (this->PassThroughPointIds)
+  {
+    this->OriginalPointIds = vtkIdTypeArray::New();
+    this->OriginalPointIds->SetName(this->GetOriginalPointIdsName());
+    this->OriginalPointIds->SetNumberOfComponents(1);
+    this->OriginalPointIds->SetNumberOfTuples(numNewPts);
+  }
+  CopyNewPoints copyPoints(&surface, input->GetPoints(), inputPD, numNewPts,
+                           newPts, outputPD, this->OriginalPointIds);
+  vtkSMPTools::For(0, numUnits, 1, copyPoints);
+  firstUses.reset();
+  this->UpdateProgress(0.75);
+
+  // Generate the cells.
+  vtkCellArray *newCells[3];
+  vtkIdType *connectivity[3];
+  for (int category = 0; category < 3; ++category)
+  {
+    newCells[category] = vtkCellArray::New();
+    connectivity[category] = newCells[category]->WritePointer(
+      numCategoryCells[category], connectivitySizes[category]);
+  }
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numNewCells);
+  if (this->PassThroughCellIds)
+  {
+    this->OriginalCellIds = vtkIdTypeArray::New();
+    this->OriginalCellIds->SetName(this->GetOriginalCellIdsName());
+    this->OriginalCellIds->SetNumberOfComponents(1);
+    this->OriginalCellIds->SetNumberOfTuples(numNewCells);
+  }
+  GenerateSurfaceCells generateCells(&surface, connectivity, inputCD,
+                                     numNewCells, outputCD,
+                                     this->OriginalCellIds);
+  vtkSMPTools::For(0, numUnits, 1, generateCells);
+
+  if (this->PassThroughCellIds)
+  {
+    outputCD->AddArray(this->OriginalCellIds);
+    this->OriginalCellIds->Delete();
+    this->OriginalCellIds = nullptr;
+  }
+  if (this->PassThroughPointIds)
+  {
+    outputPD->AddArray(this->OriginalPointIds);
+    this->OriginalPointIds->Delete();
+    this->OriginalPointIds = nullptr;
+  }
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newCells[SURFACE_POLYS]);
+  if (numCategoryCells[SURFACE_VERTS] > 0)
+  {
+    output->SetVerts(newCells[SURFACE_VERTS]);
+  }
+  if (numCategoryCells[SURFACE_LINES] > 0)
+  {
+    output->SetLines(newCells[SURFACE_LINES]);
+  }
+  for (int category = 0; category < 3; ++category)
+  {
+    newCells[category]->Delete();
+  }
+  output->Squeeze();
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
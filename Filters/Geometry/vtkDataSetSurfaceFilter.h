@@ -21,6 +21,12 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * Unstructured grids made of linear cells are processed with several threads
+ * through vtkSMPTools, when more than one thread is available. The faces of
+ * the cells are hashed by partitions of point ids, and the points and cell
+ * attributes are copied in parallel. The output, including the order of its
+ * points and cells, is identical to the one of a serial execution.
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
 */
@@ -35,6 +41,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 
 // Helper structure for hashing faces.
 struct vtkFastGeomQuadStruct
@@ -150,6 +157,14 @@ public:
 #endif
   virtual int UnstructuredGridExecute(vtkDataSet *input,
                                       vtkPolyData *output);
+
+  /**
+   * Multi-threaded version of UnstructuredGridExecute() for grids of linear
+   * cells. The output is identical to the one of the serial code.
+   */
+  int ParallelUnstructuredGridExecute(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
+
   virtual int DataSetExecute(vtkDataSet *input, vtkPolyData *output);
   virtual int StructuredWithBlankingExecute(vtkStructuredGrid *input, vtkPolyData *output);
   virtual int UniformGridExecute(
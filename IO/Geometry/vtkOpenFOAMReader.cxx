@@ -7361,16 +7361,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
   mesh->GetPointCells(0, pointCells);
   pointCells->Delete();
 
-  // since vtkPolyData and vtkUnstructuredGrid do not share common
-  // overloaded GetCellLink() or GetPointCells() functions we have to
-  // do a tedious task
+  // since vtkPolyData and vtkUnstructuredGrid do not share a common
+  // GetPointCells() function returning a pointer we have to do a tedious
+  // task
   vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(mesh);
   vtkPolyData *pd = vtkPolyData::SafeDownCast(mesh);
-  vtkCellLinks *cl = nullptr;
-  if (ug)
-  {
-    cl = ug->GetCellLinks();
-  }
 
   const int nComponents = iData->GetNumberOfComponents();
 
@@ -7382,13 +7377,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
     {
       vtkTypeInt64 pI = pointList
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
-      unsigned short nCells;
+      vtkIdType nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        ug->GetPointCells(pI, nCells, cells);
       }
       else
       {
@@ -7396,7 +7389,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
       }
       // use double intermediate variable for precision
       double interpolatedValue = 0.0;
-      for (int cellI = 0; cellI < nCells; cellI++)
+      for (vtkIdType cellI = 0; cellI < nCells; cellI++)
       {
         interpolatedValue += tuples[cells[cellI]];
       }
@@ -7413,13 +7406,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
     {
       vtkTypeInt64 pI = pointList
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
-      unsigned short nCells;
+      vtkIdType nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        ug->GetPointCells(pI, nCells, cells);
       }
       else
       {
@@ -7430,7 +7421,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
       double summedValue0 = 0.0, summedValue1 = 0.0, summedValue2 = 0.0;
 
       // hand unrolling
-      for (int cellI = 0; cellI < nCells; cellI++)
+      for (vtkIdType cellI = 0; cellI < nCells; cellI++)
       {
         const float *tuple = iData->GetPointer(3 * cells[cellI]);
         summedValue0 += tuple[0];
@@ -7451,13 +7442,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
     {
       vtkTypeInt64 pI = pointList
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
-      unsigned short nCells;
+      vtkIdType nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        ug->GetPointCells(pI, nCells, cells);
       }
       else
       {
@@ -7471,7 +7460,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
       {
         const float *tuple = iData->GetPointer(componentI);
         double summedValue = 0.0;
-        for (int cellI = 0; cellI < nCells; cellI++)
+        for (vtkIdType cellI = 0; cellI < nCells; cellI++)
         {
           summedValue += tuple[nComponents * cells[cellI]];
         }
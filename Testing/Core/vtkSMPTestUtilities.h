@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTestUtilities.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSMPTestUtilities
+ * @brief   Utility functions used to test the vtkSMPTools backends.
+ *
+ * vtkSMPTestUtilities runs a test with each vtkSMPTools backend built in,
+ * so that the threaded code paths can be compared with the serial ones.
+ * Four threads are requested, so that the ranges are split in several
+ * blocks even on a single core machine. For instance:
+ *
+ * @code
+ * vtkSmartPointer<vtkPolyData> reference;
+ * if (!vtkSMPTestUtilities::CompareBackends(
+ *       [&]() { reference = Compute(input); return true; },
+ *       [&](const char *backend) {
+ *         if (!SameOutputs(reference, Compute(input)))
+ *         {
+ *           std::cerr << "Error: the " << backend << " backend gives a "
+ *                     << "different result" << std::endl;
+ *           return false;
+ *         }
+ *         return true;
+ *       }))
+ * {
+ *   return EXIT_FAILURE;
+ * }
+ * @endcode
+*/
+
+#ifndef vtkSMPTestUtilities_h
+#define vtkSMPTestUtilities_h
+
+#include "vtkSMPTools.h"
+
+struct vtkSMPTestUtilities
+{
+  /**
+   * Calls reference() with the Sequential backend, then check(backend) with
+   * each threaded backend available. Stops and returns false as soon as one
+   * of them returns false: they report their own errors. The Sequential
+   * backend is in use on return.
+   */
+  template <typename Reference, typename Check>
+  static inline bool CompareBackends(Reference&& reference, Check&& check);
+
+  /**
+   * Calls run(backend) with each backend available, the Sequential one
+   * first. Stops and returns false as soon as run() returns false. The
+   * Sequential backend is in use on return.
+   */
+  template <typename Run>
+  static inline bool ForEachBackend(Run&& run);
+};
+
+template <typename Reference, typename Check>
+inline bool vtkSMPTestUtilities::CompareBackends(Reference&& reference,
+                                                 Check&& check)
+{
+  bool first = true;
+  return vtkSMPTestUtilities::ForEachBackend([&](const char* backend) {
+    if (first)
+    {
+      first = false;
+      return static_cast<bool>(reference());
+    }
+    return static_cast<bool>(check(backend));
+  });
+}
+
+template <typename Run>
+inline bool vtkSMPTestUtilities::ForEachBackend(Run&& run)
+{
+  vtkSMPTools::Initialize(4);
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  bool success = true;
+  for (const char* backend : backends)
+  {
+    if (vtkSMPTools::SetBackend(backend) && !run(backend))
+    {
+      success = false;
+      break;
+    }
+  }
+  vtkSMPTools::SetBackend("Sequential");
+  return success;
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPTestUtilities.h